@@ -0,0 +1,96 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2010-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Many attributes, so that the hashed name index is used */
+
+int main() {
+  
+  igraph_t g, g2;
+  char name[20];
+  long int i, j;
+  igraph_real_t sum;
+  
+  igraph_i_set_attribute_table(&igraph_cattribute_table);
+  
+  igraph_ring(&g, 10, IGRAPH_UNDIRECTED, /*mutual=*/ 0, /*circular=*/ 1);
+
+  for (i=0; i<40; i++) {
+    snprintf(name, sizeof(name), "a%li", i);
+    for (j=0; j<10; j++) {
+      SETVAN(&g, name, j, i*100+j);
+    }
+    SETEAB(&g, name, i % 10, 1);
+    SETGAS(&g, name, name);
+  }
+
+  /* Lookups */
+  sum=0;
+  for (i=0; i<40; i++) {
+    snprintf(name, sizeof(name), "a%li", i);
+    for (j=0; j<10; j++) {
+      sum += VAN(&g, name, j);
+    }
+    if (strcmp(GAS(&g, name), name) || !EAB(&g, name, i % 10)) {
+      return 1;
+    }
+  }
+  printf("Sum: %g\n", sum);
+  if (igraph_cattribute_has_attr(&g, IGRAPH_ATTRIBUTE_VERTEX, "b")) {
+    return 2;
+  }
+
+  /* Remove some of them, and add a new one */
+  for (i=0; i<40; i+=2) {
+    snprintf(name, sizeof(name), "a%li", i);
+    DELVA(&g, name);
+  }
+  if (igraph_cattribute_has_attr(&g, IGRAPH_ATTRIBUTE_VERTEX, "a0") ||
+      !igraph_cattribute_has_attr(&g, IGRAPH_ATTRIBUTE_VERTEX, "a39")) {
+    return 3;
+  }
+  SETVAN(&g, "a0", 0, -1);
+  printf("a0: %g a1: %g a39: %g\n", VAN(&g, "a0", 0), VAN(&g, "a1", 1),
+	 VAN(&g, "a39", 9));
+
+  /* Add vertices one by one, then copy the graph */
+  for (i=0; i<100; i++) {
+    igraph_add_vertices(&g, 1, 0);
+    SETVAN(&g, "a1", igraph_vcount(&g)-1, i);
+  }
+  igraph_copy(&g2, &g);
+  igraph_destroy(&g);
+  printf("Vertices: %li, a1: %g %g, a3: %g\n", (long int) igraph_vcount(&g2),
+	 VAN(&g2, "a1", 109), VAN(&g2, "a1", 1), VAN(&g2, "a3", 0));
+  printf("a5 is NaN: %i\n", (int) igraph_is_nan(VAN(&g2, "a5", 50)));
+
+  DELALL(&g2);
+  SETVAN(&g2, "a1", 0, 5);
+  printf("a1: %g\n", VAN(&g2, "a1", 0));
+  igraph_destroy(&g2);
+
+  return 0;
+}
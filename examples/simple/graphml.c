@@ -73,6 +73,9 @@ int main(int argc, char **argv) {
   igraph_warning_handler_t* oldwarnhandler;
   int result;
   FILE *ifile, *ofile;
+  igraph_strvector_t names;
+  igraph_real_t weightsum;
+  long int i;
 
   igraph_i_set_attribute_table(&igraph_cattribute_table);
 
@@ -137,6 +140,62 @@ int main(int argc, char **argv) {
   dump_graph("The undirected graph:\n", &g);
   igraph_destroy(&g);
 
+  /* Read only some of the attributes */
+  igraph_strvector_init(&names, 2);
+  igraph_strvector_set(&names, 0, "age");
+  igraph_strvector_set(&names, 1, "type");
+  ifile=fopen("graphml-default-attrs.xml", "r");
+  if ((result=igraph_read_graph_graphml_select(&g, ifile, 0, &names))) {
+    return 1;
+  }
+  fclose(ifile);
+  dump_vertex_attribute_bool("type", &g);
+  dump_vertex_attribute_numeric("age", &g);
+  if (igraph_cattribute_has_attr(&g, IGRAPH_ATTRIBUTE_VERTEX, "gender") ||
+      igraph_cattribute_has_attr(&g, IGRAPH_ATTRIBUTE_VERTEX, "retired") ||
+      igraph_cattribute_has_attr(&g, IGRAPH_ATTRIBUTE_VERTEX, "id") ||
+      igraph_cattribute_has_attr(&g, IGRAPH_ATTRIBUTE_EDGE, "id")) {
+    return 2;
+  }
+  igraph_destroy(&g);
+  igraph_strvector_destroy(&names);
+
+  /* A larger file, spanning many input chunks, with nodes declared
+     after the edges that refer to them */
+  ifile=tmpfile();
+  if (ifile==0) {
+    return 3;
+  }
+  fprintf(ifile, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	  "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+	  "<key id=\"w\" for=\"edge\" attr.name=\"weight\" "
+	  "attr.type=\"double\"/>\n"
+	  "<key id=\"l\" for=\"node\" attr.name=\"label\" "
+	  "attr.type=\"string\"/>\n"
+	  "<graph edgedefault=\"undirected\">\n");
+  for (i=0; i<20000; i++) {
+    fprintf(ifile, "<edge source=\"n%li\" target=\"n%li\">"
+	    "<data key=\"w\">%li</data></edge>\n", i, (i+1) % 20000, i % 7);
+  }
+  for (i=0; i<20000; i++) {
+    fprintf(ifile, "<node id=\"n%li\"><data key=\"l\">v%li</data></node>\n",
+	    i, i);
+  }
+  fprintf(ifile, "</graph>\n</graphml>\n");
+  rewind(ifile);
+  if ((result=igraph_read_graph_graphml(&g, ifile, 0))) {
+    return 4;
+  }
+  fclose(ifile);
+  weightsum=0;
+  for (i=0; i<igraph_ecount(&g); i++) {
+    weightsum += EAN(&g, "weight", i);
+  }
+  printf("Vertices: %li, edges: %li, weight sum: %g, labels: %s %s\n",
+	 (long int) igraph_vcount(&g), (long int) igraph_ecount(&g),
+	 weightsum, VAS(&g, "label", 0), VAS(&g, "label", 19999));
+  igraph_destroy(&g);
+
   /* Restore the old warning handler */
   igraph_set_warning_handler(oldwarnhandler);
 
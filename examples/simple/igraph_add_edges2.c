@@ -0,0 +1,98 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2014  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* Adding edges in small batches merges them into the existing
+   indices. The result must be exactly the same as creating the graph
+   in one step, including the order of the incident edges. */
+
+int check_same(const igraph_t *g1, const igraph_t *g2) {
+  igraph_vector_t v1, v2;
+  igraph_neimode_t modes[3] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+  long int i, m, n=igraph_vcount(g1);
+
+  if (igraph_ecount(g1) != igraph_ecount(g2)) { return 1; }
+
+  igraph_vector_init(&v1, 0);
+  igraph_vector_init(&v2, 0);
+  for (i=0; i<n; i++) {
+    for (m=0; m<3; m++) {
+      igraph_incident(g1, &v1, i, modes[m]);
+      igraph_incident(g2, &v2, i, modes[m]);
+      if (!igraph_vector_all_e(&v1, &v2)) { return 2; }
+      igraph_neighbors(g1, &v1, i, modes[m]);
+      igraph_neighbors(g2, &v2, i, modes[m]);
+      if (!igraph_vector_all_e(&v1, &v2)) { return 3; }
+    }
+  }
+  igraph_vector_destroy(&v1);
+  igraph_vector_destroy(&v2);
+
+  return 0;
+}
+
+int test(igraph_bool_t directed) {
+  igraph_t g1, g2;
+  igraph_vector_t edges, batch;
+  long int i, n=50, m=400, ret;
+
+  igraph_vector_init(&edges, 2*m);
+  for (i=0; i<2*m; i++) {
+    VECTOR(edges)[i] = RNG_INTEGER(0, n-1);
+  }
+  igraph_create(&g1, &edges, n, directed);
+
+  igraph_empty(&g2, n, directed);
+  igraph_vector_init(&batch, 0);
+  for (i=0; i<m; ) {
+    long int k=RNG_INTEGER(1, 10), j;
+    if (i+k > m) { k=m-i; }
+    igraph_vector_resize(&batch, 2*k);
+    for (j=0; j<2*k; j++) {
+      VECTOR(batch)[j] = VECTOR(edges)[2*i+j];
+    }
+    igraph_add_edges(&g2, &batch, 0);
+    i += k;
+  }
+
+  ret=check_same(&g1, &g2);
+
+  igraph_vector_destroy(&batch);
+  igraph_vector_destroy(&edges);
+  igraph_destroy(&g2);
+  igraph_destroy(&g1);
+
+  return ret;
+}
+
+int main() {
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  if ((ret=test(IGRAPH_DIRECTED))) { return ret; }
+  if ((ret=test(IGRAPH_UNDIRECTED))) { return 10+ret; }
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Checks that the estimates are within the error bound */
+
+int within(const igraph_vector_t *est, const igraph_vector_t *exact,
+	   igraph_real_t bound) {
+  long int i, n=igraph_vector_size(exact);
+  if (igraph_vector_size(est) != n) { return 0; }
+  for (i=0; i<n; i++) {
+    if (fabs(VECTOR(*est)[i] - VECTOR(*exact)[i]) > bound) { return 0; }
+  }
+  return 1;
+}
+
+int main() {
+  igraph_t g;
+  igraph_vector_t exact, est;
+  igraph_integer_t samples;
+  igraph_real_t n, eps=0.1;
+  igraph_error_handler_t *handler;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+  igraph_vector_init(&exact, 0);
+  igraph_vector_init(&est, 0);
+
+  /* Small graph, the sample would be too large, exact result */
+  igraph_famous(&g, "Zachary");
+  igraph_betweenness(&g, &exact, igraph_vss_all(), 0, 0, 1);
+  igraph_betweenness_approx(&g, &est, igraph_vss_all(), 0, 0, eps, 0.1,
+			    &samples);
+  if (samples != igraph_vcount(&g)) { return 1; }
+  if (!within(&est, &exact, 1e-10)) { return 2; }
+  igraph_destroy(&g);
+
+  /* Larger graph, sampling */
+  igraph_barabasi_game(&g, 3000, 1, 2, 0, 0, 1, 0, IGRAPH_BARABASI_PSUMTREE,
+		       0);
+  n=igraph_vcount(&g);
+  igraph_betweenness(&g, &exact, igraph_vss_all(), 0, 0, 1);
+  igraph_betweenness_approx(&g, &est, igraph_vss_all(), 0, 0, eps, 0.1,
+			    &samples);
+  if (samples != (igraph_integer_t) ceil(log(2*n/0.1)/(2*eps*eps))) {
+    return 3;
+  }
+  if (!within(&est, &exact, eps*n*(n-1))) { return 4; }
+  /* The top vertex is found */
+  if (igraph_vector_which_max(&est) != igraph_vector_which_max(&exact)) {
+    return 5;
+  }
+
+  igraph_edge_betweenness(&g, &exact, 0, 0);
+  igraph_edge_betweenness_approx(&g, &est, 0, 0, eps, 0.1, &samples);
+  if (samples >= n) { return 6; }
+  if (!within(&est, &exact, eps*n*(n-1))) { return 7; }
+
+  /* Invalid parameters */
+  handler=igraph_set_error_handler(igraph_error_handler_ignore);
+  ret=igraph_betweenness_approx(&g, &est, igraph_vss_all(), 0, 0, 0, 0.1, 0);
+  if (ret != IGRAPH_EINVAL) { return 8; }
+  ret=igraph_edge_betweenness_approx(&g, &est, 0, 0, 0.1, 1, 0);
+  if (ret != IGRAPH_EINVAL) { return 9; }
+  igraph_set_error_handler(handler);
+
+  igraph_destroy(&g);
+  igraph_vector_destroy(&est);
+  igraph_vector_destroy(&exact);
+
+  if (!IGRAPH_FINALLY_STACK_EMPTY) { return 10; }
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Sums the contributions of three source blocks and compares them to
+   the full betweenness scores */
+
+int check(const igraph_t *g, igraph_bool_t directed, 
+	  const igraph_vector_t *weights) {
+  igraph_vector_t full, part, sum;
+  long int n=igraph_vcount(g), from=0, i, b;
+  long int bounds[] = { n/3, n/2, n };
+
+  igraph_vector_init(&full, 0);
+  igraph_vector_init(&part, 0);
+  igraph_vector_init(&sum, n);
+  igraph_betweenness(g, &full, igraph_vss_all(), directed, weights, 1);
+  for (b=0; b<3; b++) {
+    igraph_betweenness_sources(g, &part, igraph_vss_all(), directed,
+			       igraph_vss_seq(from, bounds[b]-1), -1,
+			       weights, 1);
+    igraph_vector_add(&sum, &part);
+    from=bounds[b];
+  }
+  for (i=0; i<n; i++) {
+    if (fabs(VECTOR(sum)[i] - VECTOR(full)[i]) > 1e-8) { return 1; }
+  }
+
+  /* A vertex subset and a single source */
+  igraph_betweenness_sources(g, &part, igraph_vss_1(2), directed,
+			     igraph_vss_1(0), -1, weights, 1);
+  if (igraph_vector_size(&part) != 1) { return 2; }
+
+  igraph_vector_destroy(&sum);
+  igraph_vector_destroy(&part);
+  igraph_vector_destroy(&full);
+  return 0;
+}
+
+int main() {
+  igraph_t g;
+  igraph_vector_t weights;
+  long int i;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  igraph_famous(&g, "Zachary");
+  if ((ret=check(&g, 0, 0))) { return ret; }
+  igraph_vector_init(&weights, igraph_ecount(&g));
+  for (i=0; i<igraph_ecount(&g); i++) { VECTOR(weights)[i] = i % 5 + 1; }
+  if ((ret=check(&g, 0, &weights))) { return 10+ret; }
+  igraph_vector_destroy(&weights);
+  igraph_destroy(&g);
+
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200, 800,
+			  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+  if ((ret=check(&g, 1, 0))) { return 20+ret; }
+  if ((ret=check(&g, 0, 0))) { return 30+ret; }
+  igraph_vector_init(&weights, igraph_ecount(&g));
+  for (i=0; i<igraph_ecount(&g); i++) { VECTOR(weights)[i] = i % 3 + 1; }
+  if ((ret=check(&g, 1, &weights))) { return 40+ret; }
+  igraph_vector_destroy(&weights);
+  igraph_destroy(&g);
+
+  if (!IGRAPH_FINALLY_STACK_EMPTY) { return 50; }
+
+  return 0;
+}
@@ -0,0 +1,164 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* The distances computed without any other result, by the
+   direction-optimizing search, must be the same as the ones of the
+   ordinary search */
+
+int check_bfs(const igraph_t *graph, igraph_integer_t root,
+	      const igraph_vector_t *roots, igraph_neimode_t mode,
+	      igraph_bool_t unreachable, const igraph_vector_t *restricted) {
+  igraph_vector_t order, dist1, dist2;
+  long int i, n=igraph_vcount(graph);
+  int ret=0;
+
+  igraph_vector_init(&order, 0);
+  igraph_vector_init(&dist1, 0);
+  igraph_vector_init(&dist2, 0);
+
+  igraph_bfs(graph, root, roots, mode, unreachable, restricted,
+	     &order, 0, 0, 0, 0, &dist1, 0, 0);
+  igraph_bfs(graph, root, roots, mode, unreachable, restricted,
+	     0, 0, 0, 0, 0, &dist2, 0, 0);
+
+  if (igraph_vector_size(&dist2) != n) { ret=1; }
+  for (i=0; i<n && !ret; i++) {
+    igraph_real_t d1=VECTOR(dist1)[i], d2=VECTOR(dist2)[i];
+    if (igraph_is_nan(d1) ? !igraph_is_nan(d2) : d1 != d2) { ret=1; }
+  }
+
+  igraph_vector_destroy(&order);
+  igraph_vector_destroy(&dist1);
+  igraph_vector_destroy(&dist2);
+  return ret;
+}
+
+/* A single source against the same row computed together with
+   another source */
+
+int check_paths(const igraph_t *graph, igraph_integer_t source,
+		igraph_neimode_t mode, const igraph_vs_t to) {
+  igraph_matrix_t one, two;
+  igraph_vector_t sources;
+  long int j;
+  int ret=0;
+
+  igraph_matrix_init(&one, 0, 0);
+  igraph_matrix_init(&two, 0, 0);
+  igraph_vector_init(&sources, 2);
+  VECTOR(sources)[0]=source;
+  VECTOR(sources)[1]=0;
+
+  igraph_shortest_paths(graph, &one, igraph_vss_1(source), to, mode);
+  igraph_shortest_paths(graph, &two, igraph_vss_vector(&sources), to, mode);
+  if (igraph_matrix_nrow(&one) != 1 || 
+      igraph_matrix_ncol(&one) != igraph_matrix_ncol(&two)) {
+    ret=1;
+  }
+  for (j=0; j<igraph_matrix_ncol(&one) && !ret; j++) {
+    if (MATRIX(one, 0, j) != MATRIX(two, 0, j)) { ret=1; }
+  }
+
+  igraph_vector_destroy(&sources);
+  igraph_matrix_destroy(&two);
+  igraph_matrix_destroy(&one);
+  return ret;
+}
+
+int main() {
+  igraph_t g, g2, u;
+  igraph_vector_t roots, restricted, to;
+  igraph_bool_t conn;
+  igraph_neimode_t modes[3]={ IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+  long int i, m;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  /* Small diameter, so that the large levels are done bottom-up */
+  igraph_barabasi_game(&g, 3000, /*power=*/ 1, /*m=*/ 5, 0, 
+		       /*outpref=*/ 0, /*A=*/ 1, /*directed=*/ 0, 
+		       IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+  if (check_bfs(&g, 0, 0, IGRAPH_ALL, 0, 0)) { return 1; }
+  if (check_bfs(&g, 2999, 0, IGRAPH_ALL, 1, 0)) { return 2; }
+  if (check_paths(&g, 17, IGRAPH_ALL, igraph_vss_all())) { return 3; }
+  igraph_is_connected(&g, &conn, IGRAPH_WEAK);
+  if (!conn) { return 4; }
+
+  /* Several components, roots and a restricted set */
+  igraph_vector_init(&roots, 3);
+  VECTOR(roots)[0]=2000; VECTOR(roots)[1]=5; VECTOR(roots)[2]=3001;
+  igraph_vector_init(&restricted, 0);
+  for (i=0; i<6000; i+=3) { igraph_vector_push_back(&restricted, i); }
+  igraph_vector_push_back(&restricted, 3001);
+  igraph_disjoint_union(&u, &g, &g);
+  if (check_bfs(&u, 0, &roots, IGRAPH_ALL, 0, 0)) { return 5; }
+  if (check_bfs(&u, 0, &roots, IGRAPH_ALL, 1, 0)) { return 6; }
+  if (check_bfs(&u, 0, &roots, IGRAPH_ALL, 1, &restricted)) { return 7; }
+  if (check_bfs(&u, 3, 0, IGRAPH_ALL, 0, &restricted)) { return 8; }
+  igraph_is_connected(&u, &conn, IGRAPH_WEAK);
+  if (conn) { return 9; }
+  igraph_destroy(&u);
+  igraph_destroy(&g);
+
+  /* Directed graphs, in all modes */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 2000, 30000,
+			  /*directed=*/ 1, /*loops=*/ 0);
+  igraph_barabasi_game(&g2, 2000, /*power=*/ 1, /*m=*/ 4, 0, 
+		       /*outpref=*/ 0, /*A=*/ 1, /*directed=*/ 1, 
+		       IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+  igraph_vector_init(&to, 0);
+  for (i=0; i<2000; i+=7) { igraph_vector_push_back(&to, i); }
+  VECTOR(roots)[0]=1500; VECTOR(roots)[2]=14;
+  for (m=0; m<3; m++) {
+    if (check_bfs(&g, 0, 0, modes[m], 0, 0)) { return 10; }
+    if (check_bfs(&g, 0, &roots, modes[m], 1, &to)) { return 11; }
+    if (check_bfs(&g2, 1999, 0, modes[m], 1, 0)) { return 12; }
+    if (check_bfs(&g2, 0, 0, modes[m], 0, 0)) { return 13; }
+    if (check_paths(&g, 3, modes[m], igraph_vss_all())) { return 14; }
+    if (check_paths(&g2, 1500, modes[m], igraph_vss_vector(&to))) { 
+      return 15;
+    }
+  }
+  igraph_is_connected(&g2, &conn, IGRAPH_WEAK);
+  if (!conn) { return 16; }
+
+  /* The null graph and a single vertex */
+  igraph_destroy(&g);
+  igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+  igraph_is_connected(&g, &conn, IGRAPH_WEAK);
+  if (!conn) { return 17; }
+  igraph_destroy(&g);
+  igraph_empty(&g, 1, IGRAPH_DIRECTED);
+  if (check_bfs(&g, 0, 0, IGRAPH_OUT, 1, 0)) { return 18; }
+  if (check_paths(&g, 0, IGRAPH_IN, igraph_vss_all())) { return 19; }
+
+  igraph_vector_destroy(&to);
+  igraph_vector_destroy(&restricted);
+  igraph_vector_destroy(&roots);
+  igraph_destroy(&g2);
+  igraph_destroy(&g);
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+int same(const igraph_vector_t *v1, const igraph_vector_t *v2) {
+  long int i, n=igraph_vector_size(v1);
+  if (igraph_vector_size(v2) != n) { return 0; }
+  for (i=0; i<n; i++) {
+    if (fabs(VECTOR(*v1)[i] - VECTOR(*v2)[i]) > 1e-8) { return 0; }
+  }
+  return 1;
+}
+
+/* Removes the edges with the given ids from a copy of 'g', adds
+   'added', then checks the updated scores against the recalculated
+   ones. */
+
+int check(const igraph_t *g, igraph_real_t *rem, int nrem, 
+	  igraph_real_t *add, int nadd, igraph_neimode_t mode,
+	  igraph_integer_t *updated) {
+  igraph_t h;
+  igraph_vector_t removed, added, eids, bet, bet2, clo, clo2;
+  igraph_integer_t from, to, updated2;
+  igraph_bool_t directed=(mode != IGRAPH_ALL);
+  int i, ret=0;
+
+  igraph_vector_view(&eids, rem, nrem);
+  igraph_vector_view(&added, add, nadd);
+  igraph_vector_init(&removed, 0);
+  for (i=0; i<nrem; i++) {
+    igraph_edge(g, (igraph_integer_t) rem[i], &from, &to);
+    igraph_vector_push_back(&removed, from);
+    igraph_vector_push_back(&removed, to);
+  }
+  igraph_copy(&h, g);
+  igraph_delete_edges(&h, igraph_ess_vector(&eids));
+  igraph_add_edges(&h, &added, 0);
+
+  igraph_vector_init(&bet, 0);
+  igraph_vector_init(&bet2, 0);
+  igraph_vector_init(&clo, 0);
+  igraph_vector_init(&clo2, 0);
+  igraph_betweenness(g, &bet, igraph_vss_all(), directed, 0, 1);
+  igraph_closeness(g, &clo, igraph_vss_all(), mode, 0, 1);
+
+  igraph_betweenness_update(g, &h, &removed, &added, &bet, directed, 
+			    updated);
+  igraph_closeness_update(g, &h, &removed, &added, &clo, mode, 1,
+			  &updated2);
+  igraph_betweenness(&h, &bet2, igraph_vss_all(), directed, 0, 1);
+  igraph_closeness(&h, &clo2, igraph_vss_all(), mode, 0, 1);
+
+  if (!same(&bet, &bet2)) { ret=1; }
+  if (!same(&clo, &clo2)) { ret=2; }
+  if (mode != IGRAPH_IN && *updated != updated2) { ret=3; }
+
+  igraph_vector_destroy(&clo2);
+  igraph_vector_destroy(&clo);
+  igraph_vector_destroy(&bet2);
+  igraph_vector_destroy(&bet);
+  igraph_destroy(&h);
+  igraph_vector_destroy(&removed);
+  return ret;
+}
+
+int main() {
+  igraph_t g;
+  igraph_vector_t edges;
+  igraph_integer_t updated;
+  igraph_real_t rem[] = { 5, 17, 42 };
+  igraph_real_t add[] = { 201, 202, 3, 150, 7, 8 };
+  igraph_real_t add_leaves[] = { 203, 204 };
+  long int i;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  /* A random graph, with a star of 10 leaves attached to vertex 0 */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200, 600,
+			  IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+  igraph_vector_init(&edges, 0);
+  for (i=200; i<210; i++) {
+    igraph_vector_push_back(&edges, 0);
+    igraph_vector_push_back(&edges, i);
+  }
+  igraph_add_vertices(&g, 10, 0);
+  igraph_add_edges(&g, &edges, 0);
+
+  if ((ret=check(&g, rem, 3, add, 6, IGRAPH_ALL, &updated))) { 
+    return ret; 
+  }
+  /* Most sources are affected, so everything is recalculated */
+  if (updated != 210) { return 5; }
+  /* Only the two leaves are affected */
+  if ((ret=check(&g, rem, 0, add_leaves, 2, IGRAPH_ALL, &updated))) {
+    return 10+ret;
+  }
+  if (updated != 2) { return 20; }
+  /* Nothing changed */
+  if ((ret=check(&g, rem, 0, add, 0, IGRAPH_ALL, &updated))) {
+    return 30+ret;
+  }
+  if (updated != 0) { return 40; }
+  igraph_destroy(&g);
+
+  /* Directed */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 210, 1000,
+			  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+  if ((ret=check(&g, rem, 3, add, 6, IGRAPH_OUT, &updated))) {
+    return 50+ret;
+  }
+  if ((ret=check(&g, rem, 3, add, 6, IGRAPH_IN, &updated))) {
+    return 60+ret;
+  }
+  igraph_destroy(&g);
+
+  igraph_vector_destroy(&edges);
+
+  if (!IGRAPH_FINALLY_STACK_EMPTY) { return 70; }
+
+  return 0;
+}
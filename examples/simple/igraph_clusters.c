@@ -0,0 +1,136 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* Checks the connected components against igraph_subcomponent() */
+
+int check_weak(const igraph_t *graph) {
+  igraph_vector_t membership, csize, ref, sub;
+  igraph_integer_t no;
+  long int i, j, n=igraph_vcount(graph), next=0;
+
+  igraph_vector_init(&membership, 0);
+  igraph_vector_init(&csize, 0);
+  igraph_vector_init(&sub, 0);
+  igraph_vector_init(&ref, n);
+  igraph_vector_fill(&ref, -1);
+
+  igraph_clusters(graph, &membership, &csize, &no, IGRAPH_WEAK);
+
+  /* Components are numbered in the order of their smallest vertex */
+  for (i=0; i<n; i++) {
+    if (VECTOR(ref)[i] >= 0) { continue; }
+    igraph_subcomponent(graph, &sub, i, IGRAPH_ALL);
+    for (j=0; j<igraph_vector_size(&sub); j++) {
+      VECTOR(ref)[(long int) VECTOR(sub)[j]] = next;
+    }
+    if (VECTOR(csize)[next] != igraph_vector_size(&sub)) { return 1; }
+    next++;
+  }
+  if (no != next || igraph_vector_size(&csize) != next) { return 2; }
+  if (!igraph_vector_all_e(&ref, &membership)) { return 3; }
+
+  igraph_vector_destroy(&ref);
+  igraph_vector_destroy(&sub);
+  igraph_vector_destroy(&csize);
+  igraph_vector_destroy(&membership);
+  return 0;
+}
+
+int check_strong(const igraph_t *graph) {
+  igraph_vector_t membership, csize, out, in;
+  igraph_integer_t no;
+  long int i, j, n=igraph_vcount(graph);
+
+  igraph_vector_init(&membership, 0);
+  igraph_vector_init(&csize, 0);
+  igraph_vector_init(&out, 0);
+  igraph_vector_init(&in, 0);
+
+  igraph_clusters(graph, &membership, &csize, &no, IGRAPH_STRONG);
+  if (igraph_vector_size(&csize) != no || igraph_vector_sum(&csize) != n) {
+    return 1;
+  }
+
+  /* Two vertices are in the same component iff they reach each other */
+  for (i=0; i<n; i++) {
+    long int c=(long int) VECTOR(membership)[i], size=0;
+    igraph_subcomponent(graph, &out, i, IGRAPH_OUT);
+    igraph_subcomponent(graph, &in, i, IGRAPH_IN);
+    igraph_vector_sort(&out);
+    igraph_vector_sort(&in);
+    for (j=0; j<n; j++) {
+      igraph_bool_t same=igraph_vector_binsearch2(&out, j) &&
+	igraph_vector_binsearch2(&in, j);
+      if (same != (VECTOR(membership)[j] == c)) { return 2; }
+      size += same;
+    }
+    if (VECTOR(csize)[c] != size) { return 3; }
+  }
+
+  igraph_vector_destroy(&in);
+  igraph_vector_destroy(&out);
+  igraph_vector_destroy(&csize);
+  igraph_vector_destroy(&membership);
+  return 0;
+}
+
+int main() {
+  igraph_t g;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  /* Many small components, with loops and multi-edges */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 250,
+			  IGRAPH_DIRECTED, IGRAPH_LOOPS);
+  igraph_add_edge(&g, 7, 3);
+  igraph_add_edge(&g, 7, 3);
+  if ((ret=check_weak(&g))) { return ret; }
+  if ((ret=check_strong(&g))) { return 10+ret; }
+  igraph_destroy(&g);
+
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 500,
+			  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+  if ((ret=check_weak(&g))) { return 20+ret; }
+  if ((ret=check_strong(&g))) { return 30+ret; }
+  igraph_destroy(&g);
+
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 200,
+			  IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+  if ((ret=check_weak(&g))) { return 40+ret; }
+  igraph_destroy(&g);
+
+  /* Empty graphs */
+  igraph_empty(&g, 0, IGRAPH_DIRECTED);
+  if ((ret=check_weak(&g))) { return 50+ret; }
+  if ((ret=check_strong(&g))) { return 60+ret; }
+  igraph_destroy(&g);
+  igraph_empty(&g, 5, IGRAPH_DIRECTED);
+  if ((ret=check_weak(&g))) { return 70+ret; }
+  if ((ret=check_strong(&g))) { return 80+ret; }
+  igraph_destroy(&g);
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Every community must induce a connected subgraph */
+
+int check_connected(const igraph_t *graph, const igraph_vector_t *membership,
+		    igraph_integer_t nb_clusters) {
+  igraph_vector_t vids;
+  igraph_t sub;
+  igraph_bool_t conn;
+  long int c, i, n=igraph_vcount(graph);
+  int ret=0;
+
+  igraph_vector_init(&vids, 0);
+  for (c=0; c<nb_clusters && !ret; c++) {
+    igraph_vector_clear(&vids);
+    for (i=0; i<n; i++) {
+      if (VECTOR(*membership)[i] == c) { igraph_vector_push_back(&vids, i); }
+    }
+    if (igraph_vector_size(&vids) == 0) { ret=1; break; }
+    igraph_induced_subgraph(graph, &sub, igraph_vss_vector(&vids),
+			    IGRAPH_SUBGRAPH_AUTO);
+    igraph_is_connected(&sub, &conn, IGRAPH_WEAK);
+    if (!conn) { ret=2; }
+    igraph_destroy(&sub);
+  }
+  igraph_vector_destroy(&vids);
+  return ret;
+}
+
+int main() {
+  igraph_t g;
+  igraph_vector_t edges, membership, degree, membership2;
+  igraph_integer_t nb, nb2;
+  igraph_real_t quality, quality2, modularity;
+  long int i, j, k;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  /* Ring of 20 cliques, found with CPM */
+  igraph_vector_init(&edges, 0);
+  for (i=0; i<20; i++) {
+    for (j=0; j<10; j++) {
+      for (k=j+1; k<10; k++) {
+	igraph_vector_push_back(&edges, i*10+j);
+	igraph_vector_push_back(&edges, i*10+k);
+      }
+    }
+    igraph_vector_push_back(&edges, i*10);
+    igraph_vector_push_back(&edges, ((i+1)*10+5) % 200);
+  }
+  igraph_create(&g, &edges, 200, IGRAPH_UNDIRECTED);
+  igraph_vector_init(&membership, 0);
+  igraph_community_leiden(&g, 0, 0, /*resolution=*/ 0.05, /*beta=*/ 0.01,
+			  /*start=*/ 0, /*n_iterations=*/ 2, &membership, 
+			  &nb, &quality);
+  if (nb != 20) { return 1; }
+  for (i=0; i<200; i++) {
+    if (VECTOR(membership)[i] != VECTOR(membership)[(i/10)*10]) { return 2; }
+  }
+  if (fabs(quality - (1800.0 - 0.05 * 20 * 100) / 1840.0) > 1e-12) { 
+    return 3;
+  }
+
+  /* Starting from a single community, the refinement splits it */
+  igraph_vector_fill(&membership, 7);
+  igraph_community_leiden(&g, 0, 0, 0.05, 0.01, /*start=*/ 1, 
+			  /*n_iterations=*/ -1, &membership, &nb, 0);
+  if (nb != 20) { return 4; }
+  igraph_destroy(&g);
+
+  /* Modularity on a larger graph, communities must be connected */
+  igraph_barabasi_game(&g, 2000, /*power=*/ 1, /*m=*/ 3, 0, 
+		       /*outpref=*/ 0, /*A=*/ 1, /*directed=*/ 0, 
+		       IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ 0);
+  igraph_vector_init(&degree, 0);
+  igraph_degree(&g, &degree, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+  igraph_community_leiden(&g, 0, &degree, 1.0 / (2 * igraph_ecount(&g)), 
+			  0.01, 0, /*n_iterations=*/ 1, &membership, &nb,
+			  &quality);
+  igraph_modularity(&g, &membership, &modularity, 0);
+  if (fabs(quality - modularity) > 1e-10) { return 5; }
+  if ( (ret=check_connected(&g, &membership, nb)) ) { return 5+ret; }
+
+  /* Further iterations do not make it worse */
+  igraph_vector_init(&membership2, 0);
+  igraph_vector_update(&membership2, &membership);
+  igraph_community_leiden(&g, 0, &degree, 1.0 / (2 * igraph_ecount(&g)), 
+			  0.01, /*start=*/ 1, /*n_iterations=*/ -1, 
+			  &membership2, &nb2, &quality2);
+  if (quality2 < quality - 1e-12) { return 8; }
+  if ( (ret=check_connected(&g, &membership2, nb2)) ) { return 8+ret; }
+  igraph_destroy(&g);
+
+  /* Starting from disconnected communities, they are split */
+  for (k=0; k<20; k++) {
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 450,
+			    IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_degree(&g, &degree, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
+    igraph_vector_resize(&membership, 300);
+    for (i=0; i<300; i++) { VECTOR(membership)[i] = (i*7) % 5; }
+    igraph_community_leiden(&g, 0, &degree, 1.0 / (2 * igraph_ecount(&g)),
+			    0.01, /*start=*/ 1, /*n_iterations=*/ 1,
+			    &membership, &nb, 0);
+    if ( (ret=check_connected(&g, &membership, nb)) ) { return 12+ret; }
+    igraph_destroy(&g);
+  }
+
+  /* No edges: singletons */
+  igraph_empty(&g, 5, IGRAPH_UNDIRECTED);
+  igraph_community_leiden(&g, 0, 0, 1, 0.01, 0, 1, &membership, &nb, 
+			  &quality);
+  if (nb != 5 || !igraph_is_nan(quality)) { return 15; }
+  igraph_destroy(&g);
+
+  /* Directed graphs are not supported */
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  igraph_ring(&g, 5, IGRAPH_DIRECTED, 0, 1);
+  if (!igraph_community_leiden(&g, 0, 0, 1, 0.01, 0, 1, &membership, &nb, 
+			       0)) {
+    return 16;
+  }
+  igraph_destroy(&g);
+
+  igraph_vector_destroy(&membership2);
+  igraph_vector_destroy(&degree);
+  igraph_vector_destroy(&membership);
+  igraph_vector_destroy(&edges);
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* The modularity reported for each level must match the membership
+   vector of that level, and it must increase from level to level */
+
+int check_levels(const igraph_t *graph, const igraph_vector_t *weights) {
+  igraph_vector_t membership, modularity, row;
+  igraph_matrix_t memberships;
+  igraph_real_t q;
+  long int i, j, levels;
+  int ret=0;
+
+  igraph_vector_init(&membership, 0);
+  igraph_vector_init(&modularity, 0);
+  igraph_vector_init(&row, 0);
+  igraph_matrix_init(&memberships, 0, 0);
+
+  igraph_community_multilevel(graph, weights, &membership, &memberships,
+			      &modularity);
+  levels=igraph_matrix_nrow(&memberships);
+  if (levels == 0 || igraph_vector_size(&modularity) != levels) { ret=1; }
+  for (i=0; i<levels && !ret; i++) {
+    igraph_matrix_get_row(&memberships, &row, i);
+    igraph_modularity(graph, &row, &q, weights);
+    if (fabs(q - VECTOR(modularity)[i]) > 1e-10) { ret=2; }
+    if (i > 0 && VECTOR(modularity)[i] < VECTOR(modularity)[i-1]) { ret=3; }
+  }
+  for (j=0; j<igraph_vcount(graph) && !ret; j++) {
+    if (VECTOR(membership)[j] != VECTOR(row)[j]) { ret=4; }
+  }
+
+  igraph_matrix_destroy(&memberships);
+  igraph_vector_destroy(&row);
+  igraph_vector_destroy(&modularity);
+  igraph_vector_destroy(&membership);
+  return ret;
+}
+
+int main() {
+  igraph_t g;
+  igraph_vector_t edges, weights, membership;
+  long int i, j, k;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  /* Ring of 20 cliques, every clique must be found */
+  igraph_vector_init(&edges, 0);
+  for (i=0; i<20; i++) {
+    for (j=0; j<10; j++) {
+      for (k=j+1; k<10; k++) {
+	igraph_vector_push_back(&edges, i*10+j);
+	igraph_vector_push_back(&edges, i*10+k);
+      }
+    }
+    igraph_vector_push_back(&edges, i*10);
+    igraph_vector_push_back(&edges, ((i+1)*10+5) % 200);
+  }
+  igraph_create(&g, &edges, 200, IGRAPH_UNDIRECTED);
+  if ( (ret=check_levels(&g, 0)) ) { return ret; }
+  igraph_vector_init(&membership, 0);
+  igraph_community_multilevel(&g, 0, &membership, 0, 0);
+  for (i=0; i<200; i++) {
+    if (VECTOR(membership)[i] != VECTOR(membership)[(i/10)*10]) { return 10; }
+    if (i >= 10 && VECTOR(membership)[i] == VECTOR(membership)[i-10]) { 
+      return 11;
+    }
+  }
+  igraph_destroy(&g);
+
+  /* Random weights, multiple edges and loops */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 500, 2000,
+			  IGRAPH_UNDIRECTED, /*loops=*/ 1);
+  igraph_get_edgelist(&g, &edges, 0);
+  for (i=0; i<200; i++) { 
+    igraph_vector_push_back(&edges, VECTOR(edges)[2*i]);
+    igraph_vector_push_back(&edges, VECTOR(edges)[2*i+1]);
+  }
+  for (i=0; i<20; i++) {
+    igraph_vector_push_back(&edges, i);
+    igraph_vector_push_back(&edges, i);
+  }
+  igraph_destroy(&g);
+  igraph_create(&g, &edges, 500, IGRAPH_UNDIRECTED);
+  igraph_vector_init(&weights, igraph_ecount(&g));
+  for (i=0; i<igraph_ecount(&g); i++) {
+    VECTOR(weights)[i]=igraph_rng_get_unif(igraph_rng_default(), 0.5, 2);
+  }
+  if ( (ret=check_levels(&g, 0)) ) { return 20+ret; }
+  if ( (ret=check_levels(&g, &weights)) ) { return 30+ret; }
+
+  igraph_vector_destroy(&weights);
+  igraph_vector_destroy(&membership);
+  igraph_vector_destroy(&edges);
+  igraph_destroy(&g);
+
+  return 0;
+}
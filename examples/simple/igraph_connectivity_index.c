@@ -0,0 +1,217 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* Applies random batches of insertions and deletions, and compares
+   the index to igraph_clusters() on the current graph after each
+   batch */
+
+int check(igraph_connectivity_index_t *index, const igraph_vector_t *edges,
+	  const igraph_vector_bool_t *alive, long int no_of_nodes) {
+  igraph_t g;
+  igraph_vector_t current, membership, csize, membership2, csize2;
+  igraph_integer_t no, no2, size;
+  igraph_bool_t same;
+  long int i, u, v;
+
+  igraph_vector_init(&current, 0);
+  for (i=0; i<igraph_vector_bool_size(alive); i++) {
+    if (VECTOR(*alive)[i]) {
+      igraph_vector_push_back(&current, VECTOR(*edges)[2*i]);
+      igraph_vector_push_back(&current, VECTOR(*edges)[2*i+1]);
+    }
+  }
+  igraph_create(&g, &current, (igraph_integer_t) no_of_nodes, IGRAPH_DIRECTED);
+
+  igraph_vector_init(&membership, 0);
+  igraph_vector_init(&csize, 0);
+  igraph_vector_init(&membership2, 0);
+  igraph_vector_init(&csize2, 0);
+  igraph_clusters(&g, &membership, &csize, &no, IGRAPH_WEAK);
+
+  /* Queries first, these may rebuild the index */
+  for (i=0; i<100; i++) {
+    u=igraph_rng_get_integer(igraph_rng_default(), 0, no_of_nodes-1);
+    v=igraph_rng_get_integer(igraph_rng_default(), 0, no_of_nodes-1);
+    igraph_connectivity_index_same_component(index, &same, u, v);
+    if (same != (VECTOR(membership)[u] == VECTOR(membership)[v])) {
+      return 1;
+    }
+    igraph_connectivity_index_component_size(index, &size, u);
+    if (size != VECTOR(csize)[(long int) VECTOR(membership)[u]]) {
+      return 2;
+    }
+  }
+  igraph_connectivity_index_count(index, &no2);
+  if (no != no2) {
+    return 3;
+  }
+  igraph_connectivity_index_membership(index, &membership2, &csize2, &no2);
+  if (no != no2 || !igraph_vector_all_e(&membership, &membership2) ||
+      !igraph_vector_all_e(&csize, &csize2)) {
+    return 4;
+  }
+
+  igraph_vector_destroy(&csize2);
+  igraph_vector_destroy(&membership2);
+  igraph_vector_destroy(&csize);
+  igraph_vector_destroy(&membership);
+  igraph_vector_destroy(&current);
+  igraph_destroy(&g);
+  return 0;
+}
+
+int main() {
+  igraph_t g;
+  igraph_connectivity_index_t index;
+  igraph_vector_t edges, batch, eids, new_eids;
+  igraph_vector_bool_t alive;
+  long int i, j, e, no_of_nodes=200;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, no_of_nodes, 150,
+			  IGRAPH_DIRECTED, IGRAPH_LOOPS);
+  igraph_connectivity_index_init(&g, &index);
+  igraph_vector_init(&edges, 0);
+  igraph_get_edgelist(&g, &edges, 0);
+  igraph_vector_bool_init(&alive, igraph_ecount(&g));
+  igraph_vector_bool_fill(&alive, 1);
+  igraph_destroy(&g);
+
+  if ((ret=check(&index, &edges, &alive, no_of_nodes))) {
+    return ret;
+  }
+
+  igraph_vector_init(&batch, 0);
+  igraph_vector_init(&eids, 0);
+  igraph_vector_init(&new_eids, 0);
+  for (i=0; i<30; i++) {
+    /* Insertions, these reuse the ids of deleted edges */
+    igraph_vector_clear(&batch);
+    for (j=0; j<5; j++) {
+      igraph_vector_push_back(&batch, igraph_rng_get_integer(
+			      igraph_rng_default(), 0, no_of_nodes-1));
+      igraph_vector_push_back(&batch, igraph_rng_get_integer(
+			      igraph_rng_default(), 0, no_of_nodes-1));
+    }
+    igraph_connectivity_index_add_edges(&index, &batch, &new_eids);
+    for (j=0; j<5; j++) {
+      e=(long int) VECTOR(new_eids)[j];
+      if (e == igraph_vector_bool_size(&alive)) {
+	igraph_vector_bool_push_back(&alive, 0);
+	igraph_vector_push_back(&edges, 0);
+	igraph_vector_push_back(&edges, 0);
+      }
+      if (e >= igraph_vector_bool_size(&alive) || VECTOR(alive)[e]) {
+	return 22;
+      }
+      VECTOR(alive)[e] = 1;
+      VECTOR(edges)[2*e] = VECTOR(batch)[2*j];
+      VECTOR(edges)[2*e+1] = VECTOR(batch)[2*j+1];
+    }
+
+    /* Deletions of live edges */
+    igraph_vector_clear(&eids);
+    for (j=0; j<igraph_vector_bool_size(&alive); j++) {
+      if (VECTOR(alive)[j] &&
+	  igraph_rng_get_integer(igraph_rng_default(), 0, 19) == 0) {
+	igraph_vector_push_back(&eids, j);
+	VECTOR(alive)[j] = 0;
+      }
+    }
+    igraph_connectivity_index_delete_edges(&index, &eids);
+    if (i == 0 && igraph_vector_size(&eids) > 0) {
+      /* The last deleted id is reused first */
+      e=(long int) igraph_vector_tail(&eids);
+      igraph_vector_clear(&batch);
+      igraph_vector_push_back(&batch, 0);
+      igraph_vector_push_back(&batch, 1);
+      igraph_connectivity_index_add_edges(&index, &batch, &new_eids);
+      if (VECTOR(new_eids)[0] != e) { 
+	return 23; 
+      }
+      VECTOR(alive)[e] = 1;
+      VECTOR(edges)[2*e] = 0;
+      VECTOR(edges)[2*e+1] = 1;
+    }
+
+    /* Sometimes a new vertex */
+    if (i % 10 == 0) {
+      igraph_connectivity_index_add_vertices(&index, 2);
+      no_of_nodes += 2;
+    }
+
+    if ((ret=check(&index, &edges, &alive, no_of_nodes))) {
+      return 10 + ret;
+    }
+  }
+
+  /* Invalid updates */
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  if (igraph_connectivity_index_delete_edges(&index, &eids) != IGRAPH_EINVAL) {
+    return 20;
+  }
+  igraph_vector_clear(&batch);
+  igraph_vector_push_back(&batch, 0);
+  igraph_vector_push_back(&batch, no_of_nodes);
+  if (igraph_connectivity_index_add_edges(&index, &batch, 0) != IGRAPH_EINVVID) {
+    return 21;
+  }
+  igraph_connectivity_index_destroy(&index);
+
+  /* Deleting and re-adding an edge, with queries in between, must
+     not leave ever more dirty set entries behind */
+  igraph_empty(&g, 100, IGRAPH_UNDIRECTED);
+  igraph_add_edge(&g, 0, 1);
+  igraph_connectivity_index_init(&g, &index);
+  igraph_destroy(&g);
+  igraph_vector_clear(&batch);
+  igraph_vector_push_back(&batch, 0);
+  igraph_vector_push_back(&batch, 1);
+  igraph_vector_clear(&eids);
+  igraph_vector_push_back(&eids, 0);
+  for (i=0; i<1000; i++) {
+    igraph_bool_t res;
+    igraph_connectivity_index_delete_edges(&index, &eids);
+    igraph_connectivity_index_same_component(&index, &res, 0, 1);
+    if (res) {
+      return 24;
+    }
+    igraph_connectivity_index_add_edges(&index, &batch, &eids);
+  }
+  if (igraph_vector_int_size(&index.dirty_roots) > 100) {
+    return 25;
+  }
+
+  igraph_vector_destroy(&new_eids);
+  igraph_vector_destroy(&eids);
+  igraph_vector_destroy(&batch);
+  igraph_vector_bool_destroy(&alive);
+  igraph_vector_destroy(&edges);
+  igraph_connectivity_index_destroy(&index);
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+int check(const igraph_t *graph, igraph_neimode_t mode) {
+  igraph_csr_t csr;
+  igraph_adjlist_t adjlist;
+  igraph_inclist_t inclist;
+  long int i, j, n=igraph_vcount(graph);
+
+  igraph_csr_init(graph, &csr, mode);
+  igraph_adjlist_init(graph, &adjlist, mode);
+  igraph_inclist_init(graph, &inclist, mode);
+  
+  if (igraph_csr_size(&csr) != n) { return 1; }
+  for (i=0; i<n; i++) {
+    igraph_vector_int_t *neis=igraph_adjlist_get(&adjlist, i);
+    igraph_vector_int_t *edges=igraph_inclist_get(&inclist, i);
+    int *cneis=igraph_csr_neighbors(&csr, i);
+    int *cedges=igraph_csr_incident(&csr, i);
+    long int deg=igraph_csr_degree(&csr, i);
+    if (deg != igraph_vector_int_size(neis)) { return 2; }
+    if (deg != igraph_vector_int_size(edges)) { return 3; }
+    for (j=0; j<deg; j++) {
+      if (cneis[j] != VECTOR(*neis)[j]) { return 4; }
+      if (IGRAPH_OTHER(graph, cedges[j], i) != cneis[j]) { return 5; }
+    }
+  }
+
+  igraph_inclist_destroy(&inclist);
+  igraph_adjlist_destroy(&adjlist);
+  igraph_csr_destroy(&csr);
+  return 0;
+}
+
+int main() {
+
+  igraph_t g;
+  int ret;
+
+  /* Directed, with multiple and loop edges */
+  igraph_small(&g, 6, IGRAPH_DIRECTED, 
+	       0,1, 1,2, 2,0, 1,0, 0,1, 3,3, 3,4, 4,3, 5,2, 2,2, 2,5,
+	       -1);
+  if ((ret=check(&g, IGRAPH_OUT))) { return ret; }
+  if ((ret=check(&g, IGRAPH_IN))) { return 10+ret; }
+  if ((ret=check(&g, IGRAPH_ALL))) { return 20+ret; }
+  igraph_destroy(&g);
+
+  /* Undirected */
+  igraph_small(&g, 6, IGRAPH_UNDIRECTED, 
+	       0,1, 1,2, 2,0, 1,0, 0,1, 3,3, 3,4, 4,3, 5,2, 2,2, 2,5,
+	       -1);
+  if ((ret=check(&g, IGRAPH_OUT))) { return 30+ret; }
+  if ((ret=check(&g, IGRAPH_ALL))) { return 40+ret; }
+  igraph_destroy(&g);
+
+  /* Random graph */
+  igraph_rng_seed(igraph_rng_default(), 42);
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 500, 
+			  IGRAPH_DIRECTED, IGRAPH_LOOPS);
+  if ((ret=check(&g, IGRAPH_ALL))) { return 50+ret; }
+  igraph_destroy(&g);
+
+  /* An empty graph */
+  igraph_empty(&g, 0, IGRAPH_DIRECTED);
+  if ((ret=check(&g, IGRAPH_ALL))) { return 60+ret; }
+  igraph_destroy(&g);
+
+  /* Invalid mode */
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  igraph_empty(&g, 3, IGRAPH_DIRECTED);
+  {
+    igraph_csr_t csr;
+    if (igraph_csr_init(&g, &csr, (igraph_neimode_t) 42) != 
+	IGRAPH_EINVMODE) { return 70; }
+  }
+  igraph_destroy(&g);
+
+  return 0;
+}
@@ -0,0 +1,126 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2014  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* Deleting edges and vertices filters the existing indices, instead
+   of rebuilding them. The result must be exactly the same as creating
+   the smaller graph from scratch, including the order of the incident
+   edges. */
+
+int check_same(const igraph_t *g1, const igraph_t *g2) {
+  igraph_vector_t v1, v2;
+  igraph_neimode_t modes[3] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+  long int i, m, n=igraph_vcount(g1);
+
+  if (igraph_vcount(g1) != igraph_vcount(g2)) { return 1; }
+  if (igraph_ecount(g1) != igraph_ecount(g2)) { return 2; }
+
+  igraph_vector_init(&v1, 0);
+  igraph_vector_init(&v2, 0);
+  igraph_get_edgelist(g1, &v1, 0);
+  igraph_get_edgelist(g2, &v2, 0);
+  if (!igraph_vector_all_e(&v1, &v2)) { return 3; }
+  for (i=0; i<n; i++) {
+    for (m=0; m<3; m++) {
+      igraph_incident(g1, &v1, i, modes[m]);
+      igraph_incident(g2, &v2, i, modes[m]);
+      if (!igraph_vector_all_e(&v1, &v2)) { return 4; }
+    }
+  }
+  igraph_vector_destroy(&v1);
+  igraph_vector_destroy(&v2);
+
+  return 0;
+}
+
+int test(igraph_bool_t directed) {
+  igraph_t g1, g2;
+  igraph_vector_t edges, keep, del;
+  long int i, j, n=50, m=400, ret;
+
+  igraph_vector_init(&edges, 2*m);
+  for (i=0; i<2*m; i++) {
+    VECTOR(edges)[i] = RNG_INTEGER(0, n-1);
+  }
+  igraph_create(&g1, &edges, n, directed);
+
+  /* Delete random edges, some of them twice */
+  igraph_vector_init(&del, 0);
+  igraph_vector_init(&keep, 0);
+  for (i=0; i<m; i++) {
+    if (RNG_UNIF01() < 0.3) {
+      igraph_vector_push_back(&del, i);
+      if (RNG_UNIF01() < 0.1) { igraph_vector_push_back(&del, i); }
+    } else {
+      igraph_vector_push_back(&keep, VECTOR(edges)[2*i]);
+      igraph_vector_push_back(&keep, VECTOR(edges)[2*i+1]);
+    }
+  }
+  igraph_delete_edges(&g1, igraph_ess_vector(&del));
+  igraph_create(&g2, &keep, n, directed);
+  if ((ret=check_same(&g1, &g2))) { return ret; }
+  igraph_destroy(&g2);
+
+  /* Delete random vertices */
+  igraph_vector_clear(&del);
+  for (i=0; i<n; i++) {
+    if (RNG_UNIF01() < 0.2) { igraph_vector_push_back(&del, i); }
+  }
+  igraph_get_edgelist(&g1, &edges, 0);
+  igraph_vector_clear(&keep);
+  for (i=0; i<igraph_vector_size(&edges); i+=2) {
+    long int from=VECTOR(edges)[i], to=VECTOR(edges)[i+1];
+    long int df=0, dt=0;
+    if (igraph_vector_binsearch(&del, from, 0) ||
+	igraph_vector_binsearch(&del, to, 0)) { continue; }
+    for (j=0; j<igraph_vector_size(&del); j++) {
+      if (VECTOR(del)[j] < from) { df++; }
+      if (VECTOR(del)[j] < to) { dt++; }
+    }
+    igraph_vector_push_back(&keep, from-df);
+    igraph_vector_push_back(&keep, to-dt);
+  }
+  igraph_delete_vertices(&g1, igraph_vss_vector(&del));
+  igraph_create(&g2, &keep, n-igraph_vector_size(&del), directed);
+  ret=check_same(&g1, &g2);
+
+  igraph_vector_destroy(&keep);
+  igraph_vector_destroy(&del);
+  igraph_vector_destroy(&edges);
+  igraph_destroy(&g2);
+  igraph_destroy(&g1);
+
+  return ret;
+}
+
+int main() {
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  if ((ret=test(IGRAPH_DIRECTED))) { return ret; }
+  if ((ret=test(IGRAPH_UNDIRECTED))) { return 10+ret; }
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <stdio.h>
+
+/* Compares all distances from the index to igraph_shortest_paths() */
+
+int check(const igraph_t *g, const igraph_distance_index_t *index, 
+	  igraph_neimode_t mode) {
+  igraph_matrix_t dist;
+  long int i, j, n=igraph_vcount(g);
+  igraph_matrix_init(&dist, 0, 0);
+  igraph_shortest_paths(g, &dist, igraph_vss_all(), igraph_vss_all(), mode);
+  for (i=0; i<n; i++) {
+    for (j=0; j<n; j++) {
+      igraph_real_t d;
+      igraph_distance_index_query(index, &d, i, j);
+      if (d != MATRIX(dist, i, j)) {
+	return 1;
+      }
+    }
+  }
+  igraph_matrix_destroy(&dist);
+  return 0;
+}
+
+int main() {
+  igraph_t g;
+  igraph_distance_index_t index, index2;
+  igraph_vector_t from, to, res;
+  igraph_real_t d;
+  FILE *file;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  /* Undirected, not connected */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 320,
+			  IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+  igraph_distance_index_init(&g, &index, IGRAPH_DIRECTED);
+  if (check(&g, &index, IGRAPH_ALL)) {
+    return 1;
+  }
+  if (igraph_distance_index_size(&index) <= 0) {
+    return 2;
+  }
+
+  /* Write and read it back */
+  file=tmpfile();
+  igraph_distance_index_write(&index, file);
+  rewind(file);
+  igraph_distance_index_read(&index2, file);
+  fclose(file);
+  if (igraph_distance_index_size(&index2) != 
+      igraph_distance_index_size(&index) || check(&g, &index2, IGRAPH_ALL)) {
+    return 3;
+  }
+  igraph_distance_index_destroy(&index2);
+  igraph_distance_index_destroy(&index);
+  igraph_destroy(&g);
+
+  /* Directed, both ways */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 900,
+			  IGRAPH_DIRECTED, IGRAPH_LOOPS);
+  igraph_distance_index_init(&g, &index, IGRAPH_DIRECTED);
+  if (check(&g, &index, IGRAPH_OUT)) {
+    return 4;
+  }
+  file=tmpfile();
+  igraph_distance_index_write(&index, file);
+  rewind(file);
+  igraph_distance_index_read(&index2, file);
+  fclose(file);
+  if (check(&g, &index2, IGRAPH_OUT)) {
+    return 5;
+  }
+  igraph_distance_index_destroy(&index2);
+
+  /* Pairs */
+  igraph_vector_init_int(&from, 3, 0, 5, 7);
+  igraph_vector_init_int(&to, 3, 0, 9, 2);
+  igraph_vector_init(&res, 0);
+  igraph_distance_index_query_pairs(&index, &res, &from, &to);
+  igraph_distance_index_query(&index, &d, 5, 9);
+  if (igraph_vector_size(&res) != 3 || VECTOR(res)[0] != 0 || 
+      VECTOR(res)[1] != d) {
+    return 6;
+  }
+  igraph_distance_index_destroy(&index);
+
+  igraph_distance_index_init(&g, &index, IGRAPH_UNDIRECTED);
+  if (check(&g, &index, IGRAPH_ALL)) {
+    return 7;
+  }
+
+  /* Errors */
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  ret=igraph_distance_index_query(&index, &d, 0, 300);
+  if (ret != IGRAPH_EINVVID) {
+    return 8;
+  }
+  file=tmpfile();
+  fprintf(file, "igraph_distance_index 1\n2 0\n1 0 0\n1 3 1\n");
+  rewind(file);
+  ret=igraph_distance_index_read(&index2, file);
+  fclose(file);
+  if (ret != IGRAPH_PARSEERROR) {
+    return 9;
+  }
+  /* Distances cannot be longer than the number of vertices */
+  file=tmpfile();
+  fprintf(file, "igraph_distance_index 1\n2 0\n1 0 0\n1 0 2147483647\n");
+  rewind(file);
+  ret=igraph_distance_index_read(&index2, file);
+  fclose(file);
+  if (ret != IGRAPH_PARSEERROR) {
+    return 10;
+  }
+
+  igraph_vector_destroy(&res);
+  igraph_vector_destroy(&to);
+  igraph_vector_destroy(&from);
+  igraph_distance_index_destroy(&index);
+  igraph_destroy(&g);
+
+  return 0;
+}
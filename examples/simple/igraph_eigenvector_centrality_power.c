@@ -0,0 +1,146 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares the power iteration results to the ARPACK ones */
+
+int cmp(const igraph_vector_t *v1, const igraph_vector_t *v2,
+	igraph_real_t value1, igraph_real_t value2) {
+  long int i;
+  if (igraph_vector_size(v1) != igraph_vector_size(v2)) {
+    return 1;
+  }
+  for (i=0; i<igraph_vector_size(v1); i++) {
+    if (fabs(VECTOR(*v1)[i] - VECTOR(*v2)[i]) > 1e-6) {
+      return 1;
+    }
+  }
+  return fabs(value1 - value2) > 1e-6;
+}
+
+int main() {
+  igraph_t g, g2;
+  igraph_vector_t weights, arpack, power, prev;
+  igraph_real_t value_arpack, value_power;
+  igraph_arpack_options_t arpack_options;
+  igraph_eigenvector_power_options_t options = { 10000, 1e-10, 0, 0 };
+  igraph_integer_t cold;
+  long int i;
+
+  /* ARPACK warns about weighted directed graphs */
+  igraph_set_warning_handler(igraph_warning_handler_ignore);
+  igraph_rng_seed(igraph_rng_default(), 42);
+  igraph_arpack_options_init(&arpack_options);
+  igraph_vector_init(&arpack, 0);
+  igraph_vector_init(&power, 0);
+  igraph_vector_init(&prev, 0);
+
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 400,
+			  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+  igraph_vector_init(&weights, igraph_ecount(&g));
+  for (i=0; i<igraph_ecount(&g); i++) {
+    VECTOR(weights)[i] = igraph_rng_get_integer(igraph_rng_default(), 1, 5);
+  }
+
+  /* Eigenvector centrality, undirected and directed */
+  for (i=0; i<4; i++) {
+    igraph_bool_t directed = i / 2;
+    igraph_vector_t *w = i % 2 ? &weights : 0;
+    igraph_eigenvector_centrality(&g, &arpack, &value_arpack, directed,
+				  /*scale=*/ 1, w, &arpack_options);
+    igraph_eigenvector_centrality_power(&g, &power, &value_power, directed,
+					/*scale=*/ 1, w, 0, &options);
+    if (cmp(&arpack, &power, value_arpack, value_power)) {
+      return 1 + i;
+    }
+    if (options.residual > options.eps) {
+      return 5;
+    }
+  }
+
+  /* Hub and authority scores */
+  igraph_hub_score(&g, &arpack, &value_arpack, 1, &weights, &arpack_options);
+  igraph_hub_score_power(&g, &power, &value_power, 1, &weights, 0, &options);
+  if (cmp(&arpack, &power, value_arpack, value_power)) {
+    return 6;
+  }
+  igraph_authority_score(&g, &arpack, &value_arpack, 1, 0, &arpack_options);
+  /* With the default options */
+  igraph_authority_score_power(&g, &power, &value_power, 1, 0, 0, 0);
+  if (cmp(&arpack, &power, value_arpack, value_power)) {
+    return 7;
+  }
+
+  /* Warm start after a small change of the graph */
+  igraph_eigenvector_centrality_power(&g, &prev, 0, 0, 1, 0, 0, &options);
+  cold = options.iterations;
+  igraph_copy(&g2, &g);
+  igraph_add_edge(&g2, 0, 1);
+  igraph_eigenvector_centrality(&g2, &arpack, &value_arpack, 0, 1, 0,
+				&arpack_options);
+  igraph_eigenvector_centrality_power(&g2, &power, &value_power, 0, 1, 0,
+				      &prev, &options);
+  if (cmp(&arpack, &power, value_arpack, value_power)) {
+    return 8;
+  }
+  if (options.iterations >= cold) {
+    return 9;
+  }
+  /* The exact result converges immediately */
+  igraph_eigenvector_centrality_power(&g2, &power, &value_power, 0, 1, 0,
+				      &power, &options);
+  if (options.iterations > 1) {
+    return 10;
+  }
+  igraph_destroy(&g2);
+
+  /* Bipartite graph, the plain power iteration would oscillate here */
+  igraph_star(&g2, 10, IGRAPH_STAR_UNDIRECTED, 0);
+  igraph_eigenvector_centrality(&g2, &arpack, &value_arpack, 0, 1, 0,
+				&arpack_options);
+  igraph_eigenvector_centrality_power(&g2, &power, &value_power, 0, 1, 0,
+				      0, &options);
+  if (cmp(&arpack, &power, value_arpack, value_power)) {
+    return 11;
+  }
+  igraph_destroy(&g2);
+
+  /* A zero starting vector is an error */
+  igraph_vector_resize(&prev, igraph_vcount(&g));
+  igraph_vector_null(&prev);
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  if (igraph_eigenvector_centrality_power(&g, &power, 0, 0, 1, 0, &prev,
+					  &options) != IGRAPH_EINVAL) {
+    return 12;
+  }
+
+  igraph_vector_destroy(&weights);
+  igraph_vector_destroy(&prev);
+  igraph_vector_destroy(&power);
+  igraph_vector_destroy(&arpack);
+  igraph_destroy(&g);
+
+  return 0;
+}
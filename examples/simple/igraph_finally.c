@@ -0,0 +1,98 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard st, Cambridge MA, 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <stdio.h>
+
+int destroyed=0;
+
+void count_destroy(igraph_vector_t *v) {
+  igraph_vector_destroy(v);
+  destroyed++;
+}
+
+/* Registers one vector per recursion level, fails at the bottom */
+
+int recurse(int depth, int fail) {
+  igraph_vector_t v;
+  IGRAPH_VECTOR_INIT_FINALLY(&v, 1);
+  if (depth > 0) {
+    IGRAPH_CHECK(recurse(depth-1, fail));
+  } else if (fail) {
+    IGRAPH_ERROR("Bottom reached", IGRAPH_EINVAL);
+  }
+  igraph_vector_destroy(&v);
+  IGRAPH_FINALLY_CLEAN(1);
+  return 0;
+}
+
+int recurse_counted(int depth) {
+  igraph_vector_t *v=igraph_Calloc(1, igraph_vector_t);
+  int mark=IGRAPH_FINALLY_STACK_SIZE();
+  if (!v) { IGRAPH_ERROR("Out of memory", IGRAPH_ENOMEM); }
+  IGRAPH_FINALLY(igraph_free, v);
+  IGRAPH_CHECK(igraph_vector_init(v, 0));
+  IGRAPH_FINALLY(count_destroy, v);
+  if (depth > 0) {
+    IGRAPH_CHECK(recurse_counted(depth-1));
+  } else {
+    IGRAPH_ERROR("Bottom reached", IGRAPH_EINVAL);
+  }
+  IGRAPH_FINALLY_RESTORE(mark);
+  return 0;
+}
+
+int main() {
+  int ret;
+
+  igraph_set_error_handler(igraph_error_handler_ignore);
+
+  /* Success, the stack grows and shrinks back */
+  ret=recurse(5000, 0);
+  printf("%d %d\n", ret, IGRAPH_FINALLY_STACK_SIZE());
+
+  /* Failure, everything is freed */
+  ret=recurse(5000, 1);
+  printf("%d %d\n", ret, IGRAPH_FINALLY_STACK_SIZE());
+
+  /* Failure again, with two objects per level */
+  ret=recurse_counted(1000);
+  printf("%d %d %d\n", ret, IGRAPH_FINALLY_STACK_SIZE(), destroyed);
+
+  /* Restoring a marker only unregisters the objects */
+  { 
+    igraph_vector_t v1, v2;
+    int mark=IGRAPH_FINALLY_STACK_SIZE();
+    igraph_vector_init(&v1, 0);
+    IGRAPH_FINALLY(igraph_vector_destroy, &v1);
+    igraph_vector_init(&v2, 0);
+    IGRAPH_FINALLY(igraph_vector_destroy, &v2);
+    printf("%d\n", IGRAPH_FINALLY_STACK_SIZE() - mark);
+    IGRAPH_FINALLY_RESTORE(mark);
+    printf("%d\n", IGRAPH_FINALLY_STACK_SIZE() - mark);
+    igraph_vector_destroy(&v1);
+    igraph_vector_destroy(&v2);
+  }
+
+  return 0;
+}
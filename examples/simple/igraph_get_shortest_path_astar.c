@@ -0,0 +1,223 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Coordinates of the vertices, the heuristic is the straight-line
+   distance to the target */
+
+typedef struct {
+  const igraph_matrix_t *coords;
+  long int calls;
+} astar_data_t;
+
+int euclidean(igraph_real_t *result, igraph_integer_t from, 
+	      igraph_integer_t to, void *extra) {
+  astar_data_t *data=extra;
+  igraph_real_t dx=MATRIX(*data->coords, from, 0) - MATRIX(*data->coords, to, 0);
+  igraph_real_t dy=MATRIX(*data->coords, from, 1) - MATRIX(*data->coords, to, 1);
+  *result=sqrt(dx*dx + dy*dy);
+  data->calls++;
+  return 0;
+}
+
+int failing(igraph_real_t *result, igraph_integer_t from, 
+	    igraph_integer_t to, void *extra) {
+  return IGRAPH_EINVAL;
+}
+
+/* Checks that 'vertices' and 'edges' is a path from 'from' to 'to',
+   and returns its length */
+
+igraph_real_t path_length(const igraph_t *g, const igraph_vector_t *weights,
+			  const igraph_vector_t *vertices, 
+			  const igraph_vector_t *edges,
+			  long int from, long int to, igraph_neimode_t mode) {
+  long int i, l=igraph_vector_size(edges);
+  igraph_real_t len=0.0;
+  if (igraph_vector_size(vertices) != l+1) { return -1; }
+  if (VECTOR(*vertices)[0] != from || VECTOR(*vertices)[l] != to) {
+    return -1;
+  }
+  for (i=0; i<l; i++) {
+    long int e=(long int) VECTOR(*edges)[i];
+    long int a=(long int) VECTOR(*vertices)[i];
+    long int b=(long int) VECTOR(*vertices)[i+1];
+    long int f=IGRAPH_FROM(g, e), t=IGRAPH_TO(g, e);
+    if (mode == IGRAPH_OUT && (f != a || t != b)) { return -1; }
+    if (mode == IGRAPH_IN && (f != b || t != a)) { return -1; }
+    if (mode == IGRAPH_ALL && !((f == a && t == b) || (f == b && t == a))) {
+      return -1;
+    }
+    len += weights ? VECTOR(*weights)[e] : 1;
+  }
+  return len;
+}
+
+int main() {
+  igraph_t g;
+  igraph_vector_t dims, weights, vertices, edges;
+  igraph_matrix_t coords, dist;
+  igraph_neimode_t modes[]={ IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+  astar_data_t data;
+  long int i, m, n, k;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 7);
+  igraph_vector_init(&vertices, 0);
+  igraph_vector_init(&edges, 0);
+  igraph_matrix_init(&dist, 0, 0);
+
+  /* A 40x40 grid, with weights not shorter than the edges */
+  igraph_vector_init_int(&dims, 2, 40, 40);
+  igraph_lattice(&g, &dims, 1, IGRAPH_UNDIRECTED, 0, 0);
+  n=igraph_vcount(&g);
+  m=igraph_ecount(&g);
+  igraph_matrix_init(&coords, n, 2);
+  for (i=0; i<n; i++) {
+    MATRIX(coords, i, 0)=i % 40;
+    MATRIX(coords, i, 1)=i / 40;
+  }
+  igraph_vector_init(&weights, m);
+  for (i=0; i<m; i++) {
+    VECTOR(weights)[i]=1 + RNG_INTEGER(0, 3);
+  }
+  data.coords=&coords;
+
+  for (k=0; k<20; k++) {
+    long int from=RNG_INTEGER(0, n-1), to=RNG_INTEGER(0, n-1);
+    igraph_real_t d;
+    igraph_shortest_paths_dijkstra(&g, &dist, igraph_vss_1(from), 
+				   igraph_vss_1(to), &weights, IGRAPH_OUT);
+    d=MATRIX(dist, 0, 0);
+
+    data.calls=0;
+    igraph_get_shortest_path_astar(&g, &vertices, &edges, from, to,
+				   &weights, IGRAPH_OUT, euclidean, &data);
+    if (path_length(&g, &weights, &vertices, &edges, from, to, 
+		    IGRAPH_ALL) != d) {
+      return 1;
+    }
+    if (data.calls > n) {
+      return 2;
+    }
+    igraph_get_shortest_path_astar(&g, &vertices, &edges, from, to,
+				   &weights, IGRAPH_OUT, 0, 0);
+    if (path_length(&g, &weights, &vertices, &edges, from, to, 
+		    IGRAPH_ALL) != d) {
+      return 3;
+    }
+    igraph_get_shortest_path_bidirectional(&g, &vertices, &edges, from, to,
+					   &weights, IGRAPH_OUT);
+    if (path_length(&g, &weights, &vertices, &edges, from, to, 
+		    IGRAPH_ALL) != d) {
+      return 4;
+    }
+  }
+
+  /* Close vertices, the heuristic leads the search straight there */
+  data.calls=0;
+  igraph_get_shortest_path_astar(&g, &vertices, &edges, 0, 5, 
+				 0, IGRAPH_ALL, euclidean, &data);
+  if (igraph_vector_size(&edges) != 5 || data.calls > 100) {
+    return 5;
+  }
+
+  /* Errors of the heuristic are passed on */
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  ret=igraph_get_shortest_path_astar(&g, &vertices, &edges, 0, 5, 
+				     0, IGRAPH_ALL, failing, 0);
+  if (ret != IGRAPH_EINVAL) {
+    return 6;
+  }
+  igraph_set_error_handler(igraph_error_handler_abort);
+
+  igraph_vector_destroy(&weights);
+  igraph_matrix_destroy(&coords);
+  igraph_vector_destroy(&dims);
+  igraph_destroy(&g);
+
+  /* A sparse directed graph, all directions, weighted and unweighted */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 600,
+			  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+  n=igraph_vcount(&g);
+  m=igraph_ecount(&g);
+  igraph_vector_init(&weights, m);
+  for (i=0; i<m; i++) {
+    VECTOR(weights)[i]=RNG_UNIF(0, 10);
+  }
+  igraph_set_warning_handler(igraph_warning_handler_ignore);
+  for (k=0; k<60; k++) {
+    long int from=RNG_INTEGER(0, n-1), to=RNG_INTEGER(0, n-1);
+    igraph_neimode_t mode=modes[k % 3];
+    igraph_vector_t *w= k % 2 ? &weights : 0;
+    igraph_real_t d, len;
+    igraph_shortest_paths_dijkstra(&g, &dist, igraph_vss_1(from), 
+				   igraph_vss_1(to), w, mode);
+    d=MATRIX(dist, 0, 0);
+
+    igraph_get_shortest_path_bidirectional(&g, &vertices, &edges, from, to,
+					   w, mode);
+    if (!IGRAPH_FINITE(d)) {
+      if (igraph_vector_size(&vertices) != 0 || 
+	  igraph_vector_size(&edges) != 0) {
+	return 7;
+      }
+    } else {
+      len=path_length(&g, w, &vertices, &edges, from, to, mode);
+      if (fabs(len - d) > 1e-10) {
+	return 8;
+      }
+    }
+
+    igraph_get_shortest_path_astar(&g, &vertices, &edges, from, to,
+				   w, mode, 0, 0);
+    if (!IGRAPH_FINITE(d)) {
+      if (igraph_vector_size(&vertices) != 0) {
+	return 9;
+      }
+    } else {
+      len=path_length(&g, w, &vertices, &edges, from, to, mode);
+      if (fabs(len - d) > 1e-10) {
+	return 10;
+      }
+    }
+  }
+
+  /* From a vertex to itself */
+  igraph_get_shortest_path_bidirectional(&g, &vertices, &edges, 3, 3,
+					 &weights, IGRAPH_OUT);
+  if (igraph_vector_size(&vertices) != 1 || VECTOR(vertices)[0] != 3 ||
+      igraph_vector_size(&edges) != 0) {
+    return 11;
+  }
+
+  igraph_vector_destroy(&weights);
+  igraph_destroy(&g);
+  igraph_matrix_destroy(&dist);
+  igraph_vector_destroy(&edges);
+  igraph_vector_destroy(&vertices);
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares every column of the blocked power iteration to a separate
+   personalized PageRank calculation with ARPACK. */
+
+int check(const igraph_t *graph, igraph_bool_t directed,
+	  const igraph_vector_t *seeds, const igraph_vector_t *weights) {
+  igraph_matrix_t res;
+  igraph_vector_t pr;
+  igraph_arpack_options_t arpack_options;
+  igraph_pagerank_power_options_t options = { 10000, 1e-13 };
+  long int i, j, n=igraph_vcount(graph);
+
+  igraph_arpack_options_init(&arpack_options);
+  igraph_matrix_init(&res, 0, 0);
+  igraph_vector_init(&pr, 0);
+
+  if (igraph_personalized_pagerank_multi_vs(graph, &res, directed, 0.85,
+					    igraph_vss_vector(seeds),
+					    weights, &options)) {
+    return 1;
+  }
+  if (igraph_matrix_nrow(&res) != n ||
+      igraph_matrix_ncol(&res) != igraph_vector_size(seeds)) {
+    return 2;
+  }
+
+  for (j=0; j<igraph_vector_size(seeds); j++) {
+    igraph_personalized_pagerank_vs(graph, IGRAPH_PAGERANK_ALGO_ARPACK,
+				    &pr, 0, igraph_vss_all(), directed, 0.85,
+				    igraph_vss_1(VECTOR(*seeds)[j]), weights,
+				    &arpack_options);
+    for (i=0; i<n; i++) {
+      if (fabs(VECTOR(pr)[i] - MATRIX(res, i, j)) > 1e-8) {
+	printf("seed %li, vertex %li: %g != %g\n", (long int) VECTOR(*seeds)[j],
+	       i, MATRIX(res, i, j), VECTOR(pr)[i]);
+	return 3;
+      }
+    }
+  }
+
+  igraph_vector_destroy(&pr);
+  igraph_matrix_destroy(&res);
+  return 0;
+}
+
+int main() {
+  igraph_t g;
+  igraph_vector_t seeds, weights;
+  igraph_matrix_t reset, res;
+  long int i, n=200;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  /* Sparse random graph with many dangling vertices */
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, n, 300,
+			  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+  igraph_vector_init(&weights, igraph_ecount(&g));
+  for (i=0; i<igraph_ecount(&g); i++) {
+    VECTOR(weights)[i] = igraph_rng_get_integer(igraph_rng_default(), 1, 5);
+  }
+  /* More seeds than a single block */
+  igraph_vector_init(&seeds, 37);
+  for (i=0; i<37; i++) {
+    VECTOR(seeds)[i] = (i * 7) % n;
+  }
+
+  if ((ret=check(&g, 1, &seeds, 0))) { return ret; }
+  if ((ret=check(&g, 1, &seeds, &weights))) { return 10+ret; }
+  if ((ret=check(&g, 0, &seeds, 0))) { return 20+ret; }
+  if ((ret=check(&g, 0, &seeds, &weights))) { return 30+ret; }
+
+  /* A general reset matrix: the uniform column gives PageRank */
+  igraph_matrix_init(&reset, n, 2);
+  igraph_matrix_init(&res, 0, 0);
+  for (i=0; i<n; i++) {
+    MATRIX(reset, i, 0) = 3.0;
+    MATRIX(reset, i, 1) = i % 2;
+  }
+  if (igraph_personalized_pagerank_multi(&g, &res, 1, 0.85, &reset, 0, 0)) {
+    return 41;
+  }
+  {
+    igraph_vector_t pr;
+    igraph_arpack_options_t arpack_options;
+    igraph_arpack_options_init(&arpack_options);
+    igraph_vector_init(&pr, 0);
+    igraph_pagerank(&g, IGRAPH_PAGERANK_ALGO_ARPACK, &pr, 0, igraph_vss_all(),
+		    1, 0.85, 0, &arpack_options);
+    for (i=0; i<n; i++) {
+      if (fabs(VECTOR(pr)[i] - MATRIX(res, i, 0)) > 1e-8) { return 42; }
+    }
+    igraph_vector_destroy(&pr);
+  }
+
+  /* A column summing to zero is an error */
+  igraph_matrix_null(&reset);
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  if (igraph_personalized_pagerank_multi(&g, &res, 1, 0.85, &reset, 0, 0) !=
+      IGRAPH_EINVAL) {
+    return 43;
+  }
+
+  igraph_matrix_destroy(&res);
+  igraph_matrix_destroy(&reset);
+  igraph_vector_destroy(&seeds);
+  igraph_vector_destroy(&weights);
+  igraph_destroy(&g);
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares the push approximation to the exact personalized PageRank */
+
+int check(const igraph_t *graph, igraph_bool_t directed, igraph_vs_t seeds,
+	  const igraph_vector_t *weights, igraph_real_t epsilon) {
+  igraph_vector_t vids, scores, exact, est, str;
+  igraph_arpack_options_t options;
+  long int i, n=igraph_vcount(graph);
+  igraph_real_t l1=0.0;
+
+  igraph_arpack_options_init(&options);
+  igraph_vector_init(&vids, 0);
+  igraph_vector_init(&scores, 0);
+  igraph_vector_init(&exact, 0);
+  igraph_vector_init(&est, n);
+  igraph_vector_init(&str, 0);
+
+  if (igraph_personalized_pagerank_push(graph, &vids, &scores, seeds,
+					directed, 0.85, weights, epsilon)) {
+    return 1;
+  }
+  igraph_personalized_pagerank_vs(graph, IGRAPH_PAGERANK_ALGO_ARPACK, &exact,
+				  0, igraph_vss_all(), directed, 0.85, seeds,
+				  weights, &options);
+  igraph_strength(graph, &str, igraph_vss_all(),
+		  directed ? IGRAPH_OUT : IGRAPH_ALL, IGRAPH_LOOPS, weights);
+
+  if (igraph_vector_size(&vids) != igraph_vector_size(&scores)) {
+    return 2;
+  }
+  for (i=0; i<igraph_vector_size(&vids); i++) {
+    if (i > 0 && VECTOR(scores)[i] > VECTOR(scores)[i-1]) {
+      return 3;
+    }
+    VECTOR(est)[(long int) VECTOR(vids)[i]] = VECTOR(scores)[i];
+  }
+
+  for (i=0; i<n; i++) {
+    igraph_real_t err=VECTOR(exact)[i] - VECTOR(est)[i];
+    if (err < -1e-9) {
+      return 4;
+    }
+    if (!directed && err > epsilon * VECTOR(str)[i] + 1e-9) {
+      return 5;
+    }
+    l1 += err;
+  }
+  if (l1 > 0.05) {
+    return 6;
+  }
+
+  igraph_vector_destroy(&str);
+  igraph_vector_destroy(&est);
+  igraph_vector_destroy(&exact);
+  igraph_vector_destroy(&scores);
+  igraph_vector_destroy(&vids);
+  return 0;
+}
+
+int main() {
+  igraph_t g;
+  igraph_vector_t weights, seeds, vids, scores;
+  long int i;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 600,
+			  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+  igraph_vector_init(&weights, igraph_ecount(&g));
+  for (i=0; i<igraph_ecount(&g); i++) {
+    VECTOR(weights)[i] = igraph_rng_get_integer(igraph_rng_default(), 1, 5);
+  }
+  igraph_vector_init(&seeds, 3);
+  VECTOR(seeds)[0] = 3; VECTOR(seeds)[1] = 17; VECTOR(seeds)[2] = 17;
+
+  if ((ret=check(&g, 1, igraph_vss_1(5), 0, 1e-5))) { return ret; }
+  if ((ret=check(&g, 1, igraph_vss_vector(&seeds), &weights, 1e-5))) {
+    return 10+ret;
+  }
+  if ((ret=check(&g, 0, igraph_vss_1(5), 0, 1e-5))) { return 20+ret; }
+  if ((ret=check(&g, 0, igraph_vss_vector(&seeds), &weights, 1e-5))) {
+    return 30+ret;
+  }
+
+  /* With a threshold of one over the degree of the seed, only the
+     seed itself is pushed */
+  igraph_vector_init(&vids, 0);
+  igraph_vector_init(&scores, 0);
+  igraph_degree(&g, &vids, igraph_vss_1(5), IGRAPH_ALL, IGRAPH_LOOPS);
+  igraph_personalized_pagerank_push(&g, &vids, &scores, igraph_vss_1(5),
+				    0, 0.85, 0, 1.0 / VECTOR(vids)[0]);
+  if (igraph_vector_size(&vids) != 1 || VECTOR(vids)[0] != 5 ||
+      fabs(VECTOR(scores)[0] - 0.15) > 1e-12) {
+    return 41;
+  }
+
+  /* Invalid arguments */
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  if (igraph_personalized_pagerank_push(&g, &vids, &scores, igraph_vss_none(),
+					0, 0.85, 0, 1e-4) != IGRAPH_EINVVID) {
+    return 42;
+  }
+  if (igraph_personalized_pagerank_push(&g, &vids, &scores, igraph_vss_1(5),
+					0, 0.85, 0, 0) != IGRAPH_EINVAL) {
+    return 43;
+  }
+
+  igraph_vector_destroy(&scores);
+  igraph_vector_destroy(&vids);
+  igraph_vector_destroy(&seeds);
+  igraph_vector_destroy(&weights);
+  igraph_destroy(&g);
+
+  return 0;
+}
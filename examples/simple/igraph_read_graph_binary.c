@@ -0,0 +1,202 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2013  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <stdio.h>
+
+int same_graph(const igraph_t *g1, const igraph_t *g2) {
+  igraph_vector_t e1, e2, n1, n2;
+  long int i, n=igraph_vcount(g1);
+  int ret=0;
+  
+  if (igraph_vcount(g2) != n || igraph_ecount(g1) != igraph_ecount(g2) || 
+      igraph_is_directed(g1) != igraph_is_directed(g2)) { return 1; }
+
+  igraph_vector_init(&e1, 0);
+  igraph_vector_init(&e2, 0);
+  igraph_vector_init(&n1, 0);
+  igraph_vector_init(&n2, 0);
+  igraph_get_edgelist(g1, &e1, 0);
+  igraph_get_edgelist(g2, &e2, 0);
+  if (!igraph_vector_all_e(&e1, &e2)) { ret=2; }
+  for (i=0; i<n && !ret; i++) {
+    igraph_incident(g1, &n1, i, IGRAPH_ALL);
+    igraph_incident(g2, &n2, i, IGRAPH_ALL);
+    if (!igraph_vector_all_e(&n1, &n2)) { ret=3; }
+  }
+  igraph_vector_destroy(&n2);
+  igraph_vector_destroy(&n1);
+  igraph_vector_destroy(&e2);
+  igraph_vector_destroy(&e1);
+  return ret;
+}
+
+int main() {
+
+  igraph_t g, g2;
+  igraph_vector_t values;
+  FILE *file;
+  int ret;
+  long int i;
+
+  igraph_i_set_attribute_table(&igraph_cattribute_table);
+
+  /* Directed graph with attributes */
+  igraph_rng_seed(igraph_rng_default(), 42);
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 300, 
+			  IGRAPH_DIRECTED, IGRAPH_LOOPS);
+  igraph_vector_init_seq(&values, 1, 100);
+  SETVANV(&g, "weight", &values);
+  igraph_vector_resize(&values, 300);
+  for (i=0; i<300; i++) { VECTOR(values)[i] = i / 3.0; }
+  SETEANV(&g, "weight", &values);
+  SETEANV(&g, "capacity", &values);
+  SETGAN(&g, "answer", 42);
+  SETGAS(&g, "name", "ignored");
+  igraph_vector_destroy(&values);
+
+  file=tmpfile();
+  igraph_set_warning_handler(igraph_warning_handler_ignore);
+  igraph_write_graph_binary(&g, file);
+  rewind(file);
+  igraph_read_graph_binary(&g2, file);
+  fclose(file);
+
+  if ((ret=same_graph(&g, &g2))) { return ret; }
+  if (GAN(&g2, "answer") != 42) { return 4; }
+  if (igraph_cattribute_has_attr(&g2, IGRAPH_ATTRIBUTE_GRAPH, "name")) {
+    return 5;
+  }
+  for (i=0; i<100; i++) {
+    if (VAN(&g2, "weight", i) != i+1) { return 6; }
+  }
+  for (i=0; i<300; i++) {
+    if (EAN(&g2, "weight", i) != i / 3.0) { return 7; }
+    if (EAN(&g2, "capacity", i) != i / 3.0) { return 8; }
+  }
+  igraph_destroy(&g2);
+  igraph_destroy(&g);
+
+  /* Undirected graph, and the graph still works after reading */
+  igraph_ring(&g, 10, IGRAPH_UNDIRECTED, 0, 1);
+  igraph_add_edge(&g, 3, 3);
+  igraph_add_edge(&g, 2, 7);
+  file=tmpfile();
+  igraph_write_graph_binary(&g, file);
+  rewind(file);
+  igraph_read_graph_binary(&g2, file);
+  fclose(file);
+  if ((ret=same_graph(&g, &g2))) { return 10+ret; }
+  igraph_add_edge(&g, 1, 8);
+  igraph_add_edge(&g2, 1, 8);
+  igraph_delete_vertices(&g, igraph_vss_1(5));
+  igraph_delete_vertices(&g2, igraph_vss_1(5));
+  if ((ret=same_graph(&g, &g2))) { return 20+ret; }
+  igraph_destroy(&g2);
+  igraph_destroy(&g);
+
+  /* Empty graph */
+  igraph_empty(&g, 0, IGRAPH_DIRECTED);
+  file=tmpfile();
+  igraph_write_graph_binary(&g, file);
+  rewind(file);
+  igraph_read_graph_binary(&g2, file);
+  fclose(file);
+  if ((ret=same_graph(&g, &g2))) { return 30+ret; }
+  igraph_destroy(&g2);
+  igraph_destroy(&g);
+
+  /* Errors: not a binary file, truncated and corrupt files */
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  file=tmpfile();
+  fprintf(file, "0 1\n1 2\n");
+  rewind(file);
+  if (igraph_read_graph_binary(&g2, file) != IGRAPH_PARSEERROR) { return 40; }
+  fclose(file);
+
+  igraph_ring(&g, 10, IGRAPH_DIRECTED, 0, 1);
+  file=tmpfile();
+  igraph_write_graph_binary(&g, file);
+  {
+    char buf[1000];
+    size_t len;
+    FILE *file2=tmpfile();
+    rewind(file);
+    len=fread(buf, 1, sizeof(buf), file);
+    fwrite(buf, 1, len-4, file2);
+    rewind(file2);
+    if (igraph_read_graph_binary(&g2, file2) != IGRAPH_PARSEERROR) { 
+      return 42; 
+    }
+    fclose(file2);
+  }
+  fclose(file);
+
+  file=tmpfile();
+  igraph_write_graph_binary(&g, file);
+  /* Swap two elements of the out-index */
+  fseek(file, -(long)(2*10+2*11)*(long)sizeof(int), SEEK_END);
+  {
+    int oi[2];
+    if (fread(oi, sizeof(int), 2, file) != 2) { return 41; }
+    fseek(file, -2*(long)sizeof(int), SEEK_CUR);
+    ret=oi[0]; oi[0]=oi[1]; oi[1]=ret;
+    fwrite(oi, sizeof(int), 2, file);
+  }
+  rewind(file);
+  if (igraph_read_graph_binary(&g2, file) != IGRAPH_PARSEERROR) { return 43; }
+  fclose(file);
+  igraph_destroy(&g);
+
+  /* All edges start at vertex 0, so an out-of-range start entry would
+     make the index check run past the end of the index */
+  igraph_star(&g, 10, IGRAPH_STAR_OUT, 0);
+  file=tmpfile();
+  igraph_write_graph_binary(&g, file);
+  /* Out-of-range entry in the out-start vector */
+  fseek(file, -(long)(2*11-1)*(long)sizeof(int), SEEK_END);
+  {
+    int os=1000;
+    fwrite(&os, sizeof(int), 1, file);
+  }
+  rewind(file);
+  if (igraph_read_graph_binary(&g2, file) != IGRAPH_PARSEERROR) { return 44; }
+  fclose(file);
+
+  file=tmpfile();
+  igraph_write_graph_binary(&g, file);
+  /* Decreasing entries in the in-start vector */
+  fseek(file, -(long)(11-5)*(long)sizeof(int), SEEK_END);
+  {
+    int is=1;
+    fwrite(&is, sizeof(int), 1, file);
+  }
+  rewind(file);
+  if (igraph_read_graph_binary(&g2, file) != IGRAPH_PARSEERROR) { return 45; }
+  fclose(file);
+  igraph_destroy(&g);
+
+  if (IGRAPH_FINALLY_STACK_SIZE() != 0) { return 50; }
+
+  return 0;
+}
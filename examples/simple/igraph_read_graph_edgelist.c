@@ -0,0 +1,89 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2013  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <stdio.h>
+
+int main() {
+
+  igraph_t g;
+  igraph_vector_t edges;
+  FILE *file;
+  long int i;
+
+  /* Whitespace, signs and the bases accepted by "%li" */
+  file=tmpfile();
+  fprintf(file, "  0 1\n1\t2\n\n2 0x3 +3 010\n   ");
+  rewind(file);
+  igraph_read_graph_edgelist(&g, file, 0, IGRAPH_DIRECTED);
+  fclose(file);
+  igraph_write_graph_edgelist(&g, stdout);
+  igraph_destroy(&g);
+
+  /* Empty file, the number of vertices is given */
+  file=tmpfile();
+  igraph_read_graph_edgelist(&g, file, 5, IGRAPH_UNDIRECTED);
+  fclose(file);
+  if (igraph_vcount(&g) != 5 || igraph_ecount(&g) != 0) { return 1; }
+  igraph_destroy(&g);
+
+  /* A file that is read in several blocks */
+  file=tmpfile();
+  for (i=0; i<100000; i++) {
+    fprintf(file, "%li %li\n", i, (i*7) % 100000);
+  }
+  rewind(file);
+  igraph_read_graph_edgelist(&g, file, 0, IGRAPH_DIRECTED);
+  fclose(file);
+  if (igraph_ecount(&g) != 100000) { return 2; }
+  igraph_vector_init(&edges, 0);
+  igraph_get_edgelist(&g, &edges, 0);
+  for (i=0; i<100000; i++) {
+    if (VECTOR(edges)[2*i] != i || VECTOR(edges)[2*i+1] != (i*7) % 100000) {
+      return 3;
+    }
+  }
+  igraph_vector_destroy(&edges);
+  igraph_destroy(&g);
+
+  /* Errors */
+  igraph_set_error_handler(igraph_error_handler_ignore);
+  file=tmpfile();
+  fprintf(file, "0 1\n1 2\n3\n");
+  rewind(file);
+  if (igraph_read_graph_edgelist(&g, file, 0, 1) != IGRAPH_PARSEERROR) {
+    return 4;
+  }
+  fclose(file);
+  file=tmpfile();
+  fprintf(file, "0 1\n1 x2\n");
+  rewind(file);
+  if (igraph_read_graph_edgelist(&g, file, 0, 1) != IGRAPH_PARSEERROR) {
+    return 5;
+  }
+  fclose(file);
+
+  if (!IGRAPH_FINALLY_STACK_EMPTY) { return 6; }
+
+  return 0;
+}
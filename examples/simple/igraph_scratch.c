@@ -0,0 +1,94 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include "igraph_memory_internal.h"
+
+int main() {
+  igraph_i_scratch_mark_t mark, mark2;
+  double *a, *b, *c;
+  char *big;
+  long int i;
+  igraph_t g;
+  igraph_vector_t res;
+
+  /* Allocation, zeroing and alignment */
+  igraph_i_scratch_mark(&mark);
+  a=igraph_i_scratch_Calloc(10, double);
+  b=igraph_i_scratch_Calloc(3, double);
+  if (!a || !b || b < a + 10) { return 1; }
+  if (((size_t) b) % sizeof(double) != 0) { return 2; }
+  for (i=0; i<10; i++) {
+    if (a[i] != 0) { return 3; }
+    a[i]=i;
+  }
+
+  /* Nested mark, spanning more than one chunk */
+  igraph_i_scratch_mark(&mark2);
+  big=igraph_i_scratch_Calloc(1000000, char);
+  if (!big) { return 4; }
+  big[999999]=1;
+  c=igraph_i_scratch_Calloc(1, double);
+  igraph_i_scratch_release(&mark2);
+  if (a[9] != 9) { return 5; }
+  c=igraph_i_scratch_Calloc(1, double);
+  if (c != b + 4 && c != b + 3) { return 6; }
+  igraph_i_scratch_release(&mark);
+
+  /* Released memory is reused */
+  igraph_i_scratch_mark(&mark);
+  a=igraph_i_scratch_Calloc(10, double);
+  a[9]=1;
+  igraph_i_scratch_release(&mark);
+  igraph_i_scratch_mark(&mark);
+  b=igraph_i_scratch_Calloc(10, double);
+  if (b != a || b[9] != 0) { return 7; }
+  igraph_i_scratch_release(&mark);
+
+  /* Releasing through the finally stack */
+  IGRAPH_I_SCRATCH_MARK_FINALLY(&mark);
+  b=igraph_i_scratch_Calloc(10, double);
+  if (IGRAPH_FINALLY_STACK_SIZE() != 1) { return 8; }
+  IGRAPH_FINALLY_FREE();
+  igraph_i_scratch_mark(&mark);
+  c=igraph_i_scratch_Calloc(10, double);
+  if (c != b) { return 9; }
+  igraph_i_scratch_release(&mark);
+
+  /* Algorithms using scratch memory, called many times */
+  igraph_vector_init(&res, 0);
+  for (i=0; i<1000; i++) {
+    igraph_ring(&g, 5 + i % 7, IGRAPH_UNDIRECTED, /*mutual=*/ 0, 
+		/*circular=*/ 1);
+    igraph_betweenness(&g, &res, igraph_vss_all(), IGRAPH_UNDIRECTED, 
+		       /*weights=*/ 0, /*nobigint=*/ 1);
+    if (i % 7 == 0 && VECTOR(res)[0] != 1) { return 10; }
+    igraph_closeness(&g, &res, igraph_vss_all(), IGRAPH_ALL, /*weights=*/ 0,
+		     /*normalized=*/ 0);
+    if (i % 7 == 0 && VECTOR(res)[0] != 1.0/6) { return 11; }
+    igraph_destroy(&g);
+  }
+  igraph_vector_destroy(&res);
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* The all-sources distance functions search from many vertices at
+   once. Check them against single-source searches, on a graph that
+   needs several batches and has unreachable pairs. */
+
+int check(const igraph_t *g, igraph_neimode_t mode) {
+  long int n=igraph_vcount(g), i, j;
+  igraph_matrix_t all, one;
+  igraph_vector_t ecc, clo, clo1;
+  igraph_real_t max=0, sum=0, pairs=0, apl;
+  igraph_integer_t diam, from, to;
+
+  igraph_matrix_init(&all, 0, 0);
+  igraph_matrix_init(&one, 0, 0);
+  igraph_vector_init(&ecc, 0);
+  igraph_vector_init(&clo, 0);
+  igraph_vector_init(&clo1, 0);
+
+  igraph_shortest_paths(g, &all, igraph_vss_all(), igraph_vss_all(), mode);
+  igraph_eccentricity(g, &ecc, igraph_vss_all(), mode);
+  igraph_closeness(g, &clo, igraph_vss_all(), mode, 0, 0);
+  for (i=0; i<n; i++) {
+    igraph_real_t e=0;
+    igraph_shortest_paths(g, &one, igraph_vss_1(i), igraph_vss_all(), mode);
+    igraph_closeness(g, &clo1, igraph_vss_1(i), mode, 0, 0);
+    for (j=0; j<n; j++) {
+      if (MATRIX(one, 0, j) != MATRIX(all, i, j)) { return 1; }
+      if (MATRIX(one, 0, j) != IGRAPH_INFINITY) {
+	if (MATRIX(one, 0, j) > e) { e=MATRIX(one, 0, j); }
+	if (i != j) { sum += MATRIX(one, 0, j); pairs++; }
+      }
+    }
+    if (VECTOR(ecc)[i] != e) { return 2; }
+    if (VECTOR(clo)[i] != VECTOR(clo1)[0]) { return 3; }
+    if (e > max) { max=e; }
+  }
+
+  if (mode != IGRAPH_IN) {
+    igraph_diameter(g, &diam, &from, &to, 0, mode==IGRAPH_OUT, 1);
+    if (diam != max) { return 4; }
+    if (MATRIX(all, from, to) != diam) { return 5; }
+    igraph_average_path_length(g, &apl, mode==IGRAPH_OUT, 1);
+    if (apl != sum/pairs) { return 6; }
+  }
+
+  /* Some sources and targets, in a different order */
+  igraph_shortest_paths(g, &one, igraph_vss_seq(n-1, n-1), 
+			igraph_vss_1(3), mode);
+  if (MATRIX(one, 0, 0) != MATRIX(all, n-1, 3)) { return 7; }
+
+  igraph_vector_destroy(&clo1);
+  igraph_vector_destroy(&clo);
+  igraph_vector_destroy(&ecc);
+  igraph_matrix_destroy(&one);
+  igraph_matrix_destroy(&all);
+  return 0;
+}
+
+int main() {
+  igraph_t g;
+  int ret;
+
+  igraph_rng_seed(igraph_rng_default(), 42);
+
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 150, 200,
+			  IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+  if ((ret=check(&g, IGRAPH_ALL))) { return ret; }
+  igraph_destroy(&g);
+
+  igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 150, 400,
+			  IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+  if ((ret=check(&g, IGRAPH_OUT))) { return 10+ret; }
+  if ((ret=check(&g, IGRAPH_IN))) { return 20+ret; }
+  if ((ret=check(&g, IGRAPH_ALL))) { return 30+ret; }
+  igraph_destroy(&g);
+
+  if (!IGRAPH_FINALLY_STACK_EMPTY) { return 40; }
+
+  return 0;
+}
@@ -0,0 +1,191 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Integer weights are handled by a radix heap, the same weights
+   multiplied by 0.25 go through the binary heap. All distances are
+   exact in both cases, so the results must agree. */
+
+int main() {
+  igraph_t g;
+  igraph_vector_t iweights, rweights, bi, br;
+  igraph_matrix_t di, dr;
+  igraph_vector_ptr_t vi, vr;
+  igraph_real_t diami, diamr;
+  long int i, j, n, m;
+
+  /* A directed ring, plus random edges */
+  igraph_rng_seed(igraph_rng_default(), 42);
+  igraph_ring(&g, 200, IGRAPH_DIRECTED, /*mutual=*/ 0, /*circular=*/ 1);
+  n=igraph_vcount(&g);
+  igraph_vector_init(&iweights, 0);
+  for (i=0; i<600; i++) {
+    igraph_vector_push_back(&iweights, RNG_INTEGER(0, n-1));
+    igraph_vector_push_back(&iweights, RNG_INTEGER(0, n-1));
+  }
+  igraph_add_edges(&g, &iweights, 0);
+  m=igraph_ecount(&g);
+
+  igraph_vector_resize(&iweights, m);
+  igraph_vector_init(&rweights, m);
+  for (i=0; i<m; i++) {
+    VECTOR(iweights)[i]=RNG_INTEGER(1, 1000);
+    VECTOR(rweights)[i]=VECTOR(iweights)[i] * 0.25;
+  }
+
+  /* Distance matrix */
+  igraph_matrix_init(&di, 0, 0);
+  igraph_matrix_init(&dr, 0, 0);
+  igraph_shortest_paths_dijkstra(&g, &di, igraph_vss_all(), igraph_vss_all(),
+				 &iweights, IGRAPH_OUT);
+  igraph_shortest_paths_dijkstra(&g, &dr, igraph_vss_all(), igraph_vss_all(),
+				 &rweights, IGRAPH_OUT);
+  igraph_matrix_scale(&dr, 4.0);
+  if (!igraph_matrix_all_e(&di, &dr)) {
+    return 1;
+  }
+
+  /* A subset of the targets */
+  igraph_shortest_paths_dijkstra(&g, &dr, igraph_vss_1(3), 
+				 igraph_vss_seq(10, 19), &iweights, IGRAPH_IN);
+  for (j=0; j<10; j++) {
+    igraph_real_t d;
+    igraph_matrix_t col;
+    igraph_matrix_init(&col, 0, 0);
+    igraph_shortest_paths_dijkstra(&g, &col, igraph_vss_1(10+j),
+				   igraph_vss_1(3), &iweights, IGRAPH_OUT);
+    d=MATRIX(col, 0, 0);
+    igraph_matrix_destroy(&col);
+    if (MATRIX(dr, 0, j) != d) {
+      return 2;
+    }
+  }
+
+  /* Shortest paths from one vertex, the path lengths must match
+     the distance matrix */
+  igraph_vector_ptr_init(&vi, n);
+  igraph_vector_ptr_init(&vr, n);
+  for (i=0; i<n; i++) {
+    VECTOR(vi)[i]=calloc(1, sizeof(igraph_vector_t));
+    igraph_vector_init(VECTOR(vi)[i], 0);
+    VECTOR(vr)[i]=calloc(1, sizeof(igraph_vector_t));
+    igraph_vector_init(VECTOR(vr)[i], 0);
+  }
+  igraph_get_shortest_paths_dijkstra(&g, 0, &vi, 5, igraph_vss_all(),
+				     &iweights, IGRAPH_OUT, 0, 0);
+  igraph_get_shortest_paths_dijkstra(&g, 0, &vr, 5, igraph_vss_all(),
+				     &rweights, IGRAPH_OUT, 0, 0);
+  for (i=0; i<n; i++) {
+    igraph_vector_t *p=VECTOR(vi)[i];
+    long int l=igraph_vector_size(p);
+    igraph_real_t len=0.0;
+    if (i == 5) { continue; }
+    if (l == 0 || igraph_vector_size(VECTOR(vr)[i]) == 0) {
+      return 3;
+    }
+    if (IGRAPH_FROM(&g, (long int) VECTOR(*p)[0]) != 5 || 
+	IGRAPH_TO(&g, (long int) VECTOR(*p)[l-1]) != i) {
+      return 4;
+    }
+    for (j=0; j<l; j++) {
+      if (j > 0 && IGRAPH_TO(&g, (long int) VECTOR(*p)[j-1]) !=
+	  IGRAPH_FROM(&g, (long int) VECTOR(*p)[j])) {
+	return 5;
+      }
+      len += VECTOR(iweights)[(long int) VECTOR(*p)[j]];
+    }
+    if (len != MATRIX(di, 5, i)) {
+      return 6;
+    }
+  }
+  for (i=0; i<n; i++) {
+    igraph_vector_destroy(VECTOR(vi)[i]);
+    free(VECTOR(vi)[i]);
+    igraph_vector_destroy(VECTOR(vr)[i]);
+    free(VECTOR(vr)[i]);
+  }
+  igraph_vector_ptr_destroy(&vi);
+  igraph_vector_ptr_destroy(&vr);
+
+  /* Betweenness does not depend on the scaling of the weights */
+  igraph_vector_init(&bi, 0);
+  igraph_vector_init(&br, 0);
+  igraph_betweenness(&g, &bi, igraph_vss_all(), IGRAPH_DIRECTED, 
+		     &iweights, /*nobigint=*/ 1);
+  igraph_betweenness(&g, &br, igraph_vss_all(), IGRAPH_DIRECTED, 
+		     &rweights, /*nobigint=*/ 1);
+  for (i=0; i<n; i++) {
+    if (fabs(VECTOR(bi)[i] - VECTOR(br)[i]) > 1e-9) {
+      return 7;
+    }
+  }
+  igraph_edge_betweenness(&g, &bi, IGRAPH_DIRECTED, &iweights);
+  igraph_edge_betweenness(&g, &br, IGRAPH_DIRECTED, &rweights);
+  for (i=0; i<m; i++) {
+    if (fabs(VECTOR(bi)[i] - VECTOR(br)[i]) > 1e-9) {
+      return 8;
+    }
+  }
+
+  /* Closeness is inversely proportional to the scaling */
+  igraph_closeness(&g, &bi, igraph_vss_all(), IGRAPH_ALL, &iweights, 
+		   /*normalized=*/ 0);
+  igraph_closeness(&g, &br, igraph_vss_all(), IGRAPH_ALL, &rweights, 
+		   /*normalized=*/ 0);
+  for (i=0; i<n; i++) {
+    if (fabs(VECTOR(bi)[i] * 4.0 - VECTOR(br)[i]) > 1e-12) {
+      return 9;
+    }
+  }
+
+  /* Weighted diameter */
+  igraph_diameter_dijkstra(&g, &iweights, &diami, 0, 0, 0, 
+			   IGRAPH_DIRECTED, /*unconn=*/ 1);
+  igraph_diameter_dijkstra(&g, &rweights, &diamr, 0, 0, 0, 
+			   IGRAPH_DIRECTED, /*unconn=*/ 1);
+  if (diami != diamr * 4.0) {
+    return 10;
+  }
+
+  /* Weights too large for the radix heap, scaling by a power of two
+     keeps the distances exact */
+  igraph_vector_scale(&iweights, 1099511627776.0);
+  igraph_shortest_paths_dijkstra(&g, &dr, igraph_vss_all(), igraph_vss_all(),
+				 &iweights, IGRAPH_OUT);
+  igraph_matrix_scale(&di, 1099511627776.0);
+  if (!igraph_matrix_all_e(&di, &dr)) {
+    return 11;
+  }
+
+  igraph_vector_destroy(&bi);
+  igraph_vector_destroy(&br);
+  igraph_matrix_destroy(&di);
+  igraph_matrix_destroy(&dr);
+  igraph_vector_destroy(&rweights);
+  igraph_vector_destroy(&iweights);
+  igraph_destroy(&g);
+
+  return 0;
+}
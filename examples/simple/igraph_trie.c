@@ -22,6 +22,7 @@
 */
 
 #include <stdio.h>
+#include <string.h>
 #include <igraph.h>
 #include <igraph_types_internal.h>
 
@@ -92,6 +93,27 @@ int main() {
   }
   igraph_trie_destroy(&trie);
 
+  /* many keys, and keys that are not zero terminated */
+  igraph_trie_init(&trie, 1);
+  for (i=0; i<10000; i++) {
+    char key[20];
+    sprintf(key, "v%dxyz", i);
+    igraph_trie_get2(&trie, key, (long int) strlen(key)-3, &id);
+    if (id != i) { return 2; }
+  }
+  for (i=0; i<10000; i++) {
+    char key[20];
+    sprintf(key, "v%d", i);
+    igraph_trie_check(&trie, key, &id);
+    if (id != i) { return 3; }
+    igraph_trie_idx(&trie, i, &str);
+    if (strcmp(str, key)) { return 4; }
+  }
+  igraph_trie_check(&trie, "v", &id);
+  if (id != -1) { return 5; }
+  if (igraph_trie_size(&trie) != 10000) { return 6; }
+  igraph_trie_destroy(&trie);
+
   if (!IGRAPH_FINALLY_STACK_EMPTY) return 1;
   
   return 0;
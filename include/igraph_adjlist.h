@@ -106,6 +106,75 @@ DECLDIR int igraph_inclist_fprint(const igraph_inclist_t *il, FILE *outfile);
  */
 #define igraph_inclist_get(il,no) (&(il)->incs[(long int)(no)])
 
+typedef struct igraph_csr_t {
+  igraph_integer_t length;
+  igraph_neimode_t mode;
+  igraph_vector_int_t start;
+  igraph_vector_int_t adj;
+  igraph_vector_int_t inc;
+} igraph_csr_t;
+
+DECLDIR int igraph_csr_init(const igraph_t *graph, igraph_csr_t *csr,
+                igraph_neimode_t mode);
+DECLDIR void igraph_csr_destroy(igraph_csr_t *csr);
+
+/**
+ * \define igraph_csr_size
+ * The number of vertices in a compressed adjacency list
+ * 
+ * \param csr The compressed adjacency list.
+ * \return The number of vertices.
+ * 
+ * Time complexity: O(1).
+ */
+#define igraph_csr_size(csr) ((csr)->length)
+
+/**
+ * \define igraph_csr_degree
+ * The number of neighbors of a vertex in a compressed adjacency list
+ * 
+ * \param csr The compressed adjacency list.
+ * \param no The vertex id.
+ * \return The number of neighbors (and incident edges) of the vertex.
+ * 
+ * Time complexity: O(1).
+ */
+#define igraph_csr_degree(csr,no) \
+  (VECTOR((csr)->start)[(long int)(no)+1] - VECTOR((csr)->start)[(long int)(no)])
+
+/**
+ * \define igraph_csr_neighbors
+ * The neighbors of a vertex in a compressed adjacency list
+ * 
+ * Returns a pointer to the first neighbor of a vertex, the following
+ * \ref igraph_csr_degree() elements are its neighbors. The
+ * neighbors must not be modified.
+ * \param csr The compressed adjacency list.
+ * \param no The vertex id.
+ * \return Pointer to an <type>int</type> array.
+ * 
+ * Time complexity: O(1).
+ */
+#define igraph_csr_neighbors(csr,no) \
+  (VECTOR((csr)->adj) + VECTOR((csr)->start)[(long int)(no)])
+
+/**
+ * \define igraph_csr_incident
+ * The incident edges of a vertex in a compressed adjacency list
+ * 
+ * Returns a pointer to the first incident edge of a vertex, the
+ * following \ref igraph_csr_degree() elements are the incident
+ * edges. The edges are in the same order as the neighbors returned
+ * by \ref igraph_csr_neighbors(). They must not be modified.
+ * \param csr The compressed adjacency list.
+ * \param no The vertex id.
+ * \return Pointer to an <type>int</type> array.
+ * 
+ * Time complexity: O(1).
+ */
+#define igraph_csr_incident(csr,no) \
+  (VECTOR((csr)->inc) + VECTOR((csr)->start)[(long int)(no)])
+
 typedef struct igraph_lazy_adjlist_t {
   const igraph_t *graph;
   igraph_integer_t length;
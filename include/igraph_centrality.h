@@ -45,6 +45,11 @@ DECLDIR int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *re
                 igraph_real_t cutoff,
                 const igraph_vector_t *weights,
                 igraph_bool_t normalized);
+DECLDIR int igraph_closeness_update(const igraph_t *oldgraph,
+                const igraph_t *newgraph,
+                const igraph_vector_t *removed, const igraph_vector_t *added,
+                igraph_vector_t *res, igraph_neimode_t mode,
+                igraph_bool_t normalized, igraph_integer_t *updated);
 
 DECLDIR int igraph_betweenness(const igraph_t *graph, igraph_vector_t *res, 
                 const igraph_vs_t vids, igraph_bool_t directed,
@@ -54,12 +59,31 @@ DECLDIR int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *
                 igraph_real_t cutoff, 
                 const igraph_vector_t *weights, 
                 igraph_bool_t nobigint);
+DECLDIR int igraph_betweenness_sources(const igraph_t *graph, igraph_vector_t *res,
+                const igraph_vs_t vids, igraph_bool_t directed,
+                const igraph_vs_t sources, igraph_real_t cutoff,
+                const igraph_vector_t *weights,
+                igraph_bool_t nobigint);
+DECLDIR int igraph_betweenness_approx(const igraph_t *graph, igraph_vector_t *res,
+                const igraph_vs_t vids, igraph_bool_t directed,
+                const igraph_vector_t *weights,
+                igraph_real_t epsilon, igraph_real_t delta,
+                igraph_integer_t *samples);
+DECLDIR int igraph_betweenness_update(const igraph_t *oldgraph,
+                const igraph_t *newgraph,
+                const igraph_vector_t *removed, const igraph_vector_t *added,
+                igraph_vector_t *res, igraph_bool_t directed,
+                igraph_integer_t *updated);
 DECLDIR int igraph_edge_betweenness(const igraph_t *graph, igraph_vector_t *result,
                 igraph_bool_t directed, 
                 const igraph_vector_t *weigths);
 DECLDIR int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *result,
                 igraph_bool_t directed, igraph_real_t cutoff,
                 const igraph_vector_t *weights);
+DECLDIR int igraph_edge_betweenness_approx(const igraph_t *graph, igraph_vector_t *result,
+                igraph_bool_t directed, const igraph_vector_t *weights,
+                igraph_real_t epsilon, igraph_real_t delta,
+                igraph_integer_t *samples);
 DECLDIR int igraph_pagerank_old(const igraph_t *graph, igraph_vector_t *res, 
                 const igraph_vs_t vids, igraph_bool_t directed,
                 igraph_integer_t niter, igraph_real_t eps, 
@@ -118,12 +142,58 @@ DECLDIR int igraph_personalized_pagerank_vs(const igraph_t *graph,
                 igraph_bool_t directed, igraph_real_t damping,
                 igraph_vs_t reset_vids,
                 const igraph_vector_t *weights, void *options);
+DECLDIR int igraph_personalized_pagerank_multi(const igraph_t *graph,
+                igraph_matrix_t *res,
+                igraph_bool_t directed, igraph_real_t damping,
+                const igraph_matrix_t *reset,
+                const igraph_vector_t *weights,
+                const igraph_pagerank_power_options_t *options);
+DECLDIR int igraph_personalized_pagerank_multi_vs(const igraph_t *graph,
+                igraph_matrix_t *res,
+                igraph_bool_t directed, igraph_real_t damping,
+                const igraph_vs_t seeds,
+                const igraph_vector_t *weights,
+                const igraph_pagerank_power_options_t *options);
+DECLDIR int igraph_personalized_pagerank_push(const igraph_t *graph,
+                igraph_vector_t *vids, igraph_vector_t *scores,
+                const igraph_vs_t reset_vids,
+                igraph_bool_t directed, igraph_real_t damping,
+                const igraph_vector_t *weights,
+                igraph_real_t epsilon);
+
+/**
+ * \struct igraph_eigenvector_power_options_t
+ * \brief Options and results of the eigenvector power iteration
+ *
+ * Used by \ref igraph_eigenvector_centrality_power(), \ref
+ * igraph_hub_score_power() and \ref igraph_authority_score_power().
+ * \member niter The maximum number of iterations, integer.
+ * \member eps The iteration stops when the residual is at most this
+ *        value.
+ * \member iterations Output, the number of iterations performed.
+ * \member residual Output, the Euclidean norm of
+ *        <code>M x - value x</code> for the resulting unit length
+ *        vector <code>x</code>.
+ */
+
+typedef struct igraph_eigenvector_power_options_t {
+  igraph_integer_t niter;
+  igraph_real_t eps;
+  igraph_integer_t iterations;
+  igraph_real_t residual;
+} igraph_eigenvector_power_options_t;
 
 DECLDIR int igraph_eigenvector_centrality(const igraph_t *graph, igraph_vector_t *vector,
                 igraph_real_t *value,
                 igraph_bool_t directed, igraph_bool_t scale,
                 const igraph_vector_t *weights,
                 igraph_arpack_options_t *options);
+DECLDIR int igraph_eigenvector_centrality_power(const igraph_t *graph,
+                igraph_vector_t *vector, igraph_real_t *value,
+                igraph_bool_t directed, igraph_bool_t scale,
+                const igraph_vector_t *weights,
+                const igraph_vector_t *start,
+                igraph_eigenvector_power_options_t *options);
 
 DECLDIR int igraph_hub_score(const igraph_t *graph, igraph_vector_t *vector,
                 igraph_real_t *value, igraph_bool_t scale,
@@ -133,6 +203,16 @@ DECLDIR int igraph_authority_score(const igraph_t *graph, igraph_vector_t *vecto
                 igraph_real_t *value, igraph_bool_t scale,
                 const igraph_vector_t *weights,
                 igraph_arpack_options_t *options);
+DECLDIR int igraph_hub_score_power(const igraph_t *graph, igraph_vector_t *vector,
+                igraph_real_t *value, igraph_bool_t scale,
+                const igraph_vector_t *weights,
+                const igraph_vector_t *start,
+                igraph_eigenvector_power_options_t *options);
+DECLDIR int igraph_authority_score_power(const igraph_t *graph, igraph_vector_t *vector,
+                igraph_real_t *value, igraph_bool_t scale,
+                const igraph_vector_t *weights,
+                const igraph_vector_t *start,
+                igraph_eigenvector_power_options_t *options);
 
 DECLDIR int igraph_constraint(const igraph_t *graph, igraph_vector_t *res,
                 igraph_vs_t vids, const igraph_vector_t *weights);
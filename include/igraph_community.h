@@ -213,6 +213,15 @@ DECLDIR int igraph_community_multilevel(const igraph_t *graph,
                 igraph_vector_t *membership,
                 igraph_matrix_t *memberships,
                 igraph_vector_t *modularity);
+DECLDIR int igraph_community_leiden(const igraph_t *graph,
+                const igraph_vector_t *edge_weights,
+                const igraph_vector_t *node_weights,
+                igraph_real_t resolution_parameter,
+                igraph_real_t beta, igraph_bool_t start,
+                igraph_integer_t n_iterations,
+                igraph_vector_t *membership,
+                igraph_integer_t *nb_clusters,
+                igraph_real_t *quality);
 
 /* -------------------------------------------------- */
 /* Community Structure Comparison                     */
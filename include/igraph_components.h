@@ -55,6 +55,64 @@ DECLDIR int igraph_biconnected_components(const igraph_t *graph,
                 igraph_vector_ptr_t *components,
                 igraph_vector_t *articulation_points);
 
+/**
+ * \struct igraph_connectivity_index_t
+ * \brief Incrementally maintained connected components
+ *
+ * See \ref igraph_connectivity_index_init(). These members are
+ * considered to be private:
+ * \member no_of_nodes The number of vertices.
+ * \member no The number of sets in the forest, this is the number
+ *   of components if no set is dirty.
+ * \member parent The union-find forest.
+ * \member size The sizes of the sets, for the roots of the forest.
+ * \member next The vertices of each set, as a ring.
+ * \member dirty Whether the set lost a spanning forest edge since
+ *   it was last rebuilt, for the roots of the forest.
+ * \member dirty_roots The vertices that were marked dirty, some of
+ *   their sets might be exact again.
+ * \member head The first incident edge of each vertex.
+ * \member queue The vertices of the set being rebuilt.
+ * \member edges The endpoints of the edges.
+ * \member inc_next The incidence lists of the vertices, next.
+ * \member inc_prev The incidence lists of the vertices, previous.
+ * \member state Whether each edge is deleted, a spanning forest edge,
+ *   or neither.
+ * \member free The ids of the deleted edges.
+ */
+
+typedef struct igraph_connectivity_index_t {
+  igraph_integer_t no_of_nodes;
+  igraph_integer_t no;
+  igraph_vector_int_t parent, size, next;
+  igraph_vector_char_t dirty;
+  igraph_vector_int_t dirty_roots;
+  igraph_vector_int_t head, queue;
+  igraph_vector_int_t edges, inc_next, inc_prev;
+  igraph_vector_char_t state;
+  igraph_vector_int_t free;
+} igraph_connectivity_index_t;
+
+DECLDIR int igraph_connectivity_index_init(const igraph_t *graph,
+                igraph_connectivity_index_t *index);
+DECLDIR void igraph_connectivity_index_destroy(igraph_connectivity_index_t *index);
+DECLDIR int igraph_connectivity_index_add_vertices(igraph_connectivity_index_t *index,
+                igraph_integer_t nv);
+DECLDIR int igraph_connectivity_index_add_edges(igraph_connectivity_index_t *index,
+                const igraph_vector_t *edges, igraph_vector_t *eids);
+DECLDIR int igraph_connectivity_index_delete_edges(igraph_connectivity_index_t *index,
+                const igraph_vector_t *eids);
+DECLDIR int igraph_connectivity_index_same_component(igraph_connectivity_index_t *index,
+                igraph_bool_t *res, igraph_integer_t from,
+                igraph_integer_t to);
+DECLDIR int igraph_connectivity_index_component_size(igraph_connectivity_index_t *index,
+                igraph_integer_t *res, igraph_integer_t vertex);
+DECLDIR int igraph_connectivity_index_count(igraph_connectivity_index_t *index,
+                igraph_integer_t *res);
+DECLDIR int igraph_connectivity_index_membership(igraph_connectivity_index_t *index,
+                igraph_vector_t *membership, igraph_vector_t *csize,
+                igraph_integer_t *no);
+
 __END_DECLS
 
 #endif
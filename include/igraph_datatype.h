@@ -64,17 +64,20 @@ __BEGIN_DECLS
  * \c from=v2, \c to=v1.
  *
  * The storage requirements for a graph with \c |V| vertices
- * and \c |E| edges is \c O(|E|+|V|).
+ * and \c |E| edges is \c O(|E|+|V|). All six vectors hold vertex or
+ * edge indices, so they are stored as \type igraph_vector_int_t,
+ * i.e. with the same width as \type igraph_integer_t, which already
+ * bounds the number of vertices and edges.
  */
 typedef struct igraph_s {
   igraph_integer_t n;
   igraph_bool_t directed;
-  igraph_vector_t from;
-  igraph_vector_t to;
-  igraph_vector_t oi;
-  igraph_vector_t ii;
-  igraph_vector_t os;
-  igraph_vector_t is;
+  igraph_vector_int_t from;
+  igraph_vector_int_t to;
+  igraph_vector_int_t oi;
+  igraph_vector_int_t ii;
+  igraph_vector_int_t os;
+  igraph_vector_int_t is;
   void *attr;
 } igraph_t;
 
@@ -169,8 +169,9 @@ __BEGIN_DECLS
  * \ref IGRAPH_CHECK on all \a igraph function calls which can generate errors.
  * </para>
  * <para>
- * The size of the stack used for this bookkeeping is fixed, and
- * small. If you want to allocate several objects, write a destroy
+ * The stack used for this bookkeeping grows as needed, so deeply
+ * recursive functions may register objects at each level. Still, if
+ * you want to allocate many objects, it is better to write a destroy
  * function which can deallocate all of these. See the
  * <filename>adjlist.c</filename> file in the
  * \a igraph source for an example.
@@ -538,6 +539,23 @@ DECLDIR void IGRAPH_FINALLY_FREE(void);
  */
 DECLDIR int IGRAPH_FINALLY_STACK_SIZE(void);
 
+/**
+ * \function IGRAPH_FINALLY_RESTORE
+ * \brief Unregister all objects above a marker.
+ *
+ * Removes objects from the stack of temporarily allocated objects
+ * (without destroying them), until it contains only \p mark
+ * objects. Together with \ref IGRAPH_FINALLY_STACK_SIZE this gives
+ * scoped push/pop markers: store the stack size when entering a
+ * block that registers a variable number of objects (e.g. one per
+ * recursion level), and restore it when leaving the block, instead
+ * of counting the objects for \ref IGRAPH_FINALLY_CLEAN().
+ * \param mark The stack size to restore, as returned by an earlier
+ *   \ref IGRAPH_FINALLY_STACK_SIZE call. If the stack is already
+ *   smaller, nothing happens.
+ */
+DECLDIR void IGRAPH_FINALLY_RESTORE(int mark);
+
 /**
  * \define IGRAPH_FINALLY_STACK_EMPTY
  * \brief Returns true if there are no registered objects, false otherwise.
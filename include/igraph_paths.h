@@ -32,6 +32,8 @@
 #include "igraph_matrix.h"
 #include "igraph_iterators.h"
 
+#include <stdio.h>
+
 __BEGIN_DECLS
 
 DECLDIR int igraph_diameter(const igraph_t *graph, igraph_integer_t *res, 
@@ -97,6 +99,44 @@ DECLDIR int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
 				        igraph_integer_t to,
 				        const igraph_vector_t *weights,
 				        igraph_neimode_t mode);
+DECLDIR int igraph_get_shortest_path_bidirectional(const igraph_t *graph,
+				        igraph_vector_t *vertices,
+				        igraph_vector_t *edges,
+				        igraph_integer_t from,
+				        igraph_integer_t to,
+				        const igraph_vector_t *weights,
+				        igraph_neimode_t mode);
+
+/**
+ * \typedef igraph_astar_heuristic_func_t
+ * Heuristic function for the A* shortest path search
+ * 
+ * \ref igraph_get_shortest_path_astar() calls a function of this
+ * type to estimate the distance of a vertex from the target vertex.
+ * \param result Pointer to a real number, the estimated distance
+ *   must be stored here.
+ * \param from The id of the vertex whose distance is estimated.
+ * \param to The id of the target vertex.
+ * \param extra The extra argument that was passed to \ref
+ *   igraph_get_shortest_path_astar().
+ * \return Error code, a non-zero value stops the search and it is
+ *   returned from \ref igraph_get_shortest_path_astar().
+ */
+
+typedef int igraph_astar_heuristic_func_t(igraph_real_t *result,
+				        igraph_integer_t from,
+				        igraph_integer_t to,
+				        void *extra);
+
+DECLDIR int igraph_get_shortest_path_astar(const igraph_t *graph,
+				        igraph_vector_t *vertices,
+				        igraph_vector_t *edges,
+				        igraph_integer_t from,
+				        igraph_integer_t to,
+				        const igraph_vector_t *weights,
+				        igraph_neimode_t mode,
+				        igraph_astar_heuristic_func_t *heuristic,
+				        void *extra);
 DECLDIR int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
                 igraph_vector_ptr_t *res, 
                 igraph_vector_t *nrgeo,
@@ -122,6 +162,45 @@ DECLDIR int igraph_eccentricity(const igraph_t *graph,
 DECLDIR int igraph_radius(const igraph_t *graph, igraph_real_t *radius, 
                 igraph_neimode_t mode);
 
+/**
+ * \struct igraph_distance_index_t
+ * \brief Index for fast distance queries
+ *
+ * See \ref igraph_distance_index_init(). These members are considered
+ * to be private:
+ * \member no_of_nodes The number of vertices.
+ * \member directed Whether the index is for directed paths.
+ * \member out_start Start of the labels of each vertex.
+ * \member out_labels Labels, hub ranks and distances to the hubs.
+ * \member in_start Start of the labels of each vertex, directed only.
+ * \member in_labels Labels, hub ranks and distances from the hubs,
+ *   directed only.
+ */
+
+typedef struct igraph_distance_index_t {
+  igraph_integer_t no_of_nodes;
+  igraph_bool_t directed;
+  igraph_vector_int_t out_start, out_labels;
+  igraph_vector_int_t in_start, in_labels;
+} igraph_distance_index_t;
+
+DECLDIR int igraph_distance_index_init(const igraph_t *graph, 
+                igraph_distance_index_t *index,
+                igraph_bool_t directed);
+DECLDIR void igraph_distance_index_destroy(igraph_distance_index_t *index);
+DECLDIR igraph_integer_t igraph_distance_index_size(const igraph_distance_index_t *index);
+DECLDIR int igraph_distance_index_query(const igraph_distance_index_t *index,
+                igraph_real_t *res, igraph_integer_t from,
+                igraph_integer_t to);
+DECLDIR int igraph_distance_index_query_pairs(const igraph_distance_index_t *index,
+                igraph_vector_t *res, 
+                const igraph_vector_t *from,
+                const igraph_vector_t *to);
+DECLDIR int igraph_distance_index_write(const igraph_distance_index_t *index,
+                FILE *outstream);
+DECLDIR int igraph_distance_index_read(igraph_distance_index_t *index, 
+                FILE *instream);
+
 DECLDIR int igraph_get_all_simple_paths(const igraph_t *graph,
                 igraph_vector_int_t *res,
                 igraph_integer_t from,
@@ -54,6 +54,16 @@
  * on how exactly the rewiring is done) typically O(|V|+|E|) time for
  * the whole rewiring process.</para>
  * 
+ * <para>Compressed adjacency lists (<type>igraph_csr_t</type>) are
+ * read-only snapshots of a graph. They store the neighbors and the
+ * incident edges of all vertices in two contiguous arrays, plus an
+ * array of offsets, so they are created with a handful of memory
+ * allocations, and the neighbors of consecutive vertices are next to
+ * each other in memory. They are the best choice if the same graph is
+ * traversed many times and the lists need not be modified, e.g. in
+ * betweenness or closeness calculations. The same snapshot can be
+ * reused for many analyses of the same graph.</para>
+ * 
  * <para>Lazy adjacency lists are a bit different. When creating a
  * lazy adjacency list, the neighbors of the vertices are not queried,
  * only some memory is allocated for the vectors. When \ref
@@ -656,6 +666,113 @@ void igraph_inclist_clear(igraph_inclist_t *il) {
   }
 }
 
+/**
+ * \function igraph_csr_init
+ * Create a compressed adjacency list from a graph
+ * 
+ * Creates a read-only snapshot of the neighbors and incident edges of
+ * all vertices. The neighbors of each vertex are in the same order as
+ * \ref igraph_neighbors() returns them, i.e. sorted by vertex
+ * id. The snapshot is independent of the graph after creation, it is
+ * not updated if the graph is modified.
+ * \param graph The input graph.
+ * \param csr Pointer to an uninitialized <type>igraph_csr_t</type>
+ *   object.
+ * \param mode Constant specifying whether outgoing
+ *   (<code>IGRAPH_OUT</code>), incoming (<code>IGRAPH_IN</code>),
+ *   or both (<code>IGRAPH_ALL</code>) types of neighbors to include.
+ *   It is ignored for undirected networks.
+ * \return Error code.
+ * 
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ */
+
+int igraph_csr_init(const igraph_t *graph, igraph_csr_t *csr,
+		    igraph_neimode_t mode) {
+  long int no_of_nodes=igraph_vcount(graph);
+  igraph_bool_t directed=igraph_is_directed(graph);
+  igraph_vector_t tmp, tmp2;
+  long int i, j, k, n1, n2, ptr=0;
+
+  if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+    IGRAPH_ERROR("Cannot create compressed adjacency list", IGRAPH_EINVMODE);
+  }
+
+  if (!directed) { mode=IGRAPH_ALL; }
+  csr->length=(igraph_integer_t) no_of_nodes;
+  csr->mode=mode;
+
+  IGRAPH_VECTOR_INIT_FINALLY(&tmp, 0);
+  IGRAPH_VECTOR_INIT_FINALLY(&tmp2, 0);
+
+  /* The offsets */
+  IGRAPH_CHECK(igraph_degree(graph, &tmp, igraph_vss_all(), mode, 
+			     IGRAPH_LOOPS));
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&csr->start, no_of_nodes+1);
+  for (i=0; i<no_of_nodes; i++) {
+    VECTOR(csr->start)[i+1] = VECTOR(csr->start)[i] + (int) VECTOR(tmp)[i];
+  }
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&csr->adj, VECTOR(csr->start)[no_of_nodes]);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&csr->inc, VECTOR(csr->start)[no_of_nodes]);
+
+  for (i=0; i<no_of_nodes; i++) {
+    IGRAPH_ALLOW_INTERRUPTION();
+    if (directed && mode==IGRAPH_ALL) {
+      /* Merge the out- and in-edges, to keep the neighbors sorted */
+      IGRAPH_CHECK(igraph_incident(graph, &tmp, (igraph_integer_t) i,
+				   IGRAPH_OUT));
+      IGRAPH_CHECK(igraph_incident(graph, &tmp2, (igraph_integer_t) i,
+				   IGRAPH_IN));
+      n1=igraph_vector_size(&tmp);
+      n2=igraph_vector_size(&tmp2);
+      j=0; k=0;
+      while (j < n1 || k < n2) {
+	long int e1= j < n1 ? (long int) VECTOR(tmp)[j] : -1;
+	long int e2= k < n2 ? (long int) VECTOR(tmp2)[k] : -1;
+	if (e2 < 0 || (e1 >= 0 && IGRAPH_TO(graph, e1) <= 
+		       IGRAPH_FROM(graph, e2))) {
+	  VECTOR(csr->inc)[ptr] = (int) e1;
+	  VECTOR(csr->adj)[ptr++] = IGRAPH_TO(graph, e1);
+	  j++;
+	} else {
+	  VECTOR(csr->inc)[ptr] = (int) e2;
+	  VECTOR(csr->adj)[ptr++] = IGRAPH_FROM(graph, e2);
+	  k++;
+	}
+      }
+    } else {
+      IGRAPH_CHECK(igraph_incident(graph, &tmp, (igraph_integer_t) i, mode));
+      n1=igraph_vector_size(&tmp);
+      for (j=0; j<n1; j++) {
+	long int e=(long int) VECTOR(tmp)[j];
+	VECTOR(csr->inc)[ptr] = (int) e;
+	VECTOR(csr->adj)[ptr++] = IGRAPH_OTHER(graph, e, i);
+      }
+    }
+  }
+
+  igraph_vector_destroy(&tmp2);
+  igraph_vector_destroy(&tmp);
+  IGRAPH_FINALLY_CLEAN(5);
+  return 0;
+}
+
+/**
+ * \function igraph_csr_destroy
+ * Frees the memory allocated for a compressed adjacency list
+ * 
+ * \param csr The compressed adjacency list to destroy.
+ * 
+ * Time complexity: depends on memory management.
+ */
+
+void igraph_csr_destroy(igraph_csr_t *csr) {
+  igraph_vector_int_destroy(&csr->start);
+  igraph_vector_int_destroy(&csr->adj);
+  igraph_vector_int_destroy(&csr->inc);
+}
+
 /**
  * \function igraph_lazy_adjlist_init
  * Constructor
@@ -27,6 +27,7 @@
 #include "igraph_math.h"
 #include "igraph_interface.h"
 #include "igraph_random.h"
+#include "igraph_types_internal.h"
 
 #include <string.h>
 
@@ -50,12 +51,101 @@ igraph_bool_t igraph_i_cattribute_find(const igraph_vector_ptr_t *ptrvec,
   return l;
 }
 
+/* Graphs with many attributes also get a hashed name index for each
+   attribute list. It is an open addressing table of list positions
+   (plus one, zero means an empty slot), built lazily when a lookup
+   happens. Attributes are only ever appended to the lists, except
+   when they are removed, which resets the index. The index is only an
+   accelerator: if it cannot be allocated, lookups fall back to the
+   linear search, no error is raised. */
+
+#define IGRAPH_I_CATTRIBUTE_INDEX_MIN 16
+
+typedef struct igraph_i_cattribute_index_t {
+  long int *slots;
+  long int size;
+  long int indexed;
+} igraph_i_cattribute_index_t;
+
 typedef struct igraph_i_cattributes_t {
   igraph_vector_ptr_t gal;
   igraph_vector_ptr_t val;
   igraph_vector_ptr_t eal;
+  igraph_i_cattribute_index_t index[3];
 } igraph_i_cattributes_t;
 
+void igraph_i_cattribute_index_reset(igraph_i_cattribute_index_t *index) {
+  if (index->slots) {
+    igraph_Free(index->slots);
+  }
+  index->size=0;
+  index->indexed=0;
+}
+
+igraph_bool_t igraph_i_cattribute_index_sync(igraph_i_cattribute_index_t *index,
+					     const igraph_vector_ptr_t *ptrvec) {
+  long int i, n=igraph_vector_ptr_size(ptrvec), mask;
+
+  if (index->indexed > n || index->size < 2*n) {
+    /* (Re)build it from scratch */
+    long int size=2*IGRAPH_I_CATTRIBUTE_INDEX_MIN;
+    while (size < 2*n) { size *= 2; }
+    igraph_i_cattribute_index_reset(index);
+    index->slots=igraph_Calloc(size, long int);
+    if (!index->slots) { return 0; }
+    index->size=size;
+  }
+
+  mask=index->size-1;
+  for (i=index->indexed; i<n; i++) {
+    igraph_attribute_record_t *rec=VECTOR(*ptrvec)[i];
+    long int slot;
+    if (!rec) { return 0; }
+    slot=igraph_i_trie_hash(rec->name, (long int) strlen(rec->name)) & mask;
+    while (index->slots[slot]) { slot = (slot+1) & mask; }
+    index->slots[slot]=i+1;
+    index->indexed=i+1;
+  }
+
+  return 1;
+}
+
+/* Same as igraph_i_cattribute_find, for the attribute lists of 'attr' */
+
+igraph_bool_t igraph_i_cattribute_find_in(igraph_i_cattributes_t *attr,
+					  const igraph_vector_ptr_t *ptrvec,
+					  const char *name, long int *idx) {
+  long int n=igraph_vector_ptr_size(ptrvec);
+  igraph_i_cattribute_index_t *index;
+
+  if (ptrvec == &attr->gal) {
+    index=&attr->index[0];
+  } else if (ptrvec == &attr->val) {
+    index=&attr->index[1];
+  } else {
+    index=&attr->index[2];
+  }
+
+  if (n >= IGRAPH_I_CATTRIBUTE_INDEX_MIN &&
+      igraph_i_cattribute_index_sync(index, ptrvec)) {
+    long int mask=index->size-1;
+    long int slot=igraph_i_trie_hash(name, (long int) strlen(name)) & mask;
+    while (index->slots[slot]) {
+      long int pos=index->slots[slot]-1;
+      igraph_attribute_record_t *rec=VECTOR(*ptrvec)[pos];
+      if (!strcmp(rec->name, name)) {
+	if (idx) { *idx=pos; }
+	return 1;
+      }
+      slot = (slot+1) & mask;
+    }
+    if (idx) { *idx=n-1; }
+    return 0;
+  }
+
+  return igraph_i_cattribute_find(ptrvec, name, idx);
+}
+
 int igraph_i_cattributes_copy_attribute_record(igraph_attribute_record_t **newrec, 
 					       const igraph_attribute_record_t *rec) {
   igraph_vector_t *num, *newnum;
@@ -168,6 +258,9 @@ void igraph_i_cattribute_destroy(igraph_t *graph) {
   igraph_vector_ptr_destroy(&attr->gal);
   igraph_vector_ptr_destroy(&attr->val);
   igraph_vector_ptr_destroy(&attr->eal);
+  for (a=0; a<3; a++) {
+    igraph_i_cattribute_index_reset(&attr->index[a]);
+  }
   igraph_free(graph->attr);
   graph->attr=0;
 }
@@ -202,6 +295,7 @@ void igraph_i_cattribute_copy_free(igraph_i_cattributes_t *attr) {
       igraph_free((char*)rec->name);
       igraph_free(rec);
     }
+    igraph_i_cattribute_index_reset(&attr->index[a]);
   }  
 }
 
@@ -245,6 +339,29 @@ int igraph_i_cattribute_copy(igraph_t *to, const igraph_t *from,
   return 0;
 }
 
+/* Makes room for 'size' elements in a numeric or Boolean attribute
+   vector, growing its storage geometrically, so that adding vertices
+   or edges one by one does not reallocate every attribute column
+   each time. */
+
+int igraph_i_cattribute_reserve(igraph_attribute_record_t *rec, 
+				long int size) {
+  if (rec->type == IGRAPH_ATTRIBUTE_NUMERIC) {
+    igraph_vector_t *num=(igraph_vector_t*)rec->value;
+    long int cap=igraph_vector_capacity(num);
+    if (size > cap) {
+      IGRAPH_CHECK(igraph_vector_reserve(num, size > 2*cap ? size : 2*cap));
+    }
+  } else if (rec->type == IGRAPH_ATTRIBUTE_BOOLEAN) {
+    igraph_vector_bool_t *log=(igraph_vector_bool_t*)rec->value;
+    long int cap=igraph_vector_bool_capacity(log);
+    if (size > cap) {
+      IGRAPH_CHECK(igraph_vector_bool_reserve(log, size > 2*cap ? size : 2*cap));
+    }
+  }
+  return 0;
+}
+
 int igraph_i_cattribute_add_vertices(igraph_t *graph, long int nv,
 				     igraph_vector_ptr_t *nattr) {
 
@@ -263,7 +380,7 @@ int igraph_i_cattribute_add_vertices(igraph_t *graph, long int nv,
     igraph_attribute_record_t *nattr_entry=VECTOR(*nattr)[i];
     const char *nname=nattr_entry->name;
     long int j;
-    igraph_bool_t l=igraph_i_cattribute_find(val, nname, &j);
+    igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, nname, &j);
     if (!l) {
       newattrs++;
       IGRAPH_CHECK(igraph_vector_push_back(&news, i));
@@ -334,6 +451,7 @@ int igraph_i_cattribute_add_vertices(igraph_t *graph, long int nv,
     long int j;
     igraph_bool_t l=0;
     if (nattr) { l=igraph_i_cattribute_find(nattr, name, &j); }
+    IGRAPH_CHECK(igraph_i_cattribute_reserve(oldrec, origlen+nv));
     if (l) {
       /* This attribute is present in nattr */
       igraph_vector_t *oldnum, *newnum;
@@ -410,8 +528,11 @@ void igraph_i_cattribute_permute_free(igraph_vector_ptr_t *v) {
   long int i, n=igraph_vector_ptr_size(v);
   for (i=0; i<n; i++) {
     igraph_attribute_record_t *rec=VECTOR(*v)[i];
+    if (!rec) { continue; }
     igraph_Free(rec->name);
-    if (rec->type == IGRAPH_ATTRIBUTE_NUMERIC) {
+    if (!rec->value) {
+      /* Not filled in yet */
+    } else if (rec->type == IGRAPH_ATTRIBUTE_NUMERIC) {
       igraph_vector_t *numv= (igraph_vector_t*) rec->value;
       igraph_vector_destroy(numv);
       igraph_Free(numv);
@@ -429,6 +550,20 @@ void igraph_i_cattribute_permute_free(igraph_vector_ptr_t *v) {
   igraph_vector_ptr_clear(v);
 }
 
+/* Same as igraph_i_cattribute_permute_free, for the vertex and edge
+   attributes of 'attr'. The name index of the list might already
+   refer to the freed records, so it is reset, too. */
+
+void igraph_i_cattribute_permute_free_val(igraph_i_cattributes_t *attr) {
+  igraph_i_cattribute_permute_free(&attr->val);
+  igraph_i_cattribute_index_reset(&attr->index[1]);
+}
+
+void igraph_i_cattribute_permute_free_eal(igraph_i_cattributes_t *attr) {
+  igraph_i_cattribute_permute_free(&attr->eal);
+  igraph_i_cattribute_index_reset(&attr->index[2]);
+}
+
 int igraph_i_cattribute_permute_vertices(const igraph_t *graph,
 					 igraph_t *newgraph,
 					 const igraph_vector_t *idx) {
@@ -507,8 +642,9 @@ int igraph_i_cattribute_permute_vertices(const igraph_t *graph,
 		   IGRAPH_EATTRIBUTES);
     }
     IGRAPH_CHECK(igraph_vector_ptr_resize(new_val, valno));
+    igraph_vector_ptr_null(new_val);
     
-    IGRAPH_FINALLY(igraph_i_cattribute_permute_free, new_val);
+    IGRAPH_FINALLY(igraph_i_cattribute_permute_free_val, new_attr);
     
     for (i=0; i<valno; i++) {
       igraph_attribute_record_t *oldrec=VECTOR(*val)[i];
@@ -1395,7 +1531,8 @@ int igraph_i_cattribute_combine_vertices(const igraph_t *graph,
   }
 
   IGRAPH_CHECK(igraph_vector_ptr_resize(new_val, keepno));
-  IGRAPH_FINALLY(igraph_i_cattribute_permute_free, new_val);
+  igraph_vector_ptr_null(new_val);
+  IGRAPH_FINALLY(igraph_i_cattribute_permute_free_val, toattr);
   
   for (i=0, j=0; i<valno; i++) {
     igraph_attribute_record_t *newrec, *oldrec=VECTOR(*val)[i];
@@ -1645,7 +1782,7 @@ int igraph_i_cattribute_add_edges(igraph_t *graph, const igraph_vector_t *edges,
     igraph_attribute_record_t *nattr_entry=VECTOR(*nattr)[i];
     const char *nname=nattr_entry->name;
     long int j;
-    igraph_bool_t l=igraph_i_cattribute_find(eal, nname, &j);
+    igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, nname, &j);
     if (!l) {
       newattrs++;
       IGRAPH_CHECK(igraph_vector_push_back(&news, i));
@@ -1716,6 +1853,7 @@ int igraph_i_cattribute_add_edges(igraph_t *graph, const igraph_vector_t *edges,
     long int j;
     igraph_bool_t l=0;
     if (nattr) { l=igraph_i_cattribute_find(nattr, name, &j); }
+    IGRAPH_CHECK(igraph_i_cattribute_reserve(oldrec, origlen+ne));
     if (l) {
       /* This attribute is present in nattr */
       igraph_vector_t *oldnum, *newnum;
@@ -1896,8 +2034,9 @@ int igraph_i_cattribute_permute_edges(const igraph_t *graph,
     igraph_i_cattributes_t *new_attr=newgraph->attr;
     igraph_vector_ptr_t *new_eal=&new_attr->eal;
     IGRAPH_CHECK(igraph_vector_ptr_resize(new_eal, ealno));
+    igraph_vector_ptr_null(new_eal);
     
-    IGRAPH_FINALLY(igraph_i_cattribute_permute_free, new_eal);
+    IGRAPH_FINALLY(igraph_i_cattribute_permute_free_eal, new_attr);
     
     for (i=0; i<ealno; i++) {
       igraph_attribute_record_t *oldrec=VECTOR(*eal)[i];
@@ -2003,7 +2142,8 @@ int igraph_i_cattribute_combine_edges(const igraph_t *graph,
   }
   
   IGRAPH_CHECK(igraph_vector_ptr_resize(new_eal, keepno));
-  IGRAPH_FINALLY(igraph_i_cattribute_permute_free, new_eal);
+  igraph_vector_ptr_null(new_eal);
+  IGRAPH_FINALLY(igraph_i_cattribute_permute_free_eal, toattr);
   
   for (i=0, j=0; i<ealno; i++) {
     igraph_attribute_record_t *newrec, *oldrec=VECTOR(*eal)[i];
@@ -2236,7 +2376,7 @@ igraph_bool_t igraph_i_cattribute_has_attr(const igraph_t *graph,
     break;
   }
 
-  return igraph_i_cattribute_find(attr[attrnum], name, 0);
+  return igraph_i_cattribute_find_in(at, attr[attrnum], name, 0);
 }
 
 int igraph_i_cattribute_gettype(const igraph_t *graph,
@@ -2267,7 +2407,7 @@ int igraph_i_cattribute_gettype(const igraph_t *graph,
   }
 
   al=attr[attrnum];
-  l=igraph_i_cattribute_find(al, name, &j);  
+  l=igraph_i_cattribute_find_in(at, al, name, &j);  
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
   }  
@@ -2285,7 +2425,7 @@ int igraph_i_cattribute_get_numeric_graph_attr(const igraph_t *graph,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_t *num;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2307,7 +2447,7 @@ int igraph_i_cattribute_get_bool_graph_attr(const igraph_t *graph,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_bool_t *log;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2329,7 +2469,7 @@ int igraph_i_cattribute_get_string_graph_attr(const igraph_t *graph,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_strvector_t *str;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2352,7 +2492,7 @@ int igraph_i_cattribute_get_numeric_vertex_attr(const igraph_t *graph,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_t *num;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2390,7 +2530,7 @@ int igraph_i_cattribute_get_bool_vertex_attr(const igraph_t *graph,
   long int i, j, v;
   igraph_attribute_record_t *rec;
   igraph_vector_bool_t *log;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2425,7 +2565,7 @@ int igraph_i_cattribute_get_string_vertex_attr(const igraph_t *graph,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_strvector_t *str;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2464,7 +2604,7 @@ int igraph_i_cattribute_get_numeric_edge_attr(const igraph_t *graph,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_t *num;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2501,7 +2641,7 @@ int igraph_i_cattribute_get_string_edge_attr(const igraph_t *graph,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_strvector_t *str;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2540,7 +2680,7 @@ int igraph_i_cattribute_get_bool_edge_attr(const igraph_t *graph,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_bool_t *log;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (!l) {
     IGRAPH_ERROR("Unknown attribute", IGRAPH_EINVAL);
@@ -2649,7 +2789,7 @@ igraph_real_t igraph_cattribute_GAN(const igraph_t *graph, const char *name) {
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_t *num;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -2682,7 +2822,7 @@ igraph_bool_t igraph_cattribute_GAB(const igraph_t *graph, const char *name) {
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_bool_t *log;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -2716,7 +2856,7 @@ const char* igraph_cattribute_GAS(const igraph_t *graph, const char *name) {
   long int j;
   igraph_attribute_record_t *rec;
   igraph_strvector_t *str;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -2749,7 +2889,7 @@ igraph_real_t igraph_cattribute_VAN(const igraph_t *graph, const char *name,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_t *num;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -2782,7 +2922,7 @@ igraph_bool_t igraph_cattribute_VAB(const igraph_t *graph, const char *name,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_bool_t *log;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -2815,7 +2955,7 @@ const char* igraph_cattribute_VAS(const igraph_t *graph, const char *name,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_strvector_t *str;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -2848,7 +2988,7 @@ igraph_real_t igraph_cattribute_EAN(const igraph_t *graph, const char *name,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_t *num;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -2881,7 +3021,7 @@ igraph_bool_t igraph_cattribute_EAB(const igraph_t *graph, const char *name,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_vector_bool_t *log;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -2914,7 +3054,7 @@ const char* igraph_cattribute_EAS(const igraph_t *graph, const char *name,
   long int j;
   igraph_attribute_record_t *rec;
   igraph_strvector_t *str;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (!l) {
     igraph_error("Unknown attribute", __FILE__, __LINE__, IGRAPH_EINVAL);
@@ -3121,7 +3261,7 @@ int igraph_cattribute_GAN_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *gal=&attr->gal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*gal)[j];
@@ -3179,7 +3319,7 @@ int igraph_cattribute_GAB_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *gal=&attr->gal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*gal)[j];
@@ -3239,7 +3379,7 @@ int igraph_cattribute_GAS_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *gal=&attr->gal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*gal)[j];
@@ -3301,7 +3441,7 @@ int igraph_cattribute_VAN_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *val=&attr->val;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*val)[j];
@@ -3364,7 +3504,7 @@ int igraph_cattribute_VAB_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *val=&attr->val;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*val)[j];
@@ -3429,7 +3569,7 @@ int igraph_cattribute_VAS_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *val=&attr->val;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*val)[j];
@@ -3491,7 +3631,7 @@ int igraph_cattribute_EAN_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *eal=&attr->eal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*eal)[j];
@@ -3554,7 +3694,7 @@ int igraph_cattribute_EAB_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *eal=&attr->eal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*eal)[j];
@@ -3619,7 +3759,7 @@ int igraph_cattribute_EAS_set(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *eal=&attr->eal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (l) {
     igraph_attribute_record_t *rec=VECTOR(*eal)[j];
@@ -3678,7 +3818,7 @@ int igraph_cattribute_VAN_setv(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *val=&attr->val;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
 
   /* Check length first */
   if (igraph_vector_size(v) != igraph_vcount(graph)) {
@@ -3743,7 +3883,7 @@ int igraph_cattribute_VAB_setv(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *val=&attr->val;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
 
   /* Check length first */
   if (igraph_vector_bool_size(v) != igraph_vcount(graph)) {
@@ -3810,7 +3950,7 @@ int igraph_cattribute_VAS_setv(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *val=&attr->val;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   /* Check length first */
   if (igraph_strvector_size(sv) != igraph_vcount(graph)) {
@@ -3876,7 +4016,7 @@ int igraph_cattribute_EAN_setv(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *eal=&attr->eal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
 
   /* Check length first */
   if (igraph_vector_size(v) != igraph_ecount(graph)) {
@@ -3942,7 +4082,7 @@ int igraph_cattribute_EAB_setv(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *eal=&attr->eal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
 
   /* Check length first */
   if (igraph_vector_bool_size(v) != igraph_ecount(graph)) {
@@ -4009,7 +4149,7 @@ int igraph_cattribute_EAS_setv(igraph_t *graph, const char *name,
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *eal=&attr->eal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   /* Check length first */
   if (igraph_strvector_size(sv) != igraph_ecount(graph)) {
@@ -4086,11 +4226,12 @@ void igraph_cattribute_remove_g(igraph_t *graph, const char *name) {
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *gal=&attr->gal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(gal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, gal, name, &j);
   
   if (l) {
     igraph_i_cattribute_free_rec(VECTOR(*gal)[j]);
     igraph_vector_ptr_remove(gal, j);
+    igraph_i_cattribute_index_reset(&attr->index[0]);
   } else {
     IGRAPH_WARNING("Cannot remove non-existent graph attribute");
   }  
@@ -4111,11 +4252,12 @@ void igraph_cattribute_remove_v(igraph_t *graph, const char *name) {
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *val=&attr->val;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(val, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, val, name, &j);
   
   if (l) {
     igraph_i_cattribute_free_rec(VECTOR(*val)[j]);
     igraph_vector_ptr_remove(val, j);
+    igraph_i_cattribute_index_reset(&attr->index[1]);
   } else {
     IGRAPH_WARNING("Cannot remove non-existent graph attribute");
   }  
@@ -4136,11 +4278,12 @@ void igraph_cattribute_remove_e(igraph_t *graph, const char *name) {
   igraph_i_cattributes_t *attr=graph->attr;
   igraph_vector_ptr_t *eal=&attr->eal;
   long int j;
-  igraph_bool_t l=igraph_i_cattribute_find(eal, name, &j);
+  igraph_bool_t l=igraph_i_cattribute_find_in(attr, eal, name, &j);
   
   if (l) {
     igraph_i_cattribute_free_rec(VECTOR(*eal)[j]);
     igraph_vector_ptr_remove(eal, j);
+    igraph_i_cattribute_index_reset(&attr->index[2]);
   } else {
     IGRAPH_WARNING("Cannot remove non-existent graph attribute");
   }  
@@ -4170,6 +4313,7 @@ void igraph_cattribute_remove_all(igraph_t *graph, igraph_bool_t g,
       igraph_i_cattribute_free_rec(VECTOR(*gal)[i]);
     }
     igraph_vector_ptr_clear(gal);
+    igraph_i_cattribute_index_reset(&attr->index[0]);
   }
   if (v) {
     igraph_vector_ptr_t *val=&attr->val;
@@ -4177,7 +4321,8 @@ void igraph_cattribute_remove_all(igraph_t *graph, igraph_bool_t g,
     for (i=0;i<n;i++) {
       igraph_i_cattribute_free_rec(VECTOR(*val)[i]);
     }
-    igraph_vector_ptr_clear(val);    
+    igraph_vector_ptr_clear(val);
+    igraph_i_cattribute_index_reset(&attr->index[1]);
   }
   if (e) {
     igraph_vector_ptr_t *eal=&attr->eal;
@@ -4186,5 +4331,6 @@ void igraph_cattribute_remove_all(igraph_t *graph, igraph_bool_t g,
       igraph_i_cattribute_free_rec(VECTOR(*eal)[i]);
     }
     igraph_vector_ptr_clear(eal);
+    igraph_i_cattribute_index_reset(&attr->index[2]);
   }
 }
@@ -33,6 +33,9 @@
 #include "igraph_interface.h"
 #include "igraph_progress.h"
 #include "igraph_interrupt_internal.h"
+#include "igraph_memory_internal.h"
+#include "igraph_msbfs_internal.h"
+#include "igraph_sssp_internal.h"
 #include "igraph_topology.h"
 #include "igraph_types_internal.h"
 #include "igraph_stack.h"
@@ -891,6 +894,424 @@ int igraph_authority_score(const igraph_t *graph, igraph_vector_t *vector,
   return igraph_i_kleinberg(graph, vector, value, scale, weights, options, 1);
 }
 
+/*
+ * Power iteration with the matrix-vector product `fun' of the ARPACK
+ * based implementations above. `x' holds the starting vector on
+ * entry and the unit length eigenvector on exit. Each step computes
+ * z=Ax, the Rayleigh quotient and the residual |Ax-lambda x|, then
+ * moves to (A+shift*I)x. A positive shift makes the iteration
+ * converge for periodic matrices too, e.g. for bipartite graphs.
+ */
+
+static int igraph_i_eigenvector_power(igraph_arpack_function_t *fun,
+				      void *extra, igraph_vector_t *x,
+				      igraph_real_t shift,
+				      igraph_real_t *value,
+				      igraph_eigenvector_power_options_t *options) {
+  long int n=igraph_vector_size(x);
+  igraph_vector_t z;
+  igraph_real_t norm=0.0, lambda=0.0, res=0.0;
+  long int i, iter;
+
+  for (i=0; i<n; i++) { norm += VECTOR(*x)[i] * VECTOR(*x)[i]; }
+  if (norm == 0) {
+    IGRAPH_ERROR("The starting vector must not be zero", IGRAPH_EINVAL);
+  }
+  igraph_vector_scale(x, 1.0/sqrt(norm));
+
+  IGRAPH_VECTOR_INIT_FINALLY(&z, n);
+
+  for (iter=0; ; iter++) {
+    IGRAPH_CHECK(fun(VECTOR(z), VECTOR(*x), (int) n, extra));
+    lambda=0.0;
+    for (i=0; i<n; i++) { lambda += VECTOR(*x)[i] * VECTOR(z)[i]; }
+    res=0.0;
+    for (i=0; i<n; i++) {
+      igraph_real_t d=VECTOR(z)[i] - lambda * VECTOR(*x)[i];
+      res += d*d;
+    }
+    res=sqrt(res);
+    if (res <= options->eps || iter >= options->niter) { break; }
+
+    IGRAPH_ALLOW_INTERRUPTION();
+
+    norm=0.0;
+    for (i=0; i<n; i++) {
+      VECTOR(z)[i] += shift * VECTOR(*x)[i];
+      norm += VECTOR(z)[i] * VECTOR(z)[i];
+    }
+    if (norm == 0) { break; }
+    norm=sqrt(norm);
+    for (i=0; i<n; i++) { VECTOR(*x)[i] = VECTOR(z)[i] / norm; }
+  }
+
+  options->iterations=(igraph_integer_t) iter;
+  options->residual=res;
+  if (value) { *value=lambda; }
+
+  igraph_vector_destroy(&z);
+  IGRAPH_FINALLY_CLEAN(1);
+
+  if (res > options->eps) {
+    IGRAPH_WARNING("Power iteration did not converge");
+  }
+
+  return 0;
+}
+
+/* Common argument checks and the starting vector of the power
+   iteration based functions. Returns with `*special' set if there
+   are no edges or all weights are zero; there is nothing to iterate
+   then. */
+
+static int igraph_i_eigenvector_power_start(const igraph_t *graph,
+				    igraph_vector_t *x,
+				    const igraph_vector_t *weights,
+				    const igraph_vector_t *start,
+				    igraph_neimode_t mode,
+				    igraph_bool_t *special) {
+  long int no_of_nodes=igraph_vcount(graph);
+  long int i;
+
+  *special = igraph_ecount(graph) == 0;
+  if (weights) {
+    if (igraph_vector_size(weights) != igraph_ecount(graph)) {
+      IGRAPH_ERROR("Invalid length of weights vector", IGRAPH_EINVAL);
+    }
+    if (igraph_ecount(graph) > 0) {
+      igraph_real_t min, max;
+      IGRAPH_CHECK(igraph_vector_minmax(weights, &min, &max));
+      if (min < 0) {
+	IGRAPH_ERROR("Power iteration needs non-negative weights",
+		     IGRAPH_EINVAL);
+      }
+      if (max == 0) { *special=1; }
+    }
+  }
+
+  if (start) {
+    if (igraph_vector_size(start) != no_of_nodes) {
+      IGRAPH_ERROR("Invalid length of starting vector", IGRAPH_EINVAL);
+    }
+    IGRAPH_CHECK(igraph_vector_update(x, start));
+  } else {
+    IGRAPH_CHECK(igraph_strength(graph, x, igraph_vss_all(), mode,
+				 IGRAPH_LOOPS, weights));
+    for (i=0; i<no_of_nodes; i++) {
+      if (VECTOR(*x)[i] == 0) { VECTOR(*x)[i] = 1.0; }
+    }
+  }
+
+  return 0;
+}
+
+/* Scales the result the same way as the ARPACK based functions */
+
+static void igraph_i_eigenvector_power_scale(igraph_vector_t *vector,
+					     igraph_bool_t scale) {
+  long int i, n=igraph_vector_size(vector);
+  igraph_real_t amax=0;
+
+  for (i=0; i<n; i++) {
+    if (VECTOR(*vector)[i] < 0) { VECTOR(*vector)[i] = 0; }
+    if (VECTOR(*vector)[i] > amax) { amax=VECTOR(*vector)[i]; }
+  }
+  if (scale && amax != 0) {
+    igraph_vector_scale(vector, 1/amax);
+  }
+}
+
+/**
+ * \function igraph_eigenvector_centrality_power
+ * Eigenvector centrality with a warm-started power iteration
+ * 
+ * Calculates the same scores as \ref igraph_eigenvector_centrality(),
+ * but with a power iteration that can start from a given vector,
+ * typically the result of a previous call on a slightly different
+ * graph. From such a starting vector only a few iterations are
+ * needed, while ARPACK always runs its complete restarted Lanczos
+ * or Arnoldi iteration.
+ *
+ * </para><para>
+ * The iteration multiplies with the adjacency matrix plus the
+ * identity matrix. This does not change the eigenvectors, but makes
+ * the iteration converge on bipartite graphs and other periodic
+ * cases as well. It stops when the residual, the Euclidean norm of
+ * <code>A x - value x</code> for the unit length vector
+ * <code>x</code>, is at most the <code>eps</code> member of \p
+ * options, or after <code>niter</code> iterations. A warning is
+ * given in the latter case.
+ *
+ * \param graph The input graph. It might be directed.
+ * \param vector Pointer to an initialized vector, the result is
+ *     stored here. It can be a null pointer, then it is ignored.
+ * \param value If not a null pointer, then the eigenvalue
+ *     corresponding to the found eigenvector is stored here.
+ * \param directed Boolean scalar, whether to consider edge directions
+ *     in a directed graph. It is ignored for undirected graphs.
+ * \param scale If not zero then the result will be scaled such that
+ *     the maximum centrality is one, otherwise it has unit length.
+ * \param weights A null pointer (=no edge weights), or a vector
+ *     giving the weights of the edges. Weights must not be negative.
+ * \param start The starting vector, or a null pointer to start from
+ *     the degrees (strengths) of the vertices, as ARPACK does. Its
+ *     scale does not matter, but it must not be zero.
+ * \param options The iteration limit and tolerance, see \ref
+ *     igraph_eigenvector_power_options_t. The number of iterations
+ *     and the residual reached are stored here as well. If a null
+ *     pointer is given, at most 1000 iterations are done with
+ *     tolerance 1e-10.
+ * \return Error code.
+ * 
+ * Time complexity: O(|V|+|E|) per iteration.
+ *
+ * \sa \ref igraph_eigenvector_centrality() for the ARPACK based
+ * implementation.
+ */
+
+int igraph_eigenvector_centrality_power(const igraph_t *graph,
+				igraph_vector_t *vector,
+				igraph_real_t *value,
+				igraph_bool_t directed, igraph_bool_t scale,
+				const igraph_vector_t *weights,
+				const igraph_vector_t *start,
+				igraph_eigenvector_power_options_t *options) {
+  long int no_of_nodes=igraph_vcount(graph);
+  igraph_eigenvector_power_options_t defopts = { 1000, 1e-10, 0, 0.0 };
+  igraph_vector_t x;
+  igraph_bool_t special;
+  igraph_real_t lambda=0;
+
+  if (!options) { options=&defopts; }
+
+  directed = directed && igraph_is_directed(graph);
+
+  IGRAPH_VECTOR_INIT_FINALLY(&x, no_of_nodes);
+  IGRAPH_CHECK(igraph_i_eigenvector_power_start(graph, &x, weights, start,
+				    directed ? IGRAPH_IN : IGRAPH_ALL,
+				    &special));
+  options->iterations=0;
+  options->residual=0.0;
+
+  if (special) {
+    /* No edges or all weights are zero, like in the ARPACK version */
+    igraph_vector_fill(&x, 1.0);
+  } else if (directed) {
+    igraph_bool_t dag;
+    IGRAPH_CHECK(igraph_is_dag(graph, &dag));
+    if (dag) {
+      IGRAPH_WARNING("graph is directed and acyclic; eigenvector centralities "
+		     "will be zeros");
+      igraph_vector_null(&x);
+    } else if (!weights) {
+      igraph_adjlist_t adjlist;
+      IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_IN));
+      IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+      IGRAPH_CHECK(igraph_i_eigenvector_power(igraph_i_eigenvector_centrality,
+					      &adjlist, &x, 1.0, &lambda,
+					      options));
+      igraph_adjlist_destroy(&adjlist);
+      IGRAPH_FINALLY_CLEAN(1);
+    } else {
+      igraph_inclist_t inclist;
+      igraph_i_eigenvector_centrality_t data={ graph, &inclist, weights };
+      IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_IN));
+      IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+      IGRAPH_CHECK(igraph_i_eigenvector_power(igraph_i_eigenvector_centrality2,
+					      &data, &x, 1.0, &lambda,
+					      options));
+      igraph_inclist_destroy(&inclist);
+      IGRAPH_FINALLY_CLEAN(1);
+    }
+  } else if (!weights) {
+    igraph_adjlist_t adjlist;
+    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+    IGRAPH_CHECK(igraph_i_eigenvector_centrality_loop(&adjlist));
+    IGRAPH_CHECK(igraph_i_eigenvector_power(igraph_i_eigenvector_centrality,
+					    &adjlist, &x, 1.0, &lambda,
+					    options));
+    igraph_adjlist_destroy(&adjlist);
+    IGRAPH_FINALLY_CLEAN(1);
+  } else {
+    igraph_inclist_t inclist;
+    igraph_i_eigenvector_centrality_t data={ graph, &inclist, weights };
+    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_ALL));
+    IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+    IGRAPH_CHECK(igraph_inclist_remove_duplicate(graph, &inclist));
+    IGRAPH_CHECK(igraph_i_eigenvector_power(igraph_i_eigenvector_centrality2,
+					    &data, &x, 1.0, &lambda,
+					    options));
+    igraph_inclist_destroy(&inclist);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
+
+  if (value) { *value=lambda; }
+  if (vector) {
+    IGRAPH_CHECK(igraph_vector_update(vector, &x));
+    igraph_i_eigenvector_power_scale(vector, scale);
+  }
+
+  igraph_vector_destroy(&x);
+  IGRAPH_FINALLY_CLEAN(1);
+
+  return 0;
+}
+
+static int igraph_i_kleinberg_power(const igraph_t *graph,
+				    igraph_vector_t *vector,
+				    igraph_real_t *value, igraph_bool_t scale,
+				    const igraph_vector_t *weights,
+				    const igraph_vector_t *start,
+				    igraph_eigenvector_power_options_t *options,
+				    int inout) {
+  long int no_of_nodes=igraph_vcount(graph);
+  igraph_neimode_t inmode= inout==0 ? IGRAPH_IN : IGRAPH_OUT;
+  igraph_neimode_t outmode= inout==0 ? IGRAPH_OUT : IGRAPH_IN;
+  igraph_eigenvector_power_options_t defopts = { 1000, 1e-10, 0, 0.0 };
+  igraph_vector_t x, tmp;
+  igraph_bool_t special;
+  igraph_real_t lambda=IGRAPH_NAN;
+
+  if (!options) { options=&defopts; }
+
+  IGRAPH_VECTOR_INIT_FINALLY(&x, no_of_nodes);
+  IGRAPH_CHECK(igraph_i_eigenvector_power_start(graph, &x, weights, start,
+						IGRAPH_ALL, &special));
+  IGRAPH_VECTOR_INIT_FINALLY(&tmp, no_of_nodes);
+  options->iterations=0;
+  options->residual=0.0;
+
+  if (special || no_of_nodes == 1) {
+    /* Same special cases as in the ARPACK version */
+    if (igraph_ecount(graph) > 0 && !special) { lambda=1.0; }
+    igraph_vector_fill(&x, 1.0);
+  } else if (!weights) {
+    igraph_adjlist_t in, out;
+    igraph_i_kleinberg_data_t extra;
+    IGRAPH_CHECK(igraph_adjlist_init(graph, &in, inmode));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &in);
+    IGRAPH_CHECK(igraph_adjlist_init(graph, &out, outmode));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &out);
+    extra.in=&in; extra.out=&out; extra.tmp=&tmp;
+    /* A*A^T is positive semidefinite, no shift is needed */
+    IGRAPH_CHECK(igraph_i_eigenvector_power(igraph_i_kleinberg_unweighted,
+					    &extra, &x, 0.0, &lambda,
+					    options));
+    igraph_adjlist_destroy(&out);
+    igraph_adjlist_destroy(&in);
+    IGRAPH_FINALLY_CLEAN(2);
+  } else {
+    igraph_inclist_t in, out;
+    igraph_i_kleinberg_data2_t extra2;
+    IGRAPH_CHECK(igraph_inclist_init(graph, &in, inmode));
+    IGRAPH_FINALLY(igraph_inclist_destroy, &in);
+    IGRAPH_CHECK(igraph_inclist_init(graph, &out, outmode));
+    IGRAPH_FINALLY(igraph_inclist_destroy, &out);
+    extra2.in=&in; extra2.out=&out; extra2.tmp=&tmp;
+    extra2.graph=graph; extra2.weights=weights;
+    IGRAPH_CHECK(igraph_i_eigenvector_power(igraph_i_kleinberg_weighted,
+					    &extra2, &x, 0.0, &lambda,
+					    options));
+    igraph_inclist_destroy(&out);
+    igraph_inclist_destroy(&in);
+    IGRAPH_FINALLY_CLEAN(2);
+  }
+
+  if (value) { *value=lambda; }
+  if (vector) {
+    IGRAPH_CHECK(igraph_vector_update(vector, &x));
+    igraph_i_eigenvector_power_scale(vector, scale);
+  }
+
+  igraph_vector_destroy(&tmp);
+  igraph_vector_destroy(&x);
+  IGRAPH_FINALLY_CLEAN(2);
+
+  return 0;
+}
+
+/**
+ * \function igraph_hub_score_power
+ * Kleinberg's hub scores with a warm-started power iteration
+ * 
+ * Calculates the same scores as \ref igraph_hub_score(), with a
+ * power iteration that can start from a previous result. See \ref
+ * igraph_eigenvector_centrality_power() for the details; no identity
+ * shift is used here, as <code>A*A^T</code> has no negative
+ * eigenvalues.
+ *
+ * \param graph The input graph. Can be directed and undirected.
+ * \param vector Pointer to an initialized vector, the result is
+ *    stored here. If a null pointer then it is ignored.
+ * \param value If not a null pointer then the eigenvalue
+ *    corresponding to the calculated eigenvector is stored here.
+ * \param scale If not zero then the result will be scaled such that
+ *     the maximum score is one, otherwise it has unit length.
+ * \param weights A null pointer (=no edge weights), or a vector
+ *     giving the weights of the edges. Weights must not be negative.
+ * \param start The starting vector, or a null pointer to start from
+ *     the degrees (strengths) of the vertices.
+ * \param options The iteration limit and tolerance, the number of
+ *     iterations and the residual reached are stored here as well.
+ *     If a null pointer is given, at most 1000 iterations are done
+ *     with tolerance 1e-10.
+ * \return Error code.
+ * 
+ * Time complexity: O(|V|+|E|) per iteration.
+ *
+ * \sa \ref igraph_authority_score_power() for the companion measure.
+ */
+
+int igraph_hub_score_power(const igraph_t *graph, igraph_vector_t *vector,
+			   igraph_real_t *value, igraph_bool_t scale,
+			   const igraph_vector_t *weights,
+			   const igraph_vector_t *start,
+			   igraph_eigenvector_power_options_t *options) {
+  return igraph_i_kleinberg_power(graph, vector, value, scale, weights,
+				  start, options, 0);
+}
+
+/**
+ * \function igraph_authority_score_power
+ * Kleinberg's authority scores with a warm-started power iteration
+ * 
+ * Calculates the same scores as \ref igraph_authority_score(), with
+ * a power iteration that can start from a previous result. See \ref
+ * igraph_hub_score_power() for the parameters.
+ *
+ * \param graph The input graph. Can be directed and undirected.
+ * \param vector Pointer to an initialized vector, the result is
+ *    stored here. If a null pointer then it is ignored.
+ * \param value If not a null pointer then the eigenvalue
+ *    corresponding to the calculated eigenvector is stored here.
+ * \param scale If not zero then the result will be scaled such that
+ *     the maximum score is one, otherwise it has unit length.
+ * \param weights A null pointer (=no edge weights), or a vector
+ *     giving the weights of the edges. Weights must not be negative.
+ * \param start The starting vector, or a null pointer to start from
+ *     the degrees (strengths) of the vertices.
+ * \param options The iteration limit and tolerance, the number of
+ *     iterations and the residual reached are stored here as well.
+ *     If a null pointer is given, at most 1000 iterations are done
+ *     with tolerance 1e-10.
+ * \return Error code.
+ * 
+ * Time complexity: O(|V|+|E|) per iteration.
+ *
+ * \sa \ref igraph_hub_score_power() for the companion measure.
+ */
+
+int igraph_authority_score_power(const igraph_t *graph,
+				 igraph_vector_t *vector,
+				 igraph_real_t *value, igraph_bool_t scale,
+				 const igraph_vector_t *weights,
+				 const igraph_vector_t *start,
+				 igraph_eigenvector_power_options_t *options) {
+  return igraph_i_kleinberg_power(graph, vector, value, scale, weights,
+				  start, options, 1);
+}
+
 typedef struct igraph_i_pagerank_data_t {
   const igraph_t *graph;
   igraph_adjlist_t *adjlist;
@@ -1522,6 +1943,577 @@ int igraph_personalized_pagerank_arpack(const igraph_t *graph, igraph_vector_t *
   return 0;
 }
 
+/* Number of personalization vectors that are iterated together by
+ * igraph_personalized_pagerank_multi(). */
+#define IGRAPH_I_PAGERANK_BLOCK 16
+
+/*
+ * Power iteration for a block of k personalized PageRank vectors.
+ * All buffers are n*k, row-major: the k values of vertex v are
+ * stored next to each other, so a single pass over the in-edges of a
+ * vertex updates all k vectors. `x' holds the reset distributions
+ * on entry (they are also the starting vectors) and the results on
+ * exit; `reset' is a copy of the reset distributions.
+ */
+
+static int igraph_i_pagerank_block(const igraph_csr_t *csr,
+				   const igraph_vector_t *weights,
+				   const igraph_vector_t *outstrength,
+				   igraph_real_t damping, long int k,
+				   const igraph_real_t *reset,
+				   igraph_real_t *x, igraph_real_t *y,
+				   igraph_real_t *tmp,
+				   const igraph_pagerank_power_options_t *options) {
+  long int no_of_nodes=csr->length;
+  igraph_real_t jump[IGRAPH_I_PAGERANK_BLOCK], diff[IGRAPH_I_PAGERANK_BLOCK];
+  igraph_real_t sum[IGRAPH_I_PAGERANK_BLOCK];
+  igraph_real_t fact=1-damping;
+  long int iter, v, c, j;
+
+  for (iter=0; iter < options->niter; iter++) {
+    igraph_real_t maxdiff=0.0;
+
+    IGRAPH_ALLOW_INTERRUPTION();
+
+    /* p(v) / outstrength(v) for every vertex and the probability of a
+     * random jump, exactly as in igraph_i_pagerank2() */
+    for (c=0; c<k; c++) { jump[c]=0.0; diff[c]=0.0; }
+    for (v=0; v<no_of_nodes; v++) {
+      const igraph_real_t *xv=x+v*k;
+      igraph_real_t *tv=tmp+v*k;
+      igraph_real_t str=VECTOR(*outstrength)[v];
+      if (str != 0) {
+	igraph_real_t inv=1.0/str;
+	for (c=0; c<k; c++) {
+	  jump[c] += xv[c] * fact;
+	  tv[c] = xv[c] * inv;
+	}
+      } else {
+	for (c=0; c<k; c++) {
+	  jump[c] += xv[c];
+	  tv[c] = 0.0;
+	}
+      }
+    }
+
+    for (v=0; v<no_of_nodes; v++) {
+      int *neis=igraph_csr_neighbors(csr, v);
+      int *incs=igraph_csr_incident(csr, v);
+      long int nlen=igraph_csr_degree(csr, v);
+      igraph_real_t *yv=y+v*k;
+      const igraph_real_t *xv=x+v*k, *rv=reset+v*k;
+      /* Sum into a local array, which does not alias `tmp'. The
+       * loops over a full block have a constant length, so that the
+       * compiler can unroll and vectorize them. */
+      for (c=0; c<IGRAPH_I_PAGERANK_BLOCK; c++) { sum[c]=0.0; }
+      for (j=0; j<nlen; j++) {
+	const igraph_real_t *tn=tmp+(long int)neis[j]*k;
+	igraph_real_t w=weights ? VECTOR(*weights)[incs[j]] : 1.0;
+	if (k == IGRAPH_I_PAGERANK_BLOCK) {
+	  for (c=0; c<IGRAPH_I_PAGERANK_BLOCK; c++) { sum[c] += w * tn[c]; }
+	} else {
+	  for (c=0; c<k; c++) { sum[c] += w * tn[c]; }
+	}
+      }
+      for (c=0; c<k; c++) {
+	yv[c] = damping * sum[c] + jump[c] * rv[c];
+	diff[c] += fabs(yv[c] - xv[c]);
+      }
+    }
+
+    for (c=0; c<k; c++) {
+      if (diff[c] > maxdiff) { maxdiff=diff[c]; }
+    }
+    memcpy(x, y, sizeof(igraph_real_t) * (size_t) (no_of_nodes * k));
+    if (maxdiff < options->eps) { break; }
+  }
+
+  return 0;
+}
+
+/**
+ * \function igraph_personalized_pagerank_multi
+ * \brief Personalized PageRank for many reset distributions at once.
+ * 
+ * Calculates one personalized PageRank vector for each column of
+ * \p reset, using a power iteration. The vectors are processed in
+ * blocks of sixteen, and all vectors of a block share a single pass
+ * over the edges of the graph in every iteration, so this is
+ * considerably faster than calling \ref igraph_personalized_pagerank()
+ * once for each reset distribution.
+ *
+ * </para><para>
+ * The random walk model is the same as for the ARPACK and PRPACK
+ * implementations of \ref igraph_personalized_pagerank(); the walker
+ * leaves vertices without outgoing edges according to the reset
+ * distribution.
+ *
+ * \param graph The graph object.
+ * \param res Pointer to an initialized matrix, the result is stored
+ *    here, one column for each column of \p reset, one row for each
+ *    vertex. It is resized as needed.
+ * \param directed Boolean, whether to consider the directedness of
+ *    the edges. This is ignored for undirected graphs.
+ * \param damping The damping factor ("d" in the original paper).
+ * \param reset Matrix with one row for each vertex, each column
+ *    gives a reset distribution. The columns are normalized to sum to
+ *    one; they must not contain negative elements and must not sum
+ *    to zero.
+ * \param weights Optional edge weights, it is either a null pointer,
+ *    then the edges are not weighted, or a vector of the same length
+ *    as the number of edges. Weights must not be negative.
+ * \param options Pointer to an \ref igraph_pagerank_power_options_t
+ *    object or a null pointer. The iteration stops after
+ *    <code>niter</code> iterations, or when the L1 norm of the
+ *    change of every vector between two iterations is less than
+ *    <code>eps</code>. If a null pointer is given, at most 1000
+ *    iterations are done with tolerance 1e-10.
+ * \return Error code:
+ *         \c IGRAPH_EINVAL, invalid damping factor, reset matrix or
+ *         weight vector.
+ * 
+ * Time complexity: O(k (|V|+|E|)) per iteration, for k reset
+ * distributions.
+ *
+ * \sa \ref igraph_personalized_pagerank_multi_vs() for computing the
+ * personalized PageRank of a set of seed vertices.
+ */
+
+int igraph_personalized_pagerank_multi(const igraph_t *graph,
+			    igraph_matrix_t *res,
+			    igraph_bool_t directed, igraph_real_t damping,
+			    const igraph_matrix_t *reset,
+			    const igraph_vector_t *weights,
+			    const igraph_pagerank_power_options_t *options) {
+  long int no_of_nodes=igraph_vcount(graph);
+  long int no_of_edges=igraph_ecount(graph);
+  long int no_of_vectors=igraph_matrix_ncol(reset);
+  igraph_pagerank_power_options_t defopts = { 1000, 1e-10 };
+  igraph_vector_t outstrength, colsum;
+  igraph_vector_t x, y, tmp, resetbuf;
+  igraph_csr_t csr;
+  long int i, v, c, first;
+
+  if (!options) { options=&defopts; }
+
+  if (damping < 0 || damping > 1) {
+    IGRAPH_ERROR("The damping factor must be in [0,1]", IGRAPH_EINVAL);
+  }
+  if (igraph_matrix_nrow(reset) != no_of_nodes) {
+    IGRAPH_ERROR("Invalid number of rows in reset matrix when calculating "
+		 "personalized PageRank scores", IGRAPH_EINVAL);
+  }
+  if (weights && igraph_vector_size(weights) != no_of_edges) {
+    IGRAPH_ERROR("Invalid length of weights vector when calculating "
+		 "PageRank scores", IGRAPH_EINVAL);
+  }
+  if (weights && no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+    IGRAPH_ERROR("Weights must not be negative", IGRAPH_EINVAL);
+  }
+  if (no_of_nodes > 0 && no_of_vectors > 0 &&
+      igraph_vector_min(&reset->data) < 0) {
+    IGRAPH_ERROR("the reset matrix must not contain negative elements",
+		 IGRAPH_EINVAL);
+  }
+
+  IGRAPH_VECTOR_INIT_FINALLY(&colsum, no_of_vectors);
+  IGRAPH_CHECK(igraph_matrix_colsum(reset, &colsum));
+  for (c=0; c<no_of_vectors; c++) {
+    if (VECTOR(colsum)[c] == 0) {
+      IGRAPH_ERROR("the sum of the elements in each column of the reset "
+		   "matrix must not be zero", IGRAPH_EINVAL);
+    }
+  }
+
+  IGRAPH_CHECK(igraph_matrix_resize(res, no_of_nodes, no_of_vectors));
+
+  directed = directed && igraph_is_directed(graph);
+
+  IGRAPH_VECTOR_INIT_FINALLY(&outstrength, no_of_nodes);
+  for (i=0; i<no_of_edges; i++) {
+    igraph_real_t w=weights ? VECTOR(*weights)[i] : 1.0;
+    VECTOR(outstrength)[(long int) IGRAPH_FROM(graph, i)] += w;
+    if (!directed) {
+      VECTOR(outstrength)[(long int) IGRAPH_TO(graph, i)] += w;
+    }
+  }
+
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, directed ? IGRAPH_IN : IGRAPH_ALL));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
+
+  i=no_of_nodes * (no_of_vectors < IGRAPH_I_PAGERANK_BLOCK ?
+		   no_of_vectors : IGRAPH_I_PAGERANK_BLOCK);
+  IGRAPH_VECTOR_INIT_FINALLY(&x, i);
+  IGRAPH_VECTOR_INIT_FINALLY(&y, i);
+  IGRAPH_VECTOR_INIT_FINALLY(&tmp, i);
+  IGRAPH_VECTOR_INIT_FINALLY(&resetbuf, i);
+
+  for (first=0; first < no_of_vectors; first += IGRAPH_I_PAGERANK_BLOCK) {
+    long int k=no_of_vectors - first;
+    if (k > IGRAPH_I_PAGERANK_BLOCK) { k=IGRAPH_I_PAGERANK_BLOCK; }
+
+    for (v=0; v<no_of_nodes; v++) {
+      for (c=0; c<k; c++) {
+	VECTOR(resetbuf)[v*k+c] = VECTOR(x)[v*k+c] =
+	  MATRIX(*reset, v, first+c) / VECTOR(colsum)[first+c];
+      }
+    }
+
+    IGRAPH_CHECK(igraph_i_pagerank_block(&csr, weights, &outstrength,
+					 damping, k, VECTOR(resetbuf),
+					 VECTOR(x), VECTOR(y), VECTOR(tmp),
+					 options));
+
+    /* Normalize, to remove the accumulated rounding errors */
+    for (c=0; c<k; c++) {
+      igraph_real_t sum=0.0;
+      for (v=0; v<no_of_nodes; v++) { sum += VECTOR(x)[v*k+c]; }
+      for (v=0; v<no_of_nodes; v++) {
+	MATRIX(*res, v, first+c) = VECTOR(x)[v*k+c] / sum;
+      }
+    }
+  }
+
+  igraph_vector_destroy(&resetbuf);
+  igraph_vector_destroy(&tmp);
+  igraph_vector_destroy(&y);
+  igraph_vector_destroy(&x);
+  igraph_csr_destroy(&csr);
+  igraph_vector_destroy(&outstrength);
+  igraph_vector_destroy(&colsum);
+  IGRAPH_FINALLY_CLEAN(7);
+
+  return 0;
+}
+
+/**
+ * \function igraph_personalized_pagerank_multi_vs
+ * \brief Personalized PageRank for many seed vertices at once.
+ * 
+ * Calculates a personalized PageRank vector for each vertex in
+ * \p seeds, the random walk always resets to the seed vertex
+ * itself. See \ref igraph_personalized_pagerank_multi() for the
+ * details.
+ *
+ * \param graph The graph object.
+ * \param res Pointer to an initialized matrix, the result is stored
+ *    here, one column for each seed vertex, in the order of \p seeds,
+ *    and one row for each vertex. It is resized as needed.
+ * \param directed Boolean, whether to consider the directedness of
+ *    the edges. This is ignored for undirected graphs.
+ * \param damping The damping factor ("d" in the original paper).
+ * \param seeds The seed vertices.
+ * \param weights Optional edge weights, a null pointer or a vector of
+ *    the same length as the number of edges.
+ * \param options Pointer to an \ref igraph_pagerank_power_options_t
+ *    object or a null pointer, see \ref
+ *    igraph_personalized_pagerank_multi().
+ * \return Error code:
+ *         \c IGRAPH_EINVVID, invalid vertex id in \p seeds.
+ *         \c IGRAPH_EINVAL, invalid damping factor or weight vector.
+ * 
+ * Time complexity: O(k (|V|+|E|)) per iteration, for k seed vertices.
+ */
+
+int igraph_personalized_pagerank_multi_vs(const igraph_t *graph,
+			    igraph_matrix_t *res,
+			    igraph_bool_t directed, igraph_real_t damping,
+			    const igraph_vs_t seeds,
+			    const igraph_vector_t *weights,
+			    const igraph_pagerank_power_options_t *options) {
+  igraph_matrix_t reset;
+  igraph_vit_t vit;
+  long int i;
+
+  IGRAPH_CHECK(igraph_vit_create(graph, seeds, &vit));
+  IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+
+  IGRAPH_MATRIX_INIT_FINALLY(&reset, igraph_vcount(graph),
+			     IGRAPH_VIT_SIZE(vit));
+  for (i=0; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit), i++) {
+    MATRIX(reset, (long int) IGRAPH_VIT_GET(vit), i) = 1.0;
+  }
+
+  IGRAPH_CHECK(igraph_personalized_pagerank_multi(graph, res, directed,
+						  damping, &reset, weights,
+						  options));
+
+  igraph_matrix_destroy(&reset);
+  igraph_vit_destroy(&vit);
+  IGRAPH_FINALLY_CLEAN(2);
+
+  return 0;
+}
+
+/*
+ * A small open addressing hash table from vertex ids to the estimate
+ * and residual of the push algorithm. It only holds the vertices
+ * that were reached, so the memory and time use of
+ * igraph_personalized_pagerank_push() do not depend on the size of
+ * the graph.
+ */
+
+typedef struct igraph_i_ppr_hash_t {
+  igraph_vector_long_t keys;	/* vertex ids, -1 marks an empty slot */
+  igraph_vector_t p;		/* PageRank estimates */
+  igraph_vector_t r;		/* residuals */
+  igraph_vector_bool_t queued;
+  long int size;
+} igraph_i_ppr_hash_t;
+
+static int igraph_i_ppr_hash_init(igraph_i_ppr_hash_t *h, long int capacity) {
+  IGRAPH_CHECK(igraph_vector_long_init(&h->keys, capacity));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &h->keys);
+  igraph_vector_long_fill(&h->keys, -1);
+  IGRAPH_VECTOR_INIT_FINALLY(&h->p, capacity);
+  IGRAPH_VECTOR_INIT_FINALLY(&h->r, capacity);
+  IGRAPH_CHECK(igraph_vector_bool_init(&h->queued, capacity));
+  IGRAPH_FINALLY_CLEAN(3);
+  h->size=0;
+  return 0;
+}
+
+static void igraph_i_ppr_hash_destroy(igraph_i_ppr_hash_t *h) {
+  igraph_vector_bool_destroy(&h->queued);
+  igraph_vector_destroy(&h->r);
+  igraph_vector_destroy(&h->p);
+  igraph_vector_long_destroy(&h->keys);
+}
+
+static long int igraph_i_ppr_hash_slot(const igraph_i_ppr_hash_t *h,
+				       long int key) {
+  unsigned long int mask=(unsigned long int) igraph_vector_long_size(&h->keys)-1;
+  unsigned long int i=((unsigned long int) key * 2654435761UL) & mask;
+  while (VECTOR(h->keys)[i] != -1 && VECTOR(h->keys)[i] != key) {
+    i=(i+1) & mask;
+  }
+  return (long int) i;
+}
+
+/* Returns the slot of `key', inserting it with zero estimate and
+   residual if needed. The table is kept at most half full. */
+
+static int igraph_i_ppr_hash_get(igraph_i_ppr_hash_t *h, long int key,
+				 long int *slot) {
+  long int i=igraph_i_ppr_hash_slot(h, key);
+
+  if (VECTOR(h->keys)[i] != key) {
+    long int capacity=igraph_vector_long_size(&h->keys);
+    if (2*(h->size+1) > capacity) {
+      igraph_i_ppr_hash_t bigger;
+      long int j;
+      IGRAPH_CHECK(igraph_i_ppr_hash_init(&bigger, 2*capacity));
+      for (j=0; j<capacity; j++) {
+	if (VECTOR(h->keys)[j] != -1) {
+	  long int k=igraph_i_ppr_hash_slot(&bigger, VECTOR(h->keys)[j]);
+	  VECTOR(bigger.keys)[k] = VECTOR(h->keys)[j];
+	  VECTOR(bigger.p)[k] = VECTOR(h->p)[j];
+	  VECTOR(bigger.r)[k] = VECTOR(h->r)[j];
+	  VECTOR(bigger.queued)[k] = VECTOR(h->queued)[j];
+	}
+      }
+      bigger.size=h->size;
+      igraph_i_ppr_hash_destroy(h);
+      *h=bigger;
+      i=igraph_i_ppr_hash_slot(h, key);
+    }
+    VECTOR(h->keys)[i] = key;
+    h->size++;
+  }
+
+  *slot=i;
+  return 0;
+}
+
+/* Adds `amount' to the residual of `vertex' and queues it */
+
+static int igraph_i_ppr_push_residual(igraph_i_ppr_hash_t *h,
+				      igraph_dqueue_long_t *q,
+				      long int vertex, igraph_real_t amount) {
+  long int slot;
+  IGRAPH_CHECK(igraph_i_ppr_hash_get(h, vertex, &slot));
+  VECTOR(h->r)[slot] += amount;
+  if (!VECTOR(h->queued)[slot]) {
+    VECTOR(h->queued)[slot] = 1;
+    IGRAPH_CHECK(igraph_dqueue_long_push(q, vertex));
+  }
+  return 0;
+}
+
+/**
+ * \function igraph_personalized_pagerank_push
+ * \brief Approximate personalized PageRank with local pushes.
+ * 
+ * Approximates the personalized PageRank of the vertices around a
+ * set of seed vertices with the push algorithm of Andersen, Chung
+ * and Lang. The algorithm keeps an estimate and a residual for every
+ * vertex it reaches. Starting with all the residual on the seeds, it
+ * repeatedly moves the (1-damping) part of a vertex's residual to
+ * its estimate, and spreads the rest over the out-neighbors of the
+ * vertex. A vertex is only processed while its residual is at least
+ * \p epsilon times its out-degree (or out-strength), so only
+ * vertices with a non-negligible share of the walk are touched and
+ * the running time does not depend on the size of the graph.
+ *
+ * </para><para>
+ * The random walk model is the same as for \ref
+ * igraph_personalized_pagerank_vs(): vertices without out-edges jump
+ * back to the seeds. The estimates never exceed the exact
+ * values. On exit the residual of every vertex is less than \p
+ * epsilon times its out-degree (out-strength); for undirected graphs
+ * this bounds the error of each estimate by \p epsilon times the
+ * degree of the vertex.
+ *
+ * </para><para>
+ * Reference: Reid Andersen, Fan Chung and Kevin Lang: Local graph
+ * partitioning using PageRank vectors. Proceedings of the 47th
+ * Annual IEEE Symposium on Foundations of Computer Science,
+ * 475--486, 2006.
+ *
+ * \param graph The graph object.
+ * \param vids Pointer to an initialized vector, the ids of the
+ *    vertices with a non-zero estimate are stored here, in decreasing
+ *    order of their estimates.
+ * \param scores Pointer to an initialized vector, the estimates of
+ *    the vertices in \p vids are stored here.
+ * \param reset_vids The seed vertices, the random walk resets to a
+ *    uniformly chosen seed. A vertex listed several times gets a
+ *    proportionally larger share.
+ * \param directed Boolean, whether to consider the directedness of
+ *    the edges. This is ignored for undirected graphs.
+ * \param damping The damping factor ("d" in the original paper).
+ * \param weights Optional edge weights, it is either a null pointer,
+ *    then the edges are not weighted, or a vector of the same length
+ *    as the number of edges. Weights must not be negative.
+ * \param epsilon The approximation threshold, must be positive.
+ * \return Error code:
+ *         \c IGRAPH_EINVVID, invalid vertex id in \p reset_vids or an
+ *         empty \p reset_vids.
+ *         \c IGRAPH_EINVAL, invalid damping factor, threshold or
+ *         weight vector.
+ * 
+ * Time complexity: O(1/(epsilon (1-damping))) pushes, each taking
+ * time proportional to the degree of the pushed vertex.
+ *
+ * \sa \ref igraph_personalized_pagerank_vs() for the exact
+ * calculation.
+ */
+
+int igraph_personalized_pagerank_push(const igraph_t *graph,
+			    igraph_vector_t *vids, igraph_vector_t *scores,
+			    const igraph_vs_t reset_vids,
+			    igraph_bool_t directed, igraph_real_t damping,
+			    const igraph_vector_t *weights,
+			    igraph_real_t epsilon) {
+  long int no_of_edges=igraph_ecount(graph);
+  igraph_neimode_t mode;
+  igraph_vector_t seeds, eids, idx;
+  igraph_i_ppr_hash_t hash;
+  igraph_dqueue_long_t q;
+  long int i, j, no_of_seeds;
+
+  if (damping < 0 || damping >= 1) {
+    IGRAPH_ERROR("The damping factor must be in [0,1)", IGRAPH_EINVAL);
+  }
+  if (epsilon <= 0) {
+    IGRAPH_ERROR("The approximation threshold must be positive",
+		 IGRAPH_EINVAL);
+  }
+  if (weights && igraph_vector_size(weights) != no_of_edges) {
+    IGRAPH_ERROR("Invalid length of weights vector when calculating "
+		 "PageRank scores", IGRAPH_EINVAL);
+  }
+  if (weights && no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+    IGRAPH_ERROR("Weights must not be negative", IGRAPH_EINVAL);
+  }
+
+  mode = directed && igraph_is_directed(graph) ? IGRAPH_OUT : IGRAPH_ALL;
+
+  IGRAPH_VECTOR_INIT_FINALLY(&seeds, 0);
+  IGRAPH_CHECK(igraph_vs_as_vector(graph, reset_vids, &seeds));
+  no_of_seeds=igraph_vector_size(&seeds);
+  if (no_of_seeds == 0) {
+    IGRAPH_ERROR("Empty set of seed vertices", IGRAPH_EINVVID);
+  }
+
+  IGRAPH_VECTOR_INIT_FINALLY(&eids, 0);
+  IGRAPH_CHECK(igraph_i_ppr_hash_init(&hash, 64));
+  IGRAPH_FINALLY(igraph_i_ppr_hash_destroy, &hash);
+  IGRAPH_CHECK(igraph_dqueue_long_init(&q, 64));
+  IGRAPH_FINALLY(igraph_dqueue_long_destroy, &q);
+
+  for (i=0; i<no_of_seeds; i++) {
+    IGRAPH_CHECK(igraph_i_ppr_push_residual(&hash, &q,
+					    (long int) VECTOR(seeds)[i],
+					    1.0/no_of_seeds));
+  }
+
+  while (!igraph_dqueue_long_empty(&q)) {
+    long int u=igraph_dqueue_long_pop(&q);
+    long int slot=igraph_i_ppr_hash_slot(&hash, u), nlen;
+    igraph_real_t str=0.0, ru;
+
+    IGRAPH_ALLOW_INTERRUPTION();
+
+    VECTOR(hash.queued)[slot]=0;
+    IGRAPH_CHECK(igraph_incident(graph, &eids, (igraph_integer_t) u, mode));
+    nlen=igraph_vector_size(&eids);
+    for (j=0; j<nlen; j++) {
+      str += weights ? VECTOR(*weights)[(long int) VECTOR(eids)[j]] : 1.0;
+    }
+
+    ru=VECTOR(hash.r)[slot];
+    if (ru < epsilon * (str > 0 ? str : 1.0)) { continue; }
+
+    VECTOR(hash.p)[slot] += (1-damping) * ru;
+    VECTOR(hash.r)[slot] = 0.0;
+
+    /* The slots are not stable while we push, do not use `slot' below */
+    if (str > 0) {
+      for (j=0; j<nlen; j++) {
+	long int e=(long int) VECTOR(eids)[j];
+	igraph_real_t w=weights ? VECTOR(*weights)[e] : 1.0;
+	if (w == 0) { continue; }
+	IGRAPH_CHECK(igraph_i_ppr_push_residual(&hash, &q,
+						IGRAPH_OTHER(graph, e, u),
+						damping * ru * w / str));
+      }
+    } else {
+      for (j=0; j<no_of_seeds; j++) {
+	IGRAPH_CHECK(igraph_i_ppr_push_residual(&hash, &q,
+						(long int) VECTOR(seeds)[j],
+						damping * ru / no_of_seeds));
+      }
+    }
+  }
+
+  /* Collect the vertices with a non-zero estimate, in decreasing
+   * order of their estimates. `eids' and `seeds' are reused for the
+   * unsorted vertex ids and estimates. */
+  igraph_vector_clear(&eids);
+  igraph_vector_clear(&seeds);
+  for (i=0; i<igraph_vector_long_size(&hash.keys); i++) {
+    if (VECTOR(hash.keys)[i] != -1 && VECTOR(hash.p)[i] > 0) {
+      IGRAPH_CHECK(igraph_vector_push_back(&eids, VECTOR(hash.keys)[i]));
+      IGRAPH_CHECK(igraph_vector_push_back(&seeds, VECTOR(hash.p)[i]));
+    }
+  }
+
+  IGRAPH_VECTOR_INIT_FINALLY(&idx, 0);
+  IGRAPH_CHECK(igraph_vector_qsort_ind(&seeds, &idx, /*descending=*/ 1));
+  IGRAPH_CHECK(igraph_vector_index(&eids, vids, &idx));
+  IGRAPH_CHECK(igraph_vector_index(&seeds, scores, &idx));
+
+  igraph_vector_destroy(&idx);
+  igraph_dqueue_long_destroy(&q);
+  igraph_i_ppr_hash_destroy(&hash);
+  igraph_vector_destroy(&eids);
+  igraph_vector_destroy(&seeds);
+  IGRAPH_FINALLY_CLEAN(5);
+
+  return 0;
+}
+
 /**
  * \ingroup structural
  * \function igraph_betweenness
@@ -1579,19 +2571,20 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
 					 igraph_bool_t directed,
 					 igraph_real_t cutoff, 
 					 const igraph_vector_t *weights, 
-					 igraph_bool_t nobigint) {
+					 igraph_bool_t nobigint,
+					 const igraph_vs_t *sources) {
 
   igraph_integer_t no_of_nodes=(igraph_integer_t) igraph_vcount(graph);
   igraph_integer_t no_of_edges=(igraph_integer_t) igraph_ecount(graph);
-  igraph_2wheap_t Q;
-  igraph_inclist_t inclist;
-  igraph_adjlist_t fathers;
-  long int source, j;
+  igraph_i_sssp_queue_t Q;
+  igraph_csr_t csr;
+  igraph_vector_int_t fstart, fathers, nfathers;
+  long int source, s, nsources=no_of_nodes, j;
   igraph_stack_t S;
   igraph_neimode_t mode= directed ? IGRAPH_OUT : IGRAPH_ALL;
   igraph_vector_t dist, nrgeo, tmpscore;
   igraph_vector_t v_tmpres, *tmpres=&v_tmpres;
-  igraph_vit_t vit;
+  igraph_vit_t vit, svit;
 
   IGRAPH_UNUSED(nobigint);
 
@@ -1602,12 +2595,28 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
     IGRAPH_ERROR("Weight vector must be positive", IGRAPH_EINVAL);
   }
 
-  IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-  IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-  IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode));  
-  IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
-  IGRAPH_CHECK(igraph_adjlist_init_empty(&fathers, no_of_nodes));
-  IGRAPH_FINALLY(igraph_adjlist_destroy, &fathers);
+  if (sources) {
+    IGRAPH_CHECK(igraph_vit_create(graph, *sources, &svit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &svit);
+    nsources=IGRAPH_VIT_SIZE(svit);
+  }
+
+  IGRAPH_CHECK(igraph_i_sssp_queue_init(&Q, no_of_nodes, weights));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q);
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, mode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
+
+  /* Vertex 'w' has room for as many fathers as its in-degree,
+     starting at 'fstart[w]' */
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&fstart, no_of_nodes+1);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&fathers, igraph_vector_int_size(&csr.adj));
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&nfathers, no_of_nodes);
+  for (j=0; j<igraph_vector_int_size(&csr.adj); j++) {
+    VECTOR(fstart)[ VECTOR(csr.adj)[j]+1 ] += 1;
+  }
+  for (j=0; j<no_of_nodes; j++) {
+    VECTOR(fstart)[j+1] += VECTOR(fstart)[j];
+  }
 
   IGRAPH_CHECK(igraph_stack_init(&S, no_of_nodes));
   IGRAPH_FINALLY(igraph_stack_destroy, &S);
@@ -1623,65 +2632,74 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
     IGRAPH_VECTOR_INIT_FINALLY(tmpres, no_of_nodes);
   }
 
-  for (source=0; source<no_of_nodes; source++) {
-    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0*source/no_of_nodes, 0);
+  for (s=0; s<nsources; s++) {
+    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0*s/nsources, 0);
     IGRAPH_ALLOW_INTERRUPTION();
 
-    igraph_2wheap_push_with_index(&Q, source, 0);
+    if (sources) {
+      source=IGRAPH_VIT_GET(svit);
+      IGRAPH_VIT_NEXT(svit);
+    } else {
+      source=s;
+    }
+
+    igraph_i_sssp_queue_clear(&Q);
+    IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, source, 0));
     VECTOR(dist)[source]=1.0;
     VECTOR(nrgeo)[source]=1;
     
-    while (!igraph_2wheap_empty(&Q)) {
-      long int minnei=igraph_2wheap_max_index(&Q);
-      igraph_real_t mindist=-igraph_2wheap_delete_max(&Q);
-      igraph_vector_int_t *neis;
+    while (!igraph_i_sssp_queue_empty(&Q)) {
+      long int minnei;
+      igraph_real_t mindist;
+      int *neis, *nei_edges;
       long int nlen;
+
+      IGRAPH_CHECK(igraph_i_sssp_queue_pop(&Q, &minnei, &mindist));
       
       igraph_stack_push(&S, minnei);
       
       if (cutoff >=0 && VECTOR(dist)[minnei] >= cutoff+1.0) { continue; }
       
       /* Now check all neighbors of 'minnei' for a shorter path */
-      neis=igraph_inclist_get(&inclist, minnei);
-      nlen=igraph_vector_int_size(neis);
+      neis=igraph_csr_neighbors(&csr, minnei);
+      nei_edges=igraph_csr_incident(&csr, minnei);
+      nlen=igraph_csr_degree(&csr, minnei);
       for (j=0; j<nlen; j++) {
-	long int edge=(long int) VECTOR(*neis)[j];
-	long int to=IGRAPH_OTHER(graph, edge, minnei);
+	long int edge=(long int) nei_edges[j];
+	long int to=(long int) neis[j];
 	igraph_real_t altdist=mindist + VECTOR(*weights)[edge];
 	igraph_real_t curdist=VECTOR(dist)[to];
 	if (curdist==0) {
 	  /* This is the first non-infinite distance */
-	  igraph_vector_int_t *v=igraph_adjlist_get(&fathers, to);
-	  igraph_vector_int_resize(v,1);
-	  VECTOR(*v)[0]=minnei;
+	  VECTOR(fathers)[ VECTOR(fstart)[to] ] = (int) minnei;
+	  VECTOR(nfathers)[to] = 1;
 	  VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
 
 	  VECTOR(dist)[to]=altdist+1.0;
-	  IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, to, altdist));
 	} else if (altdist < curdist-1) {
 	  /* This is a shorter path */
-	  igraph_vector_int_t *v=igraph_adjlist_get(&fathers, to);
-	  igraph_vector_int_resize(v,1);
-	  VECTOR(*v)[0]=minnei;
+	  VECTOR(fathers)[ VECTOR(fstart)[to] ] = (int) minnei;
+	  VECTOR(nfathers)[to] = 1;
 	  VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
 
 	  VECTOR(dist)[to]=altdist+1.0;
-	  IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_modify(&Q, to, altdist));
 	} else if (altdist == curdist-1) {
-	  igraph_vector_int_t *v=igraph_adjlist_get(&fathers, to);
-	  igraph_vector_int_push_back(v, minnei);
+	  VECTOR(fathers)[ VECTOR(fstart)[to] + 
+			   VECTOR(nfathers)[to]++ ] = (int) minnei;
 	  VECTOR(nrgeo)[to] += VECTOR(nrgeo)[minnei];
 	}
       }
       
-    } /* !igraph_2wheap_empty(&Q) */
+    } /* !igraph_i_sssp_queue_empty(&Q) */
 
     while (!igraph_stack_empty(&S)) {
       long int w=(long int) igraph_stack_pop(&S);
-      igraph_vector_int_t *fatv=igraph_adjlist_get(&fathers, w);
-      long int fatv_len=igraph_vector_int_size(fatv);
+      int *fatv=VECTOR(fathers) + VECTOR(fstart)[w];
+      long int fatv_len=VECTOR(nfathers)[w];
       for (j=0; j<fatv_len; j++) {
-	long int f=(long int) VECTOR(*fatv)[j];
+	long int f=(long int) fatv[j];
 	VECTOR(tmpscore)[f] += VECTOR(nrgeo)[f]/VECTOR(nrgeo)[w] * (1+VECTOR(tmpscore)[w]);
       }
       if (w!=source) { VECTOR(*tmpres)[w] += VECTOR(tmpscore)[w]; }
@@ -1689,10 +2707,10 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
       VECTOR(tmpscore)[w]=0;
       VECTOR(dist)[w]=0;
       VECTOR(nrgeo)[w]=0;
-      igraph_vector_int_clear(igraph_adjlist_get(&fathers, w));
+      VECTOR(nfathers)[w]=0;
     }
     
-  } /* source < no_of_nodes */
+  } /* s < nsources */
 
   if (!igraph_vs_is_all(&vids)) {
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
@@ -1724,10 +2742,17 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
   igraph_vector_destroy(&tmpscore);
   igraph_vector_destroy(&dist);
   igraph_stack_destroy(&S);
-  igraph_adjlist_destroy(&fathers);
-  igraph_inclist_destroy(&inclist);
-  igraph_2wheap_destroy(&Q);
-  IGRAPH_FINALLY_CLEAN(7);
+  igraph_vector_int_destroy(&nfathers);
+  igraph_vector_int_destroy(&fathers);
+  igraph_vector_int_destroy(&fstart);
+  igraph_csr_destroy(&csr);
+  igraph_i_sssp_queue_destroy(&Q);
+  IGRAPH_FINALLY_CLEAN(9);
+
+  if (sources) {
+    igraph_vit_destroy(&svit);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
   
   return 0;
 }
@@ -1741,6 +2766,15 @@ void igraph_i_destroy_biguints(igraph_biguint_t *p) {
   igraph_Free(p2);
 }
 
+static int igraph_i_betweenness_estimate(const igraph_t *graph,
+					 igraph_vector_t *res, 
+					 const igraph_vs_t vids,
+					 igraph_bool_t directed,
+					 igraph_real_t cutoff, 
+					 const igraph_vector_t *weights, 
+					 igraph_bool_t nobigint,
+					 const igraph_vs_t *sources);
+
 /**
  * \ingroup structural
  * \function igraph_betweenness_estimate
@@ -1794,29 +2828,48 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
 				igraph_real_t cutoff, 
 				const igraph_vector_t *weights, 
 				igraph_bool_t nobigint) {
+  return igraph_i_betweenness_estimate(graph, res, vids, directed, cutoff,
+				       weights, nobigint, 0);
+}
+
+static int igraph_i_betweenness_estimate(const igraph_t *graph,
+					 igraph_vector_t *res, 
+					 const igraph_vs_t vids,
+					 igraph_bool_t directed,
+					 igraph_real_t cutoff, 
+					 const igraph_vector_t *weights, 
+					 igraph_bool_t nobigint,
+					 const igraph_vs_t *sources) {
 
   long int no_of_nodes=igraph_vcount(graph);
-  igraph_dqueue_t q=IGRAPH_DQUEUE_NULL;
   long int *distance;
   unsigned long long int *nrgeo=0;  /* must be long long; consider grid
 				       graphs for example */
   igraph_biguint_t *big_nrgeo=0;
   double *tmpscore;
-  igraph_stack_t stack=IGRAPH_STACK_NULL;
-  long int source;
+  int *order, *pstart, *preds, *npreds;
+  long int qhead, qtail;
+  long int source, s, nsources=no_of_nodes;
   long int j, k, nneis;
-  igraph_vector_int_t *neis;
+  int *neis;
   igraph_vector_t v_tmpres, *tmpres=&v_tmpres;
-  igraph_vit_t vit;
+  igraph_vit_t vit, svit;
 
-  igraph_adjlist_t adjlist_out, adjlist_in;
-  igraph_adjlist_t *adjlist_out_p, *adjlist_in_p;
+  igraph_csr_t csr;
+  igraph_i_scratch_mark_t mark;
 
   igraph_biguint_t D, R, T;
 
   if (weights) { 
     return igraph_i_betweenness_estimate_weighted(graph, res, vids, directed,
-						cutoff, weights, nobigint);
+						cutoff, weights, nobigint,
+						sources);
+  }
+
+  if (sources) {
+    IGRAPH_CHECK(igraph_vit_create(graph, *sources, &svit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &svit);
+    nsources=IGRAPH_VIT_SIZE(svit);
   }
 
   if (!igraph_vs_is_all(&vids)) {
@@ -1830,36 +2883,40 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
   }
 
   directed=directed && igraph_is_directed(graph);
-  if (directed) {
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_out, IGRAPH_OUT));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_out);
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_in, IGRAPH_IN));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_in);
-    adjlist_out_p=&adjlist_out;
-    adjlist_in_p=&adjlist_in;
-  } else {
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_out, IGRAPH_ALL));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_out);
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_in, IGRAPH_ALL));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_in);
-    adjlist_out_p=&adjlist_out;
-    adjlist_in_p=&adjlist_in;
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, directed ? IGRAPH_OUT : 
+			       IGRAPH_ALL));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
+
+  /* All temporary arrays come from the scratch arena, so repeated
+     calls on small graphs do not need the system allocator. */
+  IGRAPH_I_SCRATCH_MARK_FINALLY(&mark);
+  nneis=igraph_vector_int_size(&csr.adj);
+  distance=igraph_i_scratch_Calloc(no_of_nodes, long int);
+  tmpscore=igraph_i_scratch_Calloc(no_of_nodes, double);
+  order=igraph_i_scratch_Calloc(no_of_nodes, int);
+  pstart=igraph_i_scratch_Calloc(no_of_nodes+1, int);
+  preds=igraph_i_scratch_Calloc(nneis, int);
+  npreds=igraph_i_scratch_Calloc(no_of_nodes, int);
+  if (!distance || !tmpscore || !order || !pstart || !preds || !npreds) {
+    IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+  }
+
+  /* The predecessors of a vertex on the shortest paths are stored in
+     a single array, vertex 'w' has room for as many predecessors as
+     its in-degree, starting at 'pstart[w]'. 'npreds[w]' is the
+     number of predecessors found so far. */
+  for (j=0; j<nneis; j++) {
+    pstart[ VECTOR(csr.adj)[j]+1 ] += 1;
   }
   for (j=0; j<no_of_nodes; j++) {
-    igraph_vector_int_clear(igraph_adjlist_get(adjlist_in_p, j));
+    pstart[j+1] += pstart[j];
   }
   
-  distance=igraph_Calloc(no_of_nodes, long int);
-  if (distance==0) {
-    IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(igraph_free, distance);
   if (nobigint) {
-    nrgeo=igraph_Calloc(no_of_nodes, unsigned long long int);
+    nrgeo=igraph_i_scratch_Calloc(no_of_nodes, unsigned long long int);
     if (nrgeo==0) {
       IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
     }
-    IGRAPH_FINALLY(igraph_free, nrgeo);
   } else {
     /* +1 is to have one containing zeros, when we free it, we stop
        at the zero */
@@ -1878,23 +2935,25 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
     IGRAPH_CHECK(igraph_biguint_init(&T));
     IGRAPH_FINALLY(igraph_biguint_destroy, &T);
   }
-  tmpscore=igraph_Calloc(no_of_nodes, double);
-  if (tmpscore==0) {
-    IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(igraph_free, tmpscore);
 
-  IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-  igraph_stack_init(&stack, no_of_nodes);
-  IGRAPH_FINALLY(igraph_stack_destroy, &stack);
-    
   /* here we go */
   
-  for (source=0; source<no_of_nodes; source++) {
-    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0*source/no_of_nodes, 0);
+  for (s=0; s<nsources; s++) {
+    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0*s/nsources, 0);
     IGRAPH_ALLOW_INTERRUPTION();
 
-    IGRAPH_CHECK(igraph_dqueue_push(&q, source));
+    if (sources) {
+      source=IGRAPH_VIT_GET(svit);
+      IGRAPH_VIT_NEXT(svit);
+    } else {
+      source=s;
+    }
+
+    /* 'order' is the BFS queue; the vertices stay in it, in the order
+       of their distance from the source, and it is traversed
+       backwards in the second phase. */
+    qhead=qtail=0;
+    order[qtail++]=(int) source;
     if (nobigint) { 
       nrgeo[source]=1;
     } else {
@@ -1902,24 +2961,21 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
     }
     distance[source]=1;
     
-    while (!igraph_dqueue_empty(&q)) {
-      long int actnode=(long int) igraph_dqueue_pop(&q);
-      IGRAPH_CHECK(igraph_stack_push(&stack, actnode));
+    while (qhead < qtail) {
+      long int actnode=order[qhead++];
 
       if (cutoff >= 0 && distance[actnode] >= cutoff+1) { continue; }
       
-      neis = igraph_adjlist_get(adjlist_out_p, actnode);
-      nneis = igraph_vector_int_size(neis);
+      neis = igraph_csr_neighbors(&csr, actnode);
+      nneis = igraph_csr_degree(&csr, actnode);
       for (j=0; j<nneis; j++) {
-        long int neighbor=(long int) VECTOR(*neis)[j];
+        long int neighbor=(long int) neis[j];
         if (distance[neighbor]==0) {
 	  distance[neighbor]=distance[actnode]+1;
-	  IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
+	  order[qtail++]=(int) neighbor;
 	} 
 	if (distance[neighbor]==distance[actnode]+1) {
-	  igraph_vector_int_t *v=igraph_adjlist_get(adjlist_in_p, 
-						    neighbor);
-	  igraph_vector_int_push_back(v, actnode);
+	  preds[ pstart[neighbor] + npreds[neighbor]++ ] = (int) actnode;
 	  if (nobigint) { 
 	    nrgeo[neighbor]+=nrgeo[actnode];
 	  } else {
@@ -1929,17 +2985,17 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
 	  }
 	}
       }
-    } /* while !igraph_dqueue_empty */
+    } /* while qhead < qtail */
     
     /* Ok, we've the distance of each node and also the number of
        shortest paths to them. Now we do an inverse search, starting
        with the farthest nodes. */
-    while (!igraph_stack_empty(&stack)) {
-      long int actnode=(long int) igraph_stack_pop(&stack);
-      neis = igraph_adjlist_get(adjlist_in_p, actnode);
-      nneis = igraph_vector_int_size(neis);
+    while (qtail > 0) {
+      long int actnode=order[--qtail];
+      neis = preds + pstart[actnode];
+      nneis = npreds[actnode];
       for (j=0; j<nneis; j++) {
-        long int neighbor=(long int) VECTOR(*neis)[j];
+        long int neighbor=(long int) neis[j];
 	if (nobigint) {
 	  tmpscore[neighbor] +=  (tmpscore[actnode]+1)*
 	    ((double)(nrgeo[neighbor]))/nrgeo[actnode];
@@ -1967,58 +3023,250 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
 	igraph_biguint_set_limb(&big_nrgeo[actnode], 0);
       }
       tmpscore[actnode]=0;
-      igraph_vector_int_clear(igraph_adjlist_get(adjlist_in_p, actnode));
+      npreds[actnode]=0;
     }
 
-  } /* for source < no_of_nodes */
+  } /* for s < nsources */
 
   IGRAPH_PROGRESS("Betweenness centrality: ", 100.0, 0);
 
-  /* clean  */
-  igraph_Free(distance);
-  if (nobigint) {
-    igraph_Free(nrgeo); 
-  } else {
-    igraph_biguint_destroy(&T);
-    igraph_biguint_destroy(&R);
-    igraph_biguint_destroy(&D);
-    IGRAPH_FINALLY_CLEAN(3);
-    igraph_i_destroy_biguints(big_nrgeo);
+  /* clean  */
+  if (!nobigint) {
+    igraph_biguint_destroy(&T);
+    igraph_biguint_destroy(&R);
+    igraph_biguint_destroy(&D);
+    igraph_i_destroy_biguints(big_nrgeo);
+    IGRAPH_FINALLY_CLEAN(4);
+  }
+  igraph_i_scratch_release(&mark);
+  igraph_csr_destroy(&csr);
+  IGRAPH_FINALLY_CLEAN(2);
+
+  /* Keep only the requested vertices */
+  if (!igraph_vs_is_all(&vids)) { 
+    IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
+
+    for (k=0, IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit);
+	 IGRAPH_VIT_NEXT(vit), k++) {
+      long int node=IGRAPH_VIT_GET(vit);
+      VECTOR(*res)[k] = VECTOR(*tmpres)[node];
+    }
+
+    igraph_vit_destroy(&vit);
+    igraph_vector_destroy(tmpres);
+    IGRAPH_FINALLY_CLEAN(2);
+  }     
+
+  /* divide by 2 for undirected graph */
+  if (!directed) {
+    nneis=igraph_vector_size(res);
+    for (j=0; j<nneis; j++) {
+      VECTOR(*res)[j] /= 2.0;
+    }
+  }
+
+  if (sources) {
+    igraph_vit_destroy(&svit);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
+
+  return 0;
+}
+
+/**
+ * \ingroup structural
+ * \function igraph_betweenness_sources
+ * \brief Betweenness contributions of the shortest paths from some sources.
+ * 
+ * </para><para>
+ * This function considers only the shortest paths that start at the
+ * given source vertices. The betweenness scores of a graph are the
+ * sum of the results for a partition of its vertex set into source
+ * sets, so the computation can be split into independent parts, e.g.
+ * to run them in parallel threads (if igraph was compiled with
+ * thread-local storage) or on different machines. Each part needs
+ * memory only for its own temporary data, and the sum does not depend
+ * on the order in which the parts are finished, if they are added
+ * up in a fixed order.
+ *
+ * </para><para>
+ * For undirected graphs the result is halved, just like for
+ * \ref igraph_betweenness(), so no further correction is needed after
+ * summing the parts.
+ *
+ * \param graph The graph object.
+ * \param res The result of the computation, a vector containing the
+ *        betweenness contributions for the specified vertices.
+ * \param vids The vertices of which the betweenness contributions
+ *        will be calculated.
+ * \param directed Logical, if true directed paths will be considered
+ *        for directed graphs. It is ignored for undirected graphs.
+ * \param sources The source vertices of the shortest paths to
+ *        consider. A vertex listed twice is counted twice.
+ * \param cutoff The maximal length of paths that will be considered.
+ *        If negative, there is no upper limit on path lengths.
+ * \param weights An optional vector containing edge weights for 
+ *        calculating weighted betweenness. Supply a null pointer here
+ *        for unweighted betweenness.
+ * \param nobigint Logical, if true, then we don't use big integers
+ *        for the calculation, see \ref igraph_betweenness().
+ * \return Error code:
+ *        \c IGRAPH_ENOMEM, not enough memory for
+ *        temporary data. 
+ *        \c IGRAPH_EINVVID, invalid vertex id passed in
+ *        \p vids or \p sources.
+ *
+ * Time complexity: O(|S||E|) for unweighted graphs,
+ * O(|S||E|log|V|) for weighted ones, |S| is the number of
+ * sources, |V| and |E| are the number of vertices and edges in the
+ * graph.
+ *
+ * \sa \ref igraph_betweenness().
+ */
+
+int igraph_betweenness_sources(const igraph_t *graph, igraph_vector_t *res,
+			       const igraph_vs_t vids, igraph_bool_t directed,
+			       const igraph_vs_t sources, igraph_real_t cutoff,
+			       const igraph_vector_t *weights, 
+			       igraph_bool_t nobigint) {
+  return igraph_i_betweenness_estimate(graph, res, vids, directed, cutoff,
+				       weights, nobigint, &sources);
+}
+
+/*
+ * Draws the source vertices for the sampling estimates of
+ * betweenness. With 'k' sources drawn uniformly, with replacement,
+ * the dependency of a score on one source is in [0, n-1], so by
+ * Hoeffding's inequality and a union bound over the 'items' reported
+ * scores, k >= ln(2*items/delta) / (2 epsilon^2) makes all of the
+ * (n/k times the sum) estimates fall within epsilon*n*(n-1) of the
+ * exact scores, with probability at least 1-delta. If this is at
+ * least the number of vertices, 'sources' is left empty, the exact
+ * calculation is cheaper then.
+ */
+
+static int igraph_i_betweenness_sample(long int no_of_nodes, long int items,
+				       igraph_real_t epsilon,
+				       igraph_real_t delta,
+				       igraph_vector_t *sources) {
+  igraph_real_t k;
+  long int i, no_of_samples;
+
+  if (epsilon <= 0) {
+    IGRAPH_ERROR("`epsilon' must be positive", IGRAPH_EINVAL);
+  }
+  if (delta <= 0 || delta >= 1) {
+    IGRAPH_ERROR("`delta' must be between zero and one", IGRAPH_EINVAL);
+  }
+
+  igraph_vector_clear(sources);
+  if (items < 1) { items=1; }
+  k=ceil(log(2.0 * items / delta) / (2.0 * epsilon * epsilon));
+  if (k >= no_of_nodes) { 
+    return 0;
+  }
+
+  no_of_samples=(long int) k;
+  IGRAPH_CHECK(igraph_vector_resize(sources, no_of_samples));
+  RNG_BEGIN();
+  for (i=0; i<no_of_samples; i++) {
+    VECTOR(*sources)[i] = RNG_INTEGER(0, no_of_nodes-1);
   }
-  igraph_Free(tmpscore);
-  
-  igraph_dqueue_destroy(&q);
-  igraph_stack_destroy(&stack);
-  IGRAPH_FINALLY_CLEAN(5);
+  RNG_END();
 
-  /* Keep only the requested vertices */
-  if (!igraph_vs_is_all(&vids)) { 
-    IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
-    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-    IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
+  return 0;
+}
 
-    for (k=0, IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit);
-	 IGRAPH_VIT_NEXT(vit), k++) {
-      long int node=IGRAPH_VIT_GET(vit);
-      VECTOR(*res)[k] = VECTOR(*tmpres)[node];
-    }
+/**
+ * \ingroup structural
+ * \function igraph_betweenness_approx
+ * \brief Approximate betweenness centrality, by sampling sources.
+ * 
+ * </para><para>
+ * Unlike \ref igraph_betweenness_estimate(), which only counts the
+ * short paths, this function approximates the true betweenness
+ * scores. It considers the shortest paths from a random sample of
+ * source vertices and scales their contributions up to the whole
+ * graph (the Brandes-Pich estimator). The size of the sample
+ * depends only on the required precision and on the number of
+ * requested scores, not on the size of the graph: with
+ * probability at least 1 - \p delta, all returned scores differ from
+ * the exact ones by at most \p epsilon times n(n-1), where n is the
+ * number of vertices. If the sample would not be smaller than the
+ * graph, the exact scores are calculated.
+ *
+ * </para><para>
+ * The error bound is absolute, so the estimates are most useful to
+ * find the vertices with high betweenness.
+ *
+ * \param graph The graph object.
+ * \param res The result of the computation, a vector containing the
+ *        approximate betweenness scores for the specified vertices.
+ * \param vids The vertices of which the betweenness scores will be
+ *        approximated.
+ * \param directed Logical, if true directed paths will be considered
+ *        for directed graphs. It is ignored for undirected graphs.
+ * \param weights An optional vector containing edge weights for 
+ *        calculating weighted betweenness. Supply a null pointer here
+ *        for unweighted betweenness.
+ * \param epsilon The allowed error, relative to the number of
+ *        ordered vertex pairs. Must be positive.
+ * \param delta The allowed probability of a larger error, it must be
+ *        between zero and one.
+ * \param samples Pointer to an integer, the number of source
+ *        vertices used is stored here, unless it is a null pointer.
+ * \return Error code:
+ *        \c IGRAPH_ENOMEM, not enough memory for
+ *        temporary data. 
+ *        \c IGRAPH_EINVVID, invalid vertex id passed in
+ *        \p vids. 
+ *        \c IGRAPH_EINVAL, invalid \p epsilon or \p delta.
+ *
+ * Time complexity: O(k|E|) for unweighted graphs, O(k|E|log|V|) for
+ * weighted ones, where k = ln(2m/delta)/(2 epsilon^2) is the number
+ * of samples, m is the number of requested scores, |V| and |E| are
+ * the number of vertices and edges in the graph.
+ *
+ * \sa \ref igraph_betweenness() for the exact scores, \ref
+ * igraph_edge_betweenness_approx() for edges.
+ */
 
-    igraph_vit_destroy(&vit);
-    igraph_vector_destroy(tmpres);
-    IGRAPH_FINALLY_CLEAN(2);
-  }     
+int igraph_betweenness_approx(const igraph_t *graph, igraph_vector_t *res,
+			      const igraph_vs_t vids, igraph_bool_t directed,
+			      const igraph_vector_t *weights, 
+			      igraph_real_t epsilon, igraph_real_t delta,
+			      igraph_integer_t *samples) {
 
-  /* divide by 2 for undirected graph */
-  if (!directed) {
-    nneis=igraph_vector_size(res);
-    for (j=0; j<nneis; j++) {
-      VECTOR(*res)[j] /= 2.0;
-    }
+  long int no_of_nodes=igraph_vcount(graph);
+  igraph_integer_t items;
+  igraph_vector_t sources;
+  long int no_of_samples;
+
+  IGRAPH_CHECK(igraph_vs_size(graph, &vids, &items));
+  IGRAPH_VECTOR_INIT_FINALLY(&sources, 0);
+  IGRAPH_CHECK(igraph_i_betweenness_sample(no_of_nodes, items, epsilon,
+					   delta, &sources));
+  no_of_samples=igraph_vector_size(&sources);
+
+  if (no_of_samples == 0) {
+    IGRAPH_CHECK(igraph_i_betweenness_estimate(graph, res, vids, directed,
+					       -1, weights, 1, 0));
+    no_of_samples=no_of_nodes;
+  } else {
+    igraph_vs_t vs=igraph_vss_vector(&sources);
+    IGRAPH_CHECK(igraph_i_betweenness_estimate(graph, res, vids, directed,
+					       -1, weights, 1, &vs));
+    igraph_vector_scale(res, (double) no_of_nodes / no_of_samples);
   }
-  
-  igraph_adjlist_destroy(&adjlist_out);
-  igraph_adjlist_destroy(&adjlist_in);
-  IGRAPH_FINALLY_CLEAN(2);
+
+  if (samples) { 
+    *samples = (igraph_integer_t) no_of_samples;
+  }
+
+  igraph_vector_destroy(&sources);
+  IGRAPH_FINALLY_CLEAN(1);
 
   return 0;
 }
@@ -2027,17 +3275,19 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
 					      igraph_vector_t *result,
 					      igraph_bool_t directed, 
 					      igraph_real_t cutoff,
-					      const igraph_vector_t *weights) {
+					      const igraph_vector_t *weights,
+					      const igraph_vs_t *sources) {
   igraph_integer_t no_of_nodes=(igraph_integer_t) igraph_vcount(graph);
   igraph_integer_t no_of_edges=(igraph_integer_t) igraph_ecount(graph);
-  igraph_2wheap_t Q;
+  igraph_i_sssp_queue_t Q;
   igraph_inclist_t inclist;
   igraph_inclist_t fathers;
   igraph_neimode_t mode= directed ? IGRAPH_OUT : IGRAPH_ALL;
   igraph_vector_t distance, tmpscore;
   igraph_vector_long_t nrgeo;
-  long int source, j;
+  long int source, s, nsources=no_of_nodes, j;
   igraph_stack_t S;
+  igraph_vit_t svit;
 
   if (igraph_vector_size(weights) != no_of_edges) {
     IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
@@ -2045,6 +3295,12 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
   if (igraph_vector_min(weights) < 0) {
     IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
   }
+
+  if (sources) {
+    IGRAPH_CHECK(igraph_vit_create(graph, *sources, &svit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &svit);
+    nsources=IGRAPH_VIT_SIZE(svit);
+  }
   
   IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode));
   IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
@@ -2056,34 +3312,44 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
   IGRAPH_CHECK(igraph_vector_long_init(&nrgeo, no_of_nodes));
   IGRAPH_FINALLY(igraph_vector_long_destroy, &nrgeo);
 
-  IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-  IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+  IGRAPH_CHECK(igraph_i_sssp_queue_init(&Q, no_of_nodes, weights));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q);
   IGRAPH_CHECK(igraph_stack_init(&S, no_of_nodes));
   IGRAPH_FINALLY(igraph_stack_destroy, &S);
 
   IGRAPH_CHECK(igraph_vector_resize(result, no_of_edges));
   igraph_vector_null(result);
 
-  for (source=0; source<no_of_nodes; source++) {
-    IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0*source/no_of_nodes, 0);
+  for (s=0; s<nsources; s++) {
+    IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0*s/nsources, 0);
     IGRAPH_ALLOW_INTERRUPTION();
 
+    if (sources) {
+      source=IGRAPH_VIT_GET(svit);
+      IGRAPH_VIT_NEXT(svit);
+    } else {
+      source=s;
+    }
+
 /*     printf("source: %li\n", source); */
     
     igraph_vector_null(&distance);
     igraph_vector_null(&tmpscore);
     igraph_vector_long_null(&nrgeo);
     
-    igraph_2wheap_push_with_index(&Q, source, 0);
+    igraph_i_sssp_queue_clear(&Q);
+    IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, source, 0));
     VECTOR(distance)[source]=1.0;
     VECTOR(nrgeo)[source]=1;
     
-    while (!igraph_2wheap_empty(&Q)) {
-      long int minnei=igraph_2wheap_max_index(&Q);
-      igraph_real_t mindist=-igraph_2wheap_delete_max(&Q);
+    while (!igraph_i_sssp_queue_empty(&Q)) {
+      long int minnei;
+      igraph_real_t mindist;
       igraph_vector_int_t *neis;
       long int nlen;
 
+      IGRAPH_CHECK(igraph_i_sssp_queue_pop(&Q, &minnei, &mindist));
+
 /*       printf("SP to %li is final, dist: %g, nrgeo: %li\n", minnei, */
 /* 	     VECTOR(distance)[minnei]-1.0, VECTOR(nrgeo)[minnei]); */
       
@@ -2107,7 +3373,7 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
 	  VECTOR(*v)[0]=edge;
 	  VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
 	  VECTOR(distance)[to]=altdist+1.0;
-	  IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, to, altdist));
 	} else if (altdist < curdist-1) {
 	  /* This is a shorter path */
 	  igraph_vector_int_t *v =igraph_inclist_get(&fathers, to);
@@ -2116,7 +3382,7 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
 	  VECTOR(*v)[0]=edge;
 	  VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
 	  VECTOR(distance)[to] = altdist+1.0;
-	  IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_modify(&Q, to, altdist));
 	} else if (altdist == curdist-1) {
 	  igraph_vector_int_t *v=igraph_inclist_get(&fathers, to);
 /* 	  printf("Found a second SP to %li (from %li)\n", to, minnei); */
@@ -2125,7 +3391,7 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
 	}
       }
 	  
-    } /* igraph_2wheap_empty(&Q) */
+    } /* !igraph_i_sssp_queue_empty(&Q) */
 
     while (!igraph_stack_empty(&S)) {
       long int w=(long int) igraph_stack_pop(&S);
@@ -2149,7 +3415,7 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
       igraph_vector_int_clear(fatv);
     }
     
-  } /* source < no_of_nodes */
+  } /* s < nsources */
 
   if (!directed || !igraph_is_directed(graph)) {
     for (j=0; j<no_of_edges; j++) {
@@ -2160,7 +3426,7 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
   IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0, 0);
 
   igraph_stack_destroy(&S);
-  igraph_2wheap_destroy(&Q);
+  igraph_i_sssp_queue_destroy(&Q);
   IGRAPH_FINALLY_CLEAN(2);
   
   igraph_inclist_destroy(&inclist);
@@ -2169,10 +3435,22 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
   igraph_vector_destroy(&tmpscore);
   igraph_vector_long_destroy(&nrgeo);
   IGRAPH_FINALLY_CLEAN(5);
+
+  if (sources) {
+    igraph_vit_destroy(&svit);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
   
   return 0;
 }
 
+static int igraph_i_edge_betweenness_estimate(const igraph_t *graph,
+					      igraph_vector_t *result,
+					      igraph_bool_t directed,
+					      igraph_real_t cutoff,
+					      const igraph_vector_t *weights,
+					      const igraph_vs_t *sources);
+
 /**
  * \ingroup structural
  * \function igraph_edge_betweenness
@@ -2254,6 +3532,16 @@ int igraph_edge_betweenness(const igraph_t *graph, igraph_vector_t *result,
 int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *result,
                                      igraph_bool_t directed, igraph_real_t cutoff,
 				     const igraph_vector_t *weights) {
+  return igraph_i_edge_betweenness_estimate(graph, result, directed, cutoff,
+					    weights, 0);
+}
+
+static int igraph_i_edge_betweenness_estimate(const igraph_t *graph,
+					      igraph_vector_t *result,
+					      igraph_bool_t directed,
+					      igraph_real_t cutoff,
+					      const igraph_vector_t *weights,
+					      const igraph_vs_t *sources) {
   long int no_of_nodes=igraph_vcount(graph);
   long int no_of_edges=igraph_ecount(graph);
   igraph_dqueue_t q=IGRAPH_DQUEUE_NULL;
@@ -2261,8 +3549,9 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
   unsigned long long int *nrgeo;
   double *tmpscore;
   igraph_stack_t stack=IGRAPH_STACK_NULL;
-  long int source;
+  long int source, s, nsources=no_of_nodes;
   long int j;
+  igraph_vit_t svit;
 
   igraph_inclist_t elist_out, elist_in;
   igraph_inclist_t *elist_out_p, *elist_in_p;
@@ -2272,7 +3561,14 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
 
   if (weights) { 
     return igraph_i_edge_betweenness_estimate_weighted(graph, result, 
-						     directed, cutoff, weights);
+						     directed, cutoff, weights,
+						     sources);
+  }
+
+  if (sources) {
+    IGRAPH_CHECK(igraph_vit_create(graph, *sources, &svit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &svit);
+    nsources=IGRAPH_VIT_SIZE(svit);
   }
 
   directed=directed && igraph_is_directed(graph);
@@ -2315,10 +3611,17 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
 
   /* here we go */
   
-  for (source=0; source<no_of_nodes; source++) {
-    IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0*source/no_of_nodes, 0);
+  for (s=0; s<nsources; s++) {
+    IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0*s/nsources, 0);
     IGRAPH_ALLOW_INTERRUPTION();
 
+    if (sources) {
+      source=IGRAPH_VIT_GET(svit);
+      IGRAPH_VIT_NEXT(svit);
+    } else {
+      source=s;
+    }
+
     memset(distance, 0, (size_t) no_of_nodes * sizeof(long int));
     memset(nrgeo, 0, (size_t) no_of_nodes*sizeof(unsigned long long int));
     memset(tmpscore, 0, (size_t) no_of_nodes*sizeof(double));
@@ -2383,7 +3686,7 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
       }
     }
     /* Ok, we've the scores for this source */
-  } /* for source <= no_of_nodes */
+  } /* for s < nsources */
   IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0, 0);
 
   /* clean and return */
@@ -2409,10 +3712,92 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
       VECTOR(*result)[j] /= 2.0;
     }
   }
+
+  if (sources) {
+    igraph_vit_destroy(&svit);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
   
   return 0;
 }
 
+/**
+ * \ingroup structural
+ * \function igraph_edge_betweenness_approx
+ * \brief Approximate betweenness centrality of the edges.
+ * 
+ * </para><para>
+ * This is the edge version of \ref igraph_betweenness_approx(): it
+ * considers the shortest paths from a random sample of source
+ * vertices, and with probability at least 1 - \p delta all returned
+ * scores differ from the exact ones by at most \p epsilon times
+ * n(n-1), where n is the number of vertices.
+ *
+ * \param graph The graph object.
+ * \param result The result of the computation, vector containing the
+ *        approximate betweenness scores for the edges.
+ * \param directed Logical, if true directed paths will be considered
+ *        for directed graphs. It is ignored for undirected graphs.
+ * \param weights An optional weight vector for weighted
+ *        betweenness. Supply a null pointer here for unweighted
+ *        betweenness.
+ * \param epsilon The allowed error, relative to the number of
+ *        ordered vertex pairs. Must be positive.
+ * \param delta The allowed probability of a larger error, it must be
+ *        between zero and one.
+ * \param samples Pointer to an integer, the number of source
+ *        vertices used is stored here, unless it is a null pointer.
+ * \return Error code:
+ *        \c IGRAPH_ENOMEM, not enough memory for
+ *        temporary data. 
+ *        \c IGRAPH_EINVAL, invalid \p epsilon or \p delta.
+ *
+ * Time complexity: O(k|E|) for unweighted graphs, O(k|E|log|V|) for
+ * weighted ones, where k = ln(2|E|/delta)/(2 epsilon^2) is the
+ * number of samples, |V| and |E| are the number of vertices and
+ * edges in the graph.
+ *
+ * \sa \ref igraph_edge_betweenness() for the exact scores.
+ */
+
+int igraph_edge_betweenness_approx(const igraph_t *graph, 
+				   igraph_vector_t *result,
+				   igraph_bool_t directed, 
+				   const igraph_vector_t *weights,
+				   igraph_real_t epsilon, igraph_real_t delta,
+				   igraph_integer_t *samples) {
+
+  long int no_of_nodes=igraph_vcount(graph);
+  igraph_vector_t sources;
+  long int no_of_samples;
+
+  IGRAPH_VECTOR_INIT_FINALLY(&sources, 0);
+  IGRAPH_CHECK(igraph_i_betweenness_sample(no_of_nodes, 
+					   igraph_ecount(graph), epsilon,
+					   delta, &sources));
+  no_of_samples=igraph_vector_size(&sources);
+
+  if (no_of_samples == 0) {
+    IGRAPH_CHECK(igraph_i_edge_betweenness_estimate(graph, result, directed,
+						    -1, weights, 0));
+    no_of_samples=no_of_nodes;
+  } else {
+    igraph_vs_t vs=igraph_vss_vector(&sources);
+    IGRAPH_CHECK(igraph_i_edge_betweenness_estimate(graph, result, directed,
+						    -1, weights, &vs));
+    igraph_vector_scale(result, (double) no_of_nodes / no_of_samples);
+  }
+
+  if (samples) { 
+    *samples = (igraph_integer_t) no_of_samples;
+  }
+
+  igraph_vector_destroy(&sources);
+  IGRAPH_FINALLY_CLEAN(1);
+
+  return 0;
+}
+
 /**
  * \ingroup structural
  * \function igraph_closeness
@@ -2492,11 +3877,11 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
   long int no_of_nodes=igraph_vcount(graph);
   long int no_of_edges=igraph_ecount(graph);
   
-  igraph_2wheap_t Q;
+  igraph_i_sssp_queue_t Q;
   igraph_vit_t vit;
   long int nodes_to_calc;
   
-  igraph_lazy_inclist_t inclist;
+  igraph_csr_t csr;
   long int i, j;
   
   igraph_vector_t dist;
@@ -2516,10 +3901,10 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
   
   nodes_to_calc=IGRAPH_VIT_SIZE(vit);
   
-  IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-  IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-  IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
-  IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
+  IGRAPH_CHECK(igraph_i_sssp_queue_init(&Q, no_of_nodes, weights));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q);
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, mode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
 
   IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
   IGRAPH_CHECK(igraph_vector_long_init(&which, no_of_nodes));
@@ -2531,19 +3916,24 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
   for (i=0; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit), i++) {
     
     long int source=IGRAPH_VIT_GET(vit);
-    igraph_2wheap_clear(&Q);
-    igraph_2wheap_push_with_index(&Q, source, 0);
+    igraph_i_sssp_queue_clear(&Q);
+    IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, source, 0));
     VECTOR(which)[source]=i+1;
     VECTOR(dist)[source]=0.0;
     nodes_reached=0;
     
-    while (!igraph_2wheap_empty(&Q)) {
-      igraph_integer_t minnei=(igraph_integer_t) igraph_2wheap_max_index(&Q);
-      igraph_real_t mindist=-igraph_2wheap_delete_max(&Q);
-      
+    while (!igraph_i_sssp_queue_empty(&Q)) {
+      long int minnei;
+      igraph_real_t mindist;
+      int *neis, *nei_edges;
+      long int nlen;
+
+      IGRAPH_CHECK(igraph_i_sssp_queue_pop(&Q, &minnei, &mindist));
+
       /* Now check all neighbors of minnei for a shorter path */
-      igraph_vector_t *neis=igraph_lazy_inclist_get(&inclist, minnei);
-      long int nlen=igraph_vector_size(neis);
+      neis=igraph_csr_neighbors(&csr, minnei);
+      nei_edges=igraph_csr_incident(&csr, minnei);
+      nlen=igraph_csr_degree(&csr, minnei);
 
       VECTOR(*res)[i] += mindist;
       nodes_reached++;
@@ -2551,23 +3941,23 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
       if (cutoff>0 && mindist>=cutoff) continue;    /* NOT break!!! */
       
       for (j=0; j<nlen; j++) {
-	long int edge=(long int) VECTOR(*neis)[j];
-	long int to=IGRAPH_OTHER(graph, edge, minnei);
+	long int edge=(long int) nei_edges[j];
+	long int to=(long int) neis[j];
 	igraph_real_t altdist=mindist+VECTOR(*weights)[edge];
 	igraph_real_t curdist=VECTOR(dist)[to];
 	if (VECTOR(which)[to] != i+1) {
 	  /* First non-infinite distance */
 	  VECTOR(which)[to]=i+1;
 	  VECTOR(dist)[to]=altdist;
-	  IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, to, altdist));
 	} else if (altdist < curdist) {
 	  /* This is a shorter path */
 	  VECTOR(dist)[to]=altdist;
-	  IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_modify(&Q, to, altdist));
 	}
       }
 
-    } /* !igraph_2wheap_empty(&Q) */
+    } /* !igraph_i_sssp_queue_empty(&Q) */
 
     /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
     VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes * (no_of_nodes-nodes_reached));
@@ -2583,8 +3973,8 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
 
   igraph_vector_long_destroy(&which);
   igraph_vector_destroy(&dist);
-  igraph_lazy_inclist_destroy(&inclist);
-  igraph_2wheap_destroy(&Q);
+  igraph_csr_destroy(&csr);
+  igraph_i_sssp_queue_destroy(&Q);
   igraph_vit_destroy(&vit);
   IGRAPH_FINALLY_CLEAN(5);
 
@@ -2657,6 +4047,26 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
  *
  * \sa Other centrality types: \ref igraph_degree(), \ref igraph_betweenness().
  */
+typedef struct igraph_i_closeness_data_t {
+  igraph_vector_t *res;
+  long int *reached;
+  long int row;
+} igraph_i_closeness_data_t;
+
+static int igraph_i_closeness_handler(long int vertex, 
+				      igraph_i_msbfs_word_t mask,
+				      long int dist, void *extra) {
+  igraph_i_closeness_data_t *data=(igraph_i_closeness_data_t*) extra;
+  IGRAPH_UNUSED(vertex);
+  while (mask) {
+    int b=IGRAPH_I_MSBFS_LOWEST(mask);
+    VECTOR(*data->res)[data->row + b] += dist;
+    data->reached[data->row + b] += 1;
+    mask &= mask-1;
+  }
+  return 0;
+}
+
 int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res, 
 		              const igraph_vs_t vids, igraph_neimode_t mode,
                               igraph_real_t cutoff,
@@ -2664,13 +4074,13 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
 			      igraph_bool_t normalized) {
 
   long int no_of_nodes=igraph_vcount(graph);
-  igraph_vector_t already_counted;
-  igraph_vector_int_t *neis;
-  long int i, j;
-  long int nodes_reached;
-  igraph_adjlist_t allneis;
-
-  igraph_dqueue_t q;
+  long int i, nsrc;
+  long int *nodes_reached;
+  igraph_csr_t allneis;
+  igraph_i_msbfs_t bfs;
+  long int sources[IGRAPH_I_MSBFS_WIDTH];
+  igraph_i_closeness_data_t data;
+  igraph_i_scratch_mark_t mark;
   
   long int nodes_to_calc;
   igraph_vit_t vit;
@@ -2690,47 +4100,42 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
     IGRAPH_ERROR("calculating closeness", IGRAPH_EINVMODE);
   }
 
-  IGRAPH_VECTOR_INIT_FINALLY(&already_counted, no_of_nodes);
-  IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
+  IGRAPH_I_SCRATCH_MARK_FINALLY(&mark);
+  nodes_reached=igraph_i_scratch_Calloc(nodes_to_calc, long int);
+  if (!nodes_reached) {
+    IGRAPH_ERROR("calculating closeness", IGRAPH_ENOMEM);
+  }
 
-  IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, mode));
-  IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
+  IGRAPH_CHECK(igraph_csr_init(graph, &allneis, mode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &allneis);
+  IGRAPH_CHECK(igraph_i_msbfs_init(&bfs, &allneis));
+  IGRAPH_FINALLY(igraph_i_msbfs_destroy, &bfs);
 
   IGRAPH_CHECK(igraph_vector_resize(res, nodes_to_calc));
   igraph_vector_null(res);
-  
-  for (IGRAPH_VIT_RESET(vit), i=0; 
-       !IGRAPH_VIT_END(vit); 
-       IGRAPH_VIT_NEXT(vit), i++) {
-    igraph_dqueue_clear(&q);
-    IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(vit)));
-    IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-    nodes_reached=1;
-    VECTOR(already_counted)[(long int)IGRAPH_VIT_GET(vit)]=i+1;
 
-    IGRAPH_PROGRESS("Closeness: ", 100.0*i/no_of_nodes, NULL);
-    IGRAPH_ALLOW_INTERRUPTION();
-    
-    while (!igraph_dqueue_empty(&q)) {
-      long int act=(long int) igraph_dqueue_pop(&q);
-      long int actdist=(long int) igraph_dqueue_pop(&q);
-      
-      VECTOR(*res)[i] += actdist;
-
-      if (cutoff>0 && actdist>=cutoff) continue;   /* NOT break!!! */
-
-      neis=igraph_adjlist_get(&allneis, act);
-      for (j=0; j<igraph_vector_int_size(neis); j++) {
-        long int neighbor=(long int) VECTOR(*neis)[j];
-        if (VECTOR(already_counted)[neighbor] == i+1) { continue; }
-        VECTOR(already_counted)[neighbor] = i+1;
-        nodes_reached++;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, actdist+1));
-      }
+  /* Searches from IGRAPH_I_MSBFS_WIDTH vertices at once; vertices
+     at the cutoff distance are reached but not expanded */
+  data.res=res;
+  data.reached=nodes_reached;
+  for (IGRAPH_VIT_RESET(vit), i=0; i<nodes_to_calc; i+=nsrc) {
+    for (nsrc=0; nsrc < IGRAPH_I_MSBFS_WIDTH && !IGRAPH_VIT_END(vit);
+	 nsrc++, IGRAPH_VIT_NEXT(vit)) {
+      sources[nsrc]=IGRAPH_VIT_GET(vit);
     }
+    data.row=i;
+
+    IGRAPH_PROGRESS("Closeness: ", 100.0*i/nodes_to_calc, NULL);
+
+    IGRAPH_CHECK(igraph_i_msbfs_run(&bfs, sources, (int) nsrc, 
+				    cutoff > 0 ? cutoff : -1,
+				    igraph_i_closeness_handler, &data));
+  }
+
+  for (i=0; i<nodes_to_calc; i++) {
     /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
-    VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes * (no_of_nodes-nodes_reached));
+    VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes * 
+			(no_of_nodes-nodes_reached[i]));
     VECTOR(*res)[i] = (no_of_nodes-1) / VECTOR(*res)[i];
   }
 
@@ -2743,15 +4148,387 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
   IGRAPH_PROGRESS("Closeness: ", 100.0, NULL);
 
   /* Clean */
-  igraph_dqueue_destroy(&q);
-  igraph_vector_destroy(&already_counted);
+  igraph_i_msbfs_destroy(&bfs);
+  igraph_csr_destroy(&allneis);
+  igraph_i_scratch_release(&mark);
   igraph_vit_destroy(&vit);
-  igraph_adjlist_destroy(&allneis);
   IGRAPH_FINALLY_CLEAN(4);
   
   return 0;
 }
 
+/*
+ * Breadth-first search from 'root' in 'csr', the distances are
+ * stored in 'dist', -1 for unreachable vertices.
+ */
+
+static void igraph_i_centrality_bfs(const igraph_csr_t *csr, long int root,
+				    long int *dist, int *queue,
+				    long int no_of_nodes) {
+  long int j, qhead=0, qtail=0;
+  for (j=0; j<no_of_nodes; j++) { dist[j] = -1; }
+  dist[root]=0;
+  queue[qtail++]=(int) root;
+  while (qhead < qtail) {
+    long int actnode=queue[qhead++];
+    int *neis=igraph_csr_neighbors(csr, actnode);
+    long int nlen=igraph_csr_degree(csr, actnode);
+    for (j=0; j<nlen; j++) {
+      long int nei=neis[j];
+      if (dist[nei] < 0) {
+	dist[nei] = dist[actnode] + 1;
+	queue[qtail++]=(int) nei;
+      }
+    }
+  }
+}
+
+/*
+ * Marks the sources whose shortest path DAG, following 'mode',
+ * contains one of the edges given as vertex pairs in 'edges'. Edge
+ * u->v is in the DAG of s if d(s,v) = d(s,u)+1, the distances from
+ * all sources to u and v come from two BFS searches in the reverse
+ * direction. If no changed edge is in the DAG of s in the old graph,
+ * and no new edge is in its DAG in the new graph, then the DAG, and
+ * so all scores derived from the paths from s, are the same.
+ *
+ * This tests DAG membership without storing the DAG of every source,
+ * which would need quadratic memory. '*count' is the number of marked
+ * sources, the search stops as soon as it exceeds 'limit'.
+ */
+
+static int igraph_i_centrality_affected(const igraph_t *graph,
+					const igraph_vector_t *edges,
+					igraph_neimode_t mode,
+					igraph_vector_bool_t *affected,
+					long int *count, long int limit) {
+  long int no_of_nodes=igraph_vcount(graph);
+  long int no_of_pairs=igraph_vector_size(edges) / 2;
+  igraph_neimode_t revmode;
+  igraph_csr_t csr;
+  long int *du, *dv;
+  int *queue;
+  long int i, s;
+  igraph_i_scratch_mark_t mark;
+
+  if (no_of_pairs == 0 || *count > limit) { return 0; }
+
+  revmode = mode == IGRAPH_OUT ? IGRAPH_IN : 
+    mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL;
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, revmode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
+
+  IGRAPH_I_SCRATCH_MARK_FINALLY(&mark);
+  du=igraph_i_scratch_Calloc(no_of_nodes, long int);
+  dv=igraph_i_scratch_Calloc(no_of_nodes, long int);
+  queue=igraph_i_scratch_Calloc(no_of_nodes, int);
+  if (!du || !dv || !queue) {
+    IGRAPH_ERROR("Cannot find affected vertices", IGRAPH_ENOMEM);
+  }
+
+  for (i=0; i<no_of_pairs && *count <= limit; i++) {
+    long int u=(long int) VECTOR(*edges)[2*i];
+    long int v=(long int) VECTOR(*edges)[2*i+1];
+    IGRAPH_ALLOW_INTERRUPTION();
+    igraph_i_centrality_bfs(&csr, u, du, queue, no_of_nodes);
+    igraph_i_centrality_bfs(&csr, v, dv, queue, no_of_nodes);
+    for (s=0; s<no_of_nodes; s++) {
+      if (du[s] < 0 && dv[s] < 0) { continue; }
+      if (!VECTOR(*affected)[s] &&
+	  ((mode != IGRAPH_IN && du[s] >= 0 && dv[s] == du[s]+1) ||
+	   (mode != IGRAPH_OUT && dv[s] >= 0 && du[s] == dv[s]+1))) {
+	VECTOR(*affected)[s] = 1;
+	(*count)++;
+      }
+    }
+  }
+
+  igraph_i_scratch_release(&mark);
+  igraph_csr_destroy(&csr);
+  IGRAPH_FINALLY_CLEAN(2);
+
+  return 0;
+}
+
+/*
+ * Collects the sources affected by removing and adding the given
+ * edges, after checking the arguments of the update functions.
+ *
+ * Finding them costs two BFS per changed edge, and updating
+ * betweenness costs two Brandes passes per affected source. So if
+ * there are at least half as many changed edges as vertices, or more
+ * than half of the vertices are affected, the update would be slower
+ * than recalculating everything, '*full' is set then instead.
+ */
+
+static int igraph_i_centrality_update_sources(const igraph_t *oldgraph,
+					      const igraph_t *newgraph,
+					      const igraph_vector_t *removed,
+					      const igraph_vector_t *added,
+					      const igraph_vector_t *res,
+					      igraph_neimode_t mode,
+					      igraph_vector_t *sources,
+					      igraph_bool_t *full) {
+  long int no_of_nodes=igraph_vcount(oldgraph);
+  long int no_of_changes, count=0, limit=no_of_nodes / 2;
+  igraph_vector_bool_t affected;
+  long int i;
+
+  if (igraph_vcount(newgraph) != no_of_nodes) {
+    IGRAPH_ERROR("The two graphs must have the same number of vertices",
+		 IGRAPH_EINVAL);
+  }
+  if (igraph_is_directed(oldgraph) != igraph_is_directed(newgraph)) {
+    IGRAPH_ERROR("The two graphs must have the same directedness",
+		 IGRAPH_EINVAL);
+  }
+  if (igraph_vector_size(res) != no_of_nodes) {
+    IGRAPH_ERROR("Invalid length of the score vector", IGRAPH_EINVAL);
+  }
+  if (igraph_vector_size(removed) % 2 != 0 ||
+      igraph_vector_size(added) % 2 != 0) {
+    IGRAPH_ERROR("Invalid (odd) length of edge vector", IGRAPH_EINVAL);
+  }
+  if (!igraph_vector_isininterval(removed, 0, no_of_nodes-1) ||
+      !igraph_vector_isininterval(added, 0, no_of_nodes-1)) {
+    IGRAPH_ERROR("Invalid vertex id in edge vector", IGRAPH_EINVVID);
+  }
+
+  igraph_vector_clear(sources);
+  no_of_changes=(igraph_vector_size(removed) + igraph_vector_size(added)) / 2;
+  if (no_of_changes > 0 && 2 * no_of_changes >= no_of_nodes) {
+    *full=1;
+    return 0;
+  }
+
+  IGRAPH_CHECK(igraph_vector_bool_init(&affected, no_of_nodes));
+  IGRAPH_FINALLY(igraph_vector_bool_destroy, &affected);
+  IGRAPH_CHECK(igraph_i_centrality_affected(oldgraph, removed, mode, 
+					    &affected, &count, limit));
+  IGRAPH_CHECK(igraph_i_centrality_affected(newgraph, added, mode,
+					    &affected, &count, limit));
+
+  *full = count > limit;
+  for (i=0; i<no_of_nodes && !*full; i++) {
+    if (VECTOR(affected)[i]) {
+      IGRAPH_CHECK(igraph_vector_push_back(sources, i));
+    }
+  }
+
+  igraph_vector_bool_destroy(&affected);
+  IGRAPH_FINALLY_CLEAN(1);
+
+  return 0;
+}
+
+/**
+ * \function igraph_betweenness_update
+ * \brief Update betweenness scores after adding and removing edges.
+ * 
+ * </para><para>
+ * Instead of recalculating the betweenness of all vertices after a
+ * few edges changed, this function only recalculates the shortest
+ * paths from those source vertices, whose shortest path tree changed.
+ * A source is affected if one of the removed edges was on one of its
+ * shortest paths in the old graph, or one of the added edges is on
+ * one of its shortest paths in the new graph. These sources are
+ * found with two breadth-first searches per changed edge, from the
+ * endpoints of the edge, instead of storing the shortest path DAG of
+ * every source, which would need quadratic memory. The
+ * contributions of the affected sources are then subtracted, based on
+ * the old graph, and added again, based on the new graph.
+ *
+ * </para><para>
+ * This is only faster than \ref igraph_betweenness() if few
+ * sources are affected. On small-world graphs almost every source may
+ * be affected by a single edge. If there are at least half as many
+ * changed edges as vertices, or more than half of the vertices are
+ * affected, then the scores are recalculated from scratch on \p
+ * newgraph instead, which limits the cost to about twice the cost of
+ * \ref igraph_betweenness().
+ *
+ * </para><para>
+ * Both the old and the new graph are needed, e.g. keep a copy of
+ * the graph (see \ref igraph_copy()) before modifying it. Only
+ * unweighted betweenness is supported. As the scores are updated
+ * with floating point arithmetic, a long series of updates may
+ * accumulate small rounding errors, recalculate the scores with
+ * \ref igraph_betweenness() from time to time.
+ *
+ * \param oldgraph The graph before the change.
+ * \param newgraph The graph after the change, it must have the same
+ *        vertices as \p oldgraph.
+ * \param removed The removed edges, as pairs of vertex ids, in the
+ *        same format as for \ref igraph_create(). 
+ * \param added The added edges, in the same format.
+ * \param res The betweenness scores of all vertices in the old
+ *        graph, as calculated by \ref igraph_betweenness(). They
+ *        will be updated in place.
+ * \param directed Logical, if true directed paths will be considered
+ *        for directed graphs. It is ignored for undirected graphs.
+ *        It must be the same as for calculating the old scores.
+ * \param updated Pointer to an integer, the number of recalculated
+ *        source vertices is stored here, unless it is a null pointer.
+ *        It is the number of vertices if the scores were recalculated
+ *        from scratch.
+ * \return Error code:
+ *        \c IGRAPH_ENOMEM, not enough memory for
+ *        temporary data. 
+ *        \c IGRAPH_EINVAL, the graphs or the vectors do not match.
+ *        \c IGRAPH_EINVVID, invalid vertex id in \p removed or
+ *        \p added.
+ *
+ * Time complexity: O(min(c+a, |V|)(|V|+|E|)), c is the number of
+ * changed edges, a is the number of affected sources, |V| and |E| are
+ * the number of vertices and edges in the graph.
+ *
+ * \sa \ref igraph_closeness_update(), \ref igraph_betweenness_sources().
+ */
+
+int igraph_betweenness_update(const igraph_t *oldgraph, 
+			      const igraph_t *newgraph,
+			      const igraph_vector_t *removed,
+			      const igraph_vector_t *added,
+			      igraph_vector_t *res, igraph_bool_t directed,
+			      igraph_integer_t *updated) {
+  igraph_vector_t sources, part;
+  igraph_vs_t vs;
+  igraph_bool_t full;
+
+  directed=directed && igraph_is_directed(oldgraph);
+
+  IGRAPH_VECTOR_INIT_FINALLY(&sources, 0);
+  IGRAPH_CHECK(igraph_i_centrality_update_sources(oldgraph, newgraph, 
+						  removed, added, res, 
+						  directed ? IGRAPH_OUT : 
+						  IGRAPH_ALL, &sources,
+						  &full));
+  if (updated) { 
+    *updated = (igraph_integer_t) (full ? igraph_vcount(newgraph) : 
+				   igraph_vector_size(&sources));
+  }
+
+  if (full) {
+    IGRAPH_CHECK(igraph_betweenness(newgraph, res, igraph_vss_all(),
+				    directed, 0, 1));
+  } else if (igraph_vector_size(&sources) > 0) {
+    vs=igraph_vss_vector(&sources);
+    IGRAPH_VECTOR_INIT_FINALLY(&part, 0);
+    IGRAPH_CHECK(igraph_betweenness_sources(oldgraph, &part, igraph_vss_all(),
+					    directed, vs, -1, 0, 1));
+    igraph_vector_sub(res, &part);
+    IGRAPH_CHECK(igraph_betweenness_sources(newgraph, &part, igraph_vss_all(),
+					    directed, vs, -1, 0, 1));
+    igraph_vector_add(res, &part);
+    igraph_vector_destroy(&part);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
+
+  igraph_vector_destroy(&sources);
+  IGRAPH_FINALLY_CLEAN(1);
+
+  return 0;
+}
+
+/**
+ * \function igraph_closeness_update
+ * \brief Update closeness scores after adding and removing edges.
+ * 
+ * </para><para>
+ * Recalculates the closeness of those vertices only, whose shortest
+ * path tree (following \p mode) changed: those that had one of the
+ * removed edges on one of their shortest paths in the old graph, or
+ * have one of the added edges on one of their shortest paths in the
+ * new graph. These are found with two breadth-first searches per
+ * changed edge. The other scores are kept. Only unweighted closeness
+ * is supported.
+ *
+ * </para><para>
+ * If there are at least half as many changed edges as vertices, or
+ * more than half of the vertices are affected, then all scores are
+ * recalculated on \p newgraph, as finding the affected vertices
+ * would cost more than that.
+ *
+ * \param oldgraph The graph before the change.
+ * \param newgraph The graph after the change, it must have the same
+ *        vertices as \p oldgraph.
+ * \param removed The removed edges, as pairs of vertex ids, in the
+ *        same format as for \ref igraph_create(). 
+ * \param added The added edges, in the same format.
+ * \param res The closeness scores of all vertices in the old graph,
+ *        as calculated by \ref igraph_closeness(). They will be
+ *        updated in place.
+ * \param mode The type of shortest paths, as for \ref
+ *        igraph_closeness(). It must be the same as for calculating
+ *        the old scores.
+ * \param normalized Logical, whether the scores are normalized, as
+ *        for \ref igraph_closeness().
+ * \param updated Pointer to an integer, the number of recalculated
+ *        scores is stored here, unless it is a null pointer.
+ *        It is the number of vertices if all scores were recalculated.
+ * \return Error code:
+ *        \c IGRAPH_ENOMEM, not enough memory for
+ *        temporary data. 
+ *        \c IGRAPH_EINVAL, the graphs or the vectors do not match, or
+ *        invalid mode.
+ *        \c IGRAPH_EINVVID, invalid vertex id in \p removed or
+ *        \p added.
+ *
+ * Time complexity: O(min(c+a, |V|)(|V|+|E|)), c is the number of
+ * changed edges, a is the number of recalculated scores, |V| and |E|
+ * are the number of vertices and edges in the graph.
+ *
+ * \sa \ref igraph_betweenness_update().
+ */
+
+int igraph_closeness_update(const igraph_t *oldgraph, 
+			    const igraph_t *newgraph,
+			    const igraph_vector_t *removed,
+			    const igraph_vector_t *added,
+			    igraph_vector_t *res, igraph_neimode_t mode,
+			    igraph_bool_t normalized,
+			    igraph_integer_t *updated) {
+  igraph_vector_t sources, part;
+  igraph_bool_t full;
+  long int i, n;
+
+  if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+    IGRAPH_ERROR("Invalid mode for closeness", IGRAPH_EINVMODE);
+  }
+  if (!igraph_is_directed(oldgraph)) { 
+    mode=IGRAPH_ALL;
+  }
+
+  IGRAPH_VECTOR_INIT_FINALLY(&sources, 0);
+  IGRAPH_CHECK(igraph_i_centrality_update_sources(oldgraph, newgraph, 
+						  removed, added, res, mode,
+						  &sources, &full));
+  n= full ? igraph_vcount(newgraph) : igraph_vector_size(&sources);
+  if (updated) { 
+    *updated = (igraph_integer_t) n;
+  }
+
+  if (full) {
+    IGRAPH_CHECK(igraph_closeness(newgraph, res, igraph_vss_all(), mode, 0,
+				  normalized));
+  } else if (n > 0) {
+    IGRAPH_VECTOR_INIT_FINALLY(&part, 0);
+    IGRAPH_CHECK(igraph_closeness(newgraph, &part, 
+				  igraph_vss_vector(&sources), mode, 0,
+				  normalized));
+    for (i=0; i<n; i++) {
+      VECTOR(*res)[ (long int) VECTOR(sources)[i] ] = VECTOR(part)[i];
+    }
+    igraph_vector_destroy(&part);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
+
+  igraph_vector_destroy(&sources);
+  IGRAPH_FINALLY_CLEAN(1);
+
+  return 0;
+}
+
 /**
  * \function igraph_centralization
  * Calculate the centralization score from the node level scores
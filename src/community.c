@@ -2401,175 +2401,58 @@ igraph_real_t igraph_i_multilevel_community_modularity(
   return result;
 }
 
-typedef struct {
-  long int from;
-  long int to;
-  long int id;
-} igraph_i_multilevel_link;
-
-int igraph_i_multilevel_link_cmp(const void *a, const void *b)
-{
-  long int r = (((igraph_i_multilevel_link*)a)->from -
-                ((igraph_i_multilevel_link*)b)->from);
-  if (r != 0) return (int) r;
-  
-  return (int) (((igraph_i_multilevel_link*)a)->to -
-		((igraph_i_multilevel_link*)b)->to);
-}
-
-/* removes multiple edges and returns new edge id's for each edge in |E|log|E| */
-int igraph_i_multilevel_simplify_multiple(igraph_t *graph, igraph_vector_t *eids) {
-  long int ecount = igraph_ecount(graph);
-  long int i, l = -1, last_from = -1, last_to = -1;
-  igraph_bool_t directed = igraph_is_directed(graph);
-  igraph_integer_t from, to;
-  igraph_vector_t edges;
-  igraph_i_multilevel_link *links;
-
-  /* Make sure there's enough space in eids to store the new edge IDs */
-  IGRAPH_CHECK(igraph_vector_resize(eids, ecount));
-
-  links = igraph_Calloc(ecount, igraph_i_multilevel_link);
-  if (links == 0) {
-    IGRAPH_ERROR("multi-level community structure detection failed", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(free, links);
-
-  for (i = 0; i < ecount; i++) {
-    igraph_edge(graph, (igraph_integer_t) i, &from, &to);
-    links[i].from = from;
-    links[i].to = to;
-    links[i].id = i;
-  }  
-
-  qsort((void*)links, (size_t) ecount, sizeof(igraph_i_multilevel_link),
-      igraph_i_multilevel_link_cmp);
-
-  IGRAPH_VECTOR_INIT_FINALLY(&edges, 0);
-  for (i = 0; i < ecount; i++) {
-    if (links[i].from == last_from && links[i].to == last_to) {
-      VECTOR(*eids)[links[i].id] = l;
-      continue;
-    }
-
-    last_from = links[i].from;
-    last_to = links[i].to;
-
-    igraph_vector_push_back(&edges, last_from);
-    igraph_vector_push_back(&edges, last_to);
-
-    l++;
-
-    VECTOR(*eids)[links[i].id] = l;
-  }
-
-  free(links);
-  IGRAPH_FINALLY_CLEAN(1);
-
-  igraph_destroy(graph);
-  IGRAPH_CHECK(igraph_create(graph, &edges, igraph_vcount(graph), directed));
-
-  igraph_vector_destroy(&edges);
-  IGRAPH_FINALLY_CLEAN(1);
-
-  return 0;
-}
-
-typedef struct {
-  long int community;
-  igraph_real_t weight;
-} igraph_i_multilevel_community_link;
-
-int igraph_i_multilevel_community_link_cmp(const void *a, const void *b)
-{
-  return (int) (((igraph_i_multilevel_community_link*)a)->community -
-		((igraph_i_multilevel_community_link*)b)->community);
-}
-
 /**
  * Given a graph, a community structure and a vertex ID, this method
  * calculates:
  *
- * - edges: the list of edge IDs that are incident on the vertex
- * - weight_all: the total weight of these edges
+ * - weight_all: the total weight of the edges incident on the vertex
  * - weight_inside: the total weight of edges that stay within the same
  *   community where the given vertex is right now, excluding loop edges
  * - weight_loop: the total weight of loop edges
- * - links_community and links_weight: together these two vectors list the
- *   communities incident on this vertex and the total weight of edges
- *   pointing to these communities
+ * - links_community and links_weight: links_community lists the
+ *   communities incident on this vertex, in the order they are found,
+ *   links_weight gives the total weight of edges pointing to each
+ *   community, indexed by community ID. Its entries must be zero
+ *   before the call, and the caller must zero them again afterwards.
+ *
+ * The incident edges are taken from the compressed adjacency list of
+ * the graph, so this does no allocation and no sorting.
  */
-int igraph_i_multilevel_community_links(const igraph_t *graph,
+static void igraph_i_multilevel_community_links(const igraph_csr_t *csr,
   const igraph_i_multilevel_community_list *communities,
-  igraph_integer_t vertex, igraph_vector_t *edges,
-  igraph_real_t *weight_all, igraph_real_t *weight_inside, igraph_real_t *weight_loop,
-  igraph_vector_t *links_community, igraph_vector_t *links_weight) {
+  long int vertex, igraph_real_t *weight_all, igraph_real_t *weight_inside,
+  igraph_real_t *weight_loop, igraph_vector_long_t *links_community,
+  igraph_vector_t *links_weight, igraph_vector_bool_t *links_seen) {
   
-  long int i, n, last = -1, c = -1;
-  igraph_real_t weight = 1;
-  long int to, to_community;
-  long int community = (long int) VECTOR(*(communities->membership))[(long int)vertex];
-  igraph_i_multilevel_community_link *links;
+  long int i, n=igraph_csr_degree(csr, vertex);
+  int *neis=igraph_csr_neighbors(csr, vertex);
+  int *incs=igraph_csr_incident(csr, vertex);
+  long int community = (long int) VECTOR(*(communities->membership))[vertex];
 
   *weight_all = *weight_inside = *weight_loop = 0;
-
-  igraph_vector_clear(links_community);
-  igraph_vector_clear(links_weight);
-
-  /* Get the list of incident edges */
-  igraph_incident(graph, edges, vertex, IGRAPH_ALL);
-
-  n = igraph_vector_size(edges);
-  links = igraph_Calloc(n, igraph_i_multilevel_community_link);
-  if (links == 0) {
-    IGRAPH_ERROR("multi-level community structure detection failed", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(igraph_free, links);
+  igraph_vector_long_clear(links_community);
 
   for (i = 0; i < n; i++) {
-    long int eidx = (long int) VECTOR(*edges)[i];
-    weight = VECTOR(*communities->weights)[eidx];
-
-    to = IGRAPH_OTHER(graph, eidx, vertex);
+    long int to = neis[i], to_community;
+    igraph_real_t weight = VECTOR(*communities->weights)[ (long int) incs[i] ];
 
     *weight_all += weight;
     if (to == vertex) {
       *weight_loop += weight;
-      
-      links[i].community = community;
-      links[i].weight = 0;
       continue;
     }
 
-    to_community = (long int)VECTOR(*(communities->membership))[to];
+    to_community = (long int) VECTOR(*(communities->membership))[to];
     if (community == to_community)
       *weight_inside += weight;
 
-    /* debug("Link %ld (C: %ld) <-> %ld (C: %ld)\n", vertex, community, to, to_community); */
-    
-    links[i].community = to_community;
-    links[i].weight = weight;
-  }
-
-  /* Sort links by community ID and merge the same */
-  qsort((void*)links, (size_t) n, sizeof(igraph_i_multilevel_community_link),
-      igraph_i_multilevel_community_link_cmp);
-  for (i = 0; i < n; i++) {
-    to_community = links[i].community;
-    if (to_community != last) {
-      igraph_vector_push_back(links_community, to_community);
-      igraph_vector_push_back(links_weight, links[i].weight);
-      last = to_community;
-      c++;
-    } else {    
-      VECTOR(*links_weight)[c] += links[i].weight;
+    if (!VECTOR(*links_seen)[to_community]) {
+      VECTOR(*links_seen)[to_community] = 1;
+      /* Cannot fail, there is room for all communities */
+      igraph_vector_long_push_back(links_community, to_community);
     }
+    VECTOR(*links_weight)[to_community] += weight;
   }
-
-  igraph_free(links);
-  IGRAPH_FINALLY_CLEAN(1);
-
-  return 0;
 }
 
 igraph_real_t igraph_i_multilevel_community_modularity_gain(
@@ -2581,55 +2464,92 @@ igraph_real_t igraph_i_multilevel_community_modularity_gain(
       communities->item[(long int)community].weight_all*weight_all/communities->weight_sum;
 }
 
-/* Shrinks communities into single vertices, keeping all the edges.
+/* Shrinks communities into single vertices, merging the edges
+ * between the same two communities and adding up their weights.
  * This method is internal because it destroys the graph in-place and
  * creates a new one -- this is fine for the multilevel community
  * detection where a copy of the original graph is used anyway.
- * The membership vector will also be rewritten by the underlying
- * igraph_membership_reindex call */
-int igraph_i_multilevel_shrink(igraph_t *graph, igraph_vector_t *membership) {
-  igraph_vector_t edges;
-  long int no_of_nodes = igraph_vcount(graph);
+ * The membership vector must contain the community IDs from zero to
+ * no_of_communities-1, e.g. after igraph_reindex_membership.
+ *
+ * The edges of the new graph are ordered by their endpoints. Instead
+ * of sorting with qsort() they are ordered by two stable counting
+ * sort passes, first on the larger then on the smaller endpoint.
+ * This is linear in the number of edges and communities, and the
+ * weights of the merged edges are added up in edge ID order. */
+int igraph_i_multilevel_shrink(igraph_t *graph, 
+			       const igraph_vector_t *membership,
+			       long int no_of_communities,
+			       igraph_vector_t *weights) {
   long int no_of_edges = igraph_ecount(graph);
   igraph_bool_t directed = igraph_is_directed(graph);
-
-  long int i;
-  igraph_eit_t eit;
-
-  if (no_of_nodes == 0)
-    return 0;
-
-  if (igraph_vector_size(membership) < no_of_nodes) {
-    IGRAPH_ERROR("cannot shrink graph, membership vector too short",
-        IGRAPH_EINVAL);
+  igraph_vector_long_t lo, hi, count, order, order2;
+  igraph_vector_t edges, newweights;
+  long int i, last_lo = -1, last_hi = -1, l = -1;
+
+  IGRAPH_CHECK(igraph_vector_long_init(&lo, no_of_edges));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &lo);
+  IGRAPH_CHECK(igraph_vector_long_init(&hi, no_of_edges));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &hi);
+  IGRAPH_CHECK(igraph_vector_long_init(&count, no_of_communities+1));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &count);
+  IGRAPH_CHECK(igraph_vector_long_init(&order, no_of_edges));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &order);
+  IGRAPH_CHECK(igraph_vector_long_init(&order2, no_of_edges));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &order2);
+  IGRAPH_VECTOR_INIT_FINALLY(&edges, 0);
+  IGRAPH_VECTOR_INIT_FINALLY(&newweights, 0);
+
+  /* The community pair of each edge, in the same orientation as
+     igraph_edge() would report it in the new graph */
+  for (i = 0; i < no_of_edges; i++) {
+    long int from = (long int) VECTOR(*membership)[ (long int) IGRAPH_FROM(graph, i) ];
+    long int to = (long int) VECTOR(*membership)[ (long int) IGRAPH_TO(graph, i) ];
+    if (!directed && from > to) { long int tmp = from; from = to; to = tmp; }
+    VECTOR(lo)[i] = from;
+    VECTOR(hi)[i] = to;
+  }
+
+  /* Counting sort on 'hi', then a stable one on 'lo' */
+  for (i = 0; i < no_of_edges; i++) { VECTOR(count)[ VECTOR(hi)[i] + 1 ] += 1; }
+  for (i = 0; i < no_of_communities; i++) { VECTOR(count)[i+1] += VECTOR(count)[i]; }
+  for (i = 0; i < no_of_edges; i++) { VECTOR(order2)[ VECTOR(count)[ VECTOR(hi)[i] ]++ ] = i; }
+  igraph_vector_long_null(&count);
+  for (i = 0; i < no_of_edges; i++) { VECTOR(count)[ VECTOR(lo)[i] + 1 ] += 1; }
+  for (i = 0; i < no_of_communities; i++) { VECTOR(count)[i+1] += VECTOR(count)[i]; }
+  for (i = 0; i < no_of_edges; i++) {
+    long int e = VECTOR(order2)[i];
+    VECTOR(order)[ VECTOR(count)[ VECTOR(lo)[e] ]++ ] = e;
+  }
+
+  /* Merge the runs of edges between the same communities */
+  for (i = 0; i < no_of_edges; i++) {
+    long int e = VECTOR(order)[i];
+    if (VECTOR(lo)[e] != last_lo || VECTOR(hi)[e] != last_hi) {
+      last_lo = VECTOR(lo)[e];
+      last_hi = VECTOR(hi)[e];
+      IGRAPH_CHECK(igraph_vector_push_back(&edges, last_lo));
+      IGRAPH_CHECK(igraph_vector_push_back(&edges, last_hi));
+      IGRAPH_CHECK(igraph_vector_push_back(&newweights, 0));
+      l++;
+    }
+    VECTOR(newweights)[l] += VECTOR(*weights)[e];
   }
 
-  IGRAPH_VECTOR_INIT_FINALLY(&edges, no_of_edges * 2);
-
-  IGRAPH_CHECK(igraph_reindex_membership(membership, 0));
-
-  /* Create the new edgelist */
-  igraph_eit_create(graph, igraph_ess_all(IGRAPH_EDGEORDER_ID), &eit);
-  IGRAPH_FINALLY(igraph_eit_destroy, &eit);
-  i = 0;
-  while (!IGRAPH_EIT_END(eit)) {
-    igraph_integer_t from, to;
-    IGRAPH_CHECK(igraph_edge(graph, IGRAPH_EIT_GET(eit), &from, &to));
-    VECTOR(edges)[i++] = VECTOR(*membership)[(long int) from];
-    VECTOR(edges)[i++] = VECTOR(*membership)[(long int) to];
-    IGRAPH_EIT_NEXT(eit);
-  }
-  igraph_eit_destroy(&eit);
-  IGRAPH_FINALLY_CLEAN(1);
-
   /* Create the new graph */
   igraph_destroy(graph);
-  no_of_nodes = (long int) igraph_vector_max(membership)+1;
-  IGRAPH_CHECK(igraph_create(graph, &edges, (igraph_integer_t) no_of_nodes,
+  IGRAPH_CHECK(igraph_create(graph, &edges, (igraph_integer_t) no_of_communities,
 			     directed));
+  IGRAPH_CHECK(igraph_vector_update(weights, &newweights));
 
+  igraph_vector_destroy(&newweights);
   igraph_vector_destroy(&edges);
-  IGRAPH_FINALLY_CLEAN(1);
+  igraph_vector_long_destroy(&order2);
+  igraph_vector_long_destroy(&order);
+  igraph_vector_long_destroy(&count);
+  igraph_vector_long_destroy(&hi);
+  igraph_vector_long_destroy(&lo);
+  IGRAPH_FINALLY_CLEAN(7);
 
   return 0;
 }
@@ -2668,9 +2588,10 @@ int igraph_i_community_multilevel_step(igraph_t *graph,
   igraph_real_t q, pass_q;
   int pass;
   igraph_bool_t changed = 0;
-  igraph_vector_t links_community;
+  igraph_csr_t csr;
+  igraph_vector_long_t links_community;
   igraph_vector_t links_weight;
-  igraph_vector_t edges;
+  igraph_vector_bool_t links_seen;
   igraph_vector_t temp_membership;
   igraph_i_multilevel_community_list communities;
 
@@ -2685,9 +2606,14 @@ int igraph_i_community_multilevel_step(igraph_t *graph,
     IGRAPH_ERROR("weights must be positive", IGRAPH_EINVAL);
 
   /* Initialize data structures */
-  IGRAPH_VECTOR_INIT_FINALLY(&links_community, 0);
-  IGRAPH_VECTOR_INIT_FINALLY(&links_weight, 0);
-  IGRAPH_VECTOR_INIT_FINALLY(&edges, 0);
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, IGRAPH_ALL));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
+  IGRAPH_CHECK(igraph_vector_long_init(&links_community, 0));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &links_community);
+  IGRAPH_CHECK(igraph_vector_long_reserve(&links_community, vcount));
+  IGRAPH_VECTOR_INIT_FINALLY(&links_weight, vcount);
+  IGRAPH_CHECK(igraph_vector_bool_init(&links_seen, vcount));
+  IGRAPH_FINALLY(igraph_vector_bool_destroy, &links_seen);
   IGRAPH_VECTOR_INIT_FINALLY(&temp_membership, vcount);
   IGRAPH_CHECK(igraph_vector_resize(membership, vcount));
  
@@ -2744,11 +2670,10 @@ int igraph_i_community_multilevel_step(igraph_t *graph,
       igraph_real_t max_weight;
       long int old_id, new_id, n;
 
-      igraph_i_multilevel_community_links(graph, &communities, 
-					  (igraph_integer_t) i, &edges,
+      igraph_i_multilevel_community_links(&csr, &communities, i,
 					  &weight_all, &weight_inside, 
 					  &weight_loop, &links_community,
-					  &links_weight);
+					  &links_weight, &links_seen);
 
       old_id = (long int)VECTOR(*(communities.membership))[i];
       new_id = old_id;
@@ -2762,14 +2687,15 @@ int igraph_i_community_multilevel_step(igraph_t *graph,
 
       /* debug("Remove %ld all: %lf Inside: %lf\n", i, -weight_all, -2*weight_inside + weight_loop); */
 
-      /* Find new community to join with the best modification gain */
+      /* Find new community to join with the best modification gain.
+         Ties are broken towards the smallest community ID. */
       max_q_gain = 0;
       max_weight = weight_inside;
-      n = igraph_vector_size(&links_community);
+      n = igraph_vector_long_size(&links_community);
 
       for (j = 0; j < n; j++) {
-        long int c = (long int) VECTOR(links_community)[j];
-        igraph_real_t w = VECTOR(links_weight)[j];
+        long int c = VECTOR(links_community)[j];
+        igraph_real_t w = VECTOR(links_weight)[c];
 
         igraph_real_t q_gain = 
 	  igraph_i_multilevel_community_modularity_gain(&communities, 
@@ -2777,11 +2703,14 @@ int igraph_i_community_multilevel_step(igraph_t *graph,
 							(igraph_integer_t) i,
 							weight_all, w);
         /* debug("Link %ld -> %ld weight: %lf gain: %lf\n", i, c, (double) w, (double) q_gain); */
-        if (q_gain > max_q_gain) {
+        if (q_gain > max_q_gain || 
+	    (q_gain == max_q_gain && q_gain > 0 && c < new_id)) {
           new_id = c;
           max_q_gain = q_gain;
           max_weight = w;
         }
+        VECTOR(links_weight)[c] = 0;
+        VECTOR(links_seen)[c] = 0;
       }
 
       /* debug("Added vertex %ld to community %ld (gain %lf).\n", i, new_id, (double) max_q_gain); */
@@ -2823,33 +2752,18 @@ int igraph_i_community_multilevel_step(igraph_t *graph,
 
   IGRAPH_CHECK(igraph_reindex_membership(membership, 0));
 
-  /* Shrink the nodes of the graph according to the present community structure
-   * and simplify the resulting graph */
-
-  /* TODO: check if we really need to copy temp_membership */
-  IGRAPH_CHECK(igraph_vector_update(&temp_membership, membership));
-  IGRAPH_CHECK(igraph_i_multilevel_shrink(graph, &temp_membership));
-  igraph_vector_destroy(&temp_membership);
-  IGRAPH_FINALLY_CLEAN(1);  
-  
-  /* Update edge weights after shrinking and simplification */
-  /* Here we reuse the edges vector as we don't need the previous contents anymore */
-  /* TODO: can we use igraph_simplify here? */
-  IGRAPH_CHECK(igraph_i_multilevel_simplify_multiple(graph, &edges));
-
-  /* We reuse the links_weight vector to store the old edge weights */
-  IGRAPH_CHECK(igraph_vector_update(&links_weight, weights));
-  igraph_vector_fill(weights, 0);
-   
-  for (i = 0; i < ecount; i++) {
-    VECTOR(*weights)[(long int)VECTOR(edges)[i]] += VECTOR(links_weight)[i];
-  }
-
+  /* Shrink the nodes of the graph according to the present community
+   * structure, merging the multiple edges and their weights */
   igraph_free(communities.item);
-  igraph_vector_destroy(&links_community);
+  igraph_vector_destroy(&temp_membership);
+  igraph_vector_bool_destroy(&links_seen);
   igraph_vector_destroy(&links_weight);
-  igraph_vector_destroy(&edges);
-  IGRAPH_FINALLY_CLEAN(4);
+  igraph_vector_long_destroy(&links_community);
+  igraph_csr_destroy(&csr);
+  IGRAPH_FINALLY_CLEAN(6);
+
+  IGRAPH_CHECK(igraph_i_multilevel_shrink(graph, membership, vcount == 0 ? 0 :
+		 (long int) igraph_vector_max(membership) + 1, weights));
   
   return 0;
 }
@@ -3007,6 +2921,647 @@ int igraph_community_multilevel(const igraph_t *graph,
   return 0;
 }
 
+/********************************************************************/
+
+/* The Leiden algorithm. It uses the compressed adjacency list of the
+ * current aggregated graph for the local moves, and the shrinking of
+ * the multilevel method above for the aggregation. The quality of a
+ * partition is
+ *
+ *   1/(2m) sum_ij (A_ij - gamma n_i n_j) delta(c_i, c_j)
+ *
+ * where 'n_i' are the node weights and 'gamma' is the resolution
+ * parameter. Moving vertex 'v' into cluster 'C' changes it by
+ * w(v, C) - gamma n_v N_C, up to a positive factor, where w(v, C) is
+ * the weight of the edges between 'v' and 'C', and N_C is the total
+ * node weight of 'C'. */
+
+/* Renumbers the clusters from zero, in the order of their first
+ * vertex. The IDs must be smaller than the number of vertices. 'map'
+ * is a work vector, its elements must be -1. */
+static long int igraph_i_community_leiden_renumber(igraph_vector_t *membership,
+						   igraph_vector_long_t *map) {
+  long int i, n = igraph_vector_size(membership), nb = 0;
+  for (i = 0; i < n; i++) {
+    long int c = (long int) VECTOR(*membership)[i];
+    if (VECTOR(*map)[c] < 0) { VECTOR(*map)[c] = nb++; }
+    VECTOR(*membership)[i] = VECTOR(*map)[c];
+  }
+  for (i = 0; i < n; i++) { VECTOR(*map)[i] = -1; }
+  return nb;
+}
+
+/* Splits the clusters into their connected components and renumbers
+ * them from zero, in the order of their first vertex. A cluster can
+ * only be disconnected if the clusters of the previous level were
+ * aggregated as they are, because the refinement merged nothing. As
+ * the parts of a cluster have no edges between them, splitting it
+ * does not decrease the quality, unless there are negative node
+ * weights or resolution. 'map' is a work vector, its elements must
+ * be -1. */
+static int igraph_i_community_leiden_split(const igraph_t *graph,
+					   igraph_vector_t *membership,
+					   long int *nb_clusters,
+					   igraph_vector_long_t *map) {
+  long int no_of_nodes = igraph_vcount(graph);
+  long int no_of_edges = igraph_ecount(graph);
+  igraph_vector_long_t parent;
+  long int i, nb = 0;
+
+  IGRAPH_CHECK(igraph_vector_long_init_seq(&parent, 0, no_of_nodes-1));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &parent);
+
+  for (i = 0; i < no_of_edges; i++) {
+    long int from = IGRAPH_FROM(graph, i), to = IGRAPH_TO(graph, i);
+    if (VECTOR(*membership)[from] != VECTOR(*membership)[to]) { continue; }
+    while (VECTOR(parent)[from] != from) {
+      from = VECTOR(parent)[from] = VECTOR(parent)[ VECTOR(parent)[from] ];
+    }
+    while (VECTOR(parent)[to] != to) {
+      to = VECTOR(parent)[to] = VECTOR(parent)[ VECTOR(parent)[to] ];
+    }
+    VECTOR(parent)[from < to ? to : from] = from < to ? from : to;
+  }
+
+  for (i = 0; i < no_of_nodes; i++) {
+    long int root = i;
+    while (VECTOR(parent)[root] != root) { root = VECTOR(parent)[root]; }
+    if (VECTOR(*map)[root] < 0) { VECTOR(*map)[root] = nb++; }
+    VECTOR(*membership)[i] = VECTOR(*map)[root];
+  }
+  for (i = 0; i < no_of_nodes; i++) { VECTOR(*map)[i] = -1; }
+  *nb_clusters = nb;
+
+  igraph_vector_long_destroy(&parent);
+  IGRAPH_FINALLY_CLEAN(1);
+
+  return 0;
+}
+
+/* Fast local moving: the vertices are taken from a queue, initially
+ * in random order. Each one goes to the cluster with the best
+ * improvement, possibly an empty one, and when it moves, its
+ * neighbors outside its new cluster are put back in the queue. So
+ * only the vertices whose neighborhood changed are visited again. */
+static int igraph_i_community_leiden_fastmovenodes(const igraph_csr_t *csr,
+  const igraph_vector_t *edge_weights, const igraph_vector_t *node_weights,
+  igraph_real_t resolution, igraph_vector_t *membership,
+  long int *nb_clusters, igraph_vector_long_t *map) {
+
+  long int n = igraph_csr_size(csr);
+  igraph_dqueue_long_t queue;
+  igraph_vector_long_t order, nb_nodes, empty, neighbor_clusters;
+  igraph_vector_t cluster_weights, edge_weights_per_cluster;
+  igraph_vector_bool_t in_queue, seen;
+  long int i, j;
+
+  IGRAPH_CHECK(igraph_dqueue_long_init(&queue, n > 0 ? n : 1));
+  IGRAPH_FINALLY(igraph_dqueue_long_destroy, &queue);
+  IGRAPH_CHECK(igraph_vector_long_init_seq(&order, 0, n-1));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &order);
+  IGRAPH_CHECK(igraph_vector_long_init(&nb_nodes, n));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &nb_nodes);
+  IGRAPH_CHECK(igraph_vector_long_init(&empty, 0));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &empty);
+  IGRAPH_CHECK(igraph_vector_long_init(&neighbor_clusters, 0));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &neighbor_clusters);
+  IGRAPH_CHECK(igraph_vector_long_reserve(&empty, n));
+  IGRAPH_CHECK(igraph_vector_long_reserve(&neighbor_clusters, n+1));
+  IGRAPH_VECTOR_INIT_FINALLY(&cluster_weights, n);
+  IGRAPH_VECTOR_INIT_FINALLY(&edge_weights_per_cluster, n);
+  IGRAPH_CHECK(igraph_vector_bool_init(&in_queue, n));
+  IGRAPH_FINALLY(igraph_vector_bool_destroy, &in_queue);
+  IGRAPH_CHECK(igraph_vector_bool_init(&seen, n));
+  IGRAPH_FINALLY(igraph_vector_bool_destroy, &seen);
+
+  for (i = 0; i < n; i++) {
+    long int c = (long int) VECTOR(*membership)[i];
+    VECTOR(cluster_weights)[c] += VECTOR(*node_weights)[i];
+    VECTOR(nb_nodes)[c] += 1;
+  }
+  /* The empty clusters are kept in a stack */
+  for (i = n-1; i >= 0; i--) {
+    if (VECTOR(nb_nodes)[i] == 0) { igraph_vector_long_push_back(&empty, i); }
+  }
+
+  IGRAPH_CHECK(igraph_vector_long_shuffle(&order));
+  for (i = 0; i < n; i++) {
+    IGRAPH_CHECK(igraph_dqueue_long_push(&queue, VECTOR(order)[i]));
+    VECTOR(in_queue)[i] = 1;
+  }
+
+  while (!igraph_dqueue_long_empty(&queue)) {
+    long int v = igraph_dqueue_long_pop(&queue);
+    long int c_old = (long int) VECTOR(*membership)[v], best = c_old;
+    igraph_real_t nw = VECTOR(*node_weights)[v], max_diff;
+    long int nlen = igraph_csr_degree(csr, v), ncand;
+    int *neis = igraph_csr_neighbors(csr, v);
+    int *incs = igraph_csr_incident(csr, v);
+
+    VECTOR(in_queue)[v] = 0;
+
+    /* Take the vertex out of its cluster */
+    VECTOR(cluster_weights)[c_old] -= nw;
+    VECTOR(nb_nodes)[c_old] -= 1;
+    if (VECTOR(nb_nodes)[c_old] == 0) {
+      igraph_vector_long_push_back(&empty, c_old);
+    }
+
+    /* The candidates: the old cluster, an empty one and the clusters
+       of the neighbors */
+    igraph_vector_long_clear(&neighbor_clusters);
+    igraph_vector_long_push_back(&neighbor_clusters, c_old);
+    VECTOR(seen)[c_old] = 1;
+    if (igraph_vector_long_size(&empty) > 0 && !VECTOR(seen)[igraph_vector_long_tail(&empty)]) {
+      igraph_vector_long_push_back(&neighbor_clusters, igraph_vector_long_tail(&empty));
+      VECTOR(seen)[igraph_vector_long_tail(&empty)] = 1;
+    }
+    for (j = 0; j < nlen; j++) {
+      long int u = neis[j], c;
+      if (u == v) { continue; }
+      c = (long int) VECTOR(*membership)[u];
+      if (!VECTOR(seen)[c]) {
+	VECTOR(seen)[c] = 1;
+	igraph_vector_long_push_back(&neighbor_clusters, c);
+      }
+      VECTOR(edge_weights_per_cluster)[c] += VECTOR(*edge_weights)[ (long int) incs[j] ];
+    }
+
+    max_diff = VECTOR(edge_weights_per_cluster)[c_old] - 
+      nw * VECTOR(cluster_weights)[c_old] * resolution;
+    ncand = igraph_vector_long_size(&neighbor_clusters);
+    for (j = 0; j < ncand; j++) {
+      long int c = VECTOR(neighbor_clusters)[j];
+      igraph_real_t diff = VECTOR(edge_weights_per_cluster)[c] - 
+	nw * VECTOR(cluster_weights)[c] * resolution;
+      if (diff > max_diff) {
+	best = c;
+	max_diff = diff;
+      }
+      VECTOR(edge_weights_per_cluster)[c] = 0;
+      VECTOR(seen)[c] = 0;
+    }
+
+    /* Put it into the best one. A cluster with no vertices is the
+       top of the stack of empty clusters. */
+    VECTOR(cluster_weights)[best] += nw;
+    if (VECTOR(nb_nodes)[best] == 0) { igraph_vector_long_pop_back(&empty); }
+    VECTOR(nb_nodes)[best] += 1;
+
+    if (best != c_old) {
+      VECTOR(*membership)[v] = best;
+      for (j = 0; j < nlen; j++) {
+	long int u = neis[j];
+	if (!VECTOR(in_queue)[u] && VECTOR(*membership)[u] != best) {
+	  IGRAPH_CHECK(igraph_dqueue_long_push(&queue, u));
+	  VECTOR(in_queue)[u] = 1;
+	}
+      }
+    }
+  }
+
+  *nb_clusters = igraph_i_community_leiden_renumber(membership, map);
+
+  igraph_vector_bool_destroy(&seen);
+  igraph_vector_bool_destroy(&in_queue);
+  igraph_vector_destroy(&edge_weights_per_cluster);
+  igraph_vector_destroy(&cluster_weights);
+  igraph_vector_long_destroy(&neighbor_clusters);
+  igraph_vector_long_destroy(&empty);
+  igraph_vector_long_destroy(&nb_nodes);
+  igraph_vector_long_destroy(&order);
+  igraph_dqueue_long_destroy(&queue);
+  IGRAPH_FINALLY_CLEAN(9);
+
+  return 0;
+}
+
+/* Refinement: within each cluster of 'membership', starting from
+ * singletons, vertices that are well connected to the rest of their
+ * cluster are merged into well connected subclusters. The subcluster
+ * is chosen randomly among the ones that do not decrease the quality,
+ * with probabilities proportional to exp(diff/beta). The refined
+ * clusters are always connected. */
+static int igraph_i_community_leiden_mergenodes(const igraph_csr_t *csr,
+  const igraph_vector_t *edge_weights, const igraph_vector_t *node_weights,
+  igraph_real_t resolution, igraph_real_t beta,
+  const igraph_vector_t *membership, long int nb_clusters,
+  igraph_vector_t *refined, long int *nb_refined,
+  igraph_vector_long_t *map) {
+
+  long int n = igraph_csr_size(csr);
+  igraph_vector_long_t order, nb_nodes, neighbor_clusters;
+  igraph_vector_t cluster_weights, refined_weights, external;
+  igraph_vector_t edge_weights_per_cluster, diffs;
+  igraph_vector_bool_t seen;
+  long int i, j;
+
+  IGRAPH_CHECK(igraph_vector_long_init_seq(&order, 0, n-1));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &order);
+  IGRAPH_CHECK(igraph_vector_long_init(&nb_nodes, n));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &nb_nodes);
+  IGRAPH_CHECK(igraph_vector_long_init(&neighbor_clusters, 0));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &neighbor_clusters);
+  IGRAPH_CHECK(igraph_vector_long_reserve(&neighbor_clusters, n));
+  IGRAPH_VECTOR_INIT_FINALLY(&cluster_weights, nb_clusters);
+  IGRAPH_VECTOR_INIT_FINALLY(&refined_weights, n);
+  IGRAPH_VECTOR_INIT_FINALLY(&external, n);
+  IGRAPH_VECTOR_INIT_FINALLY(&edge_weights_per_cluster, n);
+  IGRAPH_VECTOR_INIT_FINALLY(&diffs, n);
+  IGRAPH_CHECK(igraph_vector_bool_init(&seen, n));
+  IGRAPH_FINALLY(igraph_vector_bool_destroy, &seen);
+  IGRAPH_CHECK(igraph_vector_resize(refined, n));
+
+  /* Singletons, with their edge weight to the rest of their cluster */
+  for (i = 0; i < n; i++) {
+    long int c = (long int) VECTOR(*membership)[i];
+    long int nlen = igraph_csr_degree(csr, i);
+    int *neis = igraph_csr_neighbors(csr, i);
+    int *incs = igraph_csr_incident(csr, i);
+    VECTOR(*refined)[i] = i;
+    VECTOR(nb_nodes)[i] = 1;
+    VECTOR(refined_weights)[i] = VECTOR(*node_weights)[i];
+    VECTOR(cluster_weights)[c] += VECTOR(*node_weights)[i];
+    for (j = 0; j < nlen; j++) {
+      long int u = neis[j];
+      if (u != i && VECTOR(*membership)[u] == c) {
+	VECTOR(external)[i] += VECTOR(*edge_weights)[ (long int) incs[j] ];
+      }
+    }
+  }
+
+  IGRAPH_CHECK(igraph_vector_long_shuffle(&order));
+
+  for (i = 0; i < n; i++) {
+    long int v = VECTOR(order)[i];
+    long int c = (long int) VECTOR(*membership)[v];
+    igraph_real_t nw = VECTOR(*node_weights)[v];
+    igraph_real_t total = VECTOR(cluster_weights)[c];
+    long int nlen = igraph_csr_degree(csr, v), ncand;
+    int *neis = igraph_csr_neighbors(csr, v);
+    int *incs = igraph_csr_incident(csr, v);
+    long int chosen = v;
+    igraph_real_t max_diff = 0, sum = 0, r;
+
+    /* Only singletons that are well connected to their cluster move */
+    if (VECTOR(nb_nodes)[v] != 1 || VECTOR(*refined)[v] != v) { continue; }
+    if (VECTOR(external)[v] < resolution * nw * (total - nw)) { continue; }
+
+    igraph_vector_long_clear(&neighbor_clusters);
+    for (j = 0; j < nlen; j++) {
+      long int u = neis[j], rc;
+      if (u == v || VECTOR(*membership)[u] != c) { continue; }
+      rc = (long int) VECTOR(*refined)[u];
+      if (!VECTOR(seen)[rc]) {
+	VECTOR(seen)[rc] = 1;
+	igraph_vector_long_push_back(&neighbor_clusters, rc);
+      }
+      VECTOR(edge_weights_per_cluster)[rc] += VECTOR(*edge_weights)[ (long int) incs[j] ];
+    }
+
+    /* Staying alone is the zero of the quality differences. The other
+       candidates are the well connected subclusters. */
+    ncand = igraph_vector_long_size(&neighbor_clusters);
+    for (j = 0; j < ncand; j++) {
+      long int rc = VECTOR(neighbor_clusters)[j];
+      igraph_real_t rw = VECTOR(refined_weights)[rc];
+      VECTOR(diffs)[j] = -1;
+      if (VECTOR(external)[rc] >= resolution * rw * (total - rw)) {
+	VECTOR(diffs)[j] = VECTOR(edge_weights_per_cluster)[rc] - 
+	  resolution * nw * rw;
+	if (VECTOR(diffs)[j] > max_diff) { max_diff = VECTOR(diffs)[j]; }
+      }
+    }
+    sum = exp(-max_diff / beta);
+    for (j = 0; j < ncand; j++) {
+      if (VECTOR(diffs)[j] >= 0) { 
+	sum += exp((VECTOR(diffs)[j] - max_diff) / beta);
+      }
+    }
+    r = RNG_UNIF(0, sum) - exp(-max_diff / beta);
+    for (j = 0; j < ncand && r >= 0; j++) {
+      if (VECTOR(diffs)[j] >= 0) {
+	r -= exp((VECTOR(diffs)[j] - max_diff) / beta);
+	if (r < 0) { chosen = VECTOR(neighbor_clusters)[j]; }
+      }
+    }
+
+    if (chosen != v) {
+      VECTOR(external)[chosen] += VECTOR(external)[v] - 
+	2 * VECTOR(edge_weights_per_cluster)[chosen];
+      VECTOR(refined_weights)[chosen] += nw;
+      VECTOR(refined_weights)[v] = 0;
+      VECTOR(nb_nodes)[chosen] += 1;
+      VECTOR(nb_nodes)[v] = 0;
+      VECTOR(*refined)[v] = chosen;
+    }
+
+    for (j = 0; j < ncand; j++) {
+      long int rc = VECTOR(neighbor_clusters)[j];
+      VECTOR(edge_weights_per_cluster)[rc] = 0;
+      VECTOR(seen)[rc] = 0;
+    }
+  }
+
+  *nb_refined = igraph_i_community_leiden_renumber(refined, map);
+
+  igraph_vector_bool_destroy(&seen);
+  igraph_vector_destroy(&diffs);
+  igraph_vector_destroy(&edge_weights_per_cluster);
+  igraph_vector_destroy(&external);
+  igraph_vector_destroy(&refined_weights);
+  igraph_vector_destroy(&cluster_weights);
+  igraph_vector_long_destroy(&neighbor_clusters);
+  igraph_vector_long_destroy(&nb_nodes);
+  igraph_vector_long_destroy(&order);
+  IGRAPH_FINALLY_CLEAN(9);
+
+  return 0;
+}
+
+/* One iteration of the Leiden algorithm, starting from 'membership':
+ * local moving, refinement and aggregation based on the refined
+ * partition, until the local moving does not merge anything. */
+static int igraph_i_community_leiden_iteration(const igraph_t *graph,
+  const igraph_vector_t *edge_weights, const igraph_vector_t *node_weights,
+  igraph_real_t resolution, igraph_real_t beta,
+  igraph_vector_t *membership, long int *nb_clusters) {
+
+  long int no_of_nodes = igraph_vcount(graph);
+  igraph_t g;
+  igraph_csr_t csr;
+  igraph_vector_t ew, nw, mem, refined, agg_nw, agg_mem;
+  igraph_vector_long_t node_map, map;
+  long int i, n, nb_refined;
+  igraph_bool_t continue_clustering;
+
+  IGRAPH_CHECK(igraph_copy(&g, graph));
+  IGRAPH_FINALLY(igraph_destroy, &g);
+  IGRAPH_CHECK(igraph_vector_copy(&ew, edge_weights));
+  IGRAPH_FINALLY(igraph_vector_destroy, &ew);
+  IGRAPH_CHECK(igraph_vector_copy(&nw, node_weights));
+  IGRAPH_FINALLY(igraph_vector_destroy, &nw);
+  IGRAPH_CHECK(igraph_vector_copy(&mem, membership));
+  IGRAPH_FINALLY(igraph_vector_destroy, &mem);
+  IGRAPH_VECTOR_INIT_FINALLY(&refined, 0);
+  IGRAPH_VECTOR_INIT_FINALLY(&agg_nw, 0);
+  IGRAPH_VECTOR_INIT_FINALLY(&agg_mem, 0);
+  IGRAPH_CHECK(igraph_vector_long_init_seq(&node_map, 0, no_of_nodes-1));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &node_map);
+  IGRAPH_CHECK(igraph_vector_long_init(&map, no_of_nodes));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &map);
+  igraph_vector_long_fill(&map, -1);
+
+  do {
+    n = igraph_vcount(&g);
+    IGRAPH_CHECK(igraph_csr_init(&g, &csr, IGRAPH_ALL));
+    IGRAPH_FINALLY(igraph_csr_destroy, &csr);
+
+    IGRAPH_CHECK(igraph_i_community_leiden_fastmovenodes(&csr, &ew, &nw,
+			   resolution, &mem, nb_clusters, &map));
+    continue_clustering = (*nb_clusters < n);
+
+    if (continue_clustering) {
+      IGRAPH_CHECK(igraph_i_community_leiden_mergenodes(&csr, &ew, &nw,
+			     resolution, beta, &mem, *nb_clusters,
+			     &refined, &nb_refined, &map));
+      /* If the refinement merged nothing, aggregate the clusters; the
+	 ones that are not connected are split at the end */
+      if (nb_refined >= n) {
+	IGRAPH_CHECK(igraph_vector_update(&refined, &mem));
+	nb_refined = *nb_clusters;
+      }
+
+      /* The aggregated vertices, their weights and clusters */
+      IGRAPH_CHECK(igraph_vector_resize(&agg_nw, nb_refined));
+      IGRAPH_CHECK(igraph_vector_resize(&agg_mem, nb_refined));
+      igraph_vector_null(&agg_nw);
+      for (i = 0; i < n; i++) {
+	long int rc = (long int) VECTOR(refined)[i];
+	VECTOR(agg_nw)[rc] += VECTOR(nw)[i];
+	VECTOR(agg_mem)[rc] = VECTOR(mem)[i];
+      }
+      for (i = 0; i < no_of_nodes; i++) {
+	VECTOR(node_map)[i] = (long int) VECTOR(refined)[ VECTOR(node_map)[i] ];
+      }
+    }
+
+    igraph_csr_destroy(&csr);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    if (continue_clustering) {
+      IGRAPH_CHECK(igraph_i_multilevel_shrink(&g, &refined, nb_refined, &ew));
+      IGRAPH_CHECK(igraph_vector_update(&nw, &agg_nw));
+      IGRAPH_CHECK(igraph_vector_update(&mem, &agg_mem));
+    }
+
+    IGRAPH_ALLOW_INTERRUPTION();
+  } while (continue_clustering);
+
+  for (i = 0; i < no_of_nodes; i++) {
+    VECTOR(*membership)[i] = VECTOR(mem)[ VECTOR(node_map)[i] ];
+  }
+  IGRAPH_CHECK(igraph_i_community_leiden_split(graph, membership,
+					       nb_clusters, &map));
+
+  igraph_vector_long_destroy(&map);
+  igraph_vector_long_destroy(&node_map);
+  igraph_vector_destroy(&agg_mem);
+  igraph_vector_destroy(&agg_nw);
+  igraph_vector_destroy(&refined);
+  igraph_vector_destroy(&mem);
+  igraph_vector_destroy(&nw);
+  igraph_vector_destroy(&ew);
+  igraph_destroy(&g);
+  IGRAPH_FINALLY_CLEAN(9);
+
+  return 0;
+}
+
+/**
+ * \ingroup communities
+ * \function igraph_community_leiden
+ * \brief Finding community structure using the Leiden algorithm
+ *
+ * This function implements the Leiden algorithm for finding community
+ * structure, see V. A. Traag, L. Waltman and N. J. van Eck: From Louvain
+ * to Leiden: guaranteeing well-connected communities, Sci Rep 9, 5233
+ * (2019), https://doi.org/10.1038/s41598-019-41695-z
+ *
+ * </para><para>
+ * It is similar to the multi-level algorithm (\ref
+ * igraph_community_multilevel()), but vertices are only moved again
+ * when their neighborhood changed, and the communities are refined
+ * before they are aggregated. The refinement splits communities that
+ * are not well connected. If the refinement cannot merge anything,
+ * e.g. because the starting communities are not connected, then the
+ * communities themselves are aggregated; communities that are still
+ * not connected at the end are split into their connected components,
+ * which does not decrease the quality if the node weights and the
+ * resolution parameter are not negative. So all communities found
+ * are connected.
+ *
+ * </para><para>
+ * The quality function that is optimized is
+ * 1 / 2m sum_ij (A_ij - gamma n_i n_j) d(s_i, s_j), where m is the
+ * total edge weight, A_ij is the weight of the edge(s) between i and j,
+ * gamma is the resolution parameter, n_i is the node weight of vertex
+ * i and d(s_i, s_j) is one if i and j are in the same community and
+ * zero otherwise. With unit node weights this is the Constant Potts
+ * Model (CPM). Modularity is obtained with the (weighted) degrees as
+ * node weights and 1/2m as the resolution parameter; larger or smaller
+ * resolutions give smaller or larger communities.
+ *
+ * \param graph The input graph. It must be an undirected graph.
+ * \param edge_weights Numeric vector containing edge weights. If \c
+ *    NULL, every edge has equal weight. The weights are expected to be
+ *    non-negative.
+ * \param node_weights Numeric vector containing the node weights. If
+ *    \c NULL, every vertex has weight one.
+ * \param resolution_parameter The resolution parameter, gamma above.
+ * \param beta The randomness of the refinement, it must be
+ *    positive. Small values make the refinement merge vertices into
+ *    the best subcommunity almost always, 0.01 is a good default.
+ * \param start If true, then the communities in \p membership are
+ *    the starting point of the algorithm. Otherwise it starts from
+ *    singleton communities.
+ * \param n_iterations The number of iterations of the algorithm,
+ *    each starting from the result of the previous one. If negative,
+ *    the algorithm is iterated until the communities do not change.
+ * \param membership The membership vector, the result is returned here.
+ *    For each vertex it gives the ID of its community, from zero. If
+ *    \p start is true, it must contain the starting communities.
+ * \param nb_clusters If not \c NULL, the number of communities is
+ *    stored here.
+ * \param quality If not \c NULL, the quality of the communities is
+ *    stored here, with the quality function given above. This is
+ *    the modularity if the node weights and the resolution parameter
+ *    are chosen for modularity. If the graph has no edges, \c NaN is
+ *    stored.
+ * \return Error code.
+ *
+ * Time complexity: in average near linear on sparse graphs, for each
+ * iteration.
+ *
+ * \example examples/simple/igraph_community_leiden.c
+ */
+
+int igraph_community_leiden(const igraph_t *graph,
+  const igraph_vector_t *edge_weights, const igraph_vector_t *node_weights,
+  igraph_real_t resolution_parameter, igraph_real_t beta,
+  igraph_bool_t start, igraph_integer_t n_iterations,
+  igraph_vector_t *membership, igraph_integer_t *nb_clusters,
+  igraph_real_t *quality) {
+
+  long int no_of_nodes = igraph_vcount(graph);
+  long int no_of_edges = igraph_ecount(graph);
+  igraph_vector_t ew, nw, prev, cluster_weights;
+  igraph_vector_long_t map;
+  long int i, it, nb = 0;
+  igraph_real_t total_weight, q;
+
+  if (igraph_is_directed(graph)) {
+    IGRAPH_ERROR("Leiden community detection works for undirected graphs only",
+		 IGRAPH_UNIMPLEMENTED);
+  }
+  if (edge_weights && igraph_vector_size(edge_weights) != no_of_edges) {
+    IGRAPH_ERROR("Invalid edge weight vector length", IGRAPH_EINVAL);
+  }
+  if (edge_weights && no_of_edges > 0 && igraph_vector_min(edge_weights) < 0) {
+    IGRAPH_ERROR("Edge weights must be non-negative", IGRAPH_EINVAL);
+  }
+  if (node_weights && igraph_vector_size(node_weights) != no_of_nodes) {
+    IGRAPH_ERROR("Invalid node weight vector length", IGRAPH_EINVAL);
+  }
+  if (beta <= 0) {
+    IGRAPH_ERROR("Beta must be positive", IGRAPH_EINVAL);
+  }
+  if (start) {
+    if (igraph_vector_size(membership) != no_of_nodes) {
+      IGRAPH_ERROR("Invalid starting membership vector length", IGRAPH_EINVAL);
+    }
+    if (no_of_nodes > 0 && igraph_vector_min(membership) < 0) {
+      IGRAPH_ERROR("Invalid starting membership vector", IGRAPH_EINVAL);
+    }
+  }
+
+  if (edge_weights) {
+    IGRAPH_CHECK(igraph_vector_copy(&ew, edge_weights));
+    IGRAPH_FINALLY(igraph_vector_destroy, &ew);
+  } else {
+    IGRAPH_VECTOR_INIT_FINALLY(&ew, no_of_edges);
+    igraph_vector_fill(&ew, 1);
+  }
+  if (node_weights) {
+    IGRAPH_CHECK(igraph_vector_copy(&nw, node_weights));
+    IGRAPH_FINALLY(igraph_vector_destroy, &nw);
+  } else {
+    IGRAPH_VECTOR_INIT_FINALLY(&nw, no_of_nodes);
+    igraph_vector_fill(&nw, 1);
+  }
+  IGRAPH_VECTOR_INIT_FINALLY(&prev, 0);
+  IGRAPH_CHECK(igraph_vector_long_init(&map, no_of_nodes));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &map);
+  igraph_vector_long_fill(&map, -1);
+
+  if (start) {
+    IGRAPH_CHECK(igraph_reindex_membership(membership, 0));
+    nb = igraph_i_community_leiden_renumber(membership, &map);
+  } else {
+    IGRAPH_CHECK(igraph_vector_resize(membership, no_of_nodes));
+    for (i = 0; i < no_of_nodes; i++) { VECTOR(*membership)[i] = i; }
+    nb = no_of_nodes;
+  }
+
+  RNG_BEGIN();
+
+  for (it = 0; n_iterations < 0 || it < n_iterations; it++) {
+    IGRAPH_CHECK(igraph_vector_update(&prev, membership));
+    IGRAPH_CHECK(igraph_i_community_leiden_iteration(graph, &ew, &nw,
+		   resolution_parameter, beta, membership, &nb));
+    if (n_iterations < 0 && igraph_vector_all_e(&prev, membership)) {
+      break;
+    }
+  }
+
+  RNG_END();
+
+  if (nb_clusters) {
+    *nb_clusters = (igraph_integer_t) nb;
+  }
+
+  if (quality) {
+    IGRAPH_VECTOR_INIT_FINALLY(&cluster_weights, nb);
+    q = 0;
+    total_weight = igraph_vector_sum(&ew);
+    for (i = 0; i < no_of_edges; i++) {
+      long int from = (long int) IGRAPH_FROM(graph, i);
+      long int to = (long int) IGRAPH_TO(graph, i);
+      if (VECTOR(*membership)[from] == VECTOR(*membership)[to]) {
+	q += 2 * VECTOR(ew)[i];
+      }
+    }
+    for (i = 0; i < no_of_nodes; i++) {
+      VECTOR(cluster_weights)[ (long int) VECTOR(*membership)[i] ] += VECTOR(nw)[i];
+    }
+    for (i = 0; i < nb; i++) {
+      q -= resolution_parameter * VECTOR(cluster_weights)[i] * 
+	VECTOR(cluster_weights)[i];
+    }
+    *quality = total_weight > 0 ? q / (2 * total_weight) : IGRAPH_NAN;
+    igraph_vector_destroy(&cluster_weights);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
+
+  igraph_vector_long_destroy(&map);
+  igraph_vector_destroy(&prev);
+  igraph_vector_destroy(&nw);
+  igraph_vector_destroy(&ew);
+  IGRAPH_FINALLY_CLEAN(4);
+
+  return 0;
+}
+
 
 int igraph_i_compare_communities_vi(const igraph_vector_t *v1,
     const igraph_vector_t *v2, igraph_real_t* result);
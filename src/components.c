@@ -26,6 +26,7 @@
 #include "igraph_interface.h"
 #include "igraph_adjlist.h"
 #include "igraph_interrupt_internal.h"
+#include "igraph_dobfs_internal.h"
 #include "igraph_progress.h"
 #include "igraph_structural.h"
 #include "igraph_dqueue.h"
@@ -86,77 +87,91 @@ int igraph_clusters(const igraph_t *graph, igraph_vector_t *membership,
   return 1;
 }
 
+/* Root of `x' in the union-find forest `parent', with path halving */
+
+static long int igraph_i_clusters_find(long int *parent, long int x) {
+  while (parent[x] != x) {
+    parent[x] = parent[parent[x]];
+    x = parent[x];
+  }
+  return x;
+}
+
+/* Weakly connected components with a union-find forest built from a
+ * single pass over the edge list, this does not need the neighbor
+ * lists of the vertices. The components are numbered in the order of
+ * their smallest vertex id, as a breadth-first search from the
+ * vertices in increasing id order would number them. */
+
 int igraph_clusters_weak(const igraph_t *graph, igraph_vector_t *membership,
 			 igraph_vector_t *csize, igraph_integer_t *no) {
 
   long int no_of_nodes=igraph_vcount(graph);
-  char *already_added;
-  long int first_node, act_cluster_size=0, no_of_clusters=1;
-  
-  igraph_dqueue_t q=IGRAPH_DQUEUE_NULL;
-  
+  long int no_of_edges=igraph_ecount(graph);
+  long int no_of_clusters=0;
+  long int *parent, *rank;
   long int i;
-  igraph_vector_t neis=IGRAPH_VECTOR_NULL;
 
-  already_added=igraph_Calloc(no_of_nodes,char);
-  if (already_added==0) {
+  parent=igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, long int);
+  if (parent==0) {
     IGRAPH_ERROR("Cannot calculate clusters", IGRAPH_ENOMEM);
   }
-  IGRAPH_FINALLY(igraph_free, already_added);
-
-  IGRAPH_DQUEUE_INIT_FINALLY(&q, no_of_nodes > 100000 ? 10000 : no_of_nodes/10);
-  IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
+  IGRAPH_FINALLY(igraph_free, parent);
+  rank=igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, long int);
+  if (rank==0) {
+    IGRAPH_ERROR("Cannot calculate clusters", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, rank);
+
+  for (i=0; i<no_of_nodes; i++) { parent[i]=i; }
+
+  /* Union by rank */
+  for (i=0; i<no_of_edges; i++) {
+    long int from=igraph_i_clusters_find(parent, IGRAPH_FROM(graph, i));
+    long int to=igraph_i_clusters_find(parent, IGRAPH_TO(graph, i));
+    if ((i & 0xffff) == 0) { IGRAPH_ALLOW_INTERRUPTION(); }
+    if (from == to) { continue; }
+    if (rank[from] < rank[to]) {
+      parent[from]=to;
+    } else if (rank[from] > rank[to]) {
+      parent[to]=from;
+    } else {
+      parent[to]=from;
+      rank[from]++;
+    }
+  }
 
-  /* Memory for result, csize is dynamically allocated */
+  /* Number the components, `rank' is reused for the component ids */
   if (membership) { 
     IGRAPH_CHECK(igraph_vector_resize(membership, no_of_nodes));
   }
   if (csize) { 
     igraph_vector_clear(csize);
   }
-
-  /* The algorithm */
-
-  for (first_node=0; first_node < no_of_nodes; ++first_node) {
-    if (already_added[first_node]==1) continue;
-    IGRAPH_ALLOW_INTERRUPTION();
-
-    already_added[first_node]=1;
-    act_cluster_size=1;
-    if (membership) {
-      VECTOR(*membership)[first_node]=no_of_clusters-1;
-    }
-    IGRAPH_CHECK(igraph_dqueue_push(&q, first_node));
-    
-    while ( !igraph_dqueue_empty(&q) ) {
-      long int act_node=(long int) igraph_dqueue_pop(&q);
-      IGRAPH_CHECK(igraph_neighbors(graph, &neis, 
-				    (igraph_integer_t) act_node, IGRAPH_ALL));
-      for (i=0; i<igraph_vector_size(&neis); i++) {
-	long int neighbor=(long int) VECTOR(neis)[i];
-	if (already_added[neighbor]==1) { continue; }
-	IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-	already_added[neighbor]=1;
-	act_cluster_size++;
-	if (membership) {
-	  VECTOR(*membership)[neighbor]=no_of_clusters-1;
-	}
+  for (i=0; i<no_of_nodes; i++) { rank[i]=-1; }
+  for (i=0; i<no_of_nodes; i++) {
+    long int root=igraph_i_clusters_find(parent, i);
+    if (rank[root] < 0) {
+      rank[root]=no_of_clusters++;
+      if (csize) {
+	IGRAPH_CHECK(igraph_vector_push_back(csize, 0));
       }
     }
-    no_of_clusters++;
+    if (membership) {
+      VECTOR(*membership)[i]=rank[root];
+    }
     if (csize) {
-      IGRAPH_CHECK(igraph_vector_push_back(csize, act_cluster_size));
+      VECTOR(*csize)[rank[root]] += 1;
     }
   }
   
   /* Cleaning up */
   
-  if (no) { *no = (igraph_integer_t) no_of_clusters-1; }
+  if (no) { *no = (igraph_integer_t) no_of_clusters; }
   
-  igraph_Free(already_added);
-  igraph_dqueue_destroy(&q);
-  igraph_vector_destroy(&neis);
-  IGRAPH_FINALLY_CLEAN(3);
+  igraph_Free(rank);
+  igraph_Free(parent);
+  IGRAPH_FINALLY_CLEAN(2);
   
   return 0;
 }
@@ -174,9 +189,10 @@ int igraph_clusters_strong(const igraph_t *graph, igraph_vector_t *membership,
   long int act_cluster_size;
 
   igraph_vector_t out=IGRAPH_VECTOR_NULL;
-  const igraph_vector_int_t* tmp;
+  const int *tmp;
+  long int tmplen;
 
-  igraph_adjlist_t adjlist;
+  igraph_csr_t csr;
 
   /* The result */
 
@@ -194,29 +210,28 @@ int igraph_clusters_strong(const igraph_t *graph, igraph_vector_t *membership,
     igraph_vector_clear(csize);
   }
 
-  IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_OUT));
-  IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, IGRAPH_OUT));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
 
   num_seen = 0;
   for (i=0; i<no_of_nodes; i++) {
     IGRAPH_ALLOW_INTERRUPTION();
 
-    tmp = igraph_adjlist_get(&adjlist, i);
-    if (VECTOR(next_nei)[i] > igraph_vector_int_size(tmp)) {
+    if (VECTOR(next_nei)[i] > igraph_csr_degree(&csr, i)) {
       continue;
     }
     
     IGRAPH_CHECK(igraph_dqueue_push(&q, i));
     while (!igraph_dqueue_empty(&q)) {
       long int act_node=(long int) igraph_dqueue_back(&q);
-      tmp = igraph_adjlist_get(&adjlist, act_node);
+      tmp = igraph_csr_neighbors(&csr, act_node);
+      tmplen = igraph_csr_degree(&csr, act_node);
       if (VECTOR(next_nei)[act_node]==0) {
 	/* this is the first time we've met this vertex */
 	VECTOR(next_nei)[act_node]++;
-      } else if (VECTOR(next_nei)[act_node] <= igraph_vector_int_size(tmp)) {
+      } else if (VECTOR(next_nei)[act_node] <= tmplen) {
 	/* we've already met this vertex but it has more children */
-	long int neighbor=(long int) VECTOR(*tmp)[(long int)
-						  VECTOR(next_nei)[act_node]-1];
+	long int neighbor=tmp[(long int) VECTOR(next_nei)[act_node]-1];
 	if (VECTOR(next_nei)[neighbor] == 0) {
 	  IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
 	}
@@ -239,11 +254,11 @@ int igraph_clusters_strong(const igraph_t *graph, igraph_vector_t *membership,
 
   IGRAPH_PROGRESS("Strongly connected components: ", 50.0, NULL);
 
-  igraph_adjlist_destroy(&adjlist);
+  igraph_csr_destroy(&csr);
   IGRAPH_FINALLY_CLEAN(1);
 
-  IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_IN));
-  IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, IGRAPH_IN));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
 
   /* OK, we've the 'out' values for the nodes, let's use them in
      decreasing order with the help of a heap */
@@ -272,10 +287,10 @@ int igraph_clusters_strong(const igraph_t *graph, igraph_vector_t *membership,
 
     while (!igraph_dqueue_empty(&q)) {
       long int act_node=(long int) igraph_dqueue_pop_back(&q);
-      tmp = igraph_adjlist_get(&adjlist, act_node);
-      n = igraph_vector_int_size(tmp);
+      tmp = igraph_csr_neighbors(&csr, act_node);
+      n = igraph_csr_degree(&csr, act_node);
       for (i=0; i<n; i++) {
-	long int neighbor=(long int) VECTOR(*tmp)[i];
+	long int neighbor=tmp[i];
 	if (VECTOR(next_nei)[neighbor] != 0) { continue; }
 	IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
 	VECTOR(next_nei)[neighbor]=1;
@@ -306,7 +321,7 @@ int igraph_clusters_strong(const igraph_t *graph, igraph_vector_t *membership,
 
   /* Clean up, return */
 
-  igraph_adjlist_destroy(&adjlist);
+  igraph_csr_destroy(&csr);
   igraph_vector_destroy(&out);
   igraph_dqueue_destroy(&q);
   igraph_vector_destroy(&next_nei);
@@ -383,52 +398,27 @@ int igraph_is_connected(const igraph_t *graph, igraph_bool_t *res,
 int igraph_is_connected_weak(const igraph_t *graph, igraph_bool_t *res) {
 
   long int no_of_nodes=igraph_vcount(graph);
-  char *already_added;
-  igraph_vector_t neis=IGRAPH_VECTOR_NULL;
-  igraph_dqueue_t q=IGRAPH_DQUEUE_NULL;
-  
-  long int i, j;
+  igraph_csr_t csr;
+  igraph_i_dobfs_t bfs;
+  long int reached;
 
   if (no_of_nodes == 0) {
     *res = 1;
     return IGRAPH_SUCCESS;
   }
 
-  already_added=igraph_Calloc(no_of_nodes, char);
-  if (already_added==0) {
-    IGRAPH_ERROR("is connected (weak) failed", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(free, already_added); /* TODO: hack */
-
-  IGRAPH_DQUEUE_INIT_FINALLY(&q, 10);
-  IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, IGRAPH_ALL));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
+  IGRAPH_CHECK(igraph_i_dobfs_init(&bfs, &csr, &csr));
+  IGRAPH_FINALLY(igraph_i_dobfs_destroy, &bfs);
   
-  /* Try to find at least two clusters */
-  already_added[0]=1;
-  IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-  
-  j=1;
-  while ( !igraph_dqueue_empty(&q)) {
-    long int actnode=(long int) igraph_dqueue_pop(&q);
-    IGRAPH_ALLOW_INTERRUPTION();
-    IGRAPH_CHECK(igraph_neighbors(graph, &neis, (igraph_integer_t) actnode,
-				  IGRAPH_ALL));
-    for (i=0; i <igraph_vector_size(&neis); i++) {
-      long int neighbor=(long int) VECTOR(neis)[i];
-      if (already_added[neighbor] != 0) { continue; }
-      IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-      j++;
-      already_added[neighbor]++;
-    }
-  }
-  
-  /* Connected? */
-  *res = (j == no_of_nodes);
+  /* Connected if a single search reaches every vertex */
+  IGRAPH_CHECK(igraph_i_dobfs_run(&bfs, 0, 0, &reached));
+  *res = (reached == no_of_nodes);
 
-  igraph_Free(already_added);
-  igraph_dqueue_destroy(&q);
-  igraph_vector_destroy(&neis);
-  IGRAPH_FINALLY_CLEAN(3);
+  igraph_i_dobfs_destroy(&bfs);
+  igraph_csr_destroy(&csr);
+  IGRAPH_FINALLY_CLEAN(2);
 
   return 0;
 }
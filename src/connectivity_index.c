@@ -0,0 +1,670 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=2 sts=2 sw=2 et: */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include "igraph_components.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_interrupt_internal.h"
+#include "config.h"
+
+/* The index is a union-find forest over the vertices, with union by
+   size and path halving. The vertices of each set also form a ring,
+   through 'next', so that a set can be listed without scanning all
+   vertices.
+
+   The index keeps its own copy of the live edges, in slots. The slot
+   of an edge is its id; the slots of deleted edges are kept on a free
+   list and reused by later insertions, so the storage is bounded by
+   the largest number of edges the index had at any time. Each slot
+   has a state: deleted, a forest edge (it merged two sets when it was
+   added) or a non-forest edge. Entry 2e and 2e+1 of 'edges' are the
+   endpoints of edge e, and the same entries link the edge into the
+   doubly linked incidence lists of the endpoints.
+
+   Insertions only need a union. Deleting a non-forest edge does not
+   change the components. Deleting a forest edge may split its set,
+   so the set is marked dirty; the other sets stay exact, and queries
+   on them need no rebuild. A query on a dirty set rebuilds it. A
+   small set is rebuilt from its own vertices, through the ring, and
+   its own edges, through the incidence lists. These are scattered in
+   memory, so a set with more than IGRAPH_I_CONN_REBUILD_ALL of the
+   vertices is rebuilt with the whole forest instead, in one pass
+   over the edges, this also cleans all other dirty sets. */
+
+#define IGRAPH_I_CONN_DELETED 0
+#define IGRAPH_I_CONN_OTHER   1
+#define IGRAPH_I_CONN_FOREST  2
+
+#define IGRAPH_I_CONN_REBUILD_ALL 0.125
+
+static long int igraph_i_connectivity_index_find(igraph_connectivity_index_t *index,
+						 long int x) {
+  int *parent=VECTOR(index->parent);
+  while (parent[x] != x) {
+    parent[x] = parent[parent[x]];
+    x = parent[x];
+  }
+  return x;
+}
+
+/* Merges the sets of `from' and `to', returns whether they were
+   different. The merged set is dirty if either of them was. */
+
+static igraph_bool_t igraph_i_connectivity_index_union(igraph_connectivity_index_t *index,
+						       long int from, long int to) {
+  long int r1=igraph_i_connectivity_index_find(index, from);
+  long int r2=igraph_i_connectivity_index_find(index, to);
+  int tmp;
+  if (r1 == r2) { return 0; }
+  if (VECTOR(index->size)[r1] < VECTOR(index->size)[r2]) {
+    long int t=r1; r1=r2; r2=t;
+  }
+  VECTOR(index->parent)[r2] = (int) r1;
+  VECTOR(index->size)[r1] += VECTOR(index->size)[r2];
+  VECTOR(index->dirty)[r1] |= VECTOR(index->dirty)[r2];
+  tmp=VECTOR(index->next)[r1];
+  VECTOR(index->next)[r1] = VECTOR(index->next)[r2];
+  VECTOR(index->next)[r2] = tmp;
+  index->no -= 1;
+  return 1;
+}
+
+static void igraph_i_connectivity_index_link(igraph_connectivity_index_t *index,
+					     long int k) {
+  long int v=VECTOR(index->edges)[k];
+  int first=VECTOR(index->head)[v];
+  VECTOR(index->inc_prev)[k] = -1;
+  VECTOR(index->inc_next)[k] = first;
+  if (first >= 0) { VECTOR(index->inc_prev)[first] = (int) k; }
+  VECTOR(index->head)[v] = (int) k;
+}
+
+static void igraph_i_connectivity_index_unlink(igraph_connectivity_index_t *index,
+					       long int k) {
+  int prev=VECTOR(index->inc_prev)[k], next=VECTOR(index->inc_next)[k];
+  if (prev >= 0) {
+    VECTOR(index->inc_next)[prev] = next;
+  } else {
+    VECTOR(index->head)[ (long int) VECTOR(index->edges)[k] ] = next;
+  }
+  if (next >= 0) { VECTOR(index->inc_prev)[next] = prev; }
+}
+
+/* Rebuilds the dirty set with the given root: its vertices become
+   singletons again, then its live edges are added back. */
+
+static void igraph_i_connectivity_index_rebuild_set(igraph_connectivity_index_t *index,
+						    long int root) {
+  int *queue=VECTOR(index->queue);
+  long int n=0, i, v=root;
+  int k;
+
+  do {
+    queue[n++] = (int) v;
+    v=VECTOR(index->next)[v];
+  } while (v != root);
+
+  for (i=0; i<n; i++) {
+    v=queue[i];
+    VECTOR(index->parent)[v] = (int) v;
+    VECTOR(index->size)[v] = 1;
+    VECTOR(index->next)[v] = (int) v;
+    VECTOR(index->dirty)[v] = 0;
+  }
+  index->no += n-1;
+
+  for (i=0; i<n; i++) {
+    /* Every edge once, from the entry of its first endpoint */
+    for (k=VECTOR(index->head)[ (long int) queue[i] ]; k >= 0; 
+	 k=VECTOR(index->inc_next)[k]) {
+      if (k % 2 != 0) { continue; }
+      VECTOR(index->state)[k/2] = 
+	igraph_i_connectivity_index_union(index, VECTOR(index->edges)[k],
+					  VECTOR(index->edges)[k+1]) ?
+	IGRAPH_I_CONN_FOREST : IGRAPH_I_CONN_OTHER;
+    }
+  }
+}
+
+/* Rebuilds the whole forest from the live edges */
+
+static int igraph_i_connectivity_index_rebuild_all(igraph_connectivity_index_t *index) {
+  long int no_of_nodes=index->no_of_nodes;
+  long int no_of_slots=igraph_vector_char_size(&index->state);
+  long int i;
+
+  for (i=0; i<no_of_nodes; i++) {
+    VECTOR(index->parent)[i] = (int) i;
+    VECTOR(index->size)[i] = 1;
+    VECTOR(index->next)[i] = (int) i;
+    VECTOR(index->dirty)[i] = 0;
+  }
+  index->no=(igraph_integer_t) no_of_nodes;
+  igraph_vector_int_clear(&index->dirty_roots);
+
+  for (i=0; i<no_of_slots; i++) {
+    if ((i & 0xffff) == 0) { IGRAPH_ALLOW_INTERRUPTION(); }
+    if (VECTOR(index->state)[i] == IGRAPH_I_CONN_DELETED) { continue; }
+    VECTOR(index->state)[i] =
+      igraph_i_connectivity_index_union(index, VECTOR(index->edges)[2*i],
+					VECTOR(index->edges)[2*i+1]) ?
+      IGRAPH_I_CONN_FOREST : IGRAPH_I_CONN_OTHER;
+  }
+
+  return 0;
+}
+
+static igraph_bool_t igraph_i_connectivity_index_large(igraph_connectivity_index_t *index,
+						       long int root) {
+  return VECTOR(index->size)[root] > 
+    IGRAPH_I_CONN_REBUILD_ALL * index->no_of_nodes;
+}
+
+/* Makes all sets exact */
+
+static int igraph_i_connectivity_index_rebuild(igraph_connectivity_index_t *index) {
+  long int i, n=igraph_vector_int_size(&index->dirty_roots);
+  for (i=0; i<n; i++) {
+    long int root=igraph_i_connectivity_index_find(index, 
+				   VECTOR(index->dirty_roots)[i]);
+    if (VECTOR(index->dirty)[root] && 
+	igraph_i_connectivity_index_large(index, root)) {
+      return igraph_i_connectivity_index_rebuild_all(index);
+    }
+  }
+  for (i=0; i<n; i++) {
+    long int root=igraph_i_connectivity_index_find(index, 
+				   VECTOR(index->dirty_roots)[i]);
+    if (VECTOR(index->dirty)[root]) {
+      igraph_i_connectivity_index_rebuild_set(index, root);
+    }
+  }
+  igraph_vector_int_clear(&index->dirty_roots);
+  return 0;
+}
+
+/* Queries rebuild single sets without removing them from
+   'dirty_roots', so it can have entries of sets that are exact
+   again, or several entries of the same set. This removes them. A
+   dirty set has at least two vertices, so afterwards there are at
+   most half as many entries as vertices. */
+
+static void igraph_i_connectivity_index_compact(igraph_connectivity_index_t *index) {
+  long int i, j, n=igraph_vector_int_size(&index->dirty_roots);
+  for (i=0, j=0; i<n; i++) {
+    long int root=igraph_i_connectivity_index_find(index, 
+				   VECTOR(index->dirty_roots)[i]);
+    if (VECTOR(index->dirty)[root] == 1) {
+      VECTOR(index->dirty)[root] = 2; /* kept already */
+      VECTOR(index->dirty_roots)[j++] = (int) root;
+    }
+  }
+  for (i=0; i<j; i++) {
+    VECTOR(index->dirty)[ (long int) VECTOR(index->dirty_roots)[i] ] = 1;
+  }
+  igraph_vector_int_resize(&index->dirty_roots, j); /* shrinks */
+}
+
+/* Gives the root of the set of `vertex' in '*root', after making the
+   set exact */
+
+static int igraph_i_connectivity_index_exact(igraph_connectivity_index_t *index,
+					     long int vertex, long int *root) {
+  *root=igraph_i_connectivity_index_find(index, vertex);
+  if (VECTOR(index->dirty)[*root]) {
+    if (igraph_i_connectivity_index_large(index, *root)) {
+      IGRAPH_CHECK(igraph_i_connectivity_index_rebuild_all(index));
+    } else {
+      igraph_i_connectivity_index_rebuild_set(index, *root);
+    }
+    *root=igraph_i_connectivity_index_find(index, vertex);
+  }
+  return 0;
+}
+
+/**
+ * \function igraph_connectivity_index_init
+ * \brief Builds an incrementally maintained connectivity index.
+ * 
+ * The index answers whether two vertices are in the same (weakly)
+ * connected component, the size of a component and the number of
+ * components, in almost constant time. It can be updated when edges
+ * and vertices are added to, or edges are deleted from the graph,
+ * without rebuilding it.
+ *
+ * </para><para>
+ * Insertions cost almost constant time. Deleting an edge that is not
+ * in the spanning forest of the index is also cheap, as it does not
+ * change the components. Deleting a spanning forest edge only makes
+ * its component dirty, queries on other components are still
+ * answered in almost constant time. The first query on a dirty
+ * component rebuilds it, in time linear in its number of vertices
+ * and edges. If the component has more than an eighth of the
+ * vertices, then the whole index is rebuilt instead, in time linear
+ * in the number of vertices and edges, this also rebuilds all other
+ * dirty components. A batch of deletions therefore costs at most one
+ * rebuild per component, and often just one rebuild.
+ *
+ * </para><para>
+ * The index keeps its own copy of the edges, it does not refer to
+ * the graph after this call. The edges of the index have the ids
+ * they had in the graph. Deleting an edge from the index does not
+ * change the ids of the other edges; \ref
+ * igraph_connectivity_index_add_edges() reuses the ids of the
+ * deleted edges first, so the memory of the index is proportional
+ * to the largest number of edges it had at any time.
+ *
+ * \param graph The input graph, edge directions are ignored.
+ * \param index Pointer to an uninitialized connectivity index.
+ * \return Error code.
+ * 
+ * Time complexity: O(|V|+|E|), almost linear in the number of
+ * vertices and edges.
+ *
+ * \sa \ref igraph_clusters() for a one-off calculation.
+ */
+
+int igraph_connectivity_index_init(const igraph_t *graph,
+				   igraph_connectivity_index_t *index) {
+  long int no_of_nodes=igraph_vcount(graph);
+  long int no_of_edges=igraph_ecount(graph);
+  long int i;
+
+  index->no_of_nodes=(igraph_integer_t) no_of_nodes;
+  index->no=(igraph_integer_t) no_of_nodes;
+  IGRAPH_CHECK(igraph_vector_int_init_seq(&index->parent, 0, 
+					  (int) no_of_nodes-1));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->parent);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->size, no_of_nodes));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->size);
+  igraph_vector_int_fill(&index->size, 1);
+  IGRAPH_CHECK(igraph_vector_int_init_seq(&index->next, 0, 
+					  (int) no_of_nodes-1));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->next);
+  IGRAPH_CHECK(igraph_vector_char_init(&index->dirty, no_of_nodes));
+  IGRAPH_FINALLY(igraph_vector_char_destroy, &index->dirty);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->dirty_roots, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->dirty_roots);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->head, no_of_nodes));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->head);
+  igraph_vector_int_fill(&index->head, -1);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->queue, no_of_nodes));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->queue);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->edges, 2*no_of_edges));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->edges);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->inc_next, 2*no_of_edges));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->inc_next);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->inc_prev, 2*no_of_edges));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->inc_prev);
+  IGRAPH_CHECK(igraph_vector_char_init(&index->state, no_of_edges));
+  IGRAPH_FINALLY(igraph_vector_char_destroy, &index->state);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->free, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->free);
+
+  for (i=0; i<no_of_edges; i++) {
+    if ((i & 0xffff) == 0) { IGRAPH_ALLOW_INTERRUPTION(); }
+    VECTOR(index->edges)[2*i] = IGRAPH_FROM(graph, i);
+    VECTOR(index->edges)[2*i+1] = IGRAPH_TO(graph, i);
+    igraph_i_connectivity_index_link(index, 2*i);
+    igraph_i_connectivity_index_link(index, 2*i+1);
+    VECTOR(index->state)[i] =
+      igraph_i_connectivity_index_union(index, IGRAPH_FROM(graph, i),
+					IGRAPH_TO(graph, i)) ?
+      IGRAPH_I_CONN_FOREST : IGRAPH_I_CONN_OTHER;
+  }
+
+  IGRAPH_FINALLY_CLEAN(12);
+  return 0;
+}
+
+/**
+ * \function igraph_connectivity_index_destroy
+ * \brief Deallocates the memory used by a connectivity index.
+ * 
+ * \param index The index to destroy.
+ * 
+ * Time complexity: operating system dependent.
+ */
+
+void igraph_connectivity_index_destroy(igraph_connectivity_index_t *index) {
+  igraph_vector_int_destroy(&index->free);
+  igraph_vector_char_destroy(&index->state);
+  igraph_vector_int_destroy(&index->inc_prev);
+  igraph_vector_int_destroy(&index->inc_next);
+  igraph_vector_int_destroy(&index->edges);
+  igraph_vector_int_destroy(&index->queue);
+  igraph_vector_int_destroy(&index->head);
+  igraph_vector_int_destroy(&index->dirty_roots);
+  igraph_vector_char_destroy(&index->dirty);
+  igraph_vector_int_destroy(&index->next);
+  igraph_vector_int_destroy(&index->size);
+  igraph_vector_int_destroy(&index->parent);
+}
+
+/**
+ * \function igraph_connectivity_index_add_vertices
+ * \brief Adds isolated vertices to a connectivity index.
+ * 
+ * \param index The connectivity index.
+ * \param nv The number of vertices to add, they get consecutive ids,
+ *    like in \ref igraph_add_vertices().
+ * \return Error code.
+ * 
+ * Time complexity: O(nv).
+ */
+
+int igraph_connectivity_index_add_vertices(igraph_connectivity_index_t *index,
+					   igraph_integer_t nv) {
+  long int no_of_nodes=index->no_of_nodes;
+  long int i;
+
+  if (nv < 0) {
+    IGRAPH_ERROR("Cannot add negative number of vertices", IGRAPH_EINVAL);
+  }
+  IGRAPH_CHECK(igraph_vector_int_resize(&index->parent, no_of_nodes+nv));
+  IGRAPH_CHECK(igraph_vector_int_resize(&index->size, no_of_nodes+nv));
+  IGRAPH_CHECK(igraph_vector_int_resize(&index->next, no_of_nodes+nv));
+  IGRAPH_CHECK(igraph_vector_char_resize(&index->dirty, no_of_nodes+nv));
+  IGRAPH_CHECK(igraph_vector_int_resize(&index->head, no_of_nodes+nv));
+  IGRAPH_CHECK(igraph_vector_int_resize(&index->queue, no_of_nodes+nv));
+  for (i=no_of_nodes; i<no_of_nodes+nv; i++) {
+    VECTOR(index->parent)[i] = (int) i;
+    VECTOR(index->size)[i] = 1;
+    VECTOR(index->next)[i] = (int) i;
+    VECTOR(index->dirty)[i] = 0;
+    VECTOR(index->head)[i] = -1;
+  }
+  index->no_of_nodes += nv;
+  index->no += nv;
+
+  return 0;
+}
+
+/**
+ * \function igraph_connectivity_index_add_edges
+ * \brief Adds edges to a connectivity index.
+ * 
+ * \param index The connectivity index.
+ * \param edges The edges to add, in the same format as for \ref
+ *    igraph_add_edges(): the endpoints of the first edge, then the
+ *    second edge, etc.
+ * \param eids Pointer to an initialized vector or a null pointer. If
+ *    not a null pointer, then the ids of the new edges are stored
+ *    here. The ids of deleted edges are reused first, the most
+ *    recently deleted one first; if there are none, then the edges
+ *    get consecutive new ids, like in \ref igraph_add_edges().
+ * \return Error code:
+ *    \c IGRAPH_EINVAL: odd number of vertex ids.
+ *    \c IGRAPH_EINVVID: invalid vertex id.
+ * 
+ * Time complexity: almost O(|edges|).
+ */
+
+int igraph_connectivity_index_add_edges(igraph_connectivity_index_t *index,
+					const igraph_vector_t *edges,
+					igraph_vector_t *eids) {
+  long int n=igraph_vector_size(edges);
+  long int no_of_slots=igraph_vector_char_size(&index->state);
+  long int no_of_free=igraph_vector_int_size(&index->free);
+  long int no_of_new= n/2 > no_of_free ? n/2 - no_of_free : 0;
+  long int i;
+
+  if (n % 2 != 0) {
+    IGRAPH_ERROR("Invalid (odd) edges vector", IGRAPH_EINVAL);
+  }
+  for (i=0; i<n; i++) {
+    if (VECTOR(*edges)[i] < 0 || VECTOR(*edges)[i] >= index->no_of_nodes) {
+      IGRAPH_ERROR("Invalid vertex id in edges vector", IGRAPH_EINVVID);
+    }
+  }
+
+  if (eids) { IGRAPH_CHECK(igraph_vector_resize(eids, n/2)); }
+  IGRAPH_CHECK(igraph_vector_int_resize(&index->edges, 
+					2*(no_of_slots+no_of_new)));
+  IGRAPH_CHECK(igraph_vector_int_resize(&index->inc_next, 
+					2*(no_of_slots+no_of_new)));
+  IGRAPH_CHECK(igraph_vector_int_resize(&index->inc_prev, 
+					2*(no_of_slots+no_of_new)));
+  IGRAPH_CHECK(igraph_vector_char_resize(&index->state, 
+					 no_of_slots+no_of_new));
+  for (i=0; i<n; i+=2) {
+    long int from=(long int) VECTOR(*edges)[i];
+    long int to=(long int) VECTOR(*edges)[i+1];
+    long int e= igraph_vector_int_empty(&index->free) ? no_of_slots++ :
+      igraph_vector_int_pop_back(&index->free);
+    VECTOR(index->edges)[2*e] = (int) from;
+    VECTOR(index->edges)[2*e+1] = (int) to;
+    igraph_i_connectivity_index_link(index, 2*e);
+    igraph_i_connectivity_index_link(index, 2*e+1);
+    VECTOR(index->state)[e] =
+      igraph_i_connectivity_index_union(index, from, to) ?
+      IGRAPH_I_CONN_FOREST : IGRAPH_I_CONN_OTHER;
+    if (eids) { VECTOR(*eids)[i/2] = e; }
+  }
+
+  return 0;
+}
+
+/**
+ * \function igraph_connectivity_index_delete_edges
+ * \brief Deletes edges from a connectivity index.
+ * 
+ * \param index The connectivity index.
+ * \param eids The ids of the edges to delete. See \ref
+ *    igraph_connectivity_index_init() for the edge ids of the index.
+ * \return Error code:
+ *    \c IGRAPH_EINVAL: invalid or already deleted edge id.
+ * 
+ * Time complexity: O(|eids|), plus the cost of rebuilding the
+ * components that lost a spanning forest edge, if a later query
+ * needs them.
+ */
+
+int igraph_connectivity_index_delete_edges(igraph_connectivity_index_t *index,
+					   const igraph_vector_t *eids) {
+  long int no_of_slots=igraph_vector_char_size(&index->state);
+  long int i, n=igraph_vector_size(eids);
+
+  for (i=0; i<n; i++) {
+    long int e=(long int) VECTOR(*eids)[i];
+    if (e < 0 || e >= no_of_slots ||
+	VECTOR(index->state)[e] == IGRAPH_I_CONN_DELETED) {
+      IGRAPH_ERROR("Invalid or already deleted edge id", IGRAPH_EINVAL);
+    }
+  }
+  IGRAPH_CHECK(igraph_vector_int_reserve(&index->free, 
+			 igraph_vector_int_size(&index->free) + n));
+  if (igraph_vector_int_size(&index->dirty_roots) > index->no_of_nodes) {
+    igraph_i_connectivity_index_compact(index);
+  }
+  IGRAPH_CHECK(igraph_vector_int_reserve(&index->dirty_roots,
+			 igraph_vector_int_size(&index->dirty_roots) + n));
+
+  for (i=0; i<n; i++) {
+    long int e=(long int) VECTOR(*eids)[i];
+    if (VECTOR(index->state)[e] == IGRAPH_I_CONN_DELETED) { 
+      continue;			/* duplicate id */
+    }
+    if (VECTOR(index->state)[e] == IGRAPH_I_CONN_FOREST) {
+      long int root=igraph_i_connectivity_index_find(index, 
+					     VECTOR(index->edges)[2*e]);
+      if (!VECTOR(index->dirty)[root]) {
+	VECTOR(index->dirty)[root] = 1;
+	igraph_vector_int_push_back(&index->dirty_roots, (int) root);
+      }
+    }
+    igraph_i_connectivity_index_unlink(index, 2*e);
+    igraph_i_connectivity_index_unlink(index, 2*e+1);
+    VECTOR(index->state)[e] = IGRAPH_I_CONN_DELETED;
+    igraph_vector_int_push_back(&index->free, (int) e); /* reserved */
+  }
+
+  return 0;
+}
+
+/**
+ * \function igraph_connectivity_index_same_component
+ * \brief Decides whether two vertices are in the same component.
+ * 
+ * \param index The connectivity index.
+ * \param res Pointer to a boolean, the result is stored here.
+ * \param from The first vertex.
+ * \param to The second vertex.
+ * \return Error code:
+ *    \c IGRAPH_EINVVID: invalid vertex id.
+ * 
+ * Time complexity: almost O(1), if the component of \p from lost no
+ * spanning forest edge since it was last rebuilt. Otherwise the cost
+ * of the rebuild, see \ref igraph_connectivity_index_init().
+ */
+
+int igraph_connectivity_index_same_component(igraph_connectivity_index_t *index,
+					     igraph_bool_t *res,
+					     igraph_integer_t from,
+					     igraph_integer_t to) {
+  long int r1, r2;
+
+  if (from < 0 || from >= index->no_of_nodes ||
+      to < 0 || to >= index->no_of_nodes) {
+    IGRAPH_ERROR("Invalid vertex id", IGRAPH_EINVVID);
+  }
+  r1=igraph_i_connectivity_index_find(index, from);
+  r2=igraph_i_connectivity_index_find(index, to);
+  if (r1 == r2 && VECTOR(index->dirty)[r1]) {
+    /* Different sets are never connected, as sets only split since
+       they became dirty */
+    IGRAPH_CHECK(igraph_i_connectivity_index_exact(index, from, &r1));
+    r2=igraph_i_connectivity_index_find(index, to);
+  }
+  *res = r1 == r2;
+  return 0;
+}
+
+/**
+ * \function igraph_connectivity_index_component_size
+ * \brief The size of the component of a vertex.
+ * 
+ * \param index The connectivity index.
+ * \param res Pointer to an integer, the number of vertices in the
+ *    component of \p vertex is stored here.
+ * \param vertex The vertex.
+ * \return Error code:
+ *    \c IGRAPH_EINVVID: invalid vertex id.
+ * 
+ * Time complexity: almost O(1), if the component lost no spanning
+ * forest edge since it was last rebuilt. Otherwise the cost of the
+ * rebuild, see \ref igraph_connectivity_index_init().
+ */
+
+int igraph_connectivity_index_component_size(igraph_connectivity_index_t *index,
+					     igraph_integer_t *res,
+					     igraph_integer_t vertex) {
+  long int root;
+
+  if (vertex < 0 || vertex >= index->no_of_nodes) {
+    IGRAPH_ERROR("Invalid vertex id", IGRAPH_EINVVID);
+  }
+  IGRAPH_CHECK(igraph_i_connectivity_index_exact(index, vertex, &root));
+  *res = VECTOR(index->size)[root];
+  return 0;
+}
+
+/**
+ * \function igraph_connectivity_index_count
+ * \brief The number of components.
+ * 
+ * \param index The connectivity index.
+ * \param res Pointer to an integer, the number of components is
+ *    stored here.
+ * \return Error code.
+ * 
+ * Time complexity: O(1), if no component lost a spanning forest edge
+ * since it was last rebuilt. Otherwise the cost of rebuilding these
+ * components, see \ref igraph_connectivity_index_init().
+ */
+
+int igraph_connectivity_index_count(igraph_connectivity_index_t *index,
+				    igraph_integer_t *res) {
+  IGRAPH_CHECK(igraph_i_connectivity_index_rebuild(index));
+  *res = index->no;
+  return 0;
+}
+
+/**
+ * \function igraph_connectivity_index_membership
+ * \brief The components of all vertices.
+ * 
+ * Gives the same result as \ref igraph_clusters() with \c IGRAPH_WEAK
+ * on the current graph.
+ *
+ * \param index The connectivity index.
+ * \param membership Pointer to an initialized vector or a null
+ *    pointer. If not a null pointer, then the component id of each
+ *    vertex is stored here. Components are numbered in the order of
+ *    their smallest vertex id.
+ * \param csize Pointer to an initialized vector or a null pointer. If
+ *    not a null pointer, then the sizes of the components are stored
+ *    here.
+ * \param no Pointer to an integer or a null pointer. If not a null
+ *    pointer, then the number of components is stored here.
+ * \return Error code.
+ * 
+ * Time complexity: almost O(|V|), plus the rebuild of the components
+ * that lost a spanning forest edge, see \ref
+ * igraph_connectivity_index_count().
+ */
+
+int igraph_connectivity_index_membership(igraph_connectivity_index_t *index,
+					 igraph_vector_t *membership,
+					 igraph_vector_t *csize,
+					 igraph_integer_t *no) {
+  long int no_of_nodes=index->no_of_nodes;
+  long int i, next=0;
+  igraph_vector_t ids;
+
+  IGRAPH_CHECK(igraph_i_connectivity_index_rebuild(index));
+
+  IGRAPH_VECTOR_INIT_FINALLY(&ids, no_of_nodes);
+  igraph_vector_fill(&ids, -1);
+  if (membership) {
+    IGRAPH_CHECK(igraph_vector_resize(membership, no_of_nodes));
+  }
+  if (csize) {
+    IGRAPH_CHECK(igraph_vector_resize(csize, index->no));
+  }
+  for (i=0; i<no_of_nodes; i++) {
+    long int root=igraph_i_connectivity_index_find(index, i);
+    if (VECTOR(ids)[root] < 0) {
+      if (csize) { VECTOR(*csize)[next] = VECTOR(index->size)[root]; }
+      VECTOR(ids)[root] = next++;
+    }
+    if (membership) { VECTOR(*membership)[i] = VECTOR(ids)[root]; }
+  }
+  if (no) { *no = index->no; }
+
+  igraph_vector_destroy(&ids);
+  IGRAPH_FINALLY_CLEAN(1);
+
+  return 0;
+}
@@ -0,0 +1,555 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=2 sts=2 sw=2 et: */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include "igraph_paths.h"
+#include "igraph_adjlist.h"
+#include "igraph_interface.h"
+#include "igraph_structural.h"
+#include "igraph_memory.h"
+#include "igraph_interrupt_internal.h"
+#include "config.h"
+
+#include <limits.h>
+
+/* The index is a pruned landmark labeling, see T. Akiba, Y. Iwata
+   and Y. Yoshida: Fast exact shortest-path distance queries on large
+   networks by pruned landmark labeling, SIGMOD 2013.
+
+   The vertices are ordered by decreasing degree, and a BFS is done
+   from each of them, in this order. The BFS from the vertex with rank
+   'k' adds the label (k, d) to each vertex at distance 'd', unless
+   the labels added so far already give a distance of at most 'd'
+   for this pair. In this case the BFS does not continue from that
+   vertex, either. The distance of two vertices is then the minimum
+   of d1+d2 over the common ranks of their labels. 
+
+   In directed graphs each vertex has 'out' labels, for distances
+   to the hubs, filled by the backward searches, and 'in' labels,
+   for distances from them, filled by the forward searches. Undirected
+   indices only have 'out' labels.
+
+   Labels are stored as (rank, distance) pairs, with increasing
+   ranks for each vertex. Label positions are kept in int vectors, so
+   the total number of labels must stay below INT_MAX/2. */
+
+static long int igraph_i_distance_index_dist(const int *l1, long int n1,
+					     const int *l2, long int n2) {
+  long int i=0, j=0;
+  long int best=-1;
+  while (i < n1 && j < n2) {
+    if (l1[2*i] < l2[2*j]) {
+      i++;
+    } else if (l1[2*i] > l2[2*j]) {
+      j++;
+    } else {
+      long int d=(long int) l1[2*i+1] + l2[2*j+1];
+      if (best < 0 || d < best) { best=d; }
+      i++; j++;
+    }
+  }
+  return best;
+}
+
+/* A pruned BFS from 'root' along 'csr'. 'rootlabels' are the labels
+   of the root in the opposite direction, 'labels' are extended. 
+   'tmp' is indexed by rank, 'dist' by vertex, both must be -1
+   everywhere, and they are restored before returning. */
+
+static int igraph_i_distance_index_bfs(const igraph_csr_t *csr, long int root,
+				       int rank, igraph_adjlist_t *rootlabels,
+				       igraph_adjlist_t *labels, int *tmp,
+				       int *dist, int *queue) {
+  igraph_vector_int_t *rl=igraph_adjlist_get(rootlabels, root);
+  long int i, nrl=igraph_vector_int_size(rl) / 2;
+  long int head=0, tail=0;
+
+  for (i=0; i<nrl; i++) {
+    tmp[ VECTOR(*rl)[2*i] ] = VECTOR(*rl)[2*i+1];
+  }
+
+  queue[tail++]=(int) root;
+  dist[root]=0;
+  while (head < tail) {
+    long int u=queue[head++];
+    int d=dist[u];
+    igraph_vector_int_t *ul=igraph_adjlist_get(labels, u);
+    long int nul=igraph_vector_int_size(ul);
+    int *neis;
+    long int nlen;
+    igraph_bool_t pruned=0;
+
+    for (i=0; i<nul; i+=2) {
+      int h=VECTOR(*ul)[i];
+      if (tmp[h] >= 0 && tmp[h] + VECTOR(*ul)[i+1] <= d) {
+	pruned=1;
+	break;
+      }
+    }
+    if (pruned) { continue; }
+
+    IGRAPH_CHECK(igraph_vector_int_push_back(ul, rank));
+    IGRAPH_CHECK(igraph_vector_int_push_back(ul, d));
+
+    neis=igraph_csr_neighbors(csr, u);
+    nlen=igraph_csr_degree(csr, u);
+    for (i=0; i<nlen; i++) {
+      int w=neis[i];
+      if (dist[w] < 0) {
+	dist[w]=d+1;
+	queue[tail++]=w;
+      }
+    }
+  }
+
+  for (i=0; i<tail; i++) {
+    dist[ queue[i] ] = -1;
+  }
+  for (i=0; i<nrl; i++) {
+    tmp[ VECTOR(*rl)[2*i] ] = -1;
+  }
+
+  return 0;
+}
+
+/* Copies the labels to a compressed form */
+
+static int igraph_i_distance_index_compress(igraph_adjlist_t *labels,
+					    igraph_vector_int_t *start,
+					    igraph_vector_int_t *data) {
+  long int i, n=labels->length, size=0;
+  IGRAPH_CHECK(igraph_vector_int_resize(start, n+1));
+  for (i=0; i<n; i++) {
+    VECTOR(*start)[i]=(int) size;
+    size += igraph_vector_int_size(igraph_adjlist_get(labels, i)) / 2;
+    if (size > INT_MAX/2) {
+      IGRAPH_ERROR("Distance index is too large", IGRAPH_EOVERFLOW);
+    }
+  }
+  VECTOR(*start)[n]=(int) size;
+  IGRAPH_CHECK(igraph_vector_int_resize(data, 2*size));
+  for (i=0; i<n; i++) {
+    igraph_vector_int_t *l=igraph_adjlist_get(labels, i);
+    long int j, len=igraph_vector_int_size(l);
+    for (j=0; j<len; j++) {
+      VECTOR(*data)[2*VECTOR(*start)[i]+j]=VECTOR(*l)[j];
+    }
+  }
+  return 0;
+}
+
+/**
+ * \function igraph_distance_index_init
+ * Builds an index for fast distance queries.
+ * 
+ * Computes labels for the vertices of a graph, from which the
+ * unweighted shortest path length between any two vertices can be
+ * calculated very quickly, using \ref igraph_distance_index_query().
+ * This is useful if many distance queries are answered for the same
+ * graph. The index can be saved to a file with \ref
+ * igraph_distance_index_write() and loaded again with \ref
+ * igraph_distance_index_read().
+ * 
+ * </para><para>The index is a pruned landmark labeling: each vertex
+ * stores its distance from some hub vertices, and each shortest path
+ * goes through a common hub of its endpoints. The number of labels
+ * depends on the structure of the graph, it is small for graphs with
+ * high degree vertices, e.g. for most social and web graphs, and it
+ * can be large for graphs like road networks or lattices.
+ * 
+ * </para><para>The index does not refer to the graph, it can be used
+ * after the graph was modified or destroyed, but it keeps the
+ * distances of the graph at the time it was built.
+ * 
+ * \param graph The input graph.
+ * \param index Pointer to an uninitialized distance index.
+ * \param directed Whether to consider directed paths in directed
+ *        graphs, it is ignored for undirected graphs.
+ * \return Error code, \c IGRAPH_EOVERFLOW if the index would have
+ *         more than <code>INT_MAX/2</code> labels.
+ * 
+ * Time complexity: O(|V|(|V|+|E|)) in the worst case, but it is
+ * typically much faster. The index has O(|V|^2) labels in the worst
+ * case.
+ * 
+ * \example examples/simple/igraph_distance_index.c
+ */
+
+int igraph_distance_index_init(const igraph_t *graph, 
+			       igraph_distance_index_t *index,
+			       igraph_bool_t directed) {
+  long int no_of_nodes=igraph_vcount(graph);
+  igraph_bool_t dir= directed && igraph_is_directed(graph);
+  igraph_csr_t outcsr, incsr;
+  igraph_adjlist_t outlabels, inlabels;
+  igraph_vector_t degree, order;
+  int *tmp, *dist, *queue;
+  long int i;
+
+  IGRAPH_VECTOR_INIT_FINALLY(&degree, 0);
+  IGRAPH_VECTOR_INIT_FINALLY(&order, 0);
+  IGRAPH_CHECK(igraph_degree(graph, &degree, igraph_vss_all(), IGRAPH_ALL,
+			     IGRAPH_LOOPS));
+  IGRAPH_CHECK(igraph_vector_qsort_ind(&degree, &order, /*descending=*/ 1));
+
+  IGRAPH_CHECK(igraph_csr_init(graph, &outcsr, dir ? IGRAPH_OUT : IGRAPH_ALL));
+  IGRAPH_FINALLY(igraph_csr_destroy, &outcsr);
+  IGRAPH_CHECK(igraph_adjlist_init_empty(&outlabels, 
+					 (igraph_integer_t) no_of_nodes));
+  IGRAPH_FINALLY(igraph_adjlist_destroy, &outlabels);
+  if (dir) {
+    IGRAPH_CHECK(igraph_csr_init(graph, &incsr, IGRAPH_IN));
+    IGRAPH_FINALLY(igraph_csr_destroy, &incsr);
+    IGRAPH_CHECK(igraph_adjlist_init_empty(&inlabels, 
+					   (igraph_integer_t) no_of_nodes));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &inlabels);
+  }
+
+  tmp=igraph_Calloc(no_of_nodes+1, int);
+  if (!tmp) {
+    IGRAPH_ERROR("Cannot build distance index", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, tmp);
+  dist=igraph_Calloc(no_of_nodes+1, int);
+  if (!dist) {
+    IGRAPH_ERROR("Cannot build distance index", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, dist);
+  queue=igraph_Calloc(no_of_nodes+1, int);
+  if (!queue) {
+    IGRAPH_ERROR("Cannot build distance index", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, queue);
+  for (i=0; i<no_of_nodes; i++) {
+    tmp[i]=dist[i]=-1;
+  }
+
+  for (i=0; i<no_of_nodes; i++) {
+    long int root=(long int) VECTOR(order)[i];
+    IGRAPH_ALLOW_INTERRUPTION();
+    if (dir) {
+      /* Forward search: distances from the root, the root's out 
+	 labels and the other vertices' in labels give the known 
+	 distances. Then backward. */
+      IGRAPH_CHECK(igraph_i_distance_index_bfs(&outcsr, root, (int) i, 
+					       &outlabels, &inlabels,
+					       tmp, dist, queue));
+      IGRAPH_CHECK(igraph_i_distance_index_bfs(&incsr, root, (int) i, 
+					       &inlabels, &outlabels,
+					       tmp, dist, queue));
+    } else {
+      IGRAPH_CHECK(igraph_i_distance_index_bfs(&outcsr, root, (int) i, 
+					       &outlabels, &outlabels,
+					       tmp, dist, queue));
+    }
+  }
+
+  igraph_Free(queue);
+  igraph_Free(dist);
+  igraph_Free(tmp);
+  IGRAPH_FINALLY_CLEAN(3);
+
+  index->no_of_nodes=(igraph_integer_t) no_of_nodes;
+  index->directed=dir;
+  IGRAPH_CHECK(igraph_vector_int_init(&index->out_start, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->out_start);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->out_labels, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->out_labels);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->in_start, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->in_start);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->in_labels, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->in_labels);
+
+  IGRAPH_CHECK(igraph_i_distance_index_compress(&outlabels, &index->out_start,
+						&index->out_labels));
+  if (dir) {
+    IGRAPH_CHECK(igraph_i_distance_index_compress(&inlabels, &index->in_start,
+						  &index->in_labels));
+  }
+  IGRAPH_FINALLY_CLEAN(4);
+
+  if (dir) {
+    igraph_adjlist_destroy(&inlabels);
+    igraph_csr_destroy(&incsr);
+    IGRAPH_FINALLY_CLEAN(2);
+  }
+  igraph_adjlist_destroy(&outlabels);
+  igraph_csr_destroy(&outcsr);
+  igraph_vector_destroy(&order);
+  igraph_vector_destroy(&degree);
+  IGRAPH_FINALLY_CLEAN(4);
+
+  return 0;
+}
+
+/**
+ * \function igraph_distance_index_destroy
+ * Deallocates the memory of a distance index.
+ * 
+ * \param index The index to destroy.
+ * 
+ * Time complexity: operating system dependent.
+ */
+
+void igraph_distance_index_destroy(igraph_distance_index_t *index) {
+  igraph_vector_int_destroy(&index->in_labels);
+  igraph_vector_int_destroy(&index->in_start);
+  igraph_vector_int_destroy(&index->out_labels);
+  igraph_vector_int_destroy(&index->out_start);
+}
+
+/**
+ * \function igraph_distance_index_size
+ * The number of labels in a distance index.
+ * 
+ * The query time is proportional to the number of labels of the two
+ * vertices, this function gives the total number of labels, over all
+ * vertices and both directions.
+ * 
+ * \param index The distance index.
+ * \return The number of labels.
+ * 
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_distance_index_size(const igraph_distance_index_t *index) {
+  return (igraph_integer_t) (igraph_vector_int_size(&index->out_labels) / 2 +
+			     igraph_vector_int_size(&index->in_labels) / 2);
+}
+
+/**
+ * \function igraph_distance_index_query
+ * Distance of two vertices from a distance index.
+ * 
+ * \param index The distance index, created by \ref 
+ *        igraph_distance_index_init() or \ref 
+ *        igraph_distance_index_read().
+ * \param res Pointer to a real number, the length of the shortest
+ *        path from \p from to \p to is stored here, or \c
+ *        IGRAPH_INFINITY if there is no such path.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \return Error code, \c IGRAPH_EINVVID if a vertex id is invalid.
+ * 
+ * Time complexity: O(l), the number of labels of the two vertices.
+ */
+
+int igraph_distance_index_query(const igraph_distance_index_t *index,
+				igraph_real_t *res, igraph_integer_t from,
+				igraph_integer_t to) {
+  const igraph_vector_int_t *instart= index->directed ? 
+    &index->in_start : &index->out_start;
+  const igraph_vector_int_t *inlabels= index->directed ? 
+    &index->in_labels : &index->out_labels;
+  long int f=(long int) from, t=(long int) to;
+  long int fs, ts;
+  long int d;
+
+  if (from < 0 || from >= index->no_of_nodes || 
+      to < 0 || to >= index->no_of_nodes) {
+    IGRAPH_ERROR("Invalid vertex id in distance query", IGRAPH_EINVVID);
+  }
+  
+  fs=VECTOR(index->out_start)[f];
+  ts=VECTOR(*instart)[t];
+  d=igraph_i_distance_index_dist(VECTOR(index->out_labels) + 2*fs, 
+				 VECTOR(index->out_start)[f+1] - fs,
+				 VECTOR(*inlabels) + 2*ts,
+				 VECTOR(*instart)[t+1] - ts);
+  *res= d < 0 ? IGRAPH_INFINITY : d;
+  return 0;
+}
+
+/**
+ * \function igraph_distance_index_query_pairs
+ * Distances of many vertex pairs from a distance index.
+ * 
+ * \param index The distance index, created by \ref 
+ *        igraph_distance_index_init() or \ref 
+ *        igraph_distance_index_read().
+ * \param res Pointer to an initialized vector, the distances are
+ *        stored here, it is resized as needed. Unreachable pairs have
+ *        distance \c IGRAPH_INFINITY.
+ * \param from The source vertices.
+ * \param to The target vertices, it must have the same length as \p
+ *        from. The distance from <code>from[i]</code> to
+ *        <code>to[i]</code> is stored in <code>res[i]</code>.
+ * \return Error code, \c IGRAPH_EINVVID if a vertex id is invalid.
+ * 
+ * Time complexity: O(p l), the number of pairs times the number of
+ * labels of a vertex pair.
+ */
+
+int igraph_distance_index_query_pairs(const igraph_distance_index_t *index,
+				      igraph_vector_t *res, 
+				      const igraph_vector_t *from,
+				      const igraph_vector_t *to) {
+  long int i, n=igraph_vector_size(from);
+  if (igraph_vector_size(to) != n) {
+    IGRAPH_ERROR("`from' and `to' must have the same length", IGRAPH_EINVAL);
+  }
+  IGRAPH_CHECK(igraph_vector_resize(res, n));
+  for (i=0; i<n; i++) {
+    IGRAPH_CHECK(igraph_distance_index_query(index, &VECTOR(*res)[i],
+					     (igraph_integer_t) VECTOR(*from)[i],
+					     (igraph_integer_t) VECTOR(*to)[i]));
+  }
+  return 0;
+}
+
+static int igraph_i_distance_index_write_labels(FILE *outstream, 
+						const igraph_vector_int_t *start,
+						const igraph_vector_int_t *labels) {
+  long int i, j, n=igraph_vector_int_size(start)-1;
+  for (i=0; i<n; i++) {
+    long int s=VECTOR(*start)[i], e=VECTOR(*start)[i+1];
+    if (fprintf(outstream, "%li", e-s) < 0) {
+      IGRAPH_ERROR("Write error", IGRAPH_EFILE);
+    }
+    for (j=s; j<e; j++) {
+      if (fprintf(outstream, " %d %d", VECTOR(*labels)[2*j], 
+		  VECTOR(*labels)[2*j+1]) < 0) {
+	IGRAPH_ERROR("Write error", IGRAPH_EFILE);
+      }
+    }
+    if (fprintf(outstream, "\n") < 0) {
+      IGRAPH_ERROR("Write error", IGRAPH_EFILE);
+    }
+  }
+  return 0;
+}
+
+/**
+ * \function igraph_distance_index_write
+ * Writes a distance index to a file.
+ * 
+ * The index is written in a simple text format, that can be read
+ * back by \ref igraph_distance_index_read(). The first line
+ * identifies the format, the second contains the number of vertices
+ * and whether the index is directed. Then there is one line for each
+ * vertex, with the number of its labels and the labels themselves,
+ * as pairs of hub rank and distance. Directed indices have two such
+ * blocks, for the distances to and from the hubs.
+ * 
+ * \param index The distance index to write.
+ * \param outstream Pointer to a stream, it should be writable.
+ * \return Error code, \c IGRAPH_EFILE if there is an error writing
+ *         the file.
+ * 
+ * Time complexity: O(|V|+l), the number of vertices and labels.
+ */
+
+int igraph_distance_index_write(const igraph_distance_index_t *index,
+				FILE *outstream) {
+  if (fprintf(outstream, "igraph_distance_index 1\n%li %d\n", 
+	      (long int) index->no_of_nodes, index->directed ? 1 : 0) < 0) {
+    IGRAPH_ERROR("Write error", IGRAPH_EFILE);
+  }
+  IGRAPH_CHECK(igraph_i_distance_index_write_labels(outstream, 
+			&index->out_start, &index->out_labels));
+  if (index->directed) {
+    IGRAPH_CHECK(igraph_i_distance_index_write_labels(outstream, 
+			&index->in_start, &index->in_labels));
+  }
+  return 0;
+}
+
+static int igraph_i_distance_index_read_labels(FILE *instream, long int n,
+					       igraph_vector_int_t *start,
+					       igraph_vector_int_t *labels) {
+  long int i, j, size=0;
+  IGRAPH_CHECK(igraph_vector_int_resize(start, n+1));
+  for (i=0; i<n; i++) {
+    long int len;
+    int prev=-1;
+    VECTOR(*start)[i]=(int) size;
+    if (fscanf(instream, "%li", &len) != 1 || len < 0 || len > n) {
+      IGRAPH_ERROR("Invalid distance index file", IGRAPH_PARSEERROR);
+    }
+    for (j=0; j<len; j++) {
+      int rank, dist;
+      if (fscanf(instream, "%d %d", &rank, &dist) != 2 || 
+	  rank <= prev || rank >= n || dist < 0 || dist >= n) {
+	IGRAPH_ERROR("Invalid distance index file", IGRAPH_PARSEERROR);
+      }
+      IGRAPH_CHECK(igraph_vector_int_push_back(labels, rank));
+      IGRAPH_CHECK(igraph_vector_int_push_back(labels, dist));
+      prev=rank;
+    }
+    size += len;
+    if (size > INT_MAX/2) {
+      IGRAPH_ERROR("Distance index is too large", IGRAPH_EOVERFLOW);
+    }
+  }
+  VECTOR(*start)[n]=(int) size;
+  return 0;
+}
+
+/**
+ * \function igraph_distance_index_read
+ * Reads a distance index from a file.
+ * 
+ * \param index Pointer to an uninitialized distance index.
+ * \param instream Pointer to a stream, it should be readable. It must
+ *        contain an index written by \ref igraph_distance_index_write().
+ * \return Error code, \c IGRAPH_PARSEERROR if the file is not a valid
+ *         distance index, \c IGRAPH_EOVERFLOW if it has too many labels.
+ * 
+ * Time complexity: O(|V|+l), the number of vertices and labels.
+ */
+
+int igraph_distance_index_read(igraph_distance_index_t *index, 
+			       FILE *instream) {
+  long int n;
+  int version, directed;
+
+  if (fscanf(instream, " igraph_distance_index %d", &version) != 1 || 
+      version != 1) {
+    IGRAPH_ERROR("Not a distance index file", IGRAPH_PARSEERROR);
+  }
+  if (fscanf(instream, "%li %d", &n, &directed) != 2 || n < 0 || 
+      n > INT_MAX || (directed != 0 && directed != 1)) {
+    IGRAPH_ERROR("Invalid distance index file", IGRAPH_PARSEERROR);
+  }
+
+  IGRAPH_CHECK(igraph_vector_int_init(&index->out_start, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->out_start);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->out_labels, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->out_labels);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->in_start, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->in_start);
+  IGRAPH_CHECK(igraph_vector_int_init(&index->in_labels, 0));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &index->in_labels);
+
+  IGRAPH_CHECK(igraph_i_distance_index_read_labels(instream, n, 
+			&index->out_start, &index->out_labels));
+  if (directed) {
+    IGRAPH_CHECK(igraph_i_distance_index_read_labels(instream, n,
+			&index->in_start, &index->in_labels));
+  }
+  index->no_of_nodes=(igraph_integer_t) n;
+  index->directed=directed;
+
+  IGRAPH_FINALLY_CLEAN(4);
+  return 0;
+}
@@ -23,99 +23,71 @@
 */
 
 #include "igraph_datatype.h"
-#include "igraph_dqueue.h"
 #include "igraph_iterators.h"
 #include "igraph_interrupt_internal.h"
 #include "igraph_vector.h"
 #include "igraph_interface.h"
 #include "igraph_adjlist.h"
+#include "igraph_msbfs_internal.h"
+
+typedef struct igraph_i_eccentricity_data_t {
+  igraph_vector_t *res;
+  long int row;
+} igraph_i_eccentricity_data_t;
+
+static int igraph_i_eccentricity_handler(long int vertex, 
+					 igraph_i_msbfs_word_t mask,
+					 long int dist, void *extra) {
+  igraph_i_eccentricity_data_t *data=(igraph_i_eccentricity_data_t*) extra;
+  IGRAPH_UNUSED(vertex);
+  /* The levels come in increasing order */
+  while (mask) {
+    int b=IGRAPH_I_MSBFS_LOWEST(mask);
+    VECTOR(*data->res)[data->row + b]=dist;
+    mask &= mask-1;
+  }
+  return 0;
+}
 
-int igraph_i_eccentricity(const igraph_t *graph,
-			  igraph_vector_t *res,
-			  igraph_vs_t vids,
-			  igraph_neimode_t mode,
-			  const igraph_adjlist_t *adjlist) {
+static int igraph_i_eccentricity(const igraph_t *graph,
+				 igraph_vector_t *res,
+				 igraph_vs_t vids,
+				 igraph_neimode_t mode) {
 
-  int no_of_nodes=igraph_vcount(graph);
-  igraph_dqueue_long_t q;
   igraph_vit_t vit;
-  igraph_vector_int_t counted;
-  int i, mark=1;
-  igraph_vector_t vneis;
-  igraph_vector_int_t *neis;
+  igraph_csr_t csr;
+  igraph_i_msbfs_t bfs;
+  long int sources[IGRAPH_I_MSBFS_WIDTH];
+  igraph_i_eccentricity_data_t data;
+  long int i, nsrc, no_of_vids;
 
-  IGRAPH_CHECK(igraph_dqueue_long_init(&q, 100));
-  IGRAPH_FINALLY(igraph_dqueue_long_destroy, &q);
-  
   IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
   IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+  no_of_vids=IGRAPH_VIT_SIZE(vit);
 
-  IGRAPH_CHECK(igraph_vector_int_init(&counted, no_of_nodes));
-  IGRAPH_FINALLY(igraph_vector_int_destroy, &counted);
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, mode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
+  IGRAPH_CHECK(igraph_i_msbfs_init(&bfs, &csr));
+  IGRAPH_FINALLY(igraph_i_msbfs_destroy, &bfs);
 
-  if (!adjlist) {
-    IGRAPH_VECTOR_INIT_FINALLY(&vneis, 0);
-  }
-
-  IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
+  IGRAPH_CHECK(igraph_vector_resize(res, no_of_vids));
   igraph_vector_fill(res, -1);
 
-  for (i=0, IGRAPH_VIT_RESET(vit); 
-       !IGRAPH_VIT_END(vit); 
-       IGRAPH_VIT_NEXT(vit), mark++, i++) {
-
-    long int source;
-    source=IGRAPH_VIT_GET(vit);
-    IGRAPH_CHECK(igraph_dqueue_long_push(&q, source));
-    IGRAPH_CHECK(igraph_dqueue_long_push(&q, 0));
-    VECTOR(counted)[source]=mark;
-    
-    IGRAPH_ALLOW_INTERRUPTION();
-    
-    while (!igraph_dqueue_long_empty(&q)) {
-      long int act=igraph_dqueue_long_pop(&q);
-      long int dist=igraph_dqueue_long_pop(&q);
-      int j, n;
-
-      if (dist > VECTOR(*res)[i]) {
-	VECTOR(*res)[i]=dist;
-      }
-
-      if (adjlist) {
-	neis=igraph_adjlist_get(adjlist, act);
-	n=(int) igraph_vector_int_size(neis);
-	for (j=0; j<n; j++) {
-	  int nei=(int) VECTOR(*neis)[j];
-	  if (VECTOR(counted)[nei] != mark) {
-	    VECTOR(counted)[nei]=mark;
-	    IGRAPH_CHECK(igraph_dqueue_long_push(&q, nei));
-	    IGRAPH_CHECK(igraph_dqueue_long_push(&q, dist+1));
-	  }
-	}  
-      } else {
-	IGRAPH_CHECK(igraph_neighbors(graph, &vneis,
-				      (igraph_integer_t) act, mode));
-	n=(int) igraph_vector_size(&vneis);
-	for (j=0; j<n; j++) {
-	  int nei=(int) VECTOR(vneis)[j];
-	  if (VECTOR(counted)[nei] != mark) {
-	    VECTOR(counted)[nei]=mark;
-	    IGRAPH_CHECK(igraph_dqueue_long_push(&q, nei));
-	    IGRAPH_CHECK(igraph_dqueue_long_push(&q, dist+1));
-	  }
-	}  
-      }
-    } /* while !igraph_dqueue_long_empty(dqueue) */
-
-  } /* for IGRAPH_VIT_NEXT(vit) */
-
-  if (!adjlist) {
-    igraph_vector_destroy(&vneis);
-    IGRAPH_FINALLY_CLEAN(1);
+  /* Searches from IGRAPH_I_MSBFS_WIDTH vertices at once */
+  data.res=res;
+  for (i=0; i<no_of_vids; i+=nsrc) {
+    for (nsrc=0; nsrc < IGRAPH_I_MSBFS_WIDTH && !IGRAPH_VIT_END(vit);
+	 nsrc++, IGRAPH_VIT_NEXT(vit)) {
+      sources[nsrc]=IGRAPH_VIT_GET(vit);
+    }
+    data.row=i;
+    IGRAPH_CHECK(igraph_i_msbfs_run(&bfs, sources, (int) nsrc, -1,
+				    igraph_i_eccentricity_handler, &data));
   }
-  igraph_vector_int_destroy(&counted);
+
+  igraph_i_msbfs_destroy(&bfs);
+  igraph_csr_destroy(&csr);
   igraph_vit_destroy(&vit);
-  igraph_dqueue_long_destroy(&q);
   IGRAPH_FINALLY_CLEAN(3);
   
   return 0;
@@ -158,7 +130,7 @@ int igraph_eccentricity(const igraph_t *graph,
 			igraph_vs_t vids,
 			igraph_neimode_t mode) {
 
-  return igraph_i_eccentricity(graph, res, vids, mode, /*adjlist=*/ 0);
+  return igraph_i_eccentricity(graph, res, vids, mode);
 }
 
 /**
@@ -194,17 +166,13 @@ int igraph_radius(const igraph_t *graph, igraph_real_t *radius,
   if (no_of_nodes==0) {
     *radius = IGRAPH_NAN;
   } else {
-    igraph_adjlist_t adjlist;
     igraph_vector_t ecc;
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
     IGRAPH_VECTOR_INIT_FINALLY(&ecc, igraph_vcount(graph));
     IGRAPH_CHECK(igraph_i_eccentricity(graph, &ecc, igraph_vss_all(), 
-				       mode, &adjlist));
+				       mode));
     *radius = igraph_vector_min(&ecc);
     igraph_vector_destroy(&ecc);
-    igraph_adjlist_destroy(&adjlist);
-    IGRAPH_FINALLY_CLEAN(2);
+    IGRAPH_FINALLY_CLEAN(1);
   }
   
   return 0;
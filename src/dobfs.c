@@ -0,0 +1,172 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=2 sts=2 sw=2 et: */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include "igraph_dobfs_internal.h"
+#include "igraph_memory.h"
+#include "igraph_interrupt_internal.h"
+#include "config.h"
+
+int igraph_i_dobfs_init(igraph_i_dobfs_t *bfs, const igraph_csr_t *out,
+			const igraph_csr_t *in) {
+  long int no_of_nodes=igraph_csr_size(out), i;
+  bfs->out=out;
+  bfs->in=in;
+  bfs->no_of_nodes=no_of_nodes;
+  bfs->unexplored=VECTOR(out->start)[no_of_nodes];
+  bfs->unseen=no_of_nodes;
+  bfs->ntodo=no_of_nodes;
+  bfs->seen=igraph_Calloc(no_of_nodes+1, char);
+  bfs->infrontier=igraph_Calloc(no_of_nodes+1, char);
+  bfs->frontier=igraph_Calloc(no_of_nodes+1, int);
+  bfs->next=igraph_Calloc(no_of_nodes+1, int);
+  bfs->todo=igraph_Calloc(no_of_nodes+1, int);
+  if (!bfs->seen || !bfs->infrontier || !bfs->frontier || !bfs->next ||
+      !bfs->todo) {
+    igraph_i_dobfs_destroy(bfs);
+    IGRAPH_ERROR("Cannot run breadth-first search", IGRAPH_ENOMEM);
+  }
+  for (i=0; i<no_of_nodes; i++) { bfs->todo[i]=(int) i; }
+  return 0;
+}
+
+void igraph_i_dobfs_destroy(igraph_i_dobfs_t *bfs) {
+  if (bfs->seen) { igraph_Free(bfs->seen); }
+  if (bfs->infrontier) { igraph_Free(bfs->infrontier); }
+  if (bfs->frontier) { igraph_Free(bfs->frontier); }
+  if (bfs->next) { igraph_Free(bfs->next); }
+  if (bfs->todo) { igraph_Free(bfs->todo); }
+}
+
+void igraph_i_dobfs_exclude(igraph_i_dobfs_t *bfs, long int vertex) {
+  if (!bfs->seen[vertex]) {
+    bfs->seen[vertex]=1;
+    bfs->unseen--;
+    bfs->unexplored -= igraph_csr_degree(bfs->out, vertex);
+  }
+}
+
+int igraph_i_dobfs_run(igraph_i_dobfs_t *bfs, long int root, 
+		       igraph_real_t *dist, long int *reached) {
+  const igraph_csr_t *out=bfs->out, *in=bfs->in;
+  long int no_of_nodes=bfs->no_of_nodes;
+  char *seen=bfs->seen, *infrontier=bfs->infrontier;
+  int *frontier=bfs->frontier, *next=bfs->next, *todo=bfs->todo, *tmp;
+  long int nfrontier=0, nnext, prevfrontier=0, found=0;
+  long int i, j, level=0;
+  igraph_bool_t bottomup=0;
+
+  if (seen[root]) {
+    if (reached) { *reached=0; }
+    return 0;
+  }
+
+  seen[root]=1;
+  bfs->unseen--;
+  bfs->unexplored -= igraph_csr_degree(out, root);
+  frontier[nfrontier++]=(int) root;
+  if (dist) { dist[root]=0; }
+  found=1;
+
+  while (nfrontier > 0) {
+    IGRAPH_ALLOW_INTERRUPTION();
+
+    /* Choose the direction of this step. Bottom-up steps check the
+       unseen vertices and their edges, so they are only used while
+       the frontier has a good share of the remaining edges. */
+    if (!bottomup) {
+      long int frontieredges=0;
+      for (i=0; i<nfrontier; i++) {
+	frontieredges += igraph_csr_degree(out, frontier[i]);
+      }
+      if (nfrontier > prevfrontier && frontieredges > 
+	  (bfs->unexplored + bfs->unseen) / IGRAPH_I_DOBFS_ALPHA) {
+	bottomup=1;
+	for (i=0; i<nfrontier; i++) { infrontier[ frontier[i] ]=1; }
+      }
+    } else if (nfrontier < prevfrontier && 
+	       nfrontier < no_of_nodes / IGRAPH_I_DOBFS_BETA) {
+      bottomup=0;
+      for (i=0; i<nfrontier; i++) { infrontier[ frontier[i] ]=0; }
+    }
+
+    nnext=0;
+    if (bottomup) {
+      /* 'todo' holds the unseen vertices, and some that were seen
+	 by top-down steps since the last compaction */
+      long int ntodo=0;
+      for (i=0; i<bfs->ntodo; i++) {
+	long int v=todo[i];
+	int *neis;
+	long int nlen;
+	if (seen[v]) { continue; }
+	neis=igraph_csr_neighbors(in, v);
+	nlen=igraph_csr_degree(in, v);
+	for (j=0; j<nlen; j++) {
+	  if (infrontier[ neis[j] ]) { break; }
+	}
+	if (j < nlen) {
+	  next[nnext++]=(int) v;
+	} else {
+	  todo[ntodo++]=(int) v;
+	}
+      }
+      bfs->ntodo=ntodo;
+      /* Mark the new vertices only now, so that they cannot act as
+	 parents within the same level */
+      for (i=0; i<nfrontier; i++) { infrontier[ frontier[i] ]=0; }
+      for (i=0; i<nnext; i++) {
+	seen[ next[i] ]=1;
+	infrontier[ next[i] ]=1;
+      }
+    } else {
+      for (i=0; i<nfrontier; i++) {
+	int *neis=igraph_csr_neighbors(out, frontier[i]);
+	long int nlen=igraph_csr_degree(out, frontier[i]);
+	for (j=0; j<nlen; j++) {
+	  long int w=neis[j];
+	  if (!seen[w]) {
+	    seen[w]=1;
+	    next[nnext++]=(int) w;
+	  }
+	}
+      }
+    }
+    level++;
+
+    bfs->unseen -= nnext;
+    for (i=0; i<nnext; i++) {
+      bfs->unexplored -= igraph_csr_degree(out, next[i]);
+      if (dist) { dist[ next[i] ]=level; }
+    }
+    found += nnext;
+
+    tmp=frontier; frontier=next; next=tmp;
+    prevfrontier=nfrontier;
+    nfrontier=nnext;
+  }
+
+  if (reached) { *reached=found; }
+
+  return 0;
+}
@@ -120,7 +120,11 @@ struct igraph_i_graphml_parser_state {
   igraph_attribute_elemtype_t data_type;
   char *error_message;
   char *data_char;
+  igraph_bool_t data_skip;
   long int act_node;
+  const igraph_strvector_t *keep_attrs;
+  igraph_bool_t keep_edge_ids;
+  igraph_trie_t skipped_keys;
 };
 
 static void igraph_i_report_unhandled_attribute_target(const char* target,
@@ -169,11 +173,11 @@ void igraph_i_graphml_attribute_record_destroy(igraph_i_graphml_attribute_record
   } else if (rec->record.type==IGRAPH_ATTRIBUTE_STRING) {
     if (rec->record.value != 0) {
       igraph_strvector_destroy((igraph_strvector_t*)rec->record.value);
-      if (rec->default_value.as_string != 0) {
-	igraph_Free(rec->default_value.as_string);
-      }
       igraph_Free(rec->record.value);
     }
+    if (rec->default_value.as_string != 0) {
+      igraph_Free(rec->default_value.as_string);
+    }
   } else if (rec->record.type==IGRAPH_ATTRIBUTE_BOOLEAN) {
     if (rec->record.value != 0) {
       igraph_vector_bool_destroy((igraph_vector_bool_t*)rec->record.value);
@@ -198,6 +202,7 @@ void igraph_i_graphml_destroy_state(struct igraph_i_graphml_parser_state* state)
   igraph_trie_destroy(&state->v_names);
   igraph_trie_destroy(&state->e_names);
   igraph_trie_destroy(&state->g_names);
+  igraph_trie_destroy(&state->skipped_keys);
   igraph_vector_destroy(&state->edgelist);
   igraph_vector_int_destroy(&state->prev_state_stack);
    
@@ -248,6 +253,50 @@ void igraph_i_graphml_handle_unknown_start_tag(struct igraph_i_graphml_parser_st
   }
 }
 
+/* Whether the values of the attribute called 'name' are needed at all.
+ * Without an attribute handler they would be thrown away by
+ * igraph_add_vertices() and friends, so we do not even store them. */
+static igraph_bool_t igraph_i_graphml_keep_attribute(
+    const struct igraph_i_graphml_parser_state *state, const char *name) {
+  long int i, n;
+  if (!igraph_has_attribute_table()) {
+    return 0;
+  }
+  if (state->keep_attrs == 0) {
+    return 1;
+  }
+  n=igraph_strvector_size(state->keep_attrs);
+  for (i=0; i<n; i++) {
+    if (!strcmp(STR(*state->keep_attrs, i), name)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Releases the values of an attribute column that was already copied
+ * into the graph, to lower the peak memory usage while the edges are
+ * being added. */
+static void igraph_i_graphml_attribute_record_clear(
+    igraph_i_graphml_attribute_record_t* rec) {
+  if (rec->record.type==IGRAPH_ATTRIBUTE_NUMERIC) {
+    igraph_vector_t *vec=(igraph_vector_t*)rec->record.value, empty;
+    if (igraph_vector_init(&empty, 0) == 0) {
+      igraph_vector_destroy(vec);
+      *vec=empty;
+    }
+  } else if (rec->record.type==IGRAPH_ATTRIBUTE_STRING) {
+    igraph_strvector_resize((igraph_strvector_t*)rec->record.value, 0);
+  } else if (rec->record.type==IGRAPH_ATTRIBUTE_BOOLEAN) {
+    igraph_vector_bool_t *boolvec=(igraph_vector_bool_t*)rec->record.value,
+      empty;
+    if (igraph_vector_bool_init(&empty, 0) == 0) {
+      igraph_vector_bool_destroy(boolvec);
+      *boolvec=empty;
+    }
+  }
+}
+
 void igraph_i_graphml_sax_handler_start_document(void *state0) {
   struct igraph_i_graphml_parser_state *state=
     (struct igraph_i_graphml_parser_state*)state0;
@@ -260,7 +309,9 @@ void igraph_i_graphml_sax_handler_start_document(void *state0) {
   state->data_key=0;
   state->error_message=0;
   state->data_char=0;
+  state->data_skip=0;
   state->unknown_depth=0;
+  state->keep_edge_ids=igraph_i_graphml_keep_attribute(state, "id");
 
   ret=igraph_vector_int_init(&state->prev_state_stack, 0);
   if (ret) {
@@ -331,8 +382,14 @@ void igraph_i_graphml_sax_handler_start_document(void *state0) {
     RETURN_GRAPHML_PARSE_ERROR_WITH_CODE(state, "Cannot parse GraphML file", ret);
   }
   IGRAPH_FINALLY(igraph_trie_destroy, &state->g_names);
+
+  ret=igraph_trie_init(&state->skipped_keys, 0);
+  if (ret) {
+    RETURN_GRAPHML_PARSE_ERROR_WITH_CODE(state, "Cannot parse GraphML file", ret);
+  }
+  IGRAPH_FINALLY(igraph_trie_destroy, &state->skipped_keys);
   
-  IGRAPH_FINALLY_CLEAN(10);
+  IGRAPH_FINALLY_CLEAN(11);
   IGRAPH_FINALLY(igraph_i_graphml_destroy_state, state);
 }
 
@@ -416,7 +473,8 @@ void igraph_i_graphml_sax_handler_end_document(void *state0) {
       }
       VECTOR(vattr)[i]=rec;
     }
-    if (!already_has_vertex_id) {
+    if (!already_has_vertex_id &&
+	igraph_i_graphml_keep_attribute(state, idstr)) {
       idrec.name=idstr;
       idrec.type=IGRAPH_ATTRIBUTE_STRING;
       tmp=&idrec.value;
@@ -513,6 +571,9 @@ void igraph_i_graphml_sax_handler_end_document(void *state0) {
     igraph_empty_attrs(state->g, 0, state->edges_directed, &gattr);
     igraph_add_vertices(state->g, (igraph_integer_t) 
 			igraph_trie_size(&state->node_trie), &vattr);
+    for (i=0; i<igraph_vector_ptr_size(&state->v_attrs); i++) {
+      igraph_i_graphml_attribute_record_clear(VECTOR(state->v_attrs)[i]);
+    }
     igraph_add_edges(state->g, &state->edgelist, &eattr);
 
     igraph_vector_ptr_destroy(&vattr);
@@ -659,9 +720,21 @@ igraph_i_graphml_attribute_record_t* igraph_i_graphml_add_attribute_key(
     return 0;
   }
 	
+  /* attributes that are not needed are remembered, so that their <data>
+   * tags can be dropped without parsing or storing their values */
+  if (!skip && !igraph_i_graphml_keep_attribute(state, rec->record.name)) {
+    ret=igraph_trie_get(&state->skipped_keys, rec->id, &id);
+    if (ret) {
+      GRAPHML_PARSE_ERROR_WITH_CODE(state, "Cannot parse GraphML file", ret);
+      return 0;
+    }
+    skip=1;
+  }
+	
   /* if the code above requested skipping the attribute, free everything and
    * return */
   if (skip) {
+    igraph_i_graphml_attribute_record_destroy(rec);
     igraph_free(rec);
     IGRAPH_FINALLY_CLEAN(1);
     return 0;
@@ -728,10 +801,12 @@ void igraph_i_graphml_attribute_data_setup(struct igraph_i_graphml_parser_state
 					   igraph_attribute_elemtype_t type) {
   xmlChar **it;
   int i;
+  long int skipped;
 
   if (!state->successful)
     return;
 
+  state->data_skip=0;
   for (i=0, it=(xmlChar**)attrs; i < nb_attrs; i++, it+=5) {
     if (XML_ATTR_URI(it) != 0 &&
 	!xmlStrEqual(toXmlChar(GRAPHML_NAMESPACE_URI), XML_ATTR_URI(it)))
@@ -747,6 +822,9 @@ void igraph_i_graphml_attribute_data_setup(struct igraph_i_graphml_parser_state
       }
       state->data_char=0;
       state->data_type=type;
+      igraph_trie_check(&state->skipped_keys, fromXmlChar(state->data_key),
+			&skipped);
+      state->data_skip = skipped >= 0;
     } else {
       /* ignore */
     }
@@ -783,6 +861,13 @@ void igraph_i_graphml_attribute_data_finish(struct igraph_i_graphml_parser_state
   igraph_attribute_record_t *rec;
   long int recid, id=0;
   int ret;
+
+  if (state->data_skip) {
+    if (state->data_char) {
+      igraph_Free(state->data_char);
+    }
+    return;
+  }
   
   switch (type) {
   case IGRAPH_ATTRIBUTE_GRAPH:
@@ -830,6 +915,12 @@ void igraph_i_graphml_attribute_data_finish(struct igraph_i_graphml_parser_state
     boolvec=(igraph_vector_bool_t *)rec->value;
     s=igraph_vector_bool_size(boolvec);
     if (id >= s) {
+      if (id >= igraph_vector_bool_capacity(boolvec)) {
+	ret=igraph_vector_bool_reserve(boolvec, 2*(id+1));
+	if (ret) {
+	  RETURN_GRAPHML_PARSE_ERROR_WITH_CODE(state, "Cannot parse GraphML file", ret);
+	}
+      }
       ret=igraph_vector_bool_resize(boolvec, id+1);
       if (ret) {
         RETURN_GRAPHML_PARSE_ERROR_WITH_CODE(state, "Cannot parse GraphML file", ret);
@@ -845,6 +936,12 @@ void igraph_i_graphml_attribute_data_finish(struct igraph_i_graphml_parser_state
     vec=(igraph_vector_t *)rec->value;
     s=igraph_vector_size(vec);
     if (id >= s) {
+      if (id >= igraph_vector_capacity(vec)) {
+	ret=igraph_vector_reserve(vec, 2*(id+1));
+	if (ret) {
+	  RETURN_GRAPHML_PARSE_ERROR_WITH_CODE(state, "Cannot parse GraphML file", ret);
+	}
+      }
       ret=igraph_vector_resize(vec, id+1);
       if (ret) {
         RETURN_GRAPHML_PARSE_ERROR_WITH_CODE(state, "Cannot parse GraphML file", ret);
@@ -994,8 +1091,10 @@ void igraph_i_graphml_sax_handler_start_element_ns(
     break;
 
   case INSIDE_KEY:
-    /* If we are in the INSIDE_KEY state, check for default tag */
-    if (xmlStrEqual(localname, toXmlChar("default"))) state->st=INSIDE_DEFAULT;
+    /* If we are in the INSIDE_KEY state, check for default tag; the default
+     * value of a skipped key is not needed */
+    if (xmlStrEqual(localname, toXmlChar("default")) &&
+	state->current_attr_record != 0) state->st=INSIDE_DEFAULT;
     else igraph_i_graphml_handle_unknown_start_tag(state);
     break;
 
@@ -1022,7 +1121,7 @@ void igraph_i_graphml_sax_handler_start_element_ns(
 	  attr_value = fromXmlChar(xmlStrndup(XML_ATTR_VALUE(it)));
 	  igraph_trie_get(&state->node_trie, attr_value, &id2);
 	  free(attr_value);
-	} else if (xmlStrEqual(*it, toXmlChar("id"))) {
+	} else if (xmlStrEqual(*it, toXmlChar("id")) && state->keep_edge_ids) {
 	  long int edges=igraph_vector_size(&state->edgelist)/2+1;
 	  long int origsize=igraph_strvector_size(&state->edgeids);
 	  attr_value = fromXmlChar(xmlStrndup(XML_ATTR_VALUE(it)));
@@ -1175,6 +1274,11 @@ void igraph_i_graphml_sax_handler_chars(void* state0, const xmlChar* ch, int len
     break;
     
   case INSIDE_DATA:
+    if (!state->data_skip) {
+      igraph_i_graphml_append_to_data_char(state, ch, len);
+    }
+    break;
+
   case INSIDE_DEFAULT:
     igraph_i_graphml_append_to_data_char(state, ch, len);
     break;
@@ -1266,48 +1370,17 @@ int igraph_i_xml_escape(char* src, char** dest) {
   return 0;
 }
 
-/**
- * \ingroup loadsave
- * \function igraph_read_graph_graphml
- * \brief Reads a graph from a GraphML file.
- * 
- * </para><para>
- * GraphML is an XML-based file format for representing various types of
- * graphs. Currently only the most basic import functionality is implemented
- * in igraph: it can read GraphML files without nested graphs and hyperedges.
- * Attributes of the graph are loaded only if an attribute interface
- * is attached, ie. if you use igraph from R or Python.
- *
- * </para><para>
- * Graph attribute names are taken from the \c attr.name attributes of the
- * \c key tags in the GraphML file. Since \c attr.name is not mandatory,
- * igraph will fall back to the \c id attribute of the \c key tag if
- * \c attr.name is missing.
- *
- * \param graph Pointer to an uninitialized graph object.
- * \param instream A stream, it should be readable.
- * \param index If the GraphML file contains more than one graph, the one
- *              specified by this index will be loaded. Indices start from
- *              zero, so supply zero here if your GraphML file contains only
- *              a single graph.
- * 
- * \return Error code:
- *         \c IGRAPH_PARSEERROR: if there is a
- *         problem reading the file, or the file is syntactically
- *         incorrect.
- *         \c IGRAPH_UNIMPLEMENTED: the GraphML functionality was disabled
- *         at compile-time
- * 
- * \example examples/simple/graphml.c
- */
-int igraph_read_graph_graphml(igraph_t *graph, FILE *instream,
-			      int index) {
+#define IGRAPH_I_GRAPHML_CHUNK 65536
+
+static int igraph_i_read_graph_graphml(igraph_t *graph, FILE *instream,
+				       int index,
+				       const igraph_strvector_t *attrs) {
 
 #if HAVE_LIBXML == 1
   xmlParserCtxtPtr ctxt;
   struct igraph_i_graphml_parser_state state;
   int res;
-  char buffer[4096];
+  char buffer[IGRAPH_I_GRAPHML_CHUNK];
 
   if (index<0)
     IGRAPH_ERROR("Graph index must be non-negative", IGRAPH_EINVAL);
@@ -1317,7 +1390,8 @@ int igraph_read_graph_graphml(igraph_t *graph, FILE *instream,
   /* Create a progressive parser context */
   state.g=graph;
   state.index=index<0?0:index;
-  res=(int) fread(buffer, 1, 4096, instream);
+  state.keep_attrs=attrs;
+  res=(int) fread(buffer, 1, IGRAPH_I_GRAPHML_CHUNK, instream);
   ctxt=xmlCreatePushParserCtxt(&igraph_i_graphml_sax_handler,
 			       &state,
 			       buffer,
@@ -1339,7 +1413,7 @@ int igraph_read_graph_graphml(igraph_t *graph, FILE *instream,
     IGRAPH_ERROR("Cannot set options for the parser context", IGRAPH_EINVAL);
 
   /* Parse the file */
-  while ((res=(int) fread(buffer, 1, 4096, instream))>0) {
+  while ((res=(int) fread(buffer, 1, IGRAPH_I_GRAPHML_CHUNK, instream))>0) {
     xmlParseChunk(ctxt, buffer, res, 0);
     if (!state.successful) break;
   }
@@ -1358,10 +1432,97 @@ int igraph_read_graph_graphml(igraph_t *graph, FILE *instream,
   
   return 0;
 #else
+  IGRAPH_UNUSED(graph);
+  IGRAPH_UNUSED(instream);
+  IGRAPH_UNUSED(index);
+  IGRAPH_UNUSED(attrs);
   IGRAPH_ERROR("GraphML support is disabled", IGRAPH_UNIMPLEMENTED);
 #endif
 }
 
+/**
+ * \ingroup loadsave
+ * \function igraph_read_graph_graphml
+ * \brief Reads a graph from a GraphML file.
+ * 
+ * </para><para>
+ * GraphML is an XML-based file format for representing various types of
+ * graphs. Currently only the most basic import functionality is implemented
+ * in igraph: it can read GraphML files without nested graphs and hyperedges.
+ * Attributes of the graph are loaded only if an attribute interface
+ * is attached, ie. if you use igraph from R or Python. Without an
+ * attribute interface the values of the <code>data</code> tags are
+ * not stored at all while the file is parsed.
+ *
+ * </para><para>
+ * Graph attribute names are taken from the \c attr.name attributes of the
+ * \c key tags in the GraphML file. Since \c attr.name is not mandatory,
+ * igraph will fall back to the \c id attribute of the \c key tag if
+ * \c attr.name is missing.
+ *
+ * \param graph Pointer to an uninitialized graph object.
+ * \param instream A stream, it should be readable.
+ * \param index If the GraphML file contains more than one graph, the one
+ *              specified by this index will be loaded. Indices start from
+ *              zero, so supply zero here if your GraphML file contains only
+ *              a single graph.
+ * 
+ * \return Error code:
+ *         \c IGRAPH_PARSEERROR: if there is a
+ *         problem reading the file, or the file is syntactically
+ *         incorrect.
+ *         \c IGRAPH_UNIMPLEMENTED: the GraphML functionality was disabled
+ *         at compile-time
+ * 
+ * \sa \ref igraph_read_graph_graphml_select() to read only some of the
+ * attributes.
+ *
+ * \example examples/simple/graphml.c
+ */
+int igraph_read_graph_graphml(igraph_t *graph, FILE *instream,
+			      int index) {
+  return igraph_i_read_graph_graphml(graph, instream, index, 0);
+}
+
+/**
+ * \ingroup loadsave
+ * \function igraph_read_graph_graphml_select
+ * \brief Reads a graph and some of its attributes from a GraphML file.
+ * 
+ * </para><para>
+ * This function works like \ref igraph_read_graph_graphml(), but
+ * only the listed attributes are read. The <code>data</code> tags of
+ * all other keys are skipped while the file is parsed, their values
+ * are never stored, so large files with many unneeded attributes can
+ * be read with much less memory.
+ *
+ * </para><para>
+ * The complimentary \c id vertex and edge attributes, holding the
+ * GraphML identifiers of the nodes and edges, are only created if
+ * \c id is among the listed names.
+ *
+ * \param graph Pointer to an uninitialized graph object.
+ * \param instream A stream, it should be readable.
+ * \param index If the GraphML file contains more than one graph, the one
+ *              specified by this index will be loaded. Indices start from
+ *              zero.
+ * \param attrs The names of the graph, vertex and edge attributes to
+ *              read. Names are matched against the \c attr.name
+ *              attribute of the \c key tags, or their \c id if there
+ *              is no \c attr.name. If this is a null pointer, then
+ *              all attributes are read, exactly like \ref
+ *              igraph_read_graph_graphml() does.
+ * \return Error code, see \ref igraph_read_graph_graphml().
+ * 
+ * Time complexity: O(|V|+|E|+s), s is the size of the file, assuming
+ * that only a constant number of attributes are listed.
+ */
+int igraph_read_graph_graphml_select(igraph_t *graph, FILE *instream,
+				     int index,
+				     const igraph_strvector_t *attrs) {
+  return igraph_i_read_graph_graphml(graph, instream, index, attrs);
+}
+
 /**
  * \ingroup loadsave
  * \function igraph_write_graph_graphml
@@ -0,0 +1,84 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+
+*/
+
+#ifndef IGRAPH_DOBFS_INTERNAL_H
+#define IGRAPH_DOBFS_INTERNAL_H
+
+#include "igraph_types.h"
+#include "igraph_adjlist.h"
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+# define __BEGIN_DECLS extern "C" {
+# define __END_DECLS }
+#else
+# define __BEGIN_DECLS /* empty */
+# define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* Direction-optimizing breadth-first search.
+ *
+ * A level is expanded either top-down, by following the 'out' edges
+ * of the frontier, or bottom-up, by checking for every vertex that
+ * was not reached yet whether one of its 'in' neighbors is in the
+ * frontier, with the frontier kept in a bitmap. Bottom-up steps stop
+ * at the first hit, so on low-diameter graphs they skip most of the
+ * edges of the few big levels in the middle of the search. For
+ * undirected graphs 'out' and 'in' are the same adjacency list.
+ *
+ * The search switches to bottom-up when the edges leaving the
+ * frontier are more than 1/IGRAPH_I_DOBFS_ALPHA of the edges and
+ * vertices not reached yet, and back to top-down when the frontier shrinks
+ * below 1/IGRAPH_I_DOBFS_BETA of the vertices.
+ *
+ * Vertices stay marked in 'seen' over several runs, so repeated runs
+ * from different roots visit each vertex once, like the searches of
+ * igraph_bfs() with several roots. Vertices can be excluded from the
+ * search before the first run with igraph_i_dobfs_exclude().
+ */
+
+#define IGRAPH_I_DOBFS_ALPHA 14
+#define IGRAPH_I_DOBFS_BETA  24
+
+typedef struct igraph_i_dobfs_t {
+  const igraph_csr_t *out, *in;
+  long int no_of_nodes;
+  long int unexplored, unseen, ntodo;
+  char *seen, *infrontier;
+  int *frontier, *next, *todo;
+} igraph_i_dobfs_t;
+
+int igraph_i_dobfs_init(igraph_i_dobfs_t *bfs, const igraph_csr_t *out,
+			const igraph_csr_t *in);
+void igraph_i_dobfs_destroy(igraph_i_dobfs_t *bfs);
+void igraph_i_dobfs_exclude(igraph_i_dobfs_t *bfs, long int vertex);
+int igraph_i_dobfs_run(igraph_i_dobfs_t *bfs, long int root, 
+		       igraph_real_t *dist, long int *reached);
+
+__END_DECLS
+
+#endif
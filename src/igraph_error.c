@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <string.h>
 
 static IGRAPH_THREAD_LOCAL igraph_error_handler_t *igraph_i_error_handler=0;
 static IGRAPH_THREAD_LOCAL char igraph_i_errormsg_buffer[500];
@@ -169,42 +170,127 @@ igraph_set_error_handler (igraph_error_handler_t * new_handler)
   return previous_handler;
 }
 
-IGRAPH_THREAD_LOCAL struct igraph_i_protectedPtr igraph_i_finally_stack[100];
+/*
+ * The finally stack starts out in a small static array and moves to
+ * the heap (doubling its size each time) when a deeply recursive
+ * function registers more objects than fit there. Pushing an object
+ * is thus still just a comparison and two stores. It moves back to the
+ * static array whenever it becomes empty again.
+ */
+
+#define IGRAPH_I_FINALLY_STACK_INITIAL 100
+
+static IGRAPH_THREAD_LOCAL struct igraph_i_protectedPtr
+igraph_i_finally_stack_static[IGRAPH_I_FINALLY_STACK_INITIAL];
+static IGRAPH_THREAD_LOCAL struct igraph_i_protectedPtr
+*igraph_i_finally_stack=0;
+static IGRAPH_THREAD_LOCAL int igraph_i_finally_stack_size=0;
+static IGRAPH_THREAD_LOCAL int igraph_i_finally_stack_capacity=0;
+
+static int igraph_i_finally_stack_grow(void) {
+  struct igraph_i_protectedPtr *tmp;
+  int newcap;
+
+  if (igraph_i_finally_stack == 0) {
+    igraph_i_finally_stack = igraph_i_finally_stack_static;
+    igraph_i_finally_stack_capacity = IGRAPH_I_FINALLY_STACK_INITIAL;
+    return 1;
+  }
+
+  newcap = 2 * igraph_i_finally_stack_capacity;
+  if (igraph_i_finally_stack == igraph_i_finally_stack_static) {
+    tmp = malloc(sizeof(struct igraph_i_protectedPtr) * (size_t) newcap);
+    if (tmp) {
+      memcpy(tmp, igraph_i_finally_stack_static,
+	     sizeof(struct igraph_i_protectedPtr) * 
+	     (size_t) igraph_i_finally_stack_size);
+    }
+  } else {
+    tmp = realloc(igraph_i_finally_stack, 
+		  sizeof(struct igraph_i_protectedPtr) * (size_t) newcap);
+  }
+  if (!tmp) { 
+    return 0;
+  }
+  igraph_i_finally_stack = tmp;
+  igraph_i_finally_stack_capacity = newcap;
+  return 1;
+}
+
+/*
+ * Gives back the memory of a grown stack, once it is empty again
+ */
+
+static void igraph_i_finally_stack_shrink(void) {
+  if (igraph_i_finally_stack && 
+      igraph_i_finally_stack != igraph_i_finally_stack_static) {
+    free(igraph_i_finally_stack);
+    igraph_i_finally_stack = igraph_i_finally_stack_static;
+    igraph_i_finally_stack_capacity = IGRAPH_I_FINALLY_STACK_INITIAL;
+  }
+}
 
 /*
  * Adds another element to the free list
  */
 
 void IGRAPH_FINALLY_REAL(void (*func)(void*), void* ptr) {
-  int no=igraph_i_finally_stack[0].all;
-  assert (no<100);
+  int no=igraph_i_finally_stack_size;
   assert (no>=0);
+  if (IGRAPH_UNLIKELY(no >= igraph_i_finally_stack_capacity)) {
+    if (!igraph_i_finally_stack_grow()) {
+      /* We cannot protect the object and cannot report an error to
+	 the caller either, so this is fatal. */
+#ifndef USING_R
+      igraph_error_handler_abort("Cannot grow finally stack", __FILE__,
+				 __LINE__, IGRAPH_ENOMEM);
+#else
+      igraph_error("Cannot grow finally stack", __FILE__, __LINE__,
+		   IGRAPH_ENOMEM);
+      return;
+#endif
+    }
+  }
   igraph_i_finally_stack[no].ptr=ptr;
   igraph_i_finally_stack[no].func=func;
-  igraph_i_finally_stack[0].all ++;
-  /* printf("--> Finally stack contains now %d elements\n", igraph_i_finally_stack[0].all); */
+  igraph_i_finally_stack_size ++;
+  /* printf("--> Finally stack contains now %d elements\n", igraph_i_finally_stack_size); */
 }
 
 void IGRAPH_FINALLY_CLEAN(int minus) { 
-  igraph_i_finally_stack[0].all -= minus;
-  if (igraph_i_finally_stack[0].all < 0) {
-    /* fprintf(stderr, "corrupt finally stack, popping %d elements when only %d left\n", minus, igraph_i_finally_stack[0].all+minus); */
-    igraph_i_finally_stack[0].all = 0;
+  igraph_i_finally_stack_size -= minus;
+  if (igraph_i_finally_stack_size < 0) {
+    /* fprintf(stderr, "corrupt finally stack, popping %d elements when only %d left\n", minus, igraph_i_finally_stack_size+minus); */
+    igraph_i_finally_stack_size = 0;
+  }
+  if (igraph_i_finally_stack_size == 0) {
+    igraph_i_finally_stack_shrink();
   }
-  /* printf("<-- Finally stack contains now %d elements\n", igraph_i_finally_stack[0].all); */
+  /* printf("<-- Finally stack contains now %d elements\n", igraph_i_finally_stack_size); */
 }
 
 void IGRAPH_FINALLY_FREE(void) {
   int p;
-/*   printf("[X] Finally stack will be cleaned (contained %d elements)\n", igraph_i_finally_stack[0].all);  */
-  for (p=igraph_i_finally_stack[0].all-1; p>=0; p--) {
+/*   printf("[X] Finally stack will be cleaned (contained %d elements)\n", igraph_i_finally_stack_size);  */
+  for (p=igraph_i_finally_stack_size-1; p>=0; p--) {
     igraph_i_finally_stack[p].func(igraph_i_finally_stack[p].ptr);
   }
-  igraph_i_finally_stack[0].all=0;
+  igraph_i_finally_stack_size=0;
+  igraph_i_finally_stack_shrink();
 }
 
 int IGRAPH_FINALLY_STACK_SIZE(void) {
-  return igraph_i_finally_stack[0].all;
+  return igraph_i_finally_stack_size;
+}
+
+void IGRAPH_FINALLY_RESTORE(int mark) {
+  if (mark < 0) { mark = 0; }
+  if (mark < igraph_i_finally_stack_size) {
+    igraph_i_finally_stack_size = mark;
+  }
+  if (igraph_i_finally_stack_size == 0) {
+    igraph_i_finally_stack_shrink();
+  }
 }
 
 static IGRAPH_THREAD_LOCAL igraph_warning_handler_t *igraph_i_warning_handler=0;
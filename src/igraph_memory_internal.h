@@ -0,0 +1,87 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+
+*/
+
+#ifndef IGRAPH_MEMORY_INTERNAL_H
+#define IGRAPH_MEMORY_INTERNAL_H
+
+#include "config.h"
+#include "igraph_memory.h"
+#include "igraph_error.h"
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+# define __BEGIN_DECLS extern "C" {
+# define __END_DECLS }
+#else
+# define __BEGIN_DECLS /* empty */
+# define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* Scratch memory.
+ * 
+ * Temporary arrays of the algorithms can be taken from a per-thread
+ * arena instead of calloc(). Allocation is a pointer increment and
+ * everything allocated after a mark is released at once, by going
+ * back to the mark. Marks must be released in LIFO order, which is
+ * exactly what the IGRAPH_FINALLY stack does on errors, so a
+ * function typically does:
+ *
+ *   igraph_i_scratch_mark_t mark;
+ *   IGRAPH_I_SCRATCH_MARK_FINALLY(&mark);
+ *   dist=igraph_i_scratch_Calloc(no_of_nodes, long int);
+ *   if (!dist) { IGRAPH_ERROR("...", IGRAPH_ENOMEM); }
+ *   ...
+ *   igraph_i_scratch_release(&mark);
+ *   IGRAPH_FINALLY_CLEAN(1);
+ *
+ * Scratch memory must never be passed to free() or realloc(), and
+ * must not outlive the function that allocated it. The arena keeps
+ * one released block of moderate size for the next call, so that
+ * calling an algorithm repeatedly on small graphs does not go to the
+ * system allocator at all.
+ */
+
+typedef struct igraph_i_scratch_mark_t {
+  void *chunk;
+  size_t used;
+} igraph_i_scratch_mark_t;
+
+void igraph_i_scratch_mark(igraph_i_scratch_mark_t *mark);
+void igraph_i_scratch_release(igraph_i_scratch_mark_t *mark);
+void *igraph_i_scratch_alloc(size_t size);
+void *igraph_i_scratch_calloc(size_t count, size_t size);
+
+#define igraph_i_scratch_Calloc(n,t) \
+  (t*) igraph_i_scratch_calloc((size_t)(n), sizeof(t))
+
+#define IGRAPH_I_SCRATCH_MARK_FINALLY(mark) \
+  do { igraph_i_scratch_mark(mark); \
+  IGRAPH_FINALLY(igraph_i_scratch_release, mark); } while (0)
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,97 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+
+*/
+
+#ifndef IGRAPH_MSBFS_INTERNAL_H
+#define IGRAPH_MSBFS_INTERNAL_H
+
+#include "igraph_types.h"
+#include "igraph_adjlist.h"
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+# define __BEGIN_DECLS extern "C" {
+# define __END_DECLS }
+#else
+# define __BEGIN_DECLS /* empty */
+# define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* Multi-source breadth-first search.
+ *
+ * Runs up to IGRAPH_I_MSBFS_WIDTH searches at once, each vertex has a
+ * bitset of the searches that have reached it, and of the searches
+ * that visit it in the current level. Every edge is traversed once
+ * per level for all searches together, instead of once per search.
+ *
+ * The handler is called for each vertex reached in a level, with
+ * the bitset of the searches that reached it there: bit 'i' stands
+ * for 'sources[i]'. The sources themselves are reported at distance
+ * zero. Within a level the vertices come in the order they were
+ * found, so with a single source this is the usual BFS order. A
+ * non-zero return value of the handler stops the search and is
+ * returned as an error code, except for IGRAPH_I_MSBFS_STOP, which
+ * stops it without an error.
+ */
+
+typedef unsigned long long int igraph_i_msbfs_word_t;
+
+#define IGRAPH_I_MSBFS_WIDTH ((int) (8 * sizeof(igraph_i_msbfs_word_t)))
+#define IGRAPH_I_MSBFS_STOP (-1)
+
+typedef int igraph_i_msbfs_handler_t(long int vertex, 
+				     igraph_i_msbfs_word_t mask,
+				     long int dist, void *extra);
+
+typedef struct igraph_i_msbfs_t {
+  const igraph_csr_t *csr;
+  long int no_of_nodes;
+  igraph_i_msbfs_word_t *seen, *visit, *next;
+  int *frontier, *nextfrontier, *touched;
+} igraph_i_msbfs_t;
+
+int igraph_i_msbfs_init(igraph_i_msbfs_t *bfs, const igraph_csr_t *csr);
+void igraph_i_msbfs_destroy(igraph_i_msbfs_t *bfs);
+int igraph_i_msbfs_run(igraph_i_msbfs_t *bfs, const long int *sources,
+		       int no_of_sources, igraph_real_t cutoff,
+		       igraph_i_msbfs_handler_t *handler, void *extra);
+
+/* Number of bits set, and the index of the lowest set bit of a
+   non-zero word */
+
+#if defined(__GNUC__)
+#define IGRAPH_I_MSBFS_POPCOUNT(w) __builtin_popcountll(w)
+#define IGRAPH_I_MSBFS_LOWEST(w) __builtin_ctzll(w)
+#else
+int igraph_i_msbfs_popcount(igraph_i_msbfs_word_t w);
+int igraph_i_msbfs_lowest(igraph_i_msbfs_word_t w);
+#define IGRAPH_I_MSBFS_POPCOUNT(w) igraph_i_msbfs_popcount(w)
+#define IGRAPH_I_MSBFS_LOWEST(w) igraph_i_msbfs_lowest(w)
+#endif
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,100 @@
+/* -*- mode: C -*-  */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+
+*/
+
+#ifndef IGRAPH_SSSP_INTERNAL_H
+#define IGRAPH_SSSP_INTERNAL_H
+
+#include "igraph_types.h"
+#include "igraph_vector.h"
+#include "igraph_types_internal.h"
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+# define __BEGIN_DECLS extern "C" {
+# define __END_DECLS }
+#else
+# define __BEGIN_DECLS /* empty */
+# define __END_DECLS /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/* Priority queue for the Dijkstra-based shortest path functions.
+ *
+ * The queue stores tentative distances of vertices and returns
+ * them in increasing order. If all edge weights are small enough
+ * non-negative integers, then a radix heap is used: the keys
+ * popped from the queue never decrease in Dijkstra's algorithm,
+ * so a key only needs to be compared to the last popped key, and
+ * it is kept in the bucket given by the highest bit in which they
+ * differ. Decreasing a key just adds a new entry to a lower bucket,
+ * the old one is skipped later. For other weights the indexed
+ * binary heap (igraph_2wheap_t) is used.
+ * igraph_i_sssp_queue_init_radix() skips checking the weights, e.g.
+ * for a second queue with the same weights.
+ *
+ * Just like with the 2-way heap, a vertex that was removed from
+ * the queue stays an element of it, but it is not active any
+ * more, until the queue is cleared.
+ */
+
+#define IGRAPH_I_SSSP_BUCKETS 65
+
+typedef unsigned long long int igraph_i_sssp_key_t;
+
+typedef struct igraph_i_sssp_queue_t {
+  igraph_bool_t radix;
+  igraph_2wheap_t heap;
+  long int size, active;
+  igraph_i_sssp_key_t last;
+  igraph_i_sssp_key_t *keys;
+  char *state;
+  igraph_vector_long_t touched;
+  igraph_vector_long_t buckets[IGRAPH_I_SSSP_BUCKETS];
+} igraph_i_sssp_queue_t;
+
+int igraph_i_sssp_queue_init(igraph_i_sssp_queue_t *q, long int size,
+			     const igraph_vector_t *weights);
+int igraph_i_sssp_queue_init_radix(igraph_i_sssp_queue_t *q, long int size,
+				   igraph_bool_t radix);
+void igraph_i_sssp_queue_destroy(igraph_i_sssp_queue_t *q);
+void igraph_i_sssp_queue_clear(igraph_i_sssp_queue_t *q);
+igraph_bool_t igraph_i_sssp_queue_empty(const igraph_i_sssp_queue_t *q);
+int igraph_i_sssp_queue_push(igraph_i_sssp_queue_t *q, long int idx,
+			     igraph_real_t dist);
+int igraph_i_sssp_queue_modify(igraph_i_sssp_queue_t *q, long int idx,
+			       igraph_real_t dist);
+int igraph_i_sssp_queue_pop(igraph_i_sssp_queue_t *q, long int *idx,
+			    igraph_real_t *dist);
+igraph_bool_t igraph_i_sssp_queue_has_elem(const igraph_i_sssp_queue_t *q,
+					   long int idx);
+igraph_bool_t igraph_i_sssp_queue_has_active(const igraph_i_sssp_queue_t *q,
+					     long int idx);
+igraph_real_t igraph_i_sssp_queue_get(const igraph_i_sssp_queue_t *q,
+				      long int idx);
+
+__END_DECLS
+
+#endif
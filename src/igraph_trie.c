@@ -32,254 +32,173 @@
 #include <string.h> 		/* memcpy & co. */
 #include <stdlib.h>
 
-/**
- * \ingroup igraphtrie
- * \brief Creates a trie node (not to be called directly)
- * \return Error code: errors by igraph_strvector_init(),
- *         igraph_vector_ptr_init() and igraph_vector_init() might be returned.
- */
+/* The keys are stored in the 'keys' string vector, in the order of
+   their ids, and 'hashes' holds their hash values. 'table' is an
+   open addressing hash table with linear probing, its size is a
+   power of two and it is at most half full. It contains the ids of
+   the keys plus one, zero marks an empty slot. */
 
-int igraph_i_trie_init_node(igraph_trie_node_t *t) { 
-  IGRAPH_STRVECTOR_INIT_FINALLY(&t->strs, 0);
-  IGRAPH_VECTOR_PTR_INIT_FINALLY(&t->children, 0);
-  IGRAPH_VECTOR_INIT_FINALLY(&t->values, 0);
-  IGRAPH_FINALLY_CLEAN(3);
-  return 0;
-}  
-
-void igraph_i_trie_destroy_node(igraph_trie_node_t *t, igraph_bool_t sfree);
+#define IGRAPH_I_TRIE_MINSIZE 64
 
 /**
  * \ingroup igraphtrie
- * \brief Creates a trie.
- * \return Error code: errors by igraph_strvector_init(),
- *         igraph_vector_ptr_init() and igraph_vector_init() might be returned.
+ * \brief Hash function for the keys (not to be called directly).
  */
 
-int igraph_trie_init(igraph_trie_t *t, igraph_bool_t storekeys) {
-  t->maxvalue=-1;
-  t->storekeys=storekeys;
-  IGRAPH_CHECK(igraph_i_trie_init_node( (igraph_trie_node_t *)t ));
-  IGRAPH_FINALLY(igraph_i_trie_destroy_node, t);
-  if (storekeys) {
-    IGRAPH_CHECK(igraph_strvector_init(&t->keys, 0));
+long int igraph_i_trie_hash(const char *key, long int length) {
+  unsigned long int hash=2166136261UL;
+  long int i;
+  for (i=0; i<length; i++) {
+    hash ^= (unsigned char) key[i];
+    hash *= 16777619UL;
   }
-
-  IGRAPH_FINALLY_CLEAN(1);
-  return 0;
+  return (long int) (hash & 0x7fffffffUL);
 }
 
 /**
  * \ingroup igraphtrie
- * \brief Destroys a node of a trie (not to be called directly).
+ * \brief Finds the slot of a key (not to be called directly).
+ * 
+ * Returns the slot containing the key, or the empty slot where it
+ * should be inserted.
  */
 
-void igraph_i_trie_destroy_node(igraph_trie_node_t *t, igraph_bool_t sfree) {
-  long int i;
-  igraph_strvector_destroy(&t->strs);
-  for (i=0; i<igraph_vector_ptr_size(&t->children); i++) {
-    igraph_trie_node_t *child=VECTOR(t->children)[i];
-    if (child != 0) {
-      igraph_i_trie_destroy_node(child, 1);
+long int igraph_i_trie_slot(const igraph_trie_t *t, const char *key, 
+			    long int length, long int hash) {
+  long int mask=igraph_vector_long_size(&t->table)-1;
+  long int slot=hash & mask;
+  long int id;
+  
+  while ( (id=VECTOR(t->table)[slot]) != 0 ) {
+    id--;
+    if (VECTOR(t->hashes)[id] == hash) {
+      char *str;
+      igraph_strvector_get(&t->keys, id, &str);
+      if (!strncmp(str, key, (size_t) length) && str[length]=='\0') {
+	break;
+      }
     }
+    slot = (slot+1) & mask;
   }
-  igraph_vector_ptr_destroy(&t->children);
-  igraph_vector_destroy(&t->values);
-  if (sfree) { igraph_Free(t); }
+  
+  return slot;
 }
 
 /**
  * \ingroup igraphtrie
- * \brief Destroys a trie (frees allocated memory).
+ * \brief Doubles the size of the hash table (not to be called directly).
  */
 
-void igraph_trie_destroy(igraph_trie_t *t) {
-  if (t->storekeys) {
-    igraph_strvector_destroy(&t->keys);
-  }
-  igraph_i_trie_destroy_node( (igraph_trie_node_t*) t, 0);
-}
-
-
-/**
- * \ingroup igraphtrie
- * \brief Internal helping function for igraph_trie_t
- */
-
-long int igraph_i_strdiff(const char *str, const char *key) {
-
-  long int diff=0;
-  while (key[diff] != '\0' && str[diff] != '\0' && str[diff]==key[diff]) {
-    diff++;
+int igraph_i_trie_grow(igraph_trie_t *t) {
+  long int size=igraph_vector_long_size(&t->table)*2;
+  long int mask=size-1;
+  long int i, n=igraph_vector_long_size(&t->hashes);
+  igraph_vector_long_t newtable;
+  
+  IGRAPH_CHECK(igraph_vector_long_init(&newtable, size));
+  for (i=0; i<n; i++) {
+    long int slot=VECTOR(t->hashes)[i] & mask;
+    while (VECTOR(newtable)[slot] != 0) {
+      slot = (slot+1) & mask;
+    }
+    VECTOR(newtable)[slot] = i+1;
   }
-  return diff;
+  igraph_vector_long_destroy(&t->table);
+  t->table=newtable;
+  
+  return 0;
 }
 
 /**
  * \ingroup igraphtrie
  * \brief Search/insert in a trie (not to be called directly).
- *
+ * 
+ * If \c add is false, then the key is not added if nonexistent,
+ * and -1 is returned as its id.
  * @return Error code:
  *         - <b>IGRAPH_ENOMEM</b>: out of memory
  */
 
-int igraph_trie_get_node(igraph_trie_node_t *t, const char *key, 
-			 igraph_real_t newvalue, long int *id) {
+int igraph_i_trie_get(igraph_trie_t *t, const char *key, long int length,
+		      igraph_bool_t add, long int *id) {
+  long int hash=igraph_i_trie_hash(key, length);
+  long int slot=igraph_i_trie_slot(t, key, length, hash);
+  long int n;
   char *str;
-  long int i;
-  igraph_bool_t add;
-
-  /* If newvalue is negative, we don't add the node if nonexistent, only check
-   * for its existence */
-  add = (newvalue>=0);
-
-  for (i=0; i<igraph_strvector_size(&t->strs); i++) {
-    long int diff;
-    igraph_strvector_get(&t->strs, i, &str);
-    diff=igraph_i_strdiff(str, key);
-    
-    if (diff == 0) {
-
-      /* ------------------------------------ */
-      /* No match, next */
-
-    } else if (str[diff]=='\0' && key[diff]=='\0') {
-
-      /* ------------------------------------ */
-      /* They are exactly the same */
-      if (VECTOR(t->values)[i] != -1) {
-	*id=(long int) VECTOR(t->values)[i];
-	return 0;
-      } else {
-	VECTOR(t->values)[i]=newvalue;
-	*id=(long int) newvalue;
-	return 0;
-      }
-
-    } else if (str[diff]=='\0') {
-
-      /* ------------------------------------ */
-      /* str is prefix of key, follow its link if there is one */
-      igraph_trie_node_t *node=VECTOR(t->children)[i];
-      if (node != 0) {
-	return igraph_trie_get_node(node, key+diff, newvalue, id);
-      } else if (add) {
-	igraph_trie_node_t *node=igraph_Calloc(1, igraph_trie_node_t);
-	if (node==0) {
-	  IGRAPH_ERROR("cannot add to trie", IGRAPH_ENOMEM);
-	}
-	IGRAPH_STRVECTOR_INIT_FINALLY(&node->strs, 1);
-	IGRAPH_VECTOR_PTR_INIT_FINALLY(&node->children, 1);
-	IGRAPH_VECTOR_INIT_FINALLY(&node->values, 1);
-	IGRAPH_CHECK(igraph_strvector_set(&node->strs, 0, key+diff));
-	VECTOR(node->children)[0]=0;
-	VECTOR(node->values)[0]=newvalue;
-
-	VECTOR(t->children)[i]=node;
-
-	*id=(long int) newvalue;
-	IGRAPH_FINALLY_CLEAN(3);
-	return 0;
-      } else {
-	*id=-1;
-	return 0;
-      }
-
-    } else if (key[diff]=='\0' && add) {
-
-      /* ------------------------------------ */
-      /* key is prefix of str, the node has to be cut */
-      char *str2;
-      
-      igraph_trie_node_t *node=igraph_Calloc(1, igraph_trie_node_t);
-      if (node==0) {
-	IGRAPH_ERROR("cannot add to trie", IGRAPH_ENOMEM);
-      }
-      IGRAPH_STRVECTOR_INIT_FINALLY(&node->strs, 1);
-      IGRAPH_VECTOR_PTR_INIT_FINALLY(&node->children, 1);
-      IGRAPH_VECTOR_INIT_FINALLY(&node->values, 1);
-      IGRAPH_CHECK(igraph_strvector_set(&node->strs, 0, str+diff));
-      
-      VECTOR(node->children)[0]=VECTOR(t->children)[i];
-      VECTOR(node->values)[0]=VECTOR(t->values)[i];
-
-      str2=strdup(str);
-      if (str2 == 0) {
-	IGRAPH_ERROR("cannot add to trie", IGRAPH_ENOMEM);
-      }
-      str2[diff]='\0';
-      IGRAPH_FINALLY(free, str2);
-      IGRAPH_CHECK(igraph_strvector_set(&t->strs, i, str2));
-      free(str2);
-      IGRAPH_FINALLY_CLEAN(4);
-      
-      VECTOR(t->values)[i]=newvalue;
-      VECTOR(t->children)[i]=node;
-      
-      *id=(long int) newvalue;
-      return 0;
-
-    } else if (add) {
-
-      /* ------------------------------------ */
-      /* the first diff characters match */
-      char *str2;
-
-      igraph_trie_node_t *node=igraph_Calloc(1, igraph_trie_node_t);
-      if (node==0) {
-	IGRAPH_ERROR("cannot add to trie", IGRAPH_ENOMEM);
-      }
-      IGRAPH_STRVECTOR_INIT_FINALLY(&node->strs, 2);
-      IGRAPH_VECTOR_PTR_INIT_FINALLY(&node->children, 2);
-      IGRAPH_VECTOR_INIT_FINALLY(&node->values, 2);
-      IGRAPH_CHECK(igraph_strvector_set(&node->strs, 0, str+diff));
-      IGRAPH_CHECK(igraph_strvector_set(&node->strs, 1, key+diff));
-      VECTOR(node->children)[0]=VECTOR(t->children)[i];
-      VECTOR(node->children)[1]=0;
-      VECTOR(node->values)[0]=VECTOR(t->values)[i];
-      VECTOR(node->values)[1]=newvalue;
-
-      str2=strdup(str);
-      if (str2 == 0) {
-	IGRAPH_ERROR("cannot add to trie", IGRAPH_ENOMEM);
-      }
-      str2[diff]='\0';
-      IGRAPH_FINALLY(free, str2);
-      IGRAPH_CHECK(igraph_strvector_set(&t->strs, i, str2));
-      free(str2);
-      IGRAPH_FINALLY_CLEAN(4);
+  
+  if (VECTOR(t->table)[slot] != 0) {
+    *id=VECTOR(t->table)[slot]-1;
+    return 0;
+  } else if (!add) {
+    *id=-1;
+    return 0;
+  }
 
-      VECTOR(t->values)[i]=-1;
-      VECTOR(t->children)[i]=node;
-      
-      *id=(long int) newvalue;
-      return 0;
-    } else {
-      
-      /* ------------------------------------------------- */
-      /* No match, but we requested not to add the new key */
-      *id=-1;
-      return 0;
+  n=igraph_vector_long_size(&t->hashes);
+  if ( 2*(n+1) > igraph_vector_long_size(&t->table) ) {
+    IGRAPH_CHECK(igraph_i_trie_grow(t));
+    slot=igraph_i_trie_slot(t, key, length, hash);
+  }
+  
+  if (n == t->keys_alloc) {
+    /* igraph_strvector_add() would reallocate the array for every key,
+       grow it geometrically instead */
+    long int newalloc= t->keys_alloc < 8 ? 8 : 2*t->keys_alloc;
+    char **tmp=igraph_Realloc(t->keys.data, (size_t) newalloc, char*);
+    if (tmp==0) {
+      IGRAPH_ERROR("Cannot add to trie", IGRAPH_ENOMEM);
     }
+    t->keys.data=tmp;
+    t->keys_alloc=newalloc;
+  }
+  /* The key is not necessarily zero terminated */
+  str=igraph_Calloc(length+1, char);
+  if (str==0) {
+    IGRAPH_ERROR("Cannot add to trie", IGRAPH_ENOMEM);
   }
+  memcpy(str, key, (size_t) length);
+  IGRAPH_FINALLY(igraph_free, str);
+  IGRAPH_CHECK(igraph_vector_long_push_back(&t->hashes, hash));
+  IGRAPH_FINALLY_CLEAN(1);
+  t->keys.data[n]=str;
+  t->keys.len=n+1;
+  VECTOR(t->table)[slot]=n+1;
+  
+  *id=n;
+  return 0;
+}
 
-  /* ------------------------------------ */
-  /* Nothing matches */
+/**
+ * \ingroup igraphtrie
+ * \brief Creates a trie.
+ * 
+ * The keys are always stored, \p storekeys is kept for
+ * compatibility only.
+ * \return Error code: errors by igraph_strvector_init() and
+ *         igraph_vector_long_init() might be returned.
+ */
 
-  if (add) {
-    IGRAPH_CHECK(igraph_vector_ptr_reserve(&t->children, 
-					   igraph_vector_ptr_size(&t->children)+1));
-    IGRAPH_CHECK(igraph_vector_reserve(&t->values, igraph_vector_size(&t->values)+1));
-    IGRAPH_CHECK(igraph_strvector_add(&t->strs, key));
+int igraph_trie_init(igraph_trie_t *t, igraph_bool_t storekeys) {
+  t->storekeys=storekeys;
+  t->keys_alloc=0;
+  IGRAPH_CHECK(igraph_strvector_init(&t->keys, 0));
+  IGRAPH_FINALLY(igraph_strvector_destroy, &t->keys);
+  IGRAPH_CHECK(igraph_vector_long_init(&t->hashes, 0));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &t->hashes);
+  IGRAPH_CHECK(igraph_vector_long_init(&t->table, IGRAPH_I_TRIE_MINSIZE));
+  IGRAPH_FINALLY_CLEAN(2);
+  return 0;
+}
 
-    igraph_vector_ptr_push_back(&t->children, 0); /* allocated */
-    igraph_vector_push_back(&t->values, newvalue); /* allocated */
-    *id=(long int) newvalue;
-  } else {
-    *id=-1;
-  }
+/**
+ * \ingroup igraphtrie
+ * \brief Destroys a trie (frees allocated memory).
+ */
 
-  return 0;
+void igraph_trie_destroy(igraph_trie_t *t) {
+  igraph_vector_long_destroy(&t->table);
+  igraph_vector_long_destroy(&t->hashes);
+  igraph_strvector_destroy(&t->keys);
 }
 
 /**
@@ -288,66 +207,22 @@ int igraph_trie_get_node(igraph_trie_node_t *t, const char *key,
  */
 
 int igraph_trie_get(igraph_trie_t *t, const char *key, long int *id) {
-  if (!t->storekeys) {
-    IGRAPH_CHECK(igraph_trie_get_node( (igraph_trie_node_t*) t, 
-				       key, t->maxvalue+1, id));
-    if (*id > t->maxvalue) {
-      t->maxvalue=*id;
-    }
-    return 0;
-  } else {
-    int ret;
-    igraph_error_handler_t *oldhandler;
-    oldhandler=igraph_set_error_handler(igraph_error_handler_ignore);
-    /* Add it to the string vector first, we can undo this later */
-    ret=igraph_strvector_add(&t->keys, key);
-    if (ret != 0) {
-      igraph_set_error_handler(oldhandler);
-      IGRAPH_ERROR("cannot get element from trie", ret);
-    }
-    ret = igraph_trie_get_node( (igraph_trie_node_t*) t,
-				key, t->maxvalue+1, id);
-    if (ret != 0) {
-      igraph_strvector_resize(&t->keys, igraph_strvector_size(&t->keys)-1);
-      igraph_set_error_handler(oldhandler);
-      IGRAPH_ERROR("cannot get element from trie", ret);
-    }
-    
-    /* everything is fine */
-    if (*id > t->maxvalue) {
-      t->maxvalue=*id;
-    } else {
-      igraph_strvector_resize(&t->keys, igraph_strvector_size(&t->keys)-1);
-    }
-    igraph_set_error_handler(oldhandler);    
-  }
-
-  return 0;
+  return igraph_i_trie_get(t, key, (long int) strlen(key), 1, id);
 }
 
 /**
  * \ingroup igraphtrie
  * \brief Search/insert in a trie (for internal use).
  *
+ * The key is the first \c length characters of \c key, it does
+ * not need to be zero terminated.
  * @return Error code:
  *         - <b>IGRAPH_ENOMEM</b>: out of memory
  */
 
 int igraph_trie_get2(igraph_trie_t *t, const char *key, long int length,
 		     long int *id) {
-  char *tmp=igraph_Calloc(length+1, char);
-
-  if (tmp==0) {
-    IGRAPH_ERROR("Cannot get from trie", IGRAPH_ENOMEM);
-  }
-  
-  strncpy(tmp, key, length);
-  tmp[length]='\0';
-  IGRAPH_FINALLY(free, tmp);
-  IGRAPH_CHECK(igraph_trie_get(t, tmp, id));
-  igraph_Free(tmp);
-  IGRAPH_FINALLY_CLEAN(1);
-  return 0;
+  return igraph_i_trie_get(t, key, length, 1, id);
 }
 
 /**
@@ -358,9 +233,7 @@ int igraph_trie_get2(igraph_trie_t *t, const char *key, long int length,
  */
 
 int igraph_trie_check(igraph_trie_t *t, const char *key, long int *id) {
-  IGRAPH_CHECK(igraph_trie_get_node( (igraph_trie_node_t*) t, 
-				     key, -1, id));
-  return 0;
+  return igraph_i_trie_get(t, key, (long int) strlen(key), 0, id);
 }
 
 /**
@@ -378,7 +251,7 @@ void igraph_trie_idx(igraph_trie_t *t, long int idx, char **str) {
  */
 
 long int igraph_trie_size(igraph_trie_t *t) {
-  return t->maxvalue+1;
+  return igraph_strvector_size(&t->keys);
 }
 
 /* Hmmm, very dirty.... */
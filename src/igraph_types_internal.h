@@ -40,6 +40,8 @@
 #include "igraph_strvector.h"
 #include "igraph_vector.h"
 #include "igraph_vector_ptr.h"
+#include "igraph_datatype.h"
+#include <stdio.h>
 
 __BEGIN_DECLS
 
@@ -159,27 +161,22 @@ int igraph_2wheap_modify(igraph_2wheap_t *h, long int idx, igraph_real_t elem);
 int igraph_2wheap_check(igraph_2wheap_t *h);
 
 /**
- * Trie data type
+ * Trie data type, a map from strings to consecutive integer ids.
+ * It is implemented as an open addressing hash table, the keys
+ * are stored in the order of their ids.
  * \ingroup internal
  */
 
-typedef struct s_igraph_trie_node {
-  igraph_strvector_t strs;
-  igraph_vector_ptr_t children;
-  igraph_vector_t values;
-} igraph_trie_node_t;
-
 typedef struct s_igraph_trie {
-  igraph_strvector_t strs;
-  igraph_vector_ptr_t children;
-  igraph_vector_t values;
-  long int maxvalue;
-  igraph_bool_t storekeys;
   igraph_strvector_t keys;
+  long int keys_alloc;
+  igraph_vector_long_t hashes;
+  igraph_vector_long_t table;
+  igraph_bool_t storekeys;
 } igraph_trie_t;
 
-#define IGRAPH_TRIE_NULL { IGRAPH_STRVECTOR_NULL, IGRAPH_VECTOR_PTR_NULL, \
-                           IGRAPH_VECTOR_NULL, 0, 0, IGRAPH_STRVECTOR_NULL }
+#define IGRAPH_TRIE_NULL { IGRAPH_STRVECTOR_NULL, 0, IGRAPH_VECTOR_NULL, \
+                           IGRAPH_VECTOR_NULL, 0 }
 #define IGRAPH_TRIE_INIT_FINALLY(tr, sk) \
   do { IGRAPH_CHECK(igraph_trie_init(tr, sk)); \
   IGRAPH_FINALLY(igraph_trie_destroy, tr); } while (0)
@@ -193,6 +190,7 @@ int igraph_trie_get2(igraph_trie_t *t, const char *key, long int length,
 void igraph_trie_idx(igraph_trie_t *t, long int idx, char **str);
 int igraph_trie_getkeys(igraph_trie_t *t, const igraph_strvector_t **strv);
 long int igraph_trie_size(igraph_trie_t *t);
+long int igraph_i_trie_hash(const char *key, long int length);
 
 /**
  * 2d grid containing points
@@ -390,6 +388,14 @@ int igraph_fixed_vectorlist_convert(igraph_fixed_vectorlist_t *l,
 				    const igraph_vector_t *from,
 				    long int size);
 
+/* -------------------------------------------------- */
+/* Binary I/O of the graph structure                  */
+/* -------------------------------------------------- */
+
+int igraph_i_write_graph_index(const igraph_t *graph, FILE *outstream);
+int igraph_i_read_graph_index(igraph_t *graph, FILE *instream, 
+			      igraph_integer_t n, igraph_integer_t m);
+
 __END_DECLS
 
 #endif
@@ -22,8 +22,11 @@
 */
 
 #include "igraph_memory.h"
+#include "igraph_memory_internal.h"
 #include "config.h"
 
+#include <string.h>
+
 /**
  * \function igraph_free
  * Deallocate memory that was allocated by igraph functions
@@ -97,3 +100,89 @@ int igraph_free(void *p) {
 void *igraph_malloc(size_t n) {
     return malloc(n);
 }
+
+/* The scratch arena is a stack of chunks, each allocated with
+   malloc(), only the topmost one is used for new allocations. */
+
+#define IGRAPH_I_SCRATCH_ALIGN    16
+#define IGRAPH_I_SCRATCH_MINCHUNK (64*1024)
+#define IGRAPH_I_SCRATCH_KEEP     (1024*1024)
+
+typedef struct igraph_i_scratch_chunk_t {
+  struct igraph_i_scratch_chunk_t *prev;
+  size_t size, used;
+} igraph_i_scratch_chunk_t;
+
+#define IGRAPH_I_SCRATCH_HEADER \
+  ((sizeof(igraph_i_scratch_chunk_t)+IGRAPH_I_SCRATCH_ALIGN-1) / \
+   IGRAPH_I_SCRATCH_ALIGN * IGRAPH_I_SCRATCH_ALIGN)
+
+static IGRAPH_THREAD_LOCAL igraph_i_scratch_chunk_t *igraph_i_scratch_top=0;
+static IGRAPH_THREAD_LOCAL igraph_i_scratch_chunk_t *igraph_i_scratch_spare=0;
+
+/* A chunk that is not needed any more is kept for reuse if it is not
+   too big, otherwise it is freed. */
+
+static void igraph_i_scratch_retire(igraph_i_scratch_chunk_t *chunk) {
+  if (chunk->size <= IGRAPH_I_SCRATCH_KEEP &&
+      (!igraph_i_scratch_spare || igraph_i_scratch_spare->size < chunk->size)) {
+    free(igraph_i_scratch_spare);
+    igraph_i_scratch_spare=chunk;
+  } else {
+    free(chunk);
+  }
+}
+
+void igraph_i_scratch_mark(igraph_i_scratch_mark_t *mark) {
+  mark->chunk=igraph_i_scratch_top;
+  mark->used=igraph_i_scratch_top ? igraph_i_scratch_top->used : 0;
+}
+
+void igraph_i_scratch_release(igraph_i_scratch_mark_t *mark) {
+  while (igraph_i_scratch_top && igraph_i_scratch_top != mark->chunk) {
+    igraph_i_scratch_chunk_t *chunk=igraph_i_scratch_top;
+    igraph_i_scratch_top=chunk->prev;
+    igraph_i_scratch_retire(chunk);
+  }
+  if (igraph_i_scratch_top) {
+    igraph_i_scratch_top->used=mark->used;
+  }
+}
+
+void *igraph_i_scratch_alloc(size_t size) {
+  igraph_i_scratch_chunk_t *chunk=igraph_i_scratch_top;
+  char *p;
+
+  if (size == 0) { size=1; }
+  if (size > ((size_t) -1) / 2) { return 0; }
+  size=(size+IGRAPH_I_SCRATCH_ALIGN-1) / IGRAPH_I_SCRATCH_ALIGN *
+    IGRAPH_I_SCRATCH_ALIGN;
+
+  if (!chunk || chunk->size - chunk->used < size) {
+    size_t chunksize=chunk ? 2*chunk->size : IGRAPH_I_SCRATCH_MINCHUNK;
+    if (chunksize < size) { chunksize=size; }
+    if (igraph_i_scratch_spare && igraph_i_scratch_spare->size >= size) {
+      chunk=igraph_i_scratch_spare;
+      igraph_i_scratch_spare=0;
+    } else {
+      chunk=malloc(IGRAPH_I_SCRATCH_HEADER+chunksize);
+      if (!chunk) { return 0; }
+      chunk->size=chunksize;
+    }
+    chunk->used=0;
+    chunk->prev=igraph_i_scratch_top;
+    igraph_i_scratch_top=chunk;
+  }
+  
+  p=(char*) chunk + IGRAPH_I_SCRATCH_HEADER + chunk->used;
+  chunk->used += size;
+  return p;
+}
+
+void *igraph_i_scratch_calloc(size_t count, size_t size) {
+  void *p;
+  if (size != 0 && count > ((size_t) -1) / 2 / size) { return 0; }
+  p=igraph_i_scratch_alloc(count*size);
+  if (p) { memset(p, 0, count*size); }
+  return p;
+}
@@ -0,0 +1,138 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=2 sts=2 sw=2 et: */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include "igraph_msbfs_internal.h"
+#include "igraph_memory.h"
+#include "igraph_interrupt_internal.h"
+#include "config.h"
+
+int igraph_i_msbfs_init(igraph_i_msbfs_t *bfs, const igraph_csr_t *csr) {
+  long int no_of_nodes=igraph_csr_size(csr);
+  bfs->csr=csr;
+  bfs->no_of_nodes=no_of_nodes;
+  bfs->seen=igraph_Calloc(no_of_nodes+1, igraph_i_msbfs_word_t);
+  bfs->visit=igraph_Calloc(no_of_nodes+1, igraph_i_msbfs_word_t);
+  bfs->next=igraph_Calloc(no_of_nodes+1, igraph_i_msbfs_word_t);
+  bfs->frontier=igraph_Calloc(no_of_nodes+1, int);
+  bfs->nextfrontier=igraph_Calloc(no_of_nodes+1, int);
+  bfs->touched=igraph_Calloc(no_of_nodes+1, int);
+  if (!bfs->seen || !bfs->visit || !bfs->next || !bfs->frontier ||
+      !bfs->nextfrontier || !bfs->touched) {
+    igraph_i_msbfs_destroy(bfs);
+    IGRAPH_ERROR("Cannot run multi-source BFS", IGRAPH_ENOMEM);
+  }
+  return 0;
+}
+
+void igraph_i_msbfs_destroy(igraph_i_msbfs_t *bfs) {
+  if (bfs->seen) { igraph_Free(bfs->seen); }
+  if (bfs->visit) { igraph_Free(bfs->visit); }
+  if (bfs->next) { igraph_Free(bfs->next); }
+  if (bfs->frontier) { igraph_Free(bfs->frontier); }
+  if (bfs->nextfrontier) { igraph_Free(bfs->nextfrontier); }
+  if (bfs->touched) { igraph_Free(bfs->touched); }
+}
+
+int igraph_i_msbfs_run(igraph_i_msbfs_t *bfs, const long int *sources,
+		       int no_of_sources, igraph_real_t cutoff,
+		       igraph_i_msbfs_handler_t *handler, void *extra) {
+  igraph_i_msbfs_word_t *seen=bfs->seen, *visit=bfs->visit, 
+    *next=bfs->next;
+  int *frontier=bfs->frontier, *nextfrontier=bfs->nextfrontier, *tmp;
+  long int nfrontier=0, nnext, ntouched=0;
+  long int i, j, level=0;
+  int ret=0;
+
+  for (i=0; i<no_of_sources; i++) {
+    long int v=sources[i];
+    if (!seen[v]) { bfs->touched[ntouched++]=(int) v; }
+    if (!visit[v]) { frontier[nfrontier++]=(int) v; }
+    seen[v] |= ((igraph_i_msbfs_word_t) 1) << i;
+    visit[v] |= ((igraph_i_msbfs_word_t) 1) << i;
+  }
+  for (i=0; i<nfrontier && !ret; i++) {
+    ret=handler(frontier[i], visit[frontier[i]], 0, extra);
+  }
+
+  while (nfrontier > 0 && !ret) {
+    if (cutoff >= 0 && level >= cutoff) { break; }
+    IGRAPH_ALLOW_INTERRUPTION();
+
+    /* Expand the current level for all searches together */
+    nnext=0;
+    for (i=0; i<nfrontier; i++) {
+      long int v=frontier[i];
+      igraph_i_msbfs_word_t m=visit[v];
+      int *neis=igraph_csr_neighbors(bfs->csr, v);
+      long int nlen=igraph_csr_degree(bfs->csr, v);
+      for (j=0; j<nlen; j++) {
+	long int w=neis[j];
+	igraph_i_msbfs_word_t d=m & ~seen[w];
+	if (d) {
+	  if (!seen[w]) { bfs->touched[ntouched++]=(int) w; }
+	  if (!next[w]) { nextfrontier[nnext++]=(int) w; }
+	  next[w] |= d;
+	  seen[w] |= d;
+	}
+      }
+      visit[v]=0;
+    }
+    level++;
+
+    for (i=0; i<nnext; i++) {
+      long int w=nextfrontier[i];
+      visit[w]=next[w];
+      next[w]=0;
+    }
+    for (i=0; i<nnext && !ret; i++) {
+      ret=handler(nextfrontier[i], visit[nextfrontier[i]], level, extra);
+    }
+    tmp=frontier; frontier=nextfrontier; nextfrontier=tmp;
+    nfrontier=nnext;
+  }
+
+  /* Clean up for the next run, touching only the reached vertices */
+  for (i=0; i<nfrontier; i++) {
+    visit[ (long int) frontier[i] ]=0;
+  }
+  for (i=0; i<ntouched; i++) {
+    seen[ (long int) bfs->touched[i] ]=0;
+  }
+
+  return ret == IGRAPH_I_MSBFS_STOP ? 0 : ret;
+}
+
+#if !defined(__GNUC__)
+int igraph_i_msbfs_popcount(igraph_i_msbfs_word_t w) {
+  int c=0;
+  while (w) { w &= w-1; c++; }
+  return c;
+}
+
+int igraph_i_msbfs_lowest(igraph_i_msbfs_word_t w) {
+  int c=0;
+  while (!(w & 1)) { w >>= 1; c++; }
+  return c;
+}
+#endif
@@ -0,0 +1,252 @@
+/* -*- mode: C -*-  */
+/* vim:set ts=2 sts=2 sw=2 et: */
+/* 
+   IGraph library.
+   Copyright (C) 2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+   
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+   02110-1301 USA
+
+*/
+
+#include "igraph_sssp_internal.h"
+#include "igraph_memory.h"
+#include "config.h"
+
+/* Radix heap keys must be exact in an igraph_real_t, and the
+   functions using the queue may add one to the distances */
+#define IGRAPH_I_SSSP_MAXKEY 9007199254740991.0
+
+static igraph_bool_t igraph_i_sssp_integer_weights(const igraph_vector_t *weights,
+						   long int size) {
+  long int i, n;
+  igraph_real_t max=0.0;
+  if (!weights) { return 1; }
+  n=igraph_vector_size(weights);
+  for (i=0; i<n; i++) {
+    igraph_real_t w=VECTOR(*weights)[i];
+    if (!(w >= 0 && w <= IGRAPH_I_SSSP_MAXKEY) || 
+	w != (igraph_real_t) (igraph_i_sssp_key_t) w) { 
+      return 0;
+    }
+    if (w > max) { max=w; }
+  }
+  return size == 0 || max <= (IGRAPH_I_SSSP_MAXKEY - 1.0) / size;
+}
+
+static int igraph_i_sssp_bucket(igraph_i_sssp_key_t last, 
+				igraph_i_sssp_key_t key) {
+  igraph_i_sssp_key_t diff=key ^ last;
+#if defined(__GNUC__)
+  return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+#else
+  int b=0;
+  while (diff) { diff >>= 1; b++; }
+  return b;
+#endif
+}
+
+int igraph_i_sssp_queue_init(igraph_i_sssp_queue_t *q, long int size,
+			     const igraph_vector_t *weights) {
+  return igraph_i_sssp_queue_init_radix(q, size, 
+			igraph_i_sssp_integer_weights(weights, size));
+}
+
+int igraph_i_sssp_queue_init_radix(igraph_i_sssp_queue_t *q, long int size,
+				   igraph_bool_t radix) {
+  int i, ret;
+
+  q->radix=radix;
+  q->size=size;
+  q->active=0;
+  q->last=0;
+
+  if (!q->radix) {
+    return igraph_2wheap_init(&q->heap, size);
+  }
+
+  q->keys=igraph_Calloc(size > 0 ? size : 1, igraph_i_sssp_key_t);
+  if (!q->keys) {
+    IGRAPH_ERROR("Cannot initialize shortest path queue", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, q->keys);
+  q->state=igraph_Calloc(size > 0 ? size : 1, char);
+  if (!q->state) {
+    IGRAPH_ERROR("Cannot initialize shortest path queue", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, q->state);
+  IGRAPH_CHECK(igraph_vector_long_init(&q->touched, 0));
+  IGRAPH_FINALLY(igraph_vector_long_destroy, &q->touched);
+  for (i=0; i<IGRAPH_I_SSSP_BUCKETS; i++) {
+    ret=igraph_vector_long_init(&q->buckets[i], 0);
+    if (ret) {
+      while (i > 0) { igraph_vector_long_destroy(&q->buckets[--i]); }
+      IGRAPH_ERROR("Cannot initialize shortest path queue", ret);
+    }
+  }
+  IGRAPH_FINALLY_CLEAN(3);
+
+  return 0;
+}
+
+void igraph_i_sssp_queue_destroy(igraph_i_sssp_queue_t *q) {
+  int i;
+  if (!q->radix) {
+    igraph_2wheap_destroy(&q->heap);
+    return;
+  }
+  for (i=0; i<IGRAPH_I_SSSP_BUCKETS; i++) {
+    igraph_vector_long_destroy(&q->buckets[i]);
+  }
+  igraph_vector_long_destroy(&q->touched);
+  igraph_Free(q->state);
+  igraph_Free(q->keys);
+}
+
+void igraph_i_sssp_queue_clear(igraph_i_sssp_queue_t *q) {
+  long int i, n;
+  if (!q->radix) {
+    igraph_2wheap_clear(&q->heap);
+    return;
+  }
+  n=igraph_vector_long_size(&q->touched);
+  for (i=0; i<n; i++) {
+    q->state[ VECTOR(q->touched)[i] ] = 0;
+  }
+  igraph_vector_long_clear(&q->touched);
+  for (i=0; i<IGRAPH_I_SSSP_BUCKETS; i++) {
+    igraph_vector_long_clear(&q->buckets[i]);
+  }
+  q->active=0;
+  q->last=0;
+}
+
+igraph_bool_t igraph_i_sssp_queue_empty(const igraph_i_sssp_queue_t *q) {
+  if (!q->radix) {
+    return igraph_2wheap_empty(&q->heap);
+  }
+  return q->active == 0;
+}
+
+int igraph_i_sssp_queue_push(igraph_i_sssp_queue_t *q, long int idx,
+			     igraph_real_t dist) {
+  igraph_i_sssp_key_t key;
+  if (!q->radix) {
+    return igraph_2wheap_push_with_index(&q->heap, idx, -dist);
+  }
+  key=(igraph_i_sssp_key_t) dist;
+  IGRAPH_CHECK(igraph_vector_long_push_back(&q->touched, idx));
+  IGRAPH_CHECK(igraph_vector_long_push_back(&q->buckets[
+			      igraph_i_sssp_bucket(q->last, key)], idx));
+  q->keys[idx]=key;
+  q->state[idx]=1;
+  q->active++;
+  return 0;
+}
+
+int igraph_i_sssp_queue_modify(igraph_i_sssp_queue_t *q, long int idx,
+			       igraph_real_t dist) {
+  igraph_i_sssp_key_t key;
+  if (!q->radix) {
+    return igraph_2wheap_modify(&q->heap, idx, -dist);
+  }
+  /* The old entry stays in its bucket, it is skipped once the vertex 
+     is not active any more */
+  key=(igraph_i_sssp_key_t) dist;
+  IGRAPH_CHECK(igraph_vector_long_push_back(&q->buckets[
+			      igraph_i_sssp_bucket(q->last, key)], idx));
+  q->keys[idx]=key;
+  return 0;
+}
+
+int igraph_i_sssp_queue_pop(igraph_i_sssp_queue_t *q, long int *idx,
+			    igraph_real_t *dist) {
+  igraph_vector_long_t *first=&q->buckets[0];
+
+  if (!q->radix) {
+    *idx=igraph_2wheap_max_index(&q->heap);
+    *dist=-igraph_2wheap_deactivate_max(&q->heap);
+    return 0;
+  }
+
+  while (1) {
+    long int i, n, b;
+    igraph_vector_long_t *bucket;
+    igraph_bool_t found=0;
+    igraph_i_sssp_key_t min=0;
+
+    while (!igraph_vector_long_empty(first)) {
+      long int v=igraph_vector_long_pop_back(first);
+      if (q->state[v] == 1) {
+	q->state[v]=2;
+	q->active--;
+	*idx=v;
+	*dist=(igraph_real_t) q->keys[v];
+	return 0;
+      }
+    }
+
+    /* Bucket zero is empty, the minimum is in the first non-empty
+       bucket. Moving its active entries to the new position of 'last'
+       puts them into lower buckets, at least the minimum one goes to
+       bucket zero. Entries of already removed vertices are dropped. */
+    for (b=1; igraph_vector_long_empty(&q->buckets[b]); b++) ;
+    bucket=&q->buckets[b];
+    n=igraph_vector_long_size(bucket);
+    for (i=0; i<n; i++) {
+      long int v=VECTOR(*bucket)[i];
+      if (q->state[v] == 1 && (!found || q->keys[v] < min)) {
+	min=q->keys[v];
+	found=1;
+      }
+    }
+    if (found) {
+      q->last=min;
+      for (i=0; i<n; i++) {
+	long int v=VECTOR(*bucket)[i];
+	if (q->state[v] == 1) {
+	  IGRAPH_CHECK(igraph_vector_long_push_back(&q->buckets[
+			      igraph_i_sssp_bucket(min, q->keys[v])], v));
+	}
+      }
+    }
+    igraph_vector_long_clear(bucket);
+  }
+}
+
+igraph_bool_t igraph_i_sssp_queue_has_elem(const igraph_i_sssp_queue_t *q,
+					   long int idx) {
+  if (!q->radix) {
+    return igraph_2wheap_has_elem(&q->heap, idx);
+  }
+  return q->state[idx] != 0;
+}
+
+igraph_bool_t igraph_i_sssp_queue_has_active(const igraph_i_sssp_queue_t *q,
+					     long int idx) {
+  if (!q->radix) {
+    return igraph_2wheap_has_active(&q->heap, idx);
+  }
+  return q->state[idx] == 1;
+}
+
+igraph_real_t igraph_i_sssp_queue_get(const igraph_i_sssp_queue_t *q,
+				      long int idx) {
+  if (!q->radix) {
+    return -igraph_2wheap_get(&q->heap, idx);
+  }
+  return (igraph_real_t) q->keys[idx];
+}
@@ -44,6 +44,9 @@
 #include "igraph_qsort.h"
 #include "config.h"
 #include "structural_properties_internal.h"
+#include "igraph_msbfs_internal.h"
+#include "igraph_dobfs_internal.h"
+#include "igraph_sssp_internal.h"
 
 #include <assert.h>
 #include <string.h>
@@ -89,88 +92,104 @@
  * \example examples/simple/igraph_diameter.c
  */
 
+typedef struct igraph_i_diameter_data_t {
+  const long int *sources;
+  long int res, from, to;
+  igraph_real_t reached;
+} igraph_i_diameter_data_t;
+
+static int igraph_i_diameter_handler(long int vertex, 
+				     igraph_i_msbfs_word_t mask,
+				     long int dist, void *extra) {
+  igraph_i_diameter_data_t *data=(igraph_i_diameter_data_t*) extra;
+  long int from=data->sources[IGRAPH_I_MSBFS_LOWEST(mask)];
+  IGRAPH_UNUSED(vertex);
+  data->reached += IGRAPH_I_MSBFS_POPCOUNT(mask);
+  /* The first source with the largest eccentricity */
+  if (dist > data->res || (dist == data->res && dist > 0 && 
+			   from < data->from)) {
+    data->res=dist;
+    data->from=from;
+  }
+  return 0;
+}
+
+static int igraph_i_diameter_to_handler(long int vertex, 
+					igraph_i_msbfs_word_t mask,
+					long int dist, void *extra) {
+  igraph_i_diameter_data_t *data=(igraph_i_diameter_data_t*) extra;
+  IGRAPH_UNUSED(mask);
+  if (dist == data->res && data->to < 0) { data->to=vertex; }
+  return 0;
+}
+
 int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres, 
 		    igraph_integer_t *pfrom, igraph_integer_t *pto, 
 		    igraph_vector_t *path,
 		    igraph_bool_t directed, igraph_bool_t unconn) {
 
   long int no_of_nodes=igraph_vcount(graph);
-  long int i, j, n;
-  long int *already_added;
-  long int nodes_reached;
-  long int from=0, to=0;
-  long int res=0;
+  long int i, j, nsrc;
+  long int sources[IGRAPH_I_MSBFS_WIDTH];
+  igraph_i_diameter_data_t data;
 
-  igraph_dqueue_t q=IGRAPH_DQUEUE_NULL;
-  igraph_vector_int_t *neis;
   igraph_neimode_t dirmode;
-  igraph_adjlist_t allneis;
+  igraph_csr_t allneis;
+  igraph_i_msbfs_t bfs;
   
   if (directed) { dirmode=IGRAPH_OUT; } else { dirmode=IGRAPH_ALL; }
-  already_added=igraph_Calloc(no_of_nodes, long int);
-  if (already_added==0) {
-    IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(igraph_free, already_added);
-  IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-  
-  IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, dirmode));
-  IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
+
+  IGRAPH_CHECK(igraph_csr_init(graph, &allneis, dirmode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &allneis);
+  IGRAPH_CHECK(igraph_i_msbfs_init(&bfs, &allneis));
+  IGRAPH_FINALLY(igraph_i_msbfs_destroy, &bfs);
+
+  data.sources=sources;
+  data.res=0; data.from=0; data.to=0;
   
-  for (i=0; i<no_of_nodes; i++) {
-    nodes_reached=1;
-    IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-    IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-    already_added[i]=i+1;
+  /* Searches from IGRAPH_I_MSBFS_WIDTH sources at once */
+  for (i=0; i<no_of_nodes; i+=nsrc) {
+    nsrc=no_of_nodes-i < IGRAPH_I_MSBFS_WIDTH ? no_of_nodes-i : 
+      IGRAPH_I_MSBFS_WIDTH;
+    for (j=0; j<nsrc; j++) { sources[j]=i+j; }
+    data.reached=0;
 
     IGRAPH_PROGRESS("Diameter: ", 100.0*i/no_of_nodes, NULL);
 
-    IGRAPH_ALLOW_INTERRUPTION();
-    
-    while (!igraph_dqueue_empty(&q)) {
-      long int actnode=(long int) igraph_dqueue_pop(&q);
-      long int actdist=(long int) igraph_dqueue_pop(&q);
-      if (actdist>res) { 
-        res=actdist; 
-        from=i;
-        to=actnode;
-      }
-      
-      neis=igraph_adjlist_get(&allneis, actnode);
-      n=igraph_vector_int_size(neis);
-      for (j=0; j<n; j++) {
-	long int neighbor=(long int) VECTOR(*neis)[j];
-	if (already_added[neighbor] == i+1) { continue; }
-	already_added[neighbor]=i+1;
-	nodes_reached++;
-	IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-	IGRAPH_CHECK(igraph_dqueue_push(&q, actdist+1));
-      }
-    } /* while !igraph_dqueue_empty */
+    IGRAPH_CHECK(igraph_i_msbfs_run(&bfs, sources, (int) nsrc, -1, 
+				    igraph_i_diameter_handler, &data));
     
     /* not connected, return largest possible */
-    if (nodes_reached != no_of_nodes && !unconn) {
-      res=no_of_nodes;
-      from=-1;
-      to=-1;
+    if (data.reached != (igraph_real_t) nsrc * no_of_nodes && !unconn) {
+      data.res=no_of_nodes;
+      data.from=-1;
+      data.to=-1;
       break;
     }
   } /* for i<no_of_nodes */
 
+  /* The target is the first vertex at this distance, in BFS order */
+  if (data.res > 0 && data.from >= 0) {
+    data.to=-1;
+    sources[0]=data.from;
+    IGRAPH_CHECK(igraph_i_msbfs_run(&bfs, sources, 1, -1, 
+				    igraph_i_diameter_to_handler, &data));
+  }
+
   IGRAPH_PROGRESS("Diameter: ", 100.0, NULL);
   
   /* return the requested info */
   if (pres != 0) {
-    *pres=(igraph_integer_t) res;
+    *pres=(igraph_integer_t) data.res;
   }
   if (pfrom != 0) {
-    *pfrom=(igraph_integer_t) from;
+    *pfrom=(igraph_integer_t) data.from;
   }
   if (pto != 0) {
-    *pto=(igraph_integer_t) to;
+    *pto=(igraph_integer_t) data.to;
   }
   if (path != 0) {
-    if (res==no_of_nodes) {
+    if (data.res==no_of_nodes) {
       igraph_vector_clear(path);
     } else {
       igraph_vector_ptr_t tmpptr;
@@ -178,8 +197,9 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
       IGRAPH_FINALLY(igraph_vector_ptr_destroy, &tmpptr);
       VECTOR(tmpptr)[0]=path;
       IGRAPH_CHECK(igraph_get_shortest_paths(graph, &tmpptr, 0,
-					     (igraph_integer_t) from, 
-					     igraph_vss_1((igraph_integer_t)to),
+					     (igraph_integer_t) data.from, 
+					     igraph_vss_1((igraph_integer_t)
+							  data.to),
 					     dirmode, 0, 0));
       igraph_vector_ptr_destroy(&tmpptr);
       IGRAPH_FINALLY_CLEAN(1);
@@ -187,10 +207,9 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
   }
   
   /* clean */
-  igraph_Free(already_added);
-  igraph_dqueue_destroy(&q);
-  igraph_adjlist_destroy(&allneis);
-  IGRAPH_FINALLY_CLEAN(3);
+  igraph_i_msbfs_destroy(&bfs);
+  igraph_csr_destroy(&allneis);
+  IGRAPH_FINALLY_CLEAN(2);
 
   return 0;
 }
@@ -220,71 +239,68 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
  * \example examples/simple/igraph_average_path_length.c
  */
 
+typedef struct igraph_i_average_path_length_data_t {
+  igraph_real_t sum, pairs;
+} igraph_i_average_path_length_data_t;
+
+static int igraph_i_average_path_length_handler(long int vertex, 
+						igraph_i_msbfs_word_t mask,
+						long int dist, void *extra) {
+  igraph_i_average_path_length_data_t *data=
+    (igraph_i_average_path_length_data_t*) extra;
+  IGRAPH_UNUSED(vertex);
+  if (dist > 0) {
+    int c=IGRAPH_I_MSBFS_POPCOUNT(mask);
+    data->sum += (igraph_real_t) c * dist;
+    data->pairs += c;
+  }
+  return 0;
+}
+
 int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
 			       igraph_bool_t directed, igraph_bool_t unconn) {
   long int no_of_nodes=igraph_vcount(graph);
-  long int i, j, n;
-  long int *already_added;
-  long int nodes_reached=0;
-  igraph_real_t normfact=0.0;
+  long int i, j, nsrc;
+  long int sources[IGRAPH_I_MSBFS_WIDTH];
+  igraph_i_average_path_length_data_t data;
+  igraph_real_t unreached;
 
-  igraph_dqueue_t q=IGRAPH_DQUEUE_NULL;
-  igraph_vector_int_t *neis;
   igraph_neimode_t dirmode;
-  igraph_adjlist_t allneis;
+  igraph_csr_t allneis;
+  igraph_i_msbfs_t bfs;
 
   *res=0;  
   if (directed) { dirmode=IGRAPH_OUT; } else { dirmode=IGRAPH_ALL; }
-  already_added=igraph_Calloc(no_of_nodes, long int);
-  if (already_added==0) {
-    IGRAPH_ERROR("average path length failed", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(free, already_added); /* TODO: hack */
-  IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
 
-  igraph_adjlist_init(graph, &allneis, dirmode);
-  IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
-
-  for (i=0; i<no_of_nodes; i++) {
-    nodes_reached=0;
-    IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-    IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-    already_added[i]=i+1;
-
-    IGRAPH_ALLOW_INTERRUPTION();
-    
-    while (!igraph_dqueue_empty(&q)) {
-      long int actnode=(long int) igraph_dqueue_pop(&q);
-      long int actdist=(long int) igraph_dqueue_pop(&q);
-    
-      neis=igraph_adjlist_get(&allneis, actnode);
-      n=igraph_vector_int_size(neis);
-      for (j=0; j<n; j++) {
-	long int neighbor=(long int) VECTOR(*neis)[j];
-	if (already_added[neighbor] == i+1) { continue; }
-	already_added[neighbor]=i+1;
-	nodes_reached++;
-	*res += actdist+1;
-	normfact+=1;
-	IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-	IGRAPH_CHECK(igraph_dqueue_push(&q, actdist+1));
-      }
-    } /* while !igraph_dqueue_empty */
-    
-    /* not connected, return largest possible */
-    if (!unconn) {
-      *res += (no_of_nodes * (no_of_nodes-1-nodes_reached));
-      normfact += no_of_nodes-1-nodes_reached;
-    }    
+  IGRAPH_CHECK(igraph_csr_init(graph, &allneis, dirmode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &allneis);
+  IGRAPH_CHECK(igraph_i_msbfs_init(&bfs, &allneis));
+  IGRAPH_FINALLY(igraph_i_msbfs_destroy, &bfs);
+
+  data.sum=0; data.pairs=0;
+  for (i=0; i<no_of_nodes; i+=nsrc) {
+    nsrc=no_of_nodes-i < IGRAPH_I_MSBFS_WIDTH ? no_of_nodes-i : 
+      IGRAPH_I_MSBFS_WIDTH;
+    for (j=0; j<nsrc; j++) { sources[j]=i+j; }
+    IGRAPH_CHECK(igraph_i_msbfs_run(&bfs, sources, (int) nsrc, -1, 
+				    igraph_i_average_path_length_handler,
+				    &data));
   } /* for i<no_of_nodes */
 
-  *res /= normfact;
+  *res=data.sum;
+  /* not connected, count the largest possible */
+  if (!unconn) {
+    unreached=(igraph_real_t) no_of_nodes * (no_of_nodes-1) - data.pairs;
+    *res += no_of_nodes * unreached;
+    data.pairs += unreached;
+  }    
+
+  *res /= data.pairs;
 
   /* clean */
-  igraph_Free(already_added);
-  igraph_dqueue_destroy(&q);
-  igraph_adjlist_destroy(&allneis);
-  IGRAPH_FINALLY_CLEAN(3);
+  igraph_i_msbfs_destroy(&bfs);
+  igraph_csr_destroy(&allneis);
+  IGRAPH_FINALLY_CLEAN(2);
 
   return 0;
 }
@@ -452,19 +468,97 @@ int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
  * \ref igraph_shortest_paths_dijkstra() for the weighted version.
  */
 
+typedef struct igraph_i_shortest_paths_data_t {
+  igraph_matrix_t *res;
+  long int row;
+  const igraph_vector_t *indexv;
+  long int remaining;
+} igraph_i_shortest_paths_data_t;
+
+/* 'remaining' is the number of (source, target) pairs not reached
+   yet in the current batch, the search stops when it is zero. */
+
+static int igraph_i_shortest_paths_handler(long int vertex, 
+					   igraph_i_msbfs_word_t mask,
+					   long int dist, void *extra) {
+  igraph_i_shortest_paths_data_t *data=
+    (igraph_i_shortest_paths_data_t*) extra;
+  long int col=vertex;
+  if (data->indexv) {
+    col=(long int) VECTOR(*data->indexv)[vertex] - 1;
+    if (col < 0) { return 0; }
+  }
+  data->remaining -= IGRAPH_I_MSBFS_POPCOUNT(mask);
+  while (mask) {
+    int b=IGRAPH_I_MSBFS_LOWEST(mask);
+    MATRIX(*data->res, data->row + b, col) = dist;
+    mask &= mask-1;
+  }
+  return data->remaining == 0 ? IGRAPH_I_MSBFS_STOP : 0;
+}
+
+/* A single source is searched with the direction-optimizing BFS,
+   this needs the reverse adjacency list as well, for directed
+   graphs. */
+
+static int igraph_i_shortest_paths_dobfs(const igraph_t *graph,
+					 const igraph_csr_t *csr,
+					 igraph_neimode_t mode,
+					 long int source, igraph_matrix_t *res,
+					 const igraph_vector_t *indexv) {
+  long int no_of_nodes=igraph_vcount(graph);
+  igraph_bool_t reverse= igraph_is_directed(graph) && mode != IGRAPH_ALL;
+  igraph_csr_t in;
+  igraph_i_dobfs_t bfs;
+  igraph_vector_t dist;
+  long int i;
+
+  if (reverse) {
+    IGRAPH_CHECK(igraph_csr_init(graph, &in, mode==IGRAPH_OUT ? 
+				 IGRAPH_IN : IGRAPH_OUT));
+    IGRAPH_FINALLY(igraph_csr_destroy, &in);
+  }
+  IGRAPH_CHECK(igraph_i_dobfs_init(&bfs, csr, reverse ? &in : csr));
+  IGRAPH_FINALLY(igraph_i_dobfs_destroy, &bfs);
+
+  if (!indexv) {
+    /* 'res' is a single row, filled with infinity */
+    IGRAPH_CHECK(igraph_i_dobfs_run(&bfs, source, &MATRIX(*res, 0, 0), 0));
+  } else {
+    IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
+    igraph_vector_fill(&dist, IGRAPH_INFINITY);
+    IGRAPH_CHECK(igraph_i_dobfs_run(&bfs, source, VECTOR(dist), 0));
+    for (i=0; i<no_of_nodes; i++) {
+      long int col=(long int) VECTOR(*indexv)[i] - 1;
+      if (col >= 0) { MATRIX(*res, 0, col) = VECTOR(dist)[i]; }
+    }
+    igraph_vector_destroy(&dist);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
+
+  igraph_i_dobfs_destroy(&bfs);
+  IGRAPH_FINALLY_CLEAN(1);
+  if (reverse) {
+    igraph_csr_destroy(&in);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
+
+  return 0;
+}
+
 int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res, 
 			  const igraph_vs_t from, const igraph_vs_t to,
 			  igraph_neimode_t mode) {
 
   long int no_of_nodes=igraph_vcount(graph);
   long int no_of_from, no_of_to;
-  long int *already_counted;
-  igraph_adjlist_t adjlist;
-  igraph_dqueue_t q=IGRAPH_DQUEUE_NULL;
-  igraph_vector_int_t *neis;
+  igraph_csr_t csr;
+  igraph_i_msbfs_t bfs;
   igraph_bool_t all_to;
+  long int sources[IGRAPH_I_MSBFS_WIDTH];
+  igraph_i_shortest_paths_data_t data;
 
-  long int i, j;
+  long int i, nsrc;
   igraph_vit_t fromvit, tovit;
   igraph_real_t my_infinity=IGRAPH_INFINITY;
   igraph_vector_t indexv;
@@ -478,15 +572,8 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
   IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
   no_of_from=IGRAPH_VIT_SIZE(fromvit);
 
-  IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode));
-  IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-
-  already_counted=igraph_Calloc(no_of_nodes, long int);
-  if (already_counted==0) {
-    IGRAPH_ERROR("shortest paths failed", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(free, already_counted);
-  IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
+  IGRAPH_CHECK(igraph_csr_init(graph, &csr, mode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &csr);
 
   if ( (all_to=igraph_vs_is_all(&to)) ) {
     no_of_to=no_of_nodes;
@@ -508,42 +595,29 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
   IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
   igraph_matrix_fill(res, my_infinity);
 
-  for (IGRAPH_VIT_RESET(fromvit), i=0; 
-       !IGRAPH_VIT_END(fromvit); 
-       IGRAPH_VIT_NEXT(fromvit), i++) {
-    long int reached=0;
-    IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(fromvit)));
-    IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-    already_counted[ (long int) IGRAPH_VIT_GET(fromvit) ] = i+1;
-    
-    IGRAPH_ALLOW_INTERRUPTION();
-
-    while (!igraph_dqueue_empty(&q)) {
-      long int act=(long int) igraph_dqueue_pop(&q);
-      long int actdist=(long int) igraph_dqueue_pop(&q);
-
-      if (all_to) {
-	MATRIX(*res, i, act)=actdist;
-      } else {
-	if (VECTOR(indexv)[act]) {
-	  MATRIX(*res, i, (long int)(VECTOR(indexv)[act]-1)) = actdist;
-	  reached++;
-	  if (reached==no_of_to) {
-	    igraph_dqueue_clear(&q);
-	    break;
-	  }
-	}
-      }
-      
-      neis = igraph_adjlist_get(&adjlist, act);
-      for (j=0; j<igraph_vector_int_size(neis); j++) {
-        long int neighbor=(long int) VECTOR(*neis)[j];
-        if (already_counted[neighbor] == i+1) { continue; }
-        already_counted[neighbor] = i+1;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, actdist+1));
+  data.res=res;
+  data.indexv= all_to ? 0 : &indexv;
+  IGRAPH_VIT_RESET(fromvit);
+  if (no_of_from == 1) {
+    IGRAPH_CHECK(igraph_i_shortest_paths_dobfs(graph, &csr, mode,
+					       IGRAPH_VIT_GET(fromvit), res,
+					       data.indexv));
+  } else if (no_of_from > 1) {
+    /* Searches from IGRAPH_I_MSBFS_WIDTH sources at once */
+    IGRAPH_CHECK(igraph_i_msbfs_init(&bfs, &csr));
+    IGRAPH_FINALLY(igraph_i_msbfs_destroy, &bfs);
+    for (i=0; i<no_of_from; i+=nsrc) {
+      for (nsrc=0; nsrc < IGRAPH_I_MSBFS_WIDTH && !IGRAPH_VIT_END(fromvit);
+	   nsrc++, IGRAPH_VIT_NEXT(fromvit)) {
+	sources[nsrc]=IGRAPH_VIT_GET(fromvit);
       }
+      data.row=i;
+      data.remaining=nsrc * no_of_to;
+      IGRAPH_CHECK(igraph_i_msbfs_run(&bfs, sources, (int) nsrc, -1,
+				      igraph_i_shortest_paths_handler, &data));
     }
+    igraph_i_msbfs_destroy(&bfs);
+    IGRAPH_FINALLY_CLEAN(1);
   }
 
   /* Clean */
@@ -553,11 +627,9 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
     IGRAPH_FINALLY_CLEAN(2);
   }
 
-  igraph_Free(already_counted);
-  igraph_dqueue_destroy(&q);
+  igraph_csr_destroy(&csr);
   igraph_vit_destroy(&fromvit);
-  igraph_adjlist_destroy(&adjlist);
-  IGRAPH_FINALLY_CLEAN(4);
+  IGRAPH_FINALLY_CLEAN(2);
 
   return 0;
 }
@@ -4178,7 +4250,9 @@ int igraph_convergence_degree(const igraph_t *graph, igraph_vector_t *result,
  * This function is Dijkstra's algorithm to find the weighted 
  * shortest paths to all vertices from a single source. (It is run 
  * independently for the given sources.) It uses a binary heap for 
- * efficient implementation.
+ * efficient implementation. If all weights are integers, and the
+ * longest possible path is shorter than 2^53, then a radix heap is
+ * used instead, which is usually faster.
  * 
  * \param graph The input graph, can be directed.
  * \param res The result, a matrix. A pointer to an initialized matrix
@@ -4220,15 +4294,13 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
 				   igraph_neimode_t mode) {
 
   /* Implementation details. This is the basic Dijkstra algorithm, 
-     with a binary heap. The heap is indexed, i.e. it stores not only
-     the distances, but also which vertex they belong to.
-
-     From now on we use a 2-way heap, so the distances can be queried
-     directly from the heap.
+     with an indexed priority queue, i.e. it stores not only
+     the distances, but also which vertex they belong to. For integer
+     weights the queue is a radix heap, otherwise a 2-way heap, 
+     see igraph_sssp_internal.h. The distances can be queried
+     directly from the queue.
 
      Dirty tricks:
-     - the opposite of the distance is stored in the heap, as it is a
-       maximum heap and we need a minimum heap.
      - we don't use IGRAPH_INFINITY in the res matrix during the
        computation, as IGRAPH_FINITE() might involve a function call 
        and we want to spare that. -1 will denote infinity instead.
@@ -4236,7 +4308,7 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
   
   long int no_of_nodes=igraph_vcount(graph);
   long int no_of_edges=igraph_ecount(graph);
-  igraph_2wheap_t Q;
+  igraph_i_sssp_queue_t Q;
   igraph_vit_t fromvit, tovit;
   long int no_of_from, no_of_to;
   igraph_lazy_inclist_t inclist;
@@ -4260,8 +4332,8 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
   IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
   no_of_from=IGRAPH_VIT_SIZE(fromvit);
   
-  IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-  IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+  IGRAPH_CHECK(igraph_i_sssp_queue_init(&Q, no_of_nodes, weights));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q);
   IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
   IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
 
@@ -4291,15 +4363,17 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
     
     long int reached=0;
     long int source=IGRAPH_VIT_GET(fromvit);
-    igraph_2wheap_clear(&Q);
-    igraph_2wheap_push_with_index(&Q, source, -1.0);
+    igraph_i_sssp_queue_clear(&Q);
+    IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, source, 1.0));
     
-    while (!igraph_2wheap_empty(&Q)) {
-      long int minnei=igraph_2wheap_max_index(&Q);
-      igraph_real_t mindist=-igraph_2wheap_deactivate_max(&Q);
+    while (!igraph_i_sssp_queue_empty(&Q)) {
+      long int minnei;
+      igraph_real_t mindist;
       igraph_vector_t *neis;
       long int nlen;
 
+      IGRAPH_CHECK(igraph_i_sssp_queue_pop(&Q, &minnei, &mindist));
+
       if (all_to) {
 	MATRIX(*res, i, minnei)=mindist-1.0;
       } else {
@@ -4307,7 +4381,7 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
 	  MATRIX(*res, i, (long int)(VECTOR(indexv)[minnei]-1)) = mindist-1.0;
 	  reached++;
 	  if (reached==no_of_to) {
-	    igraph_2wheap_clear(&Q);
+	    igraph_i_sssp_queue_clear(&Q);
 	    break;
 	  }
 	}
@@ -4320,19 +4394,19 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
 	long int edge=(long int) VECTOR(*neis)[j];
 	long int tto=IGRAPH_OTHER(graph, edge, minnei);
 	igraph_real_t altdist=mindist + VECTOR(*weights)[edge];
-	igraph_bool_t active=igraph_2wheap_has_active(&Q, tto);
-	igraph_bool_t has=igraph_2wheap_has_elem(&Q, tto);
-	igraph_real_t curdist= active ? -igraph_2wheap_get(&Q, tto) : 0.0;
+	igraph_bool_t active=igraph_i_sssp_queue_has_active(&Q, tto);
+	igraph_bool_t has=igraph_i_sssp_queue_has_elem(&Q, tto);
+	igraph_real_t curdist= active ? igraph_i_sssp_queue_get(&Q, tto) : 0.0;
 	if (!has) {
 	  /* This is the first non-infinite distance */
-	  IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, tto, altdist));
 	} else if (altdist < curdist) {
 	  /* This is a shorter path */
-	  IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_modify(&Q, tto, altdist));
 	}
       }
       
-    } /* !igraph_2wheap_empty(&Q) */
+    } /* !igraph_i_sssp_queue_empty(&Q) */
 
   } /* !IGRAPH_VIT_END(fromvit) */
 
@@ -4343,7 +4417,7 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
   }  
   
   igraph_lazy_inclist_destroy(&inclist);
-  igraph_2wheap_destroy(&Q);
+  igraph_i_sssp_queue_destroy(&Q);
   igraph_vit_destroy(&fromvit);
   IGRAPH_FINALLY_CLEAN(3);
   
@@ -4442,15 +4516,11 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
                                        igraph_vector_long_t *predecessors,
                                        igraph_vector_long_t *inbound_edges) {
   /* Implementation details. This is the basic Dijkstra algorithm, 
-     with a binary heap. The heap is indexed, i.e. it stores not only
-     the distances, but also which vertex they belong to. The other
-     mapping, i.e. getting the distance for a vertex is not in the
-     heap (that would by the double-indexed heap), but in the result
-     matrix.
+     with an indexed priority queue (a radix heap for integer weights,
+     a 2-way heap otherwise, see igraph_sssp_internal.h). The
+     distance of a vertex is also kept in the `dists' vector.
 
      Dirty tricks:
-     - the opposite of the distance is stored in the heap, as it is a
-       maximum heap and we need a minimum heap.
      - we don't use IGRAPH_INFINITY in the distance vector during the
        computation, as IGRAPH_FINITE() might involve a function call 
        and we want to spare that. So we store distance+1.0 instead of 
@@ -4463,7 +4533,7 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
   long int no_of_nodes=igraph_vcount(graph);
   long int no_of_edges=igraph_ecount(graph);
   igraph_vit_t vit;
-  igraph_2wheap_t Q;
+  igraph_i_sssp_queue_t Q;
   igraph_lazy_inclist_t inclist;
   igraph_vector_t dists;
   long int *parents;
@@ -4492,8 +4562,8 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
     IGRAPH_ERROR("Size of `edges' and `to' should match", IGRAPH_EINVAL);
   }
 
-  IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-  IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+  IGRAPH_CHECK(igraph_i_sssp_queue_init(&Q, no_of_nodes, weights));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q);
   IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
   IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
 
@@ -4519,15 +4589,17 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
 
   VECTOR(dists)[(long int)from] = 0.0;	/* zero distance */
   parents[(long int)from] = 0;
-  igraph_2wheap_push_with_index(&Q, from, 0);
+  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, from, 0));
     
-  while (!igraph_2wheap_empty(&Q) && to_reach > 0) {
-    long int nlen, minnei=igraph_2wheap_max_index(&Q);
-    igraph_real_t mindist=-igraph_2wheap_delete_max(&Q);
+  while (!igraph_i_sssp_queue_empty(&Q) && to_reach > 0) {
+    long int nlen, minnei;
+    igraph_real_t mindist;
     igraph_vector_t *neis;
 
     IGRAPH_ALLOW_INTERRUPTION();
 
+    IGRAPH_CHECK(igraph_i_sssp_queue_pop(&Q, &minnei, &mindist));
+
     if (is_target[minnei]) {
       is_target[minnei] = 0;
 	  to_reach--;
@@ -4545,15 +4617,15 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
         /* This is the first finite distance */
         VECTOR(dists)[tto] = altdist;
         parents[tto] = edge+1;
-        IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+        IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, tto, altdist));
       } else if (altdist < curdist) {
 	      /* This is a shorter path */
         VECTOR(dists)[tto] = altdist;
         parents[tto] = edge+1;
-        IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+        IGRAPH_CHECK(igraph_i_sssp_queue_modify(&Q, tto, altdist));
       }
     }
-  } /* !igraph_2wheap_empty(&Q) */
+  } /* !igraph_i_sssp_queue_empty(&Q) */
 
   if (to_reach > 0) IGRAPH_WARNING("Couldn't reach some vertices");
 
@@ -4635,7 +4707,7 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
   }
   
   igraph_lazy_inclist_destroy(&inclist);
-  igraph_2wheap_destroy(&Q);
+  igraph_i_sssp_queue_destroy(&Q);
   igraph_vector_destroy(&dists);
   igraph_Free(is_target);
   igraph_Free(parents);
@@ -4724,6 +4796,429 @@ int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
   return 0;
 }
 
+/* Stores the path from the root of a shortest path tree to 'node' in 
+   'vertices' and 'edges', both can be null pointers. 'parents' 
+   contains the id of the inbound tree edge plus one for each vertex,
+   and zero for the root. */
+
+static int igraph_i_path_from_parents(const igraph_t *graph, 
+				      const long int *parents, long int node,
+				      igraph_vector_t *vertices,
+				      igraph_vector_t *edges) {
+  long int size=0, act=node, i;
+  while (parents[act]) {
+    size++;
+    act=IGRAPH_OTHER(graph, parents[act]-1, act);
+  }
+  if (vertices) { 
+    IGRAPH_CHECK(igraph_vector_resize(vertices, size+1)); 
+    VECTOR(*vertices)[size]=node;
+  }
+  if (edges) { IGRAPH_CHECK(igraph_vector_resize(edges, size)); }
+  act=node;
+  for (i=size-1; i>=0; i--) {
+    long int edge=parents[act]-1;
+    act=IGRAPH_OTHER(graph, edge, act);
+    if (vertices) { VECTOR(*vertices)[i]=act; }
+    if (edges) { VECTOR(*edges)[i]=edge; }
+  }
+  return 0;
+}
+
+/**
+ * \function igraph_get_shortest_path_bidirectional
+ * Shortest path between two vertices, searching from both ends.
+ * 
+ * Calculates a single shortest path from a vertex to another one,
+ * by running two searches at the same time: one from the source
+ * vertex, following the paths forward, and one from the target
+ * vertex, following them backwards. The searches stop as soon as the
+ * shortest path is known, which is usually much earlier than
+ * reaching all vertices as close to the source as the target. For
+ * weighted graphs the searches are Dijkstra's algorithm, otherwise
+ * they are breadth-first searches.
+ * 
+ * </para><para>If there are more than one shortest paths between the
+ * two vertices, then an arbitrary one is returned. If the target is
+ * not reachable from the source, then a warning is given and both
+ * result vectors are empty.
+ * 
+ * \param graph The input graph, it can be directed or undirected.
+ * \param vertices Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the vertex ids along
+ *        the path are stored here, including the source and target
+ *        vertices. 
+ * \param edges Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the edge ids along the
+ *        path are stored here.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \param weights Vector of edge weights, in the order of edge
+ *        ids. They must be non-negative. If this is a null pointer,
+ *        then all edges have unit weight.
+ * \param mode A constant specifying how edge directions are
+ *        considered in directed graphs. \c IGRAPH_OUT follows edge
+ *        directions, \c IGRAPH_IN follows the opposite directions,
+ *        and \c IGRAPH_ALL ignores edge directions. This argument is
+ *        ignored for undirected graphs.
+ * \return Error code.
+ * 
+ * Time complexity: O(|E|log|E|+|V|) in the worst case, |V| is the
+ * number of vertices, |E| is the number of edges in the graph. 
+ * In practice only the neighborhoods of the two vertices are visited.
+ * 
+ * \sa \ref igraph_get_shortest_path_dijkstra() and \ref
+ * igraph_get_shortest_path() for searching from the source only,
+ * \ref igraph_get_shortest_path_astar() for directing the search with
+ * a heuristic.
+ * 
+ * \example examples/simple/igraph_get_shortest_path_astar.c
+ */
+
+int igraph_get_shortest_path_bidirectional(const igraph_t *graph,
+					   igraph_vector_t *vertices,
+					   igraph_vector_t *edges,
+					   igraph_integer_t from,
+					   igraph_integer_t to,
+					   const igraph_vector_t *weights,
+					   igraph_neimode_t mode) {
+
+  /* Implementation details. There is a priority queue, a distance 
+     vector and a shortest path tree (`parents', see 
+     igraph_get_shortest_paths_dijkstra()) for both directions. 
+     `best' is the length of the shortest path found so far, it goes
+     through vertex `meet'. It is a shortest path, if the radii of
+     the two searches, i.e. the last distances taken from the queues,
+     add up to at least its length. The search with the smaller
+     radius takes the next step.
+
+     For the backward search, parents[] contains the edge towards the
+     target. */
+
+  long int no_of_nodes=igraph_vcount(graph);
+  long int no_of_edges=igraph_ecount(graph);
+  igraph_neimode_t revmode;
+  igraph_i_sssp_queue_t Q[2];
+  igraph_lazy_inclist_t inclist[2];
+  igraph_vector_t dists[2];
+  long int *parents[2];
+  igraph_real_t radius[2]={ 0.0, 0.0 };
+  igraph_real_t best=IGRAPH_INFINITY;
+  long int meet=-1, d;
+
+  if (from < 0 || from >= no_of_nodes || to < 0 || to >= no_of_nodes) {
+    IGRAPH_ERROR("Cannot get shortest path", IGRAPH_EINVVID);
+  }
+  if (mode != IGRAPH_OUT && mode != IGRAPH_IN && 
+      mode != IGRAPH_ALL) {
+    IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+  }
+  if (weights) {
+    if (igraph_vector_size(weights) != no_of_edges) {
+      IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+    }
+    if (no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+      IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+    }
+  }
+
+  revmode = mode == IGRAPH_OUT ? IGRAPH_IN : 
+    mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL;
+
+  IGRAPH_CHECK(igraph_i_sssp_queue_init(&Q[0], no_of_nodes, weights));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q[0]);
+  IGRAPH_CHECK(igraph_i_sssp_queue_init_radix(&Q[1], no_of_nodes, Q[0].radix));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q[1]);
+  IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist[0], mode));
+  IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist[0]);
+  IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist[1], revmode));
+  IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist[1]);
+  IGRAPH_VECTOR_INIT_FINALLY(&dists[0], no_of_nodes);
+  igraph_vector_fill(&dists[0], -1.0);
+  IGRAPH_VECTOR_INIT_FINALLY(&dists[1], no_of_nodes);
+  igraph_vector_fill(&dists[1], -1.0);
+  parents[0]=igraph_Calloc(no_of_nodes, long int);
+  if (parents[0] == 0) {
+    IGRAPH_ERROR("Can't calculate shortest path", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, parents[0]);
+  parents[1]=igraph_Calloc(no_of_nodes, long int);
+  if (parents[1] == 0) {
+    IGRAPH_ERROR("Can't calculate shortest path", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, parents[1]);
+
+  VECTOR(dists[0])[(long int) from]=0.0;
+  VECTOR(dists[1])[(long int) to]=0.0;
+  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q[0], from, 0.0));
+  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q[1], to, 0.0));
+  if (from == to) {
+    best=0.0; meet=from;
+  }
+
+  while (!igraph_i_sssp_queue_empty(&Q[0]) && 
+	 !igraph_i_sssp_queue_empty(&Q[1]) &&
+	 radius[0] + radius[1] < best) {
+    long int minnei, nlen, i;
+    igraph_real_t mindist;
+    igraph_vector_t *neis;
+    igraph_vector_t *mydists, *otherdists;
+
+    IGRAPH_ALLOW_INTERRUPTION();
+
+    d = radius[0] <= radius[1] ? 0 : 1;
+    mydists=&dists[d];
+    otherdists=&dists[1-d];
+    IGRAPH_CHECK(igraph_i_sssp_queue_pop(&Q[d], &minnei, &mindist));
+    radius[d]=mindist;
+
+    /* Now check all neighbors of 'minnei' for a shorter path */
+    neis=igraph_lazy_inclist_get(&inclist[d], (igraph_integer_t) minnei);
+    nlen=igraph_vector_size(neis);
+    for (i=0; i<nlen; i++) {
+      long int edge=(long int) VECTOR(*neis)[i];
+      long int tto=IGRAPH_OTHER(graph, edge, minnei);
+      igraph_real_t altdist=mindist + (weights ? VECTOR(*weights)[edge] : 1);
+      igraph_real_t curdist=VECTOR(*mydists)[tto];
+      if (curdist < 0) {
+        /* This is the first finite distance */
+        VECTOR(*mydists)[tto] = altdist;
+        parents[d][tto] = edge+1;
+        IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q[d], tto, altdist));
+      } else if (altdist < curdist) {
+	/* This is a shorter path */
+        VECTOR(*mydists)[tto] = altdist;
+        parents[d][tto] = edge+1;
+        IGRAPH_CHECK(igraph_i_sssp_queue_modify(&Q[d], tto, altdist));
+      } else {
+	continue;
+      }
+      /* Do the two searches meet here? */
+      if (VECTOR(*otherdists)[tto] >= 0 && 
+	  altdist + VECTOR(*otherdists)[tto] < best) {
+	best=altdist + VECTOR(*otherdists)[tto];
+	meet=tto;
+      }
+    }
+  }
+
+  if (vertices) { igraph_vector_clear(vertices); }
+  if (edges) { igraph_vector_clear(edges); }
+
+  if (meet < 0) {
+    IGRAPH_WARNING("Couldn't reach some vertices");
+  } else {
+    long int act=meet;
+    IGRAPH_CHECK(igraph_i_path_from_parents(graph, parents[0], meet,
+					    vertices, edges));
+    while (parents[1][act]) {
+      long int edge=parents[1][act]-1;
+      act=IGRAPH_OTHER(graph, edge, act);
+      if (vertices) { IGRAPH_CHECK(igraph_vector_push_back(vertices, act)); }
+      if (edges) { IGRAPH_CHECK(igraph_vector_push_back(edges, edge)); }
+    }
+  }
+
+  igraph_Free(parents[1]);
+  igraph_Free(parents[0]);
+  igraph_vector_destroy(&dists[1]);
+  igraph_vector_destroy(&dists[0]);
+  igraph_lazy_inclist_destroy(&inclist[1]);
+  igraph_lazy_inclist_destroy(&inclist[0]);
+  igraph_i_sssp_queue_destroy(&Q[1]);
+  igraph_i_sssp_queue_destroy(&Q[0]);
+  IGRAPH_FINALLY_CLEAN(8);
+
+  return 0;
+}
+
+/**
+ * \function igraph_get_shortest_path_astar
+ * Shortest path between two vertices, using a heuristic.
+ * 
+ * Calculates a single shortest path from a vertex to another one,
+ * using the A* algorithm. This is Dijkstra's algorithm, where the
+ * vertices are taken in the order of their distance from the source
+ * plus the estimated distance to the target, given by a heuristic
+ * function. A good estimate leads the search towards the target,
+ * and much fewer vertices are visited than with Dijkstra's algorithm.
+ * For example, if the vertices have coordinates, e.g. from a layout,
+ * and the edge weights are at least as large as the distances between
+ * their endpoints, then the straight-line distance to the target is
+ * a good heuristic.
+ * 
+ * </para><para>The result is a shortest path if the heuristic is
+ * admissible, i.e. it never overestimates the distance to the
+ * target. If it is also consistent, i.e. the estimate for a vertex
+ * is never larger than the weight of an edge plus the estimate for
+ * the other endpoint, then each vertex is visited at most once.
+ * 
+ * </para><para>If there are more than one shortest paths between the
+ * two vertices, then an arbitrary one is returned. If the target is
+ * not reachable from the source, then a warning is given and both
+ * result vectors are empty.
+ * 
+ * \param graph The input graph, it can be directed or undirected.
+ * \param vertices Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the vertex ids along
+ *        the path are stored here, including the source and target
+ *        vertices. 
+ * \param edges Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the edge ids along the
+ *        path are stored here.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \param weights Vector of edge weights, in the order of edge
+ *        ids. They must be non-negative. If this is a null pointer,
+ *        then all edges have unit weight.
+ * \param mode A constant specifying how edge directions are
+ *        considered in directed graphs. \c IGRAPH_OUT follows edge
+ *        directions, \c IGRAPH_IN follows the opposite directions,
+ *        and \c IGRAPH_ALL ignores edge directions. This argument is
+ *        ignored for undirected graphs.
+ * \param heuristic The heuristic function, see \ref
+ *        igraph_astar_heuristic_func_t. It is called at most once for
+ *        each vertex. If this is a null pointer, then the estimate is
+ *        always zero, and the search is Dijkstra's algorithm, stopped
+ *        at the target.
+ * \param extra Extra argument to pass to the heuristic function.
+ * \return Error code.
+ * 
+ * Time complexity: O(|E|log|E|+|V|) for a consistent heuristic, plus
+ * the time of the heuristic calls, |V| is the number of vertices,
+ * |E| is the number of edges in the graph. In practice it depends on
+ * the quality of the heuristic.
+ * 
+ * \sa \ref igraph_get_shortest_path_dijkstra(), \ref
+ * igraph_get_shortest_path_bidirectional().
+ * 
+ * \example examples/simple/igraph_get_shortest_path_astar.c
+ */
+
+int igraph_get_shortest_path_astar(const igraph_t *graph,
+				   igraph_vector_t *vertices,
+				   igraph_vector_t *edges,
+				   igraph_integer_t from,
+				   igraph_integer_t to,
+				   const igraph_vector_t *weights,
+				   igraph_neimode_t mode,
+				   igraph_astar_heuristic_func_t *heuristic,
+				   void *extra) {
+
+  /* Implementation details. This is igraph_get_shortest_paths_dijkstra()
+     with a single target, but the heap contains the distance plus the
+     estimate (`estimates', NaN if not known yet). A vertex taken from
+     the heap is put back if a shorter path is found to it later, this
+     can only happen if the heuristic is not consistent. */
+
+  long int no_of_nodes=igraph_vcount(graph);
+  long int no_of_edges=igraph_ecount(graph);
+  igraph_2wheap_t Q;
+  igraph_lazy_inclist_t inclist;
+  igraph_vector_t dists, estimates;
+  long int *parents;
+  igraph_bool_t found= (from == to);
+
+  if (from < 0 || from >= no_of_nodes || to < 0 || to >= no_of_nodes) {
+    IGRAPH_ERROR("Cannot get shortest path", IGRAPH_EINVVID);
+  }
+  if (mode != IGRAPH_OUT && mode != IGRAPH_IN && 
+      mode != IGRAPH_ALL) {
+    IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+  }
+  if (weights) {
+    if (igraph_vector_size(weights) != no_of_edges) {
+      IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+    }
+    if (no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+      IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+    }
+  }
+
+  IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
+  IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+  IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
+  IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
+  IGRAPH_VECTOR_INIT_FINALLY(&dists, no_of_nodes);
+  igraph_vector_fill(&dists, -1.0);
+  IGRAPH_VECTOR_INIT_FINALLY(&estimates, no_of_nodes);
+  igraph_vector_fill(&estimates, IGRAPH_NAN);
+  parents=igraph_Calloc(no_of_nodes, long int);
+  if (parents == 0) {
+    IGRAPH_ERROR("Can't calculate shortest path", IGRAPH_ENOMEM);
+  }
+  IGRAPH_FINALLY(igraph_free, parents);
+
+  VECTOR(dists)[(long int) from]=0.0;
+  IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, from, 0.0));
+
+  while (!found && !igraph_2wheap_empty(&Q)) {
+    long int nlen, minnei=igraph_2wheap_max_index(&Q);
+    igraph_real_t mindist;
+    igraph_vector_t *neis;
+    long int i;
+
+    IGRAPH_ALLOW_INTERRUPTION();
+
+    igraph_2wheap_delete_max(&Q);
+    if (minnei == to) {
+      found=1;
+      break;
+    }
+    mindist=VECTOR(dists)[minnei];
+
+    /* Now check all neighbors of 'minnei' for a shorter path */
+    neis=igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
+    nlen=igraph_vector_size(neis);
+    for (i=0; i<nlen; i++) {
+      long int edge=(long int) VECTOR(*neis)[i];
+      long int tto=IGRAPH_OTHER(graph, edge, minnei);
+      igraph_real_t altdist=mindist + (weights ? VECTOR(*weights)[edge] : 1);
+      igraph_real_t curdist=VECTOR(dists)[tto];
+      igraph_real_t est;
+      if (curdist >= 0 && altdist >= curdist) { continue; }
+      VECTOR(dists)[tto]=altdist;
+      parents[tto]=edge+1;
+      est=VECTOR(estimates)[tto];
+      if (igraph_is_nan(est)) {
+	if (heuristic) {
+	  IGRAPH_CHECK(heuristic(&est, (igraph_integer_t) tto, to, extra));
+	  if (igraph_is_nan(est)) {
+	    IGRAPH_ERROR("Heuristic returned NaN", IGRAPH_EINVAL);
+	  }
+	} else {
+	  est=0.0;
+	}
+	VECTOR(estimates)[tto]=est;
+      }
+      if (igraph_2wheap_has_elem(&Q, tto)) {
+	IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -(altdist+est)));
+      } else {
+	IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -(altdist+est)));
+      }
+    }
+  }
+
+  if (vertices) { igraph_vector_clear(vertices); }
+  if (edges) { igraph_vector_clear(edges); }
+
+  if (!found) {
+    IGRAPH_WARNING("Couldn't reach some vertices");
+  } else {
+    IGRAPH_CHECK(igraph_i_path_from_parents(graph, parents, to,
+					    vertices, edges));
+  }
+
+  igraph_Free(parents);
+  igraph_vector_destroy(&estimates);
+  igraph_vector_destroy(&dists);
+  igraph_lazy_inclist_destroy(&inclist);
+  igraph_2wheap_destroy(&Q);
+  IGRAPH_FINALLY_CLEAN(5);
+
+  return 0;
+}
+
 int igraph_i_vector_tail_cmp(const void* path1, const void* path2);
 
 /* Compares two paths based on their last elements. Required by
@@ -4805,7 +5300,7 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
   long int no_of_nodes=igraph_vcount(graph);
   long int no_of_edges=igraph_ecount(graph);
   igraph_vit_t vit;
-  igraph_2wheap_t Q;
+  igraph_i_sssp_queue_t Q;
   igraph_lazy_inclist_t inclist;
   igraph_vector_t dists, order;
   igraph_vector_ptr_t parents;
@@ -4854,8 +5349,8 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
   IGRAPH_FINALLY(igraph_free, is_target);
 
   /* two-way heap storing vertices and distances */
-  IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-  IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+  IGRAPH_CHECK(igraph_i_sssp_queue_init(&Q, no_of_nodes, weights));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q);
 
   /* lazy adjacency edge list to query neighbours efficiently */
   IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
@@ -4876,15 +5371,17 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
   IGRAPH_FINALLY_CLEAN(1);
 
   VECTOR(dists)[(long int)from] = 0.0;	/* zero distance */
-  igraph_2wheap_push_with_index(&Q, from, 0);
+  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, from, 0));
     
-  while (!igraph_2wheap_empty(&Q) && to_reach > 0) {
-    long int nlen, minnei=igraph_2wheap_max_index(&Q);
-    igraph_real_t mindist=-igraph_2wheap_delete_max(&Q);
+  while (!igraph_i_sssp_queue_empty(&Q) && to_reach > 0) {
+    long int nlen, minnei;
+    igraph_real_t mindist;
     igraph_vector_t *neis;
 
     IGRAPH_ALLOW_INTERRUPTION();
 
+    IGRAPH_CHECK(igraph_i_sssp_queue_pop(&Q, &minnei, &mindist));
+
     /*
     printf("Reached vertex %ld, is_target[%ld] = %d, %ld to go\n",
         minnei, minnei, (int)is_target[minnei], to_reach - is_target[minnei]);
@@ -4913,7 +5410,7 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
         VECTOR(dists)[tto] = altdist;
         parent_vec = (igraph_vector_t*)VECTOR(parents)[tto];
         IGRAPH_CHECK(igraph_vector_push_back(parent_vec, minnei));
-        IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+        IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, tto, altdist));
       } else if (altdist == curdist && VECTOR(*weights)[edge] > 0) {
 	/* This is an alternative path with exactly the same length.
          * Note that we consider this case only if the edge via which we
@@ -4928,17 +5425,17 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
         parent_vec = (igraph_vector_t*)VECTOR(parents)[tto];
         igraph_vector_clear(parent_vec);
         IGRAPH_CHECK(igraph_vector_push_back(parent_vec, minnei));
-        IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+        IGRAPH_CHECK(igraph_i_sssp_queue_modify(&Q, tto, altdist));
       }
     }
-  } /* !igraph_2wheap_empty(&Q) */
+  } /* !igraph_i_sssp_queue_empty(&Q) */
 
   if (to_reach > 0)
     IGRAPH_WARNING("Couldn't reach some vertices");
 
   /* we don't need these anymore */
   igraph_lazy_inclist_destroy(&inclist);
-  igraph_2wheap_destroy(&Q);
+  igraph_i_sssp_queue_destroy(&Q);
   IGRAPH_FINALLY_CLEAN(2);
 
   /*
@@ -6061,15 +6558,11 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
 			     igraph_bool_t unconn) {
 
   /* Implementation details. This is the basic Dijkstra algorithm, 
-     with a binary heap. The heap is indexed, i.e. it stores not only
-     the distances, but also which vertex they belong to.
-
-     From now on we use a 2-way heap, so the distances can be queried
-     directly from the heap.
+     with an indexed priority queue, see
+     igraph_shortest_paths_dijkstra(). The distances can be queried
+     directly from the queue.
 
      Dirty tricks:
-     - the opposite of the distance is stored in the heap, as it is a
-       maximum heap and we need a minimum heap.
      - we don't use IGRAPH_INFINITY during the computation, as IGRAPH_FINITE()
        might involve a function call and we want to spare that. -1 will denote
        infinity instead.
@@ -6078,7 +6571,7 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
   long int no_of_nodes=igraph_vcount(graph);
   long int no_of_edges=igraph_ecount(graph);
 
-  igraph_2wheap_t Q;
+  igraph_i_sssp_queue_t Q;
   igraph_inclist_t inclist;
   long int source, j;
   igraph_neimode_t dirmode = directed ? IGRAPH_OUT : IGRAPH_ALL;
@@ -6104,8 +6597,8 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
     IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
   }
   
-  IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-  IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+  IGRAPH_CHECK(igraph_i_sssp_queue_init(&Q, no_of_nodes, weights));
+  IGRAPH_FINALLY(igraph_i_sssp_queue_destroy, &Q);
   IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, dirmode));
   IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
   
@@ -6114,16 +6607,18 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
     IGRAPH_PROGRESS("Weighted diameter: ", source*100.0/no_of_nodes, NULL);
     IGRAPH_ALLOW_INTERRUPTION();
 
-    igraph_2wheap_clear(&Q);
-    igraph_2wheap_push_with_index(&Q, source, -1.0);
+    igraph_i_sssp_queue_clear(&Q);
+    IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, source, 1.0));
 
     nodes_reached = 0.0;
 
-    while (!igraph_2wheap_empty(&Q)) {
-      long int minnei=igraph_2wheap_max_index(&Q);
-      igraph_real_t mindist=-igraph_2wheap_deactivate_max(&Q);
+    while (!igraph_i_sssp_queue_empty(&Q)) {
+      long int minnei;
+      igraph_real_t mindist;
       igraph_vector_int_t *neis;
       long int nlen;
+
+      IGRAPH_CHECK(igraph_i_sssp_queue_pop(&Q, &minnei, &mindist));
       
       if (mindist > res) {
 	res=mindist; from=source; to=minnei;
@@ -6137,20 +6632,20 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
 	long int edge=(long int) VECTOR(*neis)[j];
 	long int tto=IGRAPH_OTHER(graph, edge, minnei);
 	igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-        igraph_bool_t active = igraph_2wheap_has_active(&Q, tto);
-        igraph_bool_t has = igraph_2wheap_has_elem(&Q, tto);
-	igraph_real_t curdist = active ? -igraph_2wheap_get(&Q, tto) : 0.0;
+        igraph_bool_t active = igraph_i_sssp_queue_has_active(&Q, tto);
+        igraph_bool_t has = igraph_i_sssp_queue_has_elem(&Q, tto);
+	igraph_real_t curdist = active ? igraph_i_sssp_queue_get(&Q, tto) : 0.0;
 	
 	if (!has) {
 	  /* First finite distance */
-	  IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_push(&Q, tto, altdist));
 	} else if (altdist < curdist) {
 	  /* A shorter path */
-	  IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+	  IGRAPH_CHECK(igraph_i_sssp_queue_modify(&Q, tto, altdist));
 	}
       }
       
-    } /* !igraph_2wheap_empty(&Q) */
+    } /* !igraph_i_sssp_queue_empty(&Q) */
 
     /* not connected, return infinity */
     if (nodes_reached != no_of_nodes && !unconn) {
@@ -6165,7 +6660,7 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
   res -= 1;
 
   igraph_inclist_destroy(&inclist);
-  igraph_2wheap_destroy(&Q);
+  igraph_i_sssp_queue_destroy(&Q);
   IGRAPH_FINALLY_CLEAN(2);
 
   IGRAPH_PROGRESS("Weighted diameter: ", 100.0, NULL);
@@ -25,13 +25,38 @@
 #include "igraph_interface.h"
 #include "igraph_attributes.h"
 #include "igraph_memory.h"
+#include "igraph_qsort.h"
+#include "igraph_types_internal.h"
 #include <string.h>		/* memset & co. */
 #include "config.h"
 
 /* Internal functions */
 
-int igraph_i_create_start(igraph_vector_t *res, igraph_vector_t *el, igraph_vector_t *index, 
-			  igraph_integer_t nodes);
+int igraph_i_create_start(igraph_vector_int_t *res, igraph_vector_int_t *el,
+			  igraph_vector_int_t *index, igraph_integer_t nodes);
+int igraph_i_add_edges_cmp(void *extra, const void *a, const void *b);
+void igraph_i_merge_index(igraph_vector_int_t *iindex, 
+			  const igraph_vector_int_t *start,
+			  const igraph_vector_int_t *key1,
+			  const igraph_vector_int_t *key2,
+			  const int *neworder, long int no_of_old, 
+			  long int no_of_new);
+int igraph_i_add_edges_incremental(igraph_t *graph, 
+				   const igraph_vector_t *edges,
+				   void *attr, long int no_of_edges,
+				   long int edges_to_add);
+void igraph_i_filter_index(const igraph_vector_int_t *iindex,
+			   const igraph_vector_int_t *start,
+			   const igraph_vector_int_t *edge_recoding,
+			   const igraph_vector_t *vertex_recoding,
+			   igraph_vector_int_t *newindex,
+			   igraph_vector_int_t *newstart);
+igraph_bool_t igraph_i_check_index(const igraph_vector_int_t *iindex,
+				   const igraph_vector_int_t *start,
+				   const igraph_vector_int_t *key1,
+				   const igraph_vector_int_t *key2,
+				   char *seen, long int no_of_nodes,
+				   long int no_of_edges);
 
 /**
  * \section about_basic_interface
@@ -123,12 +148,12 @@ int igraph_empty_attrs(igraph_t *graph, igraph_integer_t n, igraph_bool_t direct
 
   graph->n=0;
   graph->directed=directed;
-  IGRAPH_VECTOR_INIT_FINALLY(&graph->from, 0);
-  IGRAPH_VECTOR_INIT_FINALLY(&graph->to, 0);
-  IGRAPH_VECTOR_INIT_FINALLY(&graph->oi, 0);
-  IGRAPH_VECTOR_INIT_FINALLY(&graph->ii, 0);
-  IGRAPH_VECTOR_INIT_FINALLY(&graph->os, 1);
-  IGRAPH_VECTOR_INIT_FINALLY(&graph->is, 1);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->from, 0);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->to, 0);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->oi, 0);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->ii, 0);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->os, 1);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->is, 1);
 
   VECTOR(graph->os)[0]=0;
   VECTOR(graph->is)[0]=0;
@@ -165,12 +190,12 @@ int igraph_destroy(igraph_t *graph) {
 
   IGRAPH_I_ATTRIBUTE_DESTROY(graph);
 
-  igraph_vector_destroy(&graph->from);
-  igraph_vector_destroy(&graph->to);
-  igraph_vector_destroy(&graph->oi);
-  igraph_vector_destroy(&graph->ii);
-  igraph_vector_destroy(&graph->os);
-  igraph_vector_destroy(&graph->is);
+  igraph_vector_int_destroy(&graph->from);
+  igraph_vector_int_destroy(&graph->to);
+  igraph_vector_int_destroy(&graph->oi);
+  igraph_vector_int_destroy(&graph->ii);
+  igraph_vector_int_destroy(&graph->os);
+  igraph_vector_int_destroy(&graph->is);
   
   return 0;
 }
@@ -204,18 +229,18 @@ int igraph_destroy(igraph_t *graph) {
 int igraph_copy(igraph_t *to, const igraph_t *from) {
   to->n=from->n;
   to->directed=from->directed;
-  IGRAPH_CHECK(igraph_vector_copy(&to->from, &from->from));
-  IGRAPH_FINALLY(igraph_vector_destroy, &to->from);
-  IGRAPH_CHECK(igraph_vector_copy(&to->to, &from->to));
-  IGRAPH_FINALLY(igraph_vector_destroy, &to->to);
-  IGRAPH_CHECK(igraph_vector_copy(&to->oi, &from->oi));
-  IGRAPH_FINALLY(igraph_vector_destroy, &to->oi);
-  IGRAPH_CHECK(igraph_vector_copy(&to->ii, &from->ii));
-  IGRAPH_FINALLY(igraph_vector_destroy, &to->ii);
-  IGRAPH_CHECK(igraph_vector_copy(&to->os, &from->os));
-  IGRAPH_FINALLY(igraph_vector_destroy, &to->os);
-  IGRAPH_CHECK(igraph_vector_copy(&to->is, &from->is));
-  IGRAPH_FINALLY(igraph_vector_destroy, &to->is);
+  IGRAPH_CHECK(igraph_vector_int_copy(&to->from, &from->from));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &to->from);
+  IGRAPH_CHECK(igraph_vector_int_copy(&to->to, &from->to));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &to->to);
+  IGRAPH_CHECK(igraph_vector_int_copy(&to->oi, &from->oi));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &to->oi);
+  IGRAPH_CHECK(igraph_vector_int_copy(&to->ii, &from->ii));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &to->ii);
+  IGRAPH_CHECK(igraph_vector_int_copy(&to->os, &from->os));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &to->os);
+  IGRAPH_CHECK(igraph_vector_int_copy(&to->is, &from->is));
+  IGRAPH_FINALLY(igraph_vector_int_destroy, &to->is);
 
   IGRAPH_I_ATTRIBUTE_COPY(to, from, 1,1,1); /* does IGRAPH_CHECK */
 
@@ -248,21 +273,32 @@ int igraph_copy(igraph_t *to, const igraph_t *from) {
  * This function invalidates all iterators.
  *
  * </para><para>
+ * If the graph already has at least as many edges as the number of
+ * edges to add, then the new edges are merged into the existing
+ * indices, instead of rebuilding them. Adding edges in small batches
+ * is therefore much cheaper than it used to be, but adding all edges
+ * in a single call is still the fastest.
+ *
+ * </para><para>
  * Time complexity: O(|V|+|E|) where
  * |V| is the number of vertices and
  * |E| is the number of
- * edges in the \em new, extended graph.
+ * edges in the \em new, extended graph. If the new edges are merged
+ * into the existing indices, then this is O(|V|+k log(k)+s), where k
+ * is the number of new edges and s is the number of index entries
+ * that need to be shifted; s is at most |E|, but it is a simple
+ * memory move.
  * 
  * \example examples/simple/igraph_add_edges.c
  */
 int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
 		     void *attr) {
-  long int no_of_edges=igraph_vector_size(&graph->from);
+  long int no_of_edges=igraph_vector_int_size(&graph->from);
   long int edges_to_add=igraph_vector_size(edges)/2;
   long int i=0;
   igraph_error_handler_t *oldhandler;
   int ret1, ret2;
-  igraph_vector_t newoi, newii;
+  igraph_vector_int_t newoi, newii;
   igraph_bool_t directed=igraph_is_directed(graph);
 
   if (igraph_vector_size(edges) % 2 != 0) {
@@ -273,38 +309,45 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
   }
 
   /* from & to */
-  IGRAPH_CHECK(igraph_vector_reserve(&graph->from, no_of_edges+edges_to_add));
-  IGRAPH_CHECK(igraph_vector_reserve(&graph->to  , no_of_edges+edges_to_add));
+  IGRAPH_CHECK(igraph_vector_int_reserve(&graph->from, no_of_edges+edges_to_add));
+  IGRAPH_CHECK(igraph_vector_int_reserve(&graph->to  , no_of_edges+edges_to_add));
 
   while (i<edges_to_add*2) {
     if (directed || VECTOR(*edges)[i] > VECTOR(*edges)[i+1]) {
-      igraph_vector_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
-      igraph_vector_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
+      igraph_vector_int_push_back(&graph->from, (int) VECTOR(*edges)[i++]); /* reserved */
+      igraph_vector_int_push_back(&graph->to,   (int) VECTOR(*edges)[i++]); /* reserved */
     } else {
-      igraph_vector_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
-      igraph_vector_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
+      igraph_vector_int_push_back(&graph->to,   (int) VECTOR(*edges)[i++]); /* reserved */
+      igraph_vector_int_push_back(&graph->from, (int) VECTOR(*edges)[i++]); /* reserved */
     }      
   }
 
+  /* If the graph is not empty and the new edges are not too many,
+     then we merge them into the existing indices */
+  if (no_of_edges > 0 && edges_to_add <= no_of_edges) {
+    return igraph_i_add_edges_incremental(graph, edges, attr, no_of_edges,
+					  edges_to_add);
+  }
+
   /* disable the error handler temporarily */
   oldhandler=igraph_set_error_handler(igraph_error_handler_ignore);
     
   /* oi & ii */
-  ret1=igraph_vector_init(&newoi, no_of_edges);
-  ret2=igraph_vector_init(&newii, no_of_edges);
+  ret1=igraph_vector_int_init(&newoi, no_of_edges);
+  ret2=igraph_vector_int_init(&newii, no_of_edges);
   if (ret1 != 0 || ret2 != 0) {
-    igraph_vector_resize(&graph->from, no_of_edges); /* gets smaller */
-    igraph_vector_resize(&graph->to, no_of_edges);   /* gets smaller */
+    igraph_vector_int_resize(&graph->from, no_of_edges); /* gets smaller */
+    igraph_vector_int_resize(&graph->to, no_of_edges);   /* gets smaller */
     igraph_set_error_handler(oldhandler);
     IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
   }  
-  ret1=igraph_vector_order(&graph->from, &graph->to, &newoi, graph->n);
-  ret2=igraph_vector_order(&graph->to  , &graph->from, &newii, graph->n);
+  ret1=igraph_vector_int_order(&graph->from, &graph->to, &newoi, graph->n);
+  ret2=igraph_vector_int_order(&graph->to  , &graph->from, &newii, graph->n);
   if (ret1 != 0 || ret2 != 0) {
-    igraph_vector_resize(&graph->from, no_of_edges);
-    igraph_vector_resize(&graph->to, no_of_edges);
-    igraph_vector_destroy(&newoi);
-    igraph_vector_destroy(&newii);
+    igraph_vector_int_resize(&graph->from, no_of_edges);
+    igraph_vector_int_resize(&graph->to, no_of_edges);
+    igraph_vector_int_destroy(&newoi);
+    igraph_vector_int_destroy(&newii);
     igraph_set_error_handler(oldhandler);
     IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
   }  
@@ -315,10 +358,10 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
     ret1=igraph_i_attribute_add_edges(graph, edges, attr);
     igraph_set_error_handler(igraph_error_handler_ignore);
     if (ret1 != 0) {
-      igraph_vector_resize(&graph->from, no_of_edges);
-      igraph_vector_resize(&graph->to, no_of_edges);
-      igraph_vector_destroy(&newoi);
-      igraph_vector_destroy(&newii);
+      igraph_vector_int_resize(&graph->from, no_of_edges);
+      igraph_vector_int_resize(&graph->to, no_of_edges);
+      igraph_vector_int_destroy(&newoi);
+      igraph_vector_int_destroy(&newii);
       igraph_set_error_handler(oldhandler);
       IGRAPH_ERROR("cannot add edges", ret1);
     }  
@@ -329,8 +372,8 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
   igraph_i_create_start(&graph->is, &graph->to  , &newii, graph->n);
 
   /* everything went fine  */
-  igraph_vector_destroy(&graph->oi);
-  igraph_vector_destroy(&graph->ii);
+  igraph_vector_int_destroy(&graph->oi);
+  igraph_vector_int_destroy(&graph->ii);
   graph->oi=newoi;
   graph->ii=newii;
   igraph_set_error_handler(oldhandler);
@@ -338,6 +381,157 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
   return 0;
 }
 
+/* Orders edge ids by two keys, and then by decreasing edge id. This
+   is the same order as the one igraph_vector_int_order() creates. The
+   keys are given in the first two elements of 'extra'. */
+
+int igraph_i_add_edges_cmp(void *extra, const void *a, const void *b) {
+  igraph_vector_int_t **keys=(igraph_vector_int_t **) extra;
+  int e1=*(const int*) a, e2=*(const int*) b;
+  int a1=VECTOR(*keys[0])[e1], b1=VECTOR(*keys[0])[e2];
+  if (a1 != b1) {
+    return a1 < b1 ? -1 : 1;
+  } else {
+    int a2=VECTOR(*keys[1])[e1], b2=VECTOR(*keys[1])[e2];
+    if (a2 != b2) {
+      return a2 < b2 ? -1 : 1;
+    }
+  }
+  return e1 < e2 ? 1 : (e1 > e2 ? -1 : 0);
+}
+
+/* Merges the (already sorted) new edges in 'neworder' into the index
+   'iindex', in place. 'iindex' must be already resized to hold all
+   edges, its first 'no_of_old' elements are the old index, and
+   'start' is the start vector belonging to the old index. The new
+   edges are inserted from the back, so that every old element is
+   moved at most once, and elements before the first insertion point
+   are not touched at all. This function cannot fail. */
+
+void igraph_i_merge_index(igraph_vector_int_t *iindex, 
+			  const igraph_vector_int_t *start,
+			  const igraph_vector_int_t *key1,
+			  const igraph_vector_int_t *key2,
+			  const int *neworder, long int no_of_old, 
+			  long int no_of_new) {
+  int *idx=VECTOR(*iindex);
+  long int end=no_of_old;
+  long int j;
+
+  for (j=no_of_new-1; j>=0; j--) {
+    int e=neworder[j];
+    long int k1=VECTOR(*key1)[e], k2=VECTOR(*key2)[e];
+    long int lo=VECTOR(*start)[k1], hi=VECTOR(*start)[k1+1];
+    /* Elements after 'end' were already moved, but the insertion
+       point is never after 'end', because the new edges come in
+       decreasing order */
+    if (lo > end) { lo=end; }
+    if (hi > end) { hi=end; }
+    while (lo < hi) {
+      long int mid=lo+(hi-lo)/2;
+      if (VECTOR(*key2)[ idx[mid] ] < k2) {
+	lo=mid+1;
+      } else {
+	hi=mid;
+      }
+    }
+    memmove(idx+lo+j+1, idx+lo, (size_t) (end-lo) * sizeof(int));
+    idx[lo+j]=e;
+    end=lo;
+  }
+}
+
+/* This is called from igraph_add_edges, after the new edges were
+   appended to 'from' and 'to'. Instead of recreating the indices, it
+   sorts the new edges only and merges them into 'oi' and 'ii'. */
+
+int igraph_i_add_edges_incremental(igraph_t *graph, 
+				   const igraph_vector_t *edges,
+				   void *attr, long int no_of_edges,
+				   long int edges_to_add) {
+  long int new_no_of_edges=no_of_edges+edges_to_add;
+  long int no_of_nodes=graph->n;
+  igraph_error_handler_t *oldhandler;
+  igraph_vector_int_t *keys[2];
+  int *outorder, *inorder;
+  int ret1, ret2;
+  long int i, j;
+  
+  /* disable the error handler temporarily */
+  oldhandler=igraph_set_error_handler(igraph_error_handler_ignore);
+
+  /* Reserve all memory first, so that we can roll back easily */
+  outorder=igraph_Calloc(edges_to_add > 0 ? 2*edges_to_add : 1, int);
+  ret1=igraph_vector_int_reserve(&graph->oi, new_no_of_edges);
+  ret2=igraph_vector_int_reserve(&graph->ii, new_no_of_edges);
+  if (outorder==0 || ret1 != 0 || ret2 != 0) {
+    igraph_vector_int_resize(&graph->from, no_of_edges); /* gets smaller */
+    igraph_vector_int_resize(&graph->to, no_of_edges);   /* gets smaller */
+    igraph_set_error_handler(oldhandler);
+    if (outorder==0) {
+      IGRAPH_ERROR("cannot add edges", IGRAPH_ENOMEM);
+    }
+    igraph_Free(outorder);
+    IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
+  }
+  inorder=outorder+edges_to_add;
+
+  /* Attributes */
+  if (graph->attr) { 
+    igraph_set_error_handler(oldhandler);
+    ret1=igraph_i_attribute_add_edges(graph, edges, attr);
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (ret1 != 0) {
+      igraph_vector_int_resize(&graph->from, no_of_edges);
+      igraph_vector_int_resize(&graph->to, no_of_edges);
+      igraph_Free(outorder);
+      igraph_set_error_handler(oldhandler);
+      IGRAPH_ERROR("cannot add edges", ret1);
+    }
+  }
+
+  /* Sort the new edges only */
+  for (i=0; i<edges_to_add; i++) {
+    outorder[i]=inorder[i]=(int) (no_of_edges+i);
+  }
+  keys[0]=&graph->from; keys[1]=&graph->to;
+  igraph_qsort_r(outorder, (size_t) edges_to_add, sizeof(int), keys,
+		 igraph_i_add_edges_cmp);
+  keys[0]=&graph->to; keys[1]=&graph->from;
+  igraph_qsort_r(inorder, (size_t) edges_to_add, sizeof(int), keys,
+		 igraph_i_add_edges_cmp);
+
+  /* Merge them into oi & ii, these are reserved, error safe */
+  igraph_vector_int_resize(&graph->oi, new_no_of_edges);
+  igraph_vector_int_resize(&graph->ii, new_no_of_edges);
+  igraph_i_merge_index(&graph->oi, &graph->os, &graph->from, &graph->to,
+		       outorder, no_of_edges, edges_to_add);
+  igraph_i_merge_index(&graph->ii, &graph->is, &graph->to, &graph->from,
+		       inorder, no_of_edges, edges_to_add);
+
+  /* os & is, shift them by the number of new edges before each
+     vertex, the ones before the first new edge do not change */
+  if (edges_to_add > 0) {
+    for (i=VECTOR(graph->from)[ outorder[0] ]+1, j=0; i<=no_of_nodes; i++) {
+      while (j < edges_to_add && VECTOR(graph->from)[ outorder[j] ] < i) {
+	j++;
+      }
+      VECTOR(graph->os)[i] += (int) j;
+    }
+    for (i=VECTOR(graph->to)[ inorder[0] ]+1, j=0; i<=no_of_nodes; i++) {
+      while (j < edges_to_add && VECTOR(graph->to)[ inorder[j] ] < i) {
+	j++;
+      }
+      VECTOR(graph->is)[i] += (int) j;
+    }
+  }
+
+  igraph_Free(outorder);
+  igraph_set_error_handler(oldhandler);
+
+  return 0;
+}
+
 /**
  * \ingroup interface
  * \function igraph_add_vertices
@@ -369,14 +563,14 @@ int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
     IGRAPH_ERROR("cannot add negative number of vertices", IGRAPH_EINVAL);
   }
 
-  IGRAPH_CHECK(igraph_vector_reserve(&graph->os, graph->n+nv+1));
-  IGRAPH_CHECK(igraph_vector_reserve(&graph->is, graph->n+nv+1));
+  IGRAPH_CHECK(igraph_vector_int_reserve(&graph->os, graph->n+nv+1));
+  IGRAPH_CHECK(igraph_vector_int_reserve(&graph->is, graph->n+nv+1));
   
-  igraph_vector_resize(&graph->os, graph->n+nv+1); /* reserved */
-  igraph_vector_resize(&graph->is, graph->n+nv+1); /* reserved */
+  igraph_vector_int_resize(&graph->os, graph->n+nv+1); /* reserved */
+  igraph_vector_int_resize(&graph->is, graph->n+nv+1); /* reserved */
   for (i=graph->n+1; i<graph->n+nv+1; i++) {
-    VECTOR(graph->os)[i]=ec;
-    VECTOR(graph->is)[i]=ec;
+    VECTOR(graph->os)[i]=(int) ec;
+    VECTOR(graph->is)[i]=(int) ec;
   }
   
   graph->n += nv;   
@@ -388,6 +582,40 @@ int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
   return 0;
 }
 
+/* Removes the deleted edges from the 'iindex' index (oi or ii), and
+   creates the corresponding start vector. 'edge_recoding' contains the
+   new id plus one for every old edge, or zero for deleted edges.
+   'vertex_recoding' is similar, for the vertices, if it is a null
+   pointer, then no vertices are deleted. The recodings must keep the
+   relative order of the vertices and edges, so the filtered index is
+   still sorted. The results may be written into the input vectors,
+   otherwise they must have the right size already. The vectors are
+   not resized, so this function cannot fail. */
+
+void igraph_i_filter_index(const igraph_vector_int_t *iindex,
+			   const igraph_vector_int_t *start,
+			   const igraph_vector_int_t *edge_recoding,
+			   const igraph_vector_t *vertex_recoding,
+			   igraph_vector_int_t *newindex,
+			   igraph_vector_int_t *newstart) {
+  long int no_of_nodes=igraph_vector_int_size(start)-1;
+  long int i=0, j=0, v, nv=0;
+
+  for (v=0; v<no_of_nodes; v++) {
+    long int end=VECTOR(*start)[v+1];
+    if (!vertex_recoding || VECTOR(*vertex_recoding)[v] != 0) {
+      VECTOR(*newstart)[nv++] = (int) j;
+    }
+    for (; i<end; i++) {
+      long int e=VECTOR(*edge_recoding)[ (long int) VECTOR(*iindex)[i] ];
+      if (e != 0) {
+	VECTOR(*newindex)[j++] = (int) e-1;
+      }
+    }
+  }
+  VECTOR(*newstart)[nv] = (int) j;
+}
+
 /**
  * \ingroup interface
  * \function igraph_delete_edges
@@ -402,6 +630,12 @@ int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
  *
  * </para><para>
  * This function invalidates all iterators.
+ *
+ * </para><para>
+ * The remaining edges are compacted in place and the edge indices are
+ * filtered instead of being rebuilt, but the edge ids are renumbered,
+ * so every call touches all edges. If many edges are to be removed,
+ * then remove them in a single call.
  * \param graph The graph to work on.
  * \param edges The edges to remove.
  * \return Error code.
@@ -415,30 +649,22 @@ int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
  */
 int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
   long int no_of_edges=igraph_ecount(graph);
-  long int no_of_nodes=igraph_vcount(graph);
   long int edges_to_remove=0;
   long int remaining_edges;
   igraph_eit_t eit;
-  
-  igraph_vector_t newfrom, newto, newoi;
-
-  int *mark;
+  igraph_vector_int_t mark;
   long int i, j;
   
-  mark=igraph_Calloc(no_of_edges, int);
-  if (mark==0) {
-    IGRAPH_ERROR("Cannot delete edges", IGRAPH_ENOMEM);
-  }
-  IGRAPH_FINALLY(igraph_free, mark);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&mark, no_of_edges);
 
   IGRAPH_CHECK(igraph_eit_create(graph, edges, &eit));
   IGRAPH_FINALLY(igraph_eit_destroy, &eit);
 
   for (IGRAPH_EIT_RESET(eit); !IGRAPH_EIT_END(eit); IGRAPH_EIT_NEXT(eit)) {
     long int e=IGRAPH_EIT_GET(eit);
-    if (mark[e]==0) {
+    if (VECTOR(mark)[e]==0) {
       edges_to_remove++;
-      mark[e]++;
+      VECTOR(mark)[e]++;
     }
   }
   remaining_edges=no_of_edges-edges_to_remove;
@@ -447,32 +673,28 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
   igraph_eit_destroy(&eit);
   IGRAPH_FINALLY_CLEAN(1);
 
-  IGRAPH_VECTOR_INIT_FINALLY(&newfrom, remaining_edges);
-  IGRAPH_VECTOR_INIT_FINALLY(&newto, remaining_edges);
-  
-  /* Actually remove the edges, move from pos i to pos j in newfrom/newto */
-  for (i=0,j=0; j<remaining_edges; i++) {
-    if (mark[i]==0) {
-      VECTOR(newfrom)[j] = VECTOR(graph->from)[i];
-      VECTOR(newto)[j] = VECTOR(graph->to)[i];
-      j++;
-    }
+  if (edges_to_remove == 0) {
+    igraph_vector_int_destroy(&mark);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
   }
 
-  /* Create index, this might require additional memory */
-  IGRAPH_VECTOR_INIT_FINALLY(&newoi, remaining_edges);
-  IGRAPH_CHECK(igraph_vector_order(&newfrom, &newto, &newoi, no_of_nodes));
-  IGRAPH_CHECK(igraph_vector_order(&newto, &newfrom, &graph->ii, no_of_nodes));
+  /* Recode the edges, 'mark' will hold the new id plus one for the
+     remaining edges and zero for the removed ones */
+  for (i=0, j=0; i<no_of_edges; i++) {
+    VECTOR(mark)[i] = VECTOR(mark)[i] ? 0 : (int) ++j;
+  }
 
   /* Edge attributes, we need an index that gives the ids of the 
-     original edges for every new edge. 
+     original edges for every new edge. This is the only step that
+     might fail, so we do it before touching the graph structure.
   */
   if (graph->attr) {    
     igraph_vector_t idx;
     IGRAPH_VECTOR_INIT_FINALLY(&idx, remaining_edges);
-    for (i=0, j=0; i<no_of_edges; i++) {
-      if (mark[i] == 0) {
-	VECTOR(idx)[j++] = i;
+    for (i=0; i<no_of_edges; i++) {
+      if (VECTOR(mark)[i] != 0) {
+	VECTOR(idx)[ VECTOR(mark)[i]-1 ] = i;
       }
     }
     IGRAPH_CHECK(igraph_i_attribute_permute_edges(graph, graph, &idx));
@@ -480,25 +702,28 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     IGRAPH_FINALLY_CLEAN(1);
   }
 
-  /* Ok, we've all memory needed, free the old structure  */
-  igraph_vector_destroy(&graph->from);
-  igraph_vector_destroy(&graph->to);
-  igraph_vector_destroy(&graph->oi);
-  graph->from=newfrom;
-  graph->to=newto;
-  graph->oi=newoi;
-  IGRAPH_FINALLY_CLEAN(3);
-
-  igraph_Free(mark);
+  /* Actually remove the edges, in place, the remaining edges keep
+     their relative order, so the indices need not be sorted again */
+  for (i=0; i<no_of_edges; i++) {
+    if (VECTOR(mark)[i] != 0) {
+      VECTOR(graph->from)[ VECTOR(mark)[i]-1 ] = VECTOR(graph->from)[i];
+      VECTOR(graph->to  )[ VECTOR(mark)[i]-1 ] = VECTOR(graph->to  )[i];
+    }
+  }
+  igraph_i_filter_index(&graph->oi, &graph->os, &mark, 0,
+			&graph->oi, &graph->os);
+  igraph_i_filter_index(&graph->ii, &graph->is, &mark, 0,
+			&graph->ii, &graph->is);
+
+  /* These get smaller, no memory is needed */
+  igraph_vector_int_resize(&graph->from, remaining_edges);
+  igraph_vector_int_resize(&graph->to, remaining_edges);
+  igraph_vector_int_resize(&graph->oi, remaining_edges);
+  igraph_vector_int_resize(&graph->ii, remaining_edges);
+
+  igraph_vector_int_destroy(&mark);
   IGRAPH_FINALLY_CLEAN(1);
   
-  /* Create start vectors, no memory is needed for this */
-  igraph_i_create_start(&graph->os, &graph->from, &graph->oi, 
-			(igraph_integer_t) no_of_nodes);
-  igraph_i_create_start(&graph->is, &graph->to,   &graph->ii, 
-			(igraph_integer_t) no_of_nodes);
-  
-  /* Nothing to deallocate... */
   return 0;
 }
 
@@ -539,7 +764,8 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
 
   long int no_of_edges=igraph_ecount(graph);
   long int no_of_nodes=igraph_vcount(graph);
-  igraph_vector_t edge_recoding, vertex_recoding;
+  igraph_vector_int_t edge_recoding;
+  igraph_vector_t vertex_recoding;
   igraph_vector_t *my_vertex_recoding=&vertex_recoding;
   igraph_vit_t vit;
   igraph_t newgraph;
@@ -554,7 +780,7 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     IGRAPH_VECTOR_INIT_FINALLY(&vertex_recoding, no_of_nodes);
   }
 
-  IGRAPH_VECTOR_INIT_FINALLY(&edge_recoding, no_of_edges);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&edge_recoding, no_of_edges);
  
   IGRAPH_CHECK(igraph_vit_create(graph, vertices, &vit));
   IGRAPH_FINALLY(igraph_vit_destroy, &vit);
@@ -582,7 +808,7 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     long int to=(long int) VECTOR(graph->to)[i];
     if (VECTOR(*my_vertex_recoding)[from] != 0 &&
 	VECTOR(*my_vertex_recoding)[to  ] != 0) {
-      VECTOR(edge_recoding)[i]=remaining_edges+1;
+      VECTOR(edge_recoding)[i]=(int) remaining_edges+1;
       remaining_edges++;
     } 
   }
@@ -592,35 +818,29 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
   newgraph.directed=graph->directed;  
 
   /* allocate vectors */
-  IGRAPH_VECTOR_INIT_FINALLY(&newgraph.from, remaining_edges);
-  IGRAPH_VECTOR_INIT_FINALLY(&newgraph.to, remaining_edges);
-  IGRAPH_VECTOR_INIT_FINALLY(&newgraph.oi, remaining_edges);
-  IGRAPH_VECTOR_INIT_FINALLY(&newgraph.ii, remaining_edges);
-  IGRAPH_VECTOR_INIT_FINALLY(&newgraph.os, remaining_vertices+1);
-  IGRAPH_VECTOR_INIT_FINALLY(&newgraph.is, remaining_vertices+1);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.from, remaining_edges);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.to, remaining_edges);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.oi, remaining_edges);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.ii, remaining_edges);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.os, remaining_vertices+1);
+  IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.is, remaining_vertices+1);
   
   /* Add the edges */
   for (i=0, j=0; j<remaining_edges; i++) {
     if (VECTOR(edge_recoding)[i]>0) {
       long int from=(long int) VECTOR(graph->from)[i];
       long int to=(long int) VECTOR(graph->to  )[i];
-      VECTOR(newgraph.from)[j]=VECTOR(*my_vertex_recoding)[from]-1;
-      VECTOR(newgraph.to  )[j]=VECTOR(*my_vertex_recoding)[to]-1;
+      VECTOR(newgraph.from)[j]=(int) VECTOR(*my_vertex_recoding)[from]-1;
+      VECTOR(newgraph.to  )[j]=(int) VECTOR(*my_vertex_recoding)[to]-1;
       j++;
     }
   }
-  /* update oi & ii */
-  IGRAPH_CHECK(igraph_vector_order(&newgraph.from, &newgraph.to, &newgraph.oi, 
-				   remaining_vertices));
-  IGRAPH_CHECK(igraph_vector_order(&newgraph.to, &newgraph.from, &newgraph.ii, 
-				   remaining_vertices));  
-
-  IGRAPH_CHECK(igraph_i_create_start(&newgraph.os, &newgraph.from, 
-				     &newgraph.oi, (igraph_integer_t) 
-				     remaining_vertices));
-  IGRAPH_CHECK(igraph_i_create_start(&newgraph.is, &newgraph.to,
-				     &newgraph.ii, (igraph_integer_t) 
-				     remaining_vertices));
+  /* oi, ii, os & is; the recoding keeps the order of both the
+     vertices and the edges, so we just filter the old indices */
+  igraph_i_filter_index(&graph->oi, &graph->os, &edge_recoding, 
+			my_vertex_recoding, &newgraph.oi, &newgraph.os);
+  igraph_i_filter_index(&graph->ii, &graph->is, &edge_recoding, 
+			my_vertex_recoding, &newgraph.ii, &newgraph.is);
   
   /* attributes */
   IGRAPH_I_ATTRIBUTE_COPY(&newgraph, graph, 
@@ -653,7 +873,7 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
   }
 	       
   igraph_vit_destroy(&vit);
-  igraph_vector_destroy(&edge_recoding);
+  igraph_vector_int_destroy(&edge_recoding);
   igraph_destroy(graph);
   *graph=newgraph;
 
@@ -703,7 +923,7 @@ igraph_integer_t igraph_vcount(const igraph_t *graph) {
  * Time complexity: O(1)
  */
 igraph_integer_t igraph_ecount(const igraph_t *graph) {
-  return (igraph_integer_t) igraph_vector_size(&graph->from);
+  return (igraph_integer_t) igraph_vector_int_size(&graph->from);
 }
 
 /**
@@ -832,8 +1052,8 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
  * 
  */
 
-int igraph_i_create_start(igraph_vector_t *res, igraph_vector_t *el, igraph_vector_t *iindex, 
-			  igraph_integer_t nodes) {
+int igraph_i_create_start(igraph_vector_int_t *res, igraph_vector_int_t *el,
+			  igraph_vector_int_t *iindex, igraph_integer_t nodes) {
   
 # define EDGE(i) (VECTOR(*el)[ (long int) VECTOR(*iindex)[(i)] ])
   
@@ -842,17 +1062,17 @@ int igraph_i_create_start(igraph_vector_t *res, igraph_vector_t *el, igraph_vect
   long int i, j, idx;
   
   no_of_nodes=nodes;
-  no_of_edges=igraph_vector_size(el);
+  no_of_edges=igraph_vector_int_size(el);
   
   /* result */
   
-  IGRAPH_CHECK(igraph_vector_resize(res, nodes+1));
+  IGRAPH_CHECK(igraph_vector_int_resize(res, nodes+1));
   
   /* create the index */
 
-  if (igraph_vector_size(el)==0) {
+  if (no_of_edges==0) {
     /* empty graph */
-    igraph_vector_null(res);
+    igraph_vector_int_null(res);
   } else {
     idx=-1;
     for (i=0; i<=EDGE(0); i++) {
@@ -861,12 +1081,12 @@ int igraph_i_create_start(igraph_vector_t *res, igraph_vector_t *el, igraph_vect
     for (i=1; i<no_of_edges; i++) {
       long int n=(long int) (EDGE(i) - EDGE((long int)VECTOR(*res)[idx]));
       for (j=0; j<n; j++) {
-	idx++; VECTOR(*res)[idx]=i;
+	idx++; VECTOR(*res)[idx]=(int) i;
       }
     }
     j=(long int) EDGE((long int)VECTOR(*res)[idx]);
     for (i=0; i<no_of_nodes-j; i++) {
-      idx++; VECTOR(*res)[idx]=no_of_edges;
+      idx++; VECTOR(*res)[idx]=(int) no_of_edges;
     }
   }
 
@@ -1707,3 +1927,119 @@ int igraph_incident(const igraph_t *graph, igraph_vector_t *eids,
 
   return 0;
 }
+
+/* Writes the edge list and the indices of the graph to a binary
+   stream, in native byte order. See igraph_write_graph_binary() in
+   foreign.c for the file format. */
+
+int igraph_i_write_graph_index(const igraph_t *graph, FILE *outstream) {
+  long int no_of_nodes=igraph_vcount(graph);
+  long int no_of_edges=igraph_ecount(graph);
+  const igraph_vector_int_t *vecs[6] = { &graph->from, &graph->to,
+					 &graph->oi, &graph->ii,
+					 &graph->os, &graph->is };
+  long int i;
+
+  for (i=0; i<6; i++) {
+    size_t len= i<4 ? no_of_edges : no_of_nodes+1;
+    if (fwrite(VECTOR(*vecs[i]), sizeof(int), len, outstream) != len) {
+      IGRAPH_ERROR("Write failed", IGRAPH_EFILE);
+    }
+  }
+  
+  return 0;
+}
+
+/* Checks that 'iindex' and 'start' form a valid index of the edges,
+   with 'key1' as the primary and 'key2' as the secondary sort key,
+   and decreasing edge ids within the same (key1, key2) pair. 'seen'
+   must be zeroed and have room for all edges. */
+
+igraph_bool_t igraph_i_check_index(const igraph_vector_int_t *iindex,
+				   const igraph_vector_int_t *start,
+				   const igraph_vector_int_t *key1,
+				   const igraph_vector_int_t *key2,
+				   char *seen, long int no_of_nodes,
+				   long int no_of_edges) {
+  long int v, k;
+  
+  if (VECTOR(*start)[0] != 0 || VECTOR(*start)[no_of_nodes] != no_of_edges) {
+    return 0;
+  }
+  /* 'start' must be non-decreasing, so that 'iindex' is only read
+     within its bounds below */
+  for (v=0; v<no_of_nodes; v++) {
+    if (VECTOR(*start)[v+1] < VECTOR(*start)[v]) { return 0; }
+  }
+  for (v=0; v<no_of_nodes; v++) {
+    long int s=VECTOR(*start)[v], e=VECTOR(*start)[v+1];
+    for (k=s; k<e; k++) {
+      long int edge=VECTOR(*iindex)[k];
+      if (edge < 0 || edge >= no_of_edges || seen[edge]) { return 0; }
+      seen[edge] = 1;
+      if (VECTOR(*key1)[edge] != v) { return 0; }
+      if (k > s) {
+	long int prev=VECTOR(*iindex)[k-1];
+	if (VECTOR(*key2)[prev] > VECTOR(*key2)[edge] ||
+	    (VECTOR(*key2)[prev] == VECTOR(*key2)[edge] && prev < edge)) {
+	  return 0;
+	}
+      }
+    }
+  }
+  
+  return 1;
+}
+
+/* Reads the edge list and the indices written by
+   igraph_i_write_graph_index() into 'graph', which must be an
+   initialized graph without vertices and edges. The indices are
+   checked but not rebuilt. On error the graph must be destroyed by
+   the caller. */
+
+int igraph_i_read_graph_index(igraph_t *graph, FILE *instream, 
+			      igraph_integer_t n, igraph_integer_t m) {
+  long int no_of_nodes=n;
+  long int no_of_edges=m;
+  igraph_vector_int_t *vecs[6] = { &graph->from, &graph->to,
+				   &graph->oi, &graph->ii,
+				   &graph->os, &graph->is };
+  char *seen;
+  long int i;
+  igraph_bool_t ok;
+
+  for (i=0; i<6; i++) {
+    size_t len= i<4 ? no_of_edges : no_of_nodes+1;
+    IGRAPH_CHECK(igraph_vector_int_resize(vecs[i], (long int) len));
+    if (fread(VECTOR(*vecs[i]), sizeof(int), len, instream) != len) {
+      IGRAPH_ERROR("Cannot read binary graph file", IGRAPH_PARSEERROR);
+    }
+  }
+
+  for (i=0; i<no_of_edges; i++) {
+    long int from=VECTOR(graph->from)[i], to=VECTOR(graph->to)[i];
+    if (from < 0 || from >= no_of_nodes || to < 0 || to >= no_of_nodes ||
+	(!graph->directed && from < to)) {
+      IGRAPH_ERROR("Invalid edge in binary graph file", IGRAPH_PARSEERROR);
+    }
+  }
+  
+  seen=igraph_Calloc(no_of_edges > 0 ? no_of_edges : 1, char);
+  if (!seen) {
+    IGRAPH_ERROR("Cannot read binary graph file", IGRAPH_ENOMEM);
+  }
+  ok=igraph_i_check_index(&graph->oi, &graph->os, &graph->from, &graph->to,
+			  seen, no_of_nodes, no_of_edges);
+  if (ok) {
+    memset(seen, 0, sizeof(char) * (size_t) no_of_edges);
+    ok=igraph_i_check_index(&graph->ii, &graph->is, &graph->to, &graph->from,
+			    seen, no_of_nodes, no_of_edges);
+  }
+  igraph_Free(seen);
+  if (!ok) {
+    IGRAPH_ERROR("Invalid index in binary graph file", IGRAPH_PARSEERROR);
+  }
+
+  graph->n=n;
+  return 0;
+}
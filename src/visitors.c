@@ -27,8 +27,77 @@
 #include "igraph_interface.h"
 #include "igraph_dqueue.h"
 #include "igraph_stack.h"
+#include "igraph_dobfs_internal.h"
 #include "config.h"
 
+/* igraph_bfs() when only the distances are needed: the search trees
+   are the same, so it can use the direction-optimizing search, which
+   does not keep the visiting order within a level. */
+
+static int igraph_i_bfs_dist(const igraph_t *graph, long int root, 
+			     const igraph_vector_t *roots,
+			     igraph_neimode_t mode, igraph_bool_t unreachable,
+			     const igraph_vector_t *restricted,
+			     igraph_vector_t *dist) {
+  long int no_of_nodes=igraph_vcount(graph);
+  long int noroots= roots ? igraph_vector_size(roots) : 1;
+  long int i, actroot;
+  igraph_csr_t out, in;
+  igraph_i_dobfs_t bfs;
+  igraph_neimode_t rmode= mode==IGRAPH_OUT ? IGRAPH_IN : 
+    (mode==IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL);
+
+  IGRAPH_CHECK(igraph_csr_init(graph, &out, mode));
+  IGRAPH_FINALLY(igraph_csr_destroy, &out);
+  if (rmode != mode) {
+    IGRAPH_CHECK(igraph_csr_init(graph, &in, rmode));
+    IGRAPH_FINALLY(igraph_csr_destroy, &in);
+  }
+  IGRAPH_CHECK(igraph_i_dobfs_init(&bfs, &out, rmode != mode ? &in : &out));
+  IGRAPH_FINALLY(igraph_i_dobfs_destroy, &bfs);
+
+  if (restricted) {
+    long int n=igraph_vector_size(restricted);
+    igraph_vector_char_t keep;
+    IGRAPH_CHECK(igraph_vector_char_init(&keep, no_of_nodes));
+    for (i=0; i<n; i++) {
+      VECTOR(keep)[ (long int) VECTOR(*restricted)[i] ]=1;
+    }
+    for (i=0; i<no_of_nodes; i++) {
+      if (!VECTOR(keep)[i]) { igraph_i_dobfs_exclude(&bfs, i); }
+    }
+    igraph_vector_char_destroy(&keep);
+  }
+
+  if (dist) {
+    IGRAPH_CHECK(igraph_vector_resize(dist, no_of_nodes));
+    igraph_vector_fill(dist, IGRAPH_NAN);
+  }
+
+  /* The same roots, in the same order as in igraph_bfs() */
+  for (i=0; i<noroots; i++) {
+    actroot= roots ? (long int) VECTOR(*roots)[i] : root;
+    IGRAPH_CHECK(igraph_i_dobfs_run(&bfs, actroot, 
+				    dist ? VECTOR(*dist) : 0, 0));
+  }
+  if (unreachable) {
+    for (actroot=0; actroot<no_of_nodes; actroot++) {
+      IGRAPH_CHECK(igraph_i_dobfs_run(&bfs, actroot, 
+				      dist ? VECTOR(*dist) : 0, 0));
+    }
+  }
+
+  igraph_i_dobfs_destroy(&bfs);
+  if (rmode != mode) { 
+    igraph_csr_destroy(&in);
+    IGRAPH_FINALLY_CLEAN(1);
+  }
+  igraph_csr_destroy(&out);
+  IGRAPH_FINALLY_CLEAN(2);
+
+  return 0;
+}
+
 /**
  * \function igraph_bfs
  * Breadth-first search
@@ -79,6 +148,11 @@
  *        tree), then -1 is stored.
  * \param dist If not a null pointer, then the distance from the root of
  *        the current search tree is stored here.
+ *        If this is the only result requested and there is no \p
+ *        callback, then a direction-optimizing search is used, that
+ *        checks the large levels bottom-up, from the unvisited
+ *        vertices towards the frontier. This gives the same distances
+ *        but is usually much faster on graphs with small diameter.
  * \param callback If not null, then it should be a pointer to a
  *        function of type \ref igraph_bfshandler_t. This function
  *        will be called, whenever a new vertex is visited.
@@ -142,6 +216,11 @@ int igraph_bfs(const igraph_t *graph,
   
   if (!igraph_is_directed(graph)) { mode=IGRAPH_ALL; }
 
+  if (!order && !rank && !father && !pred && !succ && !callback) {
+    return igraph_i_bfs_dist(graph, root, roots, mode, unreachable, 
+			     restricted, dist);
+  }
+
   IGRAPH_CHECK(igraph_vector_char_init(&added, no_of_nodes));
   IGRAPH_FINALLY(igraph_vector_char_destroy, &added);
   IGRAPH_CHECK(igraph_dqueue_init(&Q, 100));